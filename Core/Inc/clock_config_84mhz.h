@@ -36,6 +36,9 @@ extern "C" {
 /* Flash等待周期 */
 #define FLASH_LATENCY_84MHZ     FLASH_LATENCY_2  /* 84MHz需要2个等待周期 */
 
+/* STOP唤醒后时钟恢复的轮询上限 (HSI 16MHz下约20ms，覆盖HSE最长启动时间) */
+#define CLOCK_RESTORE_TIMEOUT_LOOPS  80000U
+
 /* 功耗对比 */
 #define POWER_REDUCTION_PERCENT 50          /* 相对168MHz的功耗降低百分比 */
 
@@ -65,6 +68,15 @@ uint32_t Get_Current_SYSCLK_Freq(void);
 void Print_Clock_Info(void);
 void Full_84MHz_Test(void);
 
+/**
+ * @brief STOP唤醒后快速恢复84MHz时钟 (寄存器级，可在关中断、SysTick暂停时调用)
+ *
+ * STOP期间PLL配置、总线分频和Flash等待周期保持不变，只有HSE/PLL被关闭、SYSCLK切回HSI，
+ * 因此只需重新打开HSE和PLL并切换SYSCLK，不必重跑HAL_RCC_OscConfig/HAL_RCC_ClockConfig。
+ * @return 0: 成功, -1: HSE未就绪, -2: PLL未锁定, -3: SYSCLK切换超时 (失败时仍运行在HSI)
+ */
+int Clock_Config_RestoreAfterStop(void);
+
 /* 时钟配置结构体 */
 typedef struct {
     uint32_t SYSCLK_Freq;
@@ -0,0 +1,122 @@
+/**
+ * @file detection_params.h
+ * @brief 检测算法运行时参数管理头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 将粗检测/细检测的阈值从编译期宏改为运行时变量，
+ * 宏定义(example-raw-data.h)保留为默认值，上位机可通过命令协议在线读写。
+ */
+
+#ifndef DETECTION_PARAMS_H
+#define DETECTION_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 参数ID定义 (上位机协议使用，数值不可改动) */
+typedef enum {
+    /* 粗检测参数 */
+    PARAM_ID_TRIGGER_MULTIPLIER     = 0x01,  // 触发倍数
+    PARAM_ID_BASELINE_RMS           = 0x02,  // 初始基线RMS (g)
+    PARAM_ID_RMS_WINDOW_SIZE        = 0x03,  // RMS窗口长度 (样本数)
+    PARAM_ID_TRIGGER_DURATION_MS    = 0x04,  // 触发持续时间 (ms)
+    PARAM_ID_COOLDOWN_TIME_MS       = 0x05,  // 冷却时间 (ms)
+
+    /* 细检测频段 */
+    PARAM_ID_LOW_FREQ_MIN           = 0x10,  // 低频段下限 (Hz)
+    PARAM_ID_LOW_FREQ_MAX           = 0x11,  // 低频段上限 (Hz)
+    PARAM_ID_MID_FREQ_MIN           = 0x12,  // 中频段下限 (Hz)
+    PARAM_ID_MID_FREQ_MAX           = 0x13,  // 中频段上限 (Hz)
+    PARAM_ID_HIGH_FREQ_MIN          = 0x14,  // 高频段下限 (Hz)
+    PARAM_ID_HIGH_FREQ_MAX          = 0x15,  // 高频段上限 (Hz)
+
+    /* 细检测分类阈值 */
+    PARAM_ID_LOW_FREQ_THRESHOLD     = 0x16,  // 低频能量阈值
+    PARAM_ID_MID_FREQ_THRESHOLD     = 0x17,  // 中频能量阈值
+    PARAM_ID_DOMINANT_FREQ_MAX      = 0x18,  // 主频上限 (Hz)
+    PARAM_ID_CENTROID_MAX           = 0x19,  // 频谱重心上限 (Hz)
+    PARAM_ID_CONFIDENCE_THRESHOLD   = 0x1A,  // 置信度阈值
+} detection_param_id_t;
+
+/* 运行时检测参数 */
+typedef struct {
+    /* 粗检测 */
+    float32_t trigger_multiplier;
+    float32_t baseline_rms_threshold;
+    uint32_t rms_window_size;               // <= RMS_WINDOW_SIZE (缓冲区容量)
+    uint32_t trigger_duration_ms;
+    uint32_t cooldown_time_ms;
+
+    /* 细检测频段 */
+    float32_t low_freq_min;
+    float32_t low_freq_max;
+    float32_t mid_freq_min;
+    float32_t mid_freq_max;
+    float32_t high_freq_min;
+    float32_t high_freq_max;
+
+    /* 细检测分类阈值 */
+    float32_t low_freq_threshold;
+    float32_t mid_freq_threshold;
+    float32_t dominant_freq_max;
+    float32_t centroid_max;
+    float32_t confidence_threshold;
+} detection_params_t;
+
+/**
+ * @brief 初始化运行时参数 (加载宏定义默认值)
+ * @return 0: 成功, <0: 失败
+ */
+int Detection_Params_Init(void);
+
+/**
+ * @brief 获取当前运行时参数
+ * @return 参数结构体指针 (只读)
+ */
+const detection_params_t* Detection_Params_Get(void);
+
+/**
+ * @brief 按ID读取参数
+ * @param param_id 参数ID
+ * @param value 输出参数值 (统一以float表示)
+ * @return 0: 成功, -1: 未知参数ID, -2: 空指针
+ */
+int Detection_Params_GetValue(uint8_t param_id, float32_t* value);
+
+/**
+ * @brief 按ID设置参数 (带范围检查)
+ * @param param_id 参数ID
+ * @param value 新参数值
+ * @return 0: 成功, -1: 未知参数ID, -3: 超出范围, -4: 频带上下限写入后 min >= max
+ *         (整体移动频带时按方向先写远端：上移先写max，下移先写min)
+ */
+int Detection_Params_SetValue(uint8_t param_id, float32_t value);
+
+/**
+ * @brief 获取全部参数ID列表
+ * @param count 输出参数个数
+ * @return 参数ID数组
+ */
+const uint8_t* Detection_Params_GetIdList(uint8_t* count);
+
+/**
+ * @brief 恢复全部参数为默认值
+ */
+void Detection_Params_ResetDefaults(void);
+
+/**
+ * @brief 打印当前参数
+ */
+void Detection_Params_Print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DETECTION_PARAMS_H */
@@ -0,0 +1,139 @@
+/**
+ * @file detection_session.h
+ * @brief 低功耗唤醒检测会话头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 每次唤醒 (RTC轮询或WOM) 开启一个检测会话，按明确的阶段推进，每个阶段有样本数和时间预算：
+ *   WARMUP    高通滤波器稳定，丢弃唤醒后最初的样本对粗检测的影响      DETECTION_WARMUP_SAMPLES
+ *   COARSE    采满一个新的RMS窗口；RMS低于触发电平且无触发 -> 安静，立即结束   rms_window_size
+ *             (上次触发仍在TRIGGERED但已序贯判定时同样视为安静)
+ *   ANALYSIS  粗检测触发：FFT采集 + 细检测，状态机回到MONITORING且DSP空闲 -> 结束
+ *   ALARM     挖掘判定：报警状态机 (MINING_DETECTED / ALARM_SENDING / ALARM_COMPLETE / ERROR_HANDLING) 结束且LoRa空闲 -> 结束
+ * 状态机进入触发/报警状态时会话从任意阶段跳到ANALYSIS/ALARM。
+ * 阶段预算耗尽时以DETECTION_END_BUDGET结束；LoRa收发或延后的FFT任务未完成时不结束 (二者有各自的超时)。
+ * 样本数取自检测链 (Vibration_Pipeline_GetSampleCount)，按LN 1kHz计。
+ */
+
+#ifndef DETECTION_SESSION_H
+#define DETECTION_SESSION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fft_processor.h"
+#include "example-raw-data.h"
+
+/* 阶段预算 (样本数为0表示只受时间预算限制) */
+#define DETECTION_WARMUP_SAMPLES        50      // 5Hz 4阶高通在1kHz下约50ms稳定
+#define DETECTION_WARMUP_BUDGET_MS      150     // 传感器无数据时的上限
+#define DETECTION_COARSE_WINDOWS        3       // RMS偏高但未触发 (冷却期) 时最多采的窗口数
+#define DETECTION_COARSE_BUDGET_MS      (DETECTION_COARSE_WINDOWS * 250)
+#define DETECTION_ANALYSIS_SAMPLES      (4 * FFT_SIZE)
+#define DETECTION_ANALYSIS_BUDGET_MS    5000    // 与STATE_FINE_ANALYSIS_TIMEOUT_MS一致
+#define DETECTION_ALARM_BUDGET_MS       11000   // STATE_ALARM_SENDING_TIMEOUT_MS + 错误恢复
+
+/* 会话阶段 */
+typedef enum {
+    DETECTION_PHASE_IDLE = 0,   // 无会话
+    DETECTION_PHASE_WARMUP,     // 滤波器稳定
+    DETECTION_PHASE_COARSE,     // 粗检测窗口
+    DETECTION_PHASE_ANALYSIS,   // FFT + 细检测
+    DETECTION_PHASE_ALARM,      // 报警发送
+    DETECTION_PHASE_COUNT
+} detection_phase_t;
+
+/* 会话结束原因 */
+typedef enum {
+    DETECTION_END_NONE = 0,     // 进行中
+    DETECTION_END_QUIET,        // 粗检测窗口安静
+    DETECTION_END_NORMAL,       // 细检测判定正常 (或细检测超时)
+    DETECTION_END_ALARM,        // 报警流程完成
+    DETECTION_END_BUDGET,       // 阶段预算耗尽
+    DETECTION_END_COUNT
+} detection_end_t;
+
+/* 阶段预算 */
+typedef struct {
+    uint32_t max_samples;       // 0 = 不限
+    uint32_t max_ms;
+} detection_budget_t;
+
+/* 当前 (或最近一次) 会话 */
+typedef struct {
+    bool active;
+    detection_phase_t phase;
+    detection_end_t end_reason;
+    detection_phase_t end_phase;                    // 结束时所在阶段
+    uint32_t start_ms;
+    uint32_t start_samples;
+    uint32_t phase_start_ms;
+    uint32_t phase_start_samples;
+    uint32_t trigger_base;                          // 会话开始时的粗检测触发累计
+    uint32_t phase_ms[DETECTION_PHASE_COUNT];       // 各阶段耗时
+    uint32_t phase_samples[DETECTION_PHASE_COUNT];  // 各阶段处理的样本
+    uint32_t duration_ms;
+} detection_session_t;
+
+/* 会话统计 (上电以来) */
+typedef struct {
+    uint32_t sessions;
+    uint32_t end_count[DETECTION_END_COUNT];
+    uint32_t budget_exceeded[DETECTION_PHASE_COUNT];    // 各阶段预算耗尽次数
+    uint32_t phase_entered[DETECTION_PHASE_COUNT];
+    uint64_t phase_ms_total[DETECTION_PHASE_COUNT];
+    uint64_t total_ms;
+    uint32_t max_ms;
+} detection_session_stats_t;
+
+/**
+ * @brief 开始一个检测会话 (唤醒、传感器就绪后调用)，从WARMUP阶段开始
+ * @return 0: 成功, -1: 上一个会话未结束 (重新开始)
+ */
+int Detection_Session_Begin(void);
+
+/**
+ * @brief 推进会话 (检测循环每轮调用)
+ * @return true: 会话已结束 (可以休眠), false: 继续
+ */
+bool Detection_Session_Process(void);
+
+/**
+ * @brief 当前阶段
+ */
+detection_phase_t Detection_Session_GetPhase(void);
+
+/**
+ * @brief 当前或最近一次会话
+ */
+const detection_session_t* Detection_Session_Get(void);
+
+/**
+ * @brief 会话统计
+ */
+const detection_session_stats_t* Detection_Session_GetStats(void);
+
+/**
+ * @brief 阶段预算 (COARSE的样本预算随rms_window_size变化)
+ */
+detection_budget_t Detection_Session_GetBudget(detection_phase_t phase);
+
+/**
+ * @brief 阶段/结束原因名称
+ */
+const char* Detection_Session_PhaseName(detection_phase_t phase);
+const char* Detection_Session_EndName(detection_end_t reason);
+
+/**
+ * @brief 打印各阶段耗时和结束原因分布
+ */
+void Detection_Session_PrintStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DETECTION_SESSION_H */
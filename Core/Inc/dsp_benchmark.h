@@ -0,0 +1,95 @@
+/**
+ * @file dsp_benchmark.h
+ * @brief 检测流水线DSP内核周期级基准测试头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 对流水线中的每个内核在256~2048点上计时 (DWT周期计数，每项重复取最小值)：
+ *   高通biquad逐样本/块处理、RMS滑动窗口、CFFT/RFFT、幅值/幅值平方、
+ *   频带能量、频谱重心以及完整的细检测特征提取 (仅512点)。
+ *
+ * 表格中的us@84MHz/us@168MHz与能量按同一周期数折算
+ * (忽略168MHz下多出的Flash等待周期，ART加速器命中时影响很小)。
+ * 同一份代码在主机构建 (Host/) 中运行时计数器为纳秒，即"1GHz虚拟内核"，
+ * 只适合比较内核之间的相对开销。
+ */
+
+#ifndef DSP_BENCHMARK_H
+#define DSP_BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 基准测试配置 */
+#define ENABLE_DSP_BENCHMARK            1
+#define DSP_BENCH_MIN_SIZE              256
+#define DSP_BENCH_MAX_SIZE              2048        // 决定静态工作缓冲区大小 (2*MAX个float)
+#define DSP_BENCH_REPEATS               3           // 每项重复次数，报告最小/最大周期
+#define DSP_BENCH_MAX_RESULTS           48
+
+/* 能量估算 (STM32F407数据手册典型值：Flash运行、ART开启、外设时钟关闭) */
+#define DSP_BENCH_SUPPLY_V              3.3f
+#define DSP_BENCH_RUN_MA_84MHZ          21.0f
+#define DSP_BENCH_RUN_MA_168MHZ         40.0f
+
+/* 内核 */
+typedef enum {
+    DSP_BENCH_BIQUAD_SAMPLE = 0,    // 逐样本直接型biquad (Highpass_Filter_Process同款运算)
+    DSP_BENCH_BIQUAD_BLOCK,         // arm_biquad_cascade_df1_f32整块处理
+    DSP_BENCH_RMS_WINDOW,           // 每样本重算整个RMS窗口 (Coarse_Detector_Process现行做法)
+    DSP_BENCH_RMS_RUNNING,          // 滑动累加和，每样本O(1)
+    DSP_BENCH_CFFT,                 // 实数数据按复数输入的arm_cfft_f32 (现行做法)
+    DSP_BENCH_RFFT,                 // arm_rfft_fast_f32
+    DSP_BENCH_MAGNITUDE,            // arm_cmplx_mag_f32
+    DSP_BENCH_MAGNITUDE_SQUARED,    // arm_cmplx_mag_squared_f32
+    DSP_BENCH_BAND_ENERGY,          // 总能量 + 低/中/高三个频带能量
+    DSP_BENCH_CENTROID,             // 频谱重心
+    DSP_BENCH_FINE_DETECTOR,        // Fine_Detector_Extract (257点频谱)
+    DSP_BENCH_KERNEL_COUNT
+} dsp_bench_kernel_t;
+
+/* 单项结果 */
+typedef struct {
+    uint8_t kernel;                 // dsp_bench_kernel_t
+    uint16_t size;                  // 输入点数
+    uint32_t cycles_min;
+    uint32_t cycles_max;
+} dsp_bench_result_t;
+
+#if ENABLE_DSP_BENCHMARK
+
+/**
+ * @brief 运行全部内核和尺寸，结果保存在模块内
+ * @return 结果条数
+ * @note 阻塞执行 (84MHz下约数百毫秒)，期间传感器FIFO可能溢出
+ */
+int DSP_Benchmark_Run(void);
+
+/**
+ * @brief 获取最近一次运行的结果
+ * @param count 输出结果条数 (未运行过为0)
+ */
+const dsp_bench_result_t* DSP_Benchmark_GetResults(uint16_t *count);
+
+/**
+ * @brief 获取内核名
+ */
+const char* DSP_Benchmark_GetKernelName(uint8_t kernel);
+
+/**
+ * @brief 打印最近一次结果表 (周期、84/168MHz耗时和能量估算)
+ * @param counter_hz 周期计数器频率 (目标板为SystemCoreClock，主机构建为1e9)
+ */
+void DSP_Benchmark_PrintTable(uint32_t counter_hz);
+
+#endif /* ENABLE_DSP_BENCHMARK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_BENCHMARK_H */
@@ -0,0 +1,146 @@
+/**
+ * @file dvfs.h
+ * @brief 按系统状态切换内核频率 (DVFS) 头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 三个工作点，按状态机当前状态选择：
+ *   MONITOR   21MHz  (PLL 84MHz / AHB 4)，电压Scale 2，Flash 0WS   STATE_MONITORING / STATE_IDLE_SLEEP / 低功耗休眠
+ *   NOMINAL   84MHz  (PLL 84MHz)，电压Scale 2，Flash 2WS             报警发送、错误处理等其余状态
+ *   ANALYSIS  168MHz (PLL 168MHz)，电压Scale 1，Flash 5WS            STATE_COARSE_TRIGGERED / STATE_FINE_ANALYSIS / STATE_MINING_DETECTED
+ * 升频立即执行，降频需在当前工作点停留至少DVFS_MIN_DWELL_MS，避免状态抖动时反复切换。
+ *
+ * 只改AHB/APB分频时直接切换；PLL分频或调压等级不同时先切到HSI，关PLL后改VOS再重新锁定
+ * (STM32F407的VOS只能在PLL关闭时修改)，约需PLL锁定时间 (~200us)。
+ * 切换后按新的PCLK重算USART1/UART5的BRR和SPI1预分频，保持波特率和SPI时钟不变；
+ * UART/SPI发送或接收进行中时推迟到下一次Dvfs_Process。目标工作点的PCLK实现不了当前波特率
+ * (BRR < 16，例如MONITOR下PCLK2 21MHz时USART1的1.5M/2M波特率) 时拒绝切换；
+ * 上位机修改波特率时按Dvfs_GetMinUartClock校验，使能DVFS时不会请求到这种速率。
+ * STOP期间PLL/总线分频配置保持，唤醒后Clock_Config_RestoreAfterStop恢复到进入STOP前的工作点。
+ *
+ * 检测能耗：每次进入ANALYSIS到离开计为一次检测，累计墙钟时间和运行周期 (运行时间取自
+ * power_account)，按各工作点的运行/睡眠电流换算出同一检测在每个工作点上的能耗。
+ */
+
+#ifndef DVFS_H
+#define DVFS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 配置 */
+#define ENABLE_DVFS                     0       // 使能按状态切换频率 (需在目标板上验证UART/SPI后开启)
+#define DVFS_MIN_DWELL_MS               50      // 降频前在当前工作点的最短停留时间
+#define DVFS_SUPPLY_V                   3.3f    // 能耗换算用的供电电压
+
+/* 各工作点电流 (数据手册典型值，Flash取指、ART开、外设时钟按需，mA) */
+#define DVFS_RUN_MA_21MHZ               7.0f
+#define DVFS_RUN_MA_84MHZ               21.0f   // 与LP_CURRENT_MCU_RUN_MA一致
+#define DVFS_RUN_MA_168MHZ              40.0f
+#define DVFS_SLEEP_MA_21MHZ             3.0f
+#define DVFS_SLEEP_MA_84MHZ             8.0f    // 与LP_CURRENT_MCU_SLEEP_MA一致
+#define DVFS_SLEEP_MA_168MHZ            15.0f
+
+/* 工作点 */
+typedef enum {
+    DVFS_OP_MONITOR = 0,        // 21MHz
+    DVFS_OP_NOMINAL,            // 84MHz (上电默认)
+    DVFS_OP_ANALYSIS,           // 168MHz
+    DVFS_OP_COUNT
+} dvfs_op_t;
+
+/* 工作点配置 */
+typedef struct {
+    const char *name;
+    uint32_t hclk_hz;           // 内核/AHB频率
+    uint32_t pllp;              // PLL P分频 (RCC_PLLP_DIVx)
+    uint32_t ahb_div;           // RCC_SYSCLK_DIVx
+    uint32_t apb1_div;          // RCC_HCLK_DIVx (PCLK1 <= 42MHz)
+    uint32_t apb2_div;          // RCC_HCLK_DIVx (PCLK2 <= 84MHz)
+    uint32_t flash_latency;     // FLASH_LATENCY_x (2.7~3.6V)
+    uint32_t voltage_scale;     // PWR_REGULATOR_VOLTAGE_SCALEx
+    float32_t run_ma;           // 运行电流
+    float32_t sleep_ma;         // WFI电流
+} dvfs_op_config_t;
+
+/* 统计 */
+typedef struct {
+    dvfs_op_t op;                           // 当前工作点
+    uint32_t enter_count[DVFS_OP_COUNT];    // 进入各工作点的次数
+    uint64_t time_us[DVFS_OP_COUNT];        // 各工作点驻留时间 (不含STOP)
+    uint64_t run_us[DVFS_OP_COUNT];         // 其中MCU运行时间
+    uint32_t deferred_count;                // UART/SPI忙推迟的切换
+    uint32_t refused_count;                 // 目标工作点下UART波特率无法实现而拒绝的切换
+    uint32_t switch_errors;                 // 时钟配置失败 (已回退SystemClock_Config)
+    uint32_t last_switch_us;                // 最近一次切换耗时
+    uint32_t max_switch_us;                 // 最大切换耗时 (PLL重新锁定)
+    uint32_t detections;                    // 完成的检测 (ANALYSIS驻留段)
+    uint64_t detection_us;                  // 检测墙钟时间累计
+    uint64_t detection_cycles;              // 检测运行周期累计
+} dvfs_stats_t;
+
+/**
+ * @brief 初始化：记录SPI1目标时钟，切换到NOMINAL工作点 (外设初始化、Power_Account_Init之后调用)
+ * @return 0: 成功, <0: 时钟配置失败
+ */
+int Dvfs_Init(void);
+
+/**
+ * @brief 主循环调用：按状态机当前状态选择工作点并切换
+ */
+void Dvfs_Process(void);
+
+/**
+ * @brief 切换工作点
+ * @return 0: 成功, -1: 未初始化或参数无效, -2: 时钟配置失败 (已回退84MHz), -3: UART/SPI忙，未切换,
+ *         -4: 目标工作点下UART当前波特率无法实现，未切换
+ */
+int Dvfs_SetOperatingPoint(dvfs_op_t op);
+
+/**
+ * @brief 当前工作点
+ */
+dvfs_op_t Dvfs_GetOperatingPoint(void);
+
+/**
+ * @brief 工作点配置
+ */
+const dvfs_op_config_t* Dvfs_GetOpConfig(dvfs_op_t op);
+
+/**
+ * @brief UART在所有工作点中最低的外设时钟 (未使能DVFS时为当前时钟)，用于校验可设置的波特率
+ */
+uint32_t Dvfs_GetMinUartClock(const UART_HandleTypeDef *huart);
+
+/**
+ * @brief SystemClock_Config重新配置时钟后调用 (STOP唤醒快速恢复失败的回退路径)，恢复为NOMINAL并重算外设分频
+ */
+void Dvfs_NotifyClockReset(void);
+
+/**
+ * @brief 获取统计 (先结算当前工作点的驻留时间)
+ */
+const dvfs_stats_t* Dvfs_GetStats(void);
+
+/**
+ * @brief 平均一次检测在指定工作点上的MCU能耗
+ * @return 毫焦，无检测记录或该工作点运行时间超过检测墙钟时间 (跟不上采样) 时返回负值
+ */
+float32_t Dvfs_EstimateDetectionEnergy(dvfs_op_t op);
+
+/**
+ * @brief 打印各工作点驻留时间和每次检测的能耗
+ */
+void Dvfs_PrintStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DVFS_H */
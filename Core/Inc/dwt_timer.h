@@ -0,0 +1,63 @@
+/**
+ * @file dwt_timer.h
+ * @brief DWT周期计数器高精度计时头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * Cortex-M4 DWT->CYCCNT按内核时钟计数，84MHz下分辨率约12ns，
+ * 32位计数约51秒回绕，只用于测量短时间间隔(差值计算自动处理回绕)。
+ * DWT_Timer_GetTimeUs在软件中扩展为64位单调微秒时钟，调用间隔需小于回绕周期。
+ */
+
+#ifndef DWT_TIMER_H
+#define DWT_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+
+/**
+ * @brief 使能DWT周期计数器
+ * @return 0: 成功, -1: 计数器未能启动 (无调试单元)
+ */
+int DWT_Timer_Init(void);
+
+#if defined(HOST_BUILD)
+/**
+ * @brief 读取当前周期计数 (主机构建：Host/hal_shim.c以纳秒计数实现)
+ */
+uint32_t DWT_Timer_GetCycles(void);
+#else
+/**
+ * @brief 读取当前周期计数
+ */
+static inline uint32_t DWT_Timer_GetCycles(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+
+/**
+ * @brief 周期数换算为微秒 (按当前SystemCoreClock)
+ */
+uint32_t DWT_Timer_CyclesToUs(uint32_t cycles);
+
+/**
+ * @brief 自start_cycles以来经过的微秒数
+ */
+uint32_t DWT_Timer_ElapsedUs(uint32_t start_cycles);
+
+/**
+ * @brief 上电以来的单调微秒时间 (中断安全)
+ * @note 两次调用间隔需小于CYCCNT回绕周期，由周期节拍保证
+ */
+uint64_t DWT_Timer_GetTimeUs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DWT_TIMER_H */
@@ -0,0 +1,108 @@
+/**
+ * @file event_loop.h
+ * @brief 事件驱动主循环头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 中断(传感器INT1、UART、RTC、周期节拍)只投递事件，主循环取出事件后分发处理，
+ * 无事件时内核在WFI中休眠，代替原先的HAL_Delay(1)轮询。
+ *
+ * 事件按类型合并为位掩码：同类事件在被处理前重复投递只记一次，
+ * 队列不会溢出；每类事件记录首次投递时的DWT时间戳，用于统计中断到处理的延迟。
+ */
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 主循环配置 */
+#define ENABLE_EVENT_LOOP               1       // 1: WFI等待事件, 0: 旧版HAL_Delay(1)轮询 (对比用)
+#define EVENT_LOOP_TICK_MS              10      // 周期节拍事件间隔 (超时/状态机推进)
+
+/* 事件类型 */
+typedef enum {
+    EVENT_SENSOR_FIFO = 0,          // 传感器INT1 (FIFO水位)
+    EVENT_HOST_RX,                  // UART1 DMA接收事件
+    EVENT_HOST_TX,                  // UART1 DMA发送完成
+    EVENT_LORA_RX,                  // UART5 DMA接收事件
+    EVENT_LORA_TX,                  // UART5 DMA发送完成
+    EVENT_RTC_WAKEUP,               // RTC周期唤醒
+    EVENT_DSP_JOB,                  // 延后的FFT/细检测任务还有待执行阶段
+    EVENT_TICK,                     // 周期节拍
+    EVENT_COUNT
+} event_id_t;
+
+#define EVENT_MASK(id)                  (1UL << (id))
+#define EVENT_MASK_ALL                  ((1UL << EVENT_COUNT) - 1UL)
+
+/* 单类事件统计 */
+typedef struct {
+    uint32_t posted;                // 投递次数 (含合并)
+    uint32_t dispatched;            // 分发次数
+    uint32_t latency_max_us;        // 最大中断到处理延迟
+    uint32_t latency_last_us;       // 最近一次延迟
+    uint64_t latency_sum_us;        // 延迟累计 (求平均)
+} event_stats_t;
+
+/* 主循环统计 */
+typedef struct {
+    uint64_t total_cycles;          // 统计窗口总周期
+    uint64_t idle_cycles;           // WFI中的周期
+    uint32_t wakeups;               // WFI唤醒次数 (含无事件的SysTick唤醒)
+    event_stats_t events[EVENT_COUNT];
+} event_loop_stats_t;
+
+/**
+ * @brief 初始化事件循环 (需在DWT_Timer_Init之后调用)
+ */
+int Event_Loop_Init(void);
+
+/**
+ * @brief 投递事件 (中断或主循环中均可调用)
+ */
+void Event_Post(event_id_t id);
+
+/**
+ * @brief 取出全部待处理事件并统计延迟
+ * @return 事件位掩码 (EVENT_MASK(id))
+ */
+uint32_t Event_Loop_Fetch(void);
+
+/**
+ * @brief 无待处理事件时进入WFI，直到有事件投递
+ */
+void Event_Loop_WaitForEvent(void);
+
+/**
+ * @brief SysTick中断中调用：按EVENT_LOOP_TICK_MS投递节拍事件
+ */
+void Event_Loop_TickHandler(void);
+
+/**
+ * @brief 当前统计窗口的空闲千分比
+ */
+uint16_t Event_Loop_GetIdlePermille(void);
+
+/**
+ * @brief 获取统计
+ */
+const event_loop_stats_t* Event_Loop_GetStats(void);
+
+/**
+ * @brief 打印统计
+ * @param reset 打印后清零统计窗口
+ */
+void Event_Loop_PrintStats(bool reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_LOOP_H */
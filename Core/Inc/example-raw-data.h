@@ -29,6 +29,53 @@
 #define ENABLE_COARSE_DETECTION       1
 #define ENABLE_FINE_DETECTION         1
 #define ENABLE_SYSTEM_STATE_MACHINE   1
+#define ENABLE_DUAL_RATE_SENSOR       1   // 空闲时LP低ODR监测，预触发时切换LN 1kHz
+#define ENABLE_SEQUENTIAL_DECISION    1   // 细检测逐帧累积证据，判定后提前停止FFT采集
+
+/* 传感器FIFO容量 (2KB / 16字节数据包) */
+#define INV_FIFO_CAPACITY_PACKETS     128
+#define INV_FIFO_DEFAULT_WATERMARK    1       // 驱动初始化的水位线：每个包产生一次中断
+
+/* 运动唤醒 (WOM)：LP模式低ODR下比较相邻样本差值，任一轴超过阈值时INT1输出 */
+#define WOM_ACCEL_ODR                 IIM423XX_ACCEL_CONFIG0_ODR_50_HZ
+#define WOM_ACCEL_LP_AVG              IIM423XX_ACCEL_FILT_CONFIG_FILT_AVG_16  // LP平均16次，降低噪声误唤醒
+#define WOM_THRESHOLD_MG_PER_LSB      (1000.0f / 256.0f)  // WOM阈值分辨率 1g/256
+#define WOM_DIFF_PER_RMS              1.4f    // 50Hz相邻样本差 / 1kHz带宽RMS (经验系数)
+#define WOM_THRESHOLD_MIN_LSB         2       // 阈值下限 (7.8mg，LP噪声以上)
+#define WOM_THRESHOLD_MAX_LSB         255
+
+#if ENABLE_DUAL_RATE_SENSOR
+/*
+ * 双速率采集：粗检测空闲时传感器以LP模式DUAL_RATE_MONITOR_HZ监测，RMS超过预触发电平
+ * (监测基线 x 预触发倍数，低于粗检测触发倍数) 时切换到ConfigureInvDevice设定的LN 1kHz；
+ * LN下安静超过DUAL_RATE_ACTIVE_HOLD_MS且检测链空闲后回到LP。
+ * 切换时高通滤波器系数和RMS窗口样本数按当前ODR重新设定 (窗口时长不变)。
+ */
+#define DUAL_RATE_MONITOR_ODR         IIM423XX_ACCEL_CONFIG0_ODR_100_HZ
+#define DUAL_RATE_MONITOR_HZ          100.0f
+#define DUAL_RATE_MONITOR_LP_AVG      IIM423XX_ACCEL_FILT_CONFIG_FILT_AVG_16
+#define DUAL_RATE_PRETRIGGER_RATIO    0.5f    // 预触发倍数 = 1 + (trigger_multiplier - 1) x 该比例
+#define DUAL_RATE_ACTIVE_HOLD_MS      5000    // LN下保持安静多久后回到LP
+#define DUAL_RATE_BASELINE_ALPHA      0.05f   // 监测基线EMA系数 (每个RMS窗口更新一次)
+
+/* 传感器采集速率 */
+typedef enum {
+    SENSOR_RATE_ACTIVE = 0,     // LN 1kHz (ConfigureInvDevice配置)，完整检测链
+    SENSOR_RATE_MONITOR,        // LP低ODR，只计算RMS判断预触发
+} sensor_rate_t;
+
+/* 双速率统计 */
+typedef struct {
+    sensor_rate_t rate;                 // 当前速率
+    float32_t monitor_baseline_rms;     // LP监测下的基线RMS (g)
+    uint32_t to_active_count;           // LP -> LN 切换次数
+    uint32_t to_monitor_count;          // LN -> LP 切换次数
+    uint32_t monitor_time_ms;           // LP累计时间 (不含当前驻留)
+    uint32_t active_time_ms;            // LN累计时间 (不含当前驻留)
+    uint32_t rate_enter_time;           // 进入当前速率的时刻
+    uint32_t switch_errors;             // 传感器重配置失败次数
+} sensor_rate_stats_t;
+#endif
 
 #if ENABLE_DATA_PREPROCESSING
 /* 高通滤波器配置 */
@@ -46,8 +93,8 @@ typedef struct {
 #endif
 
 #if ENABLE_COARSE_DETECTION
-/* 粗检测算法配置 */
-#define RMS_WINDOW_SIZE          200     // RMS滑动窗口大小 (200ms @ 1000Hz)
+/* 粗检测算法配置 (默认值，运行时参数见detection_params.h) */
+#define RMS_WINDOW_SIZE          200     // RMS滑动窗口大小 (200ms @ 1000Hz)，同时也是窗口缓冲区容量
 #define BASELINE_RMS_THRESHOLD   0.001f  // 基线RMS阈值 (降低到1mg用于调试)
 #define TRIGGER_MULTIPLIER       1.5f    // 触发倍数 (降低到1.5x用于调试)
 #define TRIGGER_DURATION_MS      2000    // 触发持续时间 (2000ms)
@@ -75,6 +122,7 @@ typedef struct {
     uint32_t cooldown_start_time;           // 冷却开始时间
 
     uint32_t trigger_count;                 // 触发计数
+    uint16_t correlation_id;                // 本次触发的延迟跟踪关联ID
     bool is_initialized;                    // 初始化标志
 } coarse_detector_t;
 #endif
@@ -125,6 +173,135 @@ int ConfigureInvDevice(uint8_t is_low_noise_mode,
  */
 int GetDataFromInvDevice(void);
 
+/**
+ * \brief Number of FIFO reads that found the FIFO full (samples were lost).
+ */
+uint32_t GetInvDeviceFifoOverflowCount(void);
+
+/**
+ * \brief Worst-case FIFO occupancy seen by GetDataFromInvDevice (packets per read).
+ * Compare against INV_FIFO_CAPACITY_PACKETS to see how close the read path is to overflow.
+ * \param[in] reset  Clear the peak after reading it
+ */
+uint32_t GetInvDeviceFifoPeakPackets(bool reset);
+
+/**
+ * \brief Set the FIFO watermark (INT1 fires while the FIFO holds at least that many packets)
+ *
+ * \param[in] packets  1..InvDevice_GetFifoCapacityPackets()
+ * \param[in] flush    Reset the FIFO after reprogramming so the next interrupt starts a fresh batch
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_SetFifoWatermark(uint16_t packets, bool flush);
+
+/**
+ * \brief Discard everything currently held in the FIFO
+ *
+ * Used after the main loop was blocked for longer than the FIFO can hold, so that the
+ * detection chain restarts from fresh samples instead of reading an overflowed FIFO.
+ *
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_FlushFifo(void);
+
+/**
+ * \brief FIFO capacity in packets for the current packet format (16 or 20 bytes)
+ */
+uint16_t InvDevice_GetFifoCapacityPackets(void);
+
+/**
+ * \brief Convert a trigger RMS level into a wake-on-motion threshold
+ *
+ * \param[in] trigger_rms_g  RMS level (g) that should wake the MCU, normally
+ *                           trigger_multiplier x learned baseline RMS
+ * \return WOM threshold in LSB (1g/256), clamped to WOM_THRESHOLD_MIN_LSB..WOM_THRESHOLD_MAX_LSB
+ */
+uint8_t InvDevice_WomThresholdFromRms(float32_t trigger_rms_g);
+
+/**
+ * \brief Put the accelerometer in low-power wake-on-motion mode
+ *
+ * Switches to LP mode at WOM_ACCEL_ODR, programs the same threshold on all three axes
+ * (OR-ed, compared with the previous sample) and routes WOM to INT1 instead of the
+ * FIFO watermark. FIFO contents accumulated in LP mode are discarded on exit.
+ *
+ * \param[in] threshold_lsb  WOM threshold in LSB (see InvDevice_WomThresholdFromRms)
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_EnterWakeOnMotion(uint8_t threshold_lsb);
+
+/**
+ * \brief Leave wake-on-motion and restore the acquisition configuration
+ *
+ * Re-enables the FIFO watermark interrupt, restores the ODR and power mode last set by
+ * ConfigureInvDevice and flushes the FIFO so the detection chain only sees LN samples.
+ *
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_ExitWakeOnMotion(void);
+
+/**
+ * \brief Read and clear the WOM interrupt status
+ *
+ * \param[out] axis_mask  BIT_INT_STATUS2_WOM_X/Y/Z_INT bits of the axes that fired
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_ReadWomStatus(uint8_t *axis_mask);
+
+/**
+ * \brief Read the number of packets currently held in the FIFO
+ *
+ * Used as a readiness check after wake-up instead of a fixed startup delay.
+ *
+ * \param[out] packets  FIFO_COUNT (record mode, set at driver init)
+ * \return 0 on success, negative value on error.
+ */
+int InvDevice_GetFifoCount(uint16_t *packets);
+
+#if ENABLE_DUAL_RATE_SENSOR
+/**
+ * \brief Switch the sensor between LN 1 kHz acquisition and LP monitoring
+ *
+ * Reconfigures ODR and power mode, flushes the FIFO, loads the high-pass coefficients
+ * for the new ODR and rescales the coarse RMS window so that it keeps the same duration.
+ * Must not be called from the FIFO packet callback.
+ *
+ * \return 0 on success (or already at that rate), negative value on error.
+ */
+int Sensor_Rate_Set(sensor_rate_t rate);
+
+/**
+ * \brief Apply the dual-rate policy (main loop, after the FIFO has been drained)
+ *
+ * LP -> LN when the monitor RMS crossed the pre-trigger level; LN -> LP after
+ * DUAL_RATE_ACTIVE_HOLD_MS without activity while the coarse detector, state machine
+ * and deferred DSP work are idle.
+ */
+void Sensor_Rate_Process(void);
+
+/**
+ * \brief Current acquisition rate
+ */
+sensor_rate_t Sensor_Rate_Get(void);
+
+/**
+ * \brief Sample rate (Hz) of the samples currently fed to the pipeline
+ */
+float32_t Sensor_Rate_GetSampleHz(void);
+
+/**
+ * \brief Dual-rate statistics
+ */
+const sensor_rate_stats_t* Sensor_Rate_GetStats(void);
+#endif
+
+/**
+ * \brief Check that the sensor still answers on the bus (WHO_AM_I)
+ *
+ * \return 0 if the device responds with the expected WHO_AM_I, negative value otherwise.
+ */
+int InvDevice_CheckAlive(void);
+
 /**
  * \brief This function is the custom handling packet function.
  *
@@ -138,6 +315,31 @@ int GetDataFromInvDevice(void);
  */
 void HandleInvDeviceFifoPacket(inv_iim423xx_sensor_event_t * event);
 
+/**
+ * \brief Run one Z-axis sample through the detection chain
+ *
+ * High-pass filter -> coarse detector -> FFT trigger control -> FFT collection.
+ * Called for every decoded FIFO packet; the host build feeds recorded or synthetic
+ * samples through the same path.
+ *
+ * \param[in] accel_z_g Z-axis acceleration in g units (before filtering)
+ */
+void Vibration_Pipeline_ProcessSample(float32_t accel_z_g);
+
+/**
+ * \brief Switch the detection chain to replayed input
+ *
+ * While active, decoded sensor samples are not fed to Vibration_Pipeline_ProcessSample;
+ * the host protocol injects recorded samples instead (HOST_CMD_REPLAY_SAMPLES).
+ */
+void Vibration_Pipeline_SetReplay(bool active);
+bool Vibration_Pipeline_IsReplay(void);
+
+/**
+ * \brief Number of samples run through the detection chain since power-up (wraps)
+ */
+uint32_t Vibration_Pipeline_GetSampleCount(void);
+
 /* 原始加速度数据发送函数已删除 - 调试串口现在专用于调试信息输出 */
 
 #if ENABLE_DATA_PREPROCESSING
@@ -169,6 +371,25 @@ float32_t Highpass_Filter_Process(float32_t input);
  * useful for restarting the filtering process.
  */
 void Highpass_Filter_Reset(void);
+
+/**
+ * \brief Get the biquad coefficients of the high-pass filter
+ *
+ * \return (HIGHPASS_FILTER_ORDER/2) stages of {b0, b1, b2, a1, a2} in CMSIS DF1 order
+ *         for the active sample rate
+ */
+const float32_t* Highpass_Filter_GetCoeffs(void);
+
+/**
+ * \brief Select the coefficient set for a sample rate and keep the filter settled
+ *
+ * The delay line is reloaded with the DC steady state of the last input, so that the
+ * gravity offset does not produce a step transient after the switch.
+ *
+ * \param[in] sample_hz  1000 (SAMPLING_FREQ) or DUAL_RATE_MONITOR_HZ
+ * \return 0 on success, -1 if no coefficient set exists for that rate
+ */
+int Highpass_Filter_SetSampleRate(float32_t sample_hz);
 #endif
 
 #if ENABLE_COARSE_DETECTION
@@ -206,10 +427,42 @@ coarse_detection_state_t Coarse_Detector_GetState(void);
  * This function resets the coarse detection algorithm to initial state.
  */
 void Coarse_Detector_Reset(void);
+
+/**
+ * \brief Add one sample to the RMS sliding window without running the trigger logic
+ *
+ * \param filtered_sample Filtered accelerometer sample (in g units)
+ * \return true when the window is full and current_rms has been updated
+ */
+bool Coarse_Detector_UpdateRms(float32_t filtered_sample);
+
+/**
+ * \brief Rescale the RMS window to a new sample rate (same window duration)
+ *
+ * The window is refilled with the current mean square so the RMS stays continuous
+ * across the switch instead of going blind for one window.
+ *
+ * \param sample_hz New sample rate in Hz
+ */
+void Coarse_Detector_SetSampleRate(float32_t sample_hz);
+
+/**
+ * \brief Override the current baseline RMS (used when the parameter is changed at runtime)
+ *
+ * \param baseline_rms New baseline RMS in g units (must be > 0)
+ */
+void Coarse_Detector_SetBaseline(float32_t baseline_rms);
+
+/**
+ * \brief Get read-only access to the coarse detector state (RMS, baseline, counters)
+ *
+ * \return Pointer to the coarse detector structure
+ */
+const coarse_detector_t* Coarse_Detector_GetInfo(void);
 #endif
 
 #if ENABLE_FINE_DETECTION
-/* 细检测算法配置 */
+/* 细检测算法配置 (默认值，运行时参数见detection_params.h) */
 #define FINE_DETECTION_LOW_FREQ_MIN    5.0f     // 低频段下限 (Hz)
 #define FINE_DETECTION_LOW_FREQ_MAX    15.0f    // 低频段上限 (Hz)
 #define FINE_DETECTION_MID_FREQ_MIN    15.0f    // 中频段下限 (Hz)
@@ -246,6 +499,7 @@ typedef struct {
     // 性能统计
     uint32_t analysis_timestamp;     // 分析时间戳
     uint32_t computation_time_us;    // 计算时间 (微秒)
+    uint16_t correlation_id;         // 延迟跟踪关联ID (来自FFT帧, 0=无)
 
     // 状态标志
     bool is_valid;                   // 结果有效性
@@ -272,12 +526,128 @@ int Fine_Detector_Process(const float32_t* magnitude_spectrum,
                          float32_t dominant_freq,
                          fine_detection_features_t* features);
 
+/**
+ * \brief Extract features and classify without side effects
+ *
+ * Same computation as Fine_Detector_Process, but does not timestamp the result,
+ * notify the state machine or update the last result (benchmarks, offline replay).
+ *
+ * \return 0 on success (features->is_valid false for an all-zero spectrum), -1 on bad arguments
+ */
+int Fine_Detector_Extract(const float32_t* magnitude_spectrum,
+                          uint32_t spectrum_length,
+                          float32_t dominant_freq,
+                          fine_detection_features_t* features);
+
+/**
+ * \brief Sum of squared magnitudes between freq_min and freq_max (inclusive bins)
+ */
+float32_t Fine_Detector_BandEnergy(const float32_t* magnitude_spectrum,
+                                   uint32_t spectrum_length,
+                                   float32_t freq_min,
+                                   float32_t freq_max);
+
+/**
+ * \brief Sum of squared magnitudes excluding the DC bin
+ */
+float32_t Fine_Detector_TotalEnergy(const float32_t* magnitude_spectrum,
+                                    uint32_t spectrum_length);
+
+/**
+ * \brief Power-weighted mean frequency (Hz), excluding the DC bin
+ */
+float32_t Fine_Detector_SpectralCentroid(const float32_t* magnitude_spectrum,
+                                         uint32_t spectrum_length);
+
 /**
  * \brief Print fine detection results
  *
  * \param features: Fine detection features and results
  */
 void Fine_Detector_PrintResults(const fine_detection_features_t* features);
+
+/**
+ * \brief Get the most recent valid fine detection result
+ *
+ * \return Pointer to last result (is_valid is false before the first analysis)
+ */
+const fine_detection_features_t* Fine_Detector_GetLastResult(void);
+
+/**
+ * \brief Get the frame behind the latest result handed to the state machine
+ *
+ * With ENABLE_SEQUENTIAL_DECISION this is the frame that reached the decision,
+ * not the latest frame. Used as the alarm event summary.
+ *
+ * \return Pointer to the deciding frame (is_valid is false before the first result)
+ */
+const fine_detection_features_t* Fine_Detector_GetDecisionResult(void);
+
+#if ENABLE_SEQUENTIAL_DECISION
+/*
+ * 序贯判定 (SPRT)：每次粗检测触发后逐帧累积对数似然比
+ *   LLR += SEQ_DECISION_EVIDENCE_GAIN * (confidence_score - confidence_threshold)
+ * LLR >= ln((1-beta)/alpha) 判定挖掘，LLR <= ln(beta/(1-alpha)) 判定正常，判定后停止本次触发的FFT采集；
+ * 置信度接近阈值时继续采集，最多SEQ_DECISION_MAX_FRAMES个有效帧后按LLR符号强制判定；
+ * 触发后一直没有有效帧 (信号低于能量下限) 时不判定，由细检测超时回到监测，冷却期内的迟到帧仍可判定。
+ * 默认参数下：环境干扰 (置信度<0.6) 和明显的挖掘震动 (>0.8) 1帧判定，
+ * 刚过阈值的挖掘震动 (0.75) 2~3帧判定，0.65~0.75之间才升级到更多帧。
+ */
+#define SEQ_DECISION_ALPHA            0.05f   // 误报率 (正常判为挖掘)
+#define SEQ_DECISION_BETA             0.05f   // 漏报率 (挖掘判为正常)
+#define SEQ_DECISION_EVIDENCE_GAIN    30.0f   // 置信度偏离阈值0.1 = 3 (约一个判定边界)
+#define SEQ_DECISION_MAX_FRAMES       8       // 最多累积的有效帧数 (512点/帧，约4.1s)
+
+/* 序贯判定结果 */
+typedef enum {
+    SEQ_DECISION_PENDING = 0,     // 证据不足，继续采集
+    SEQ_DECISION_NORMAL,          // 判定正常
+    SEQ_DECISION_MINING           // 判定挖掘
+} seq_decision_t;
+
+/* 序贯判定状态与统计 */
+typedef struct {
+    float32_t llr;                // 本次触发累积的对数似然比
+    uint8_t frames;               // 本次触发已用帧数
+    seq_decision_t decision;      // 本次触发的判定 (PENDING = 未判定)
+
+    uint32_t decisions;           // 判定次数
+    uint32_t decided_mining;
+    uint32_t decided_normal;
+    uint32_t forced;              // 达到最大帧数强制判定的次数
+    uint32_t total_frames;        // 判定所用帧数累计
+    uint32_t ignored_frames;      // 判定后仍到达的帧 (延后FFT任务中的最后一帧)
+} sequential_decision_t;
+
+/**
+ * \brief Start a new decision (called on every coarse trigger)
+ */
+void Sequential_Decision_Reset(void);
+
+/**
+ * \brief Add one frame of evidence
+ *
+ * \param confidence Fine detector confidence score of a valid frame (0-1)
+ * \return SEQ_DECISION_MINING/NORMAL on the frame that reaches the decision,
+ *         SEQ_DECISION_PENDING otherwise (including frames after the decision)
+ */
+seq_decision_t Sequential_Decision_Update(float32_t confidence);
+
+/**
+ * \brief True once the current trigger has been decided (FFT collection stops)
+ */
+bool Sequential_Decision_IsDecided(void);
+
+/**
+ * \brief Get read-only access to the decision state and statistics
+ */
+const sequential_decision_t* Sequential_Decision_GetInfo(void);
+
+/**
+ * \brief Print decision counters and average frames per decision
+ */
+void Sequential_Decision_PrintStats(void);
+#endif
 #endif
 
 #if ENABLE_SYSTEM_STATE_MACHINE
@@ -305,6 +675,31 @@ typedef enum {
     STATE_COUNT                      // 状态总数
 } system_state_t;
 
+/*
+ * 状态机事件 (由转换条件标志和超时在每次Process时合成)
+ * 枚举顺序即优先级：同时满足多个事件时取编号最小者
+ */
+typedef enum {
+    SM_EVENT_COARSE_TRIGGER = 0,     // 粗检测触发
+    SM_EVENT_FINE_MINING,            // 细检测判定挖掘
+    SM_EVENT_FINE_NORMAL,            // 细检测判定正常
+    SM_EVENT_ALARM_OK,               // 报警发送成功
+    SM_EVENT_ALARM_FAIL,             // 报警发送失败
+    SM_EVENT_TIMEOUT,                // 状态超时 (转换表中的timeout_ms)
+    SM_EVENT_ALWAYS,                 // 无条件 (每次Process都成立)
+    SM_EVENT_FAULT,                  // 非法状态恢复 (仅用于跟踪记录)
+    SM_EVENT_COUNT
+} system_event_t;
+
+/* 状态转换跟踪记录 */
+typedef struct {
+    uint64_t timestamp_us;           // 转换时刻 (DWT单调微秒时钟)
+    uint32_t dwell_ms;               // 在源状态的驻留时间
+    uint8_t from_state;              // 源状态
+    uint8_t to_state;                // 目标状态
+    uint8_t event;                   // 触发事件 (system_event_t)
+} state_trace_entry_t;
+
 /* 状态机结构体 */
 typedef struct {
     system_state_t current_state;    // 当前状态
@@ -320,12 +715,15 @@ typedef struct {
 
     // 状态统计
     uint32_t state_count[STATE_COUNT];  // 各状态计数
+    uint32_t state_time_ms[STATE_COUNT];// 各状态累计驻留时间 (不含当前状态本次驻留)
     uint32_t transition_count;       // 状态转换计数
 
     // 检测统计
     uint32_t total_detections;       // 总检测次数
     uint32_t mining_detections;      // 挖掘检测次数
     uint32_t false_alarms;           // 误报次数
+
+    uint16_t correlation_id;         // 当前报警的延迟跟踪关联ID
 } system_state_machine_t;
 
 /* 状态机配置参数 */
@@ -333,6 +731,8 @@ typedef struct {
 #define STATE_FINE_ANALYSIS_TIMEOUT_MS  5000    // 细检测分析超时 (5秒)
 #define STATE_ALARM_SENDING_TIMEOUT_MS  10000   // 报警发送超时 (10秒)
 #define STATE_ERROR_RECOVERY_DELAY_MS   1000    // 错误恢复延迟 (1秒)
+#define STATE_TRACE_DEPTH               32      // 转换跟踪环形缓冲区深度
+#define STATE_TRANSITION_LOG            0       // 1: 每次转换printf输出 (详细日志)
 
 /* 函数声明 */
 int System_State_Machine_Init(void);
@@ -342,8 +742,26 @@ void System_State_Machine_SetFineResult(uint8_t result);
 void System_State_Machine_SetAlarmStatus(uint8_t status);
 void System_State_Machine_SetError(uint8_t error_code);
 system_state_t System_State_Machine_GetCurrentState(void);
+const system_state_machine_t* System_State_Machine_GetInfo(void);
 void System_State_Machine_PrintStatus(void);
 
+/**
+ * @brief 跟踪缓冲区中的记录数 (<= STATE_TRACE_DEPTH)
+ */
+uint8_t System_State_Machine_GetTraceCount(void);
+
+/**
+ * @brief 读取一条转换跟踪记录
+ * @param index: 0为最早的一条
+ * @return 记录指针, index越界时返回NULL
+ */
+const state_trace_entry_t* System_State_Machine_GetTrace(uint8_t index);
+
+/**
+ * @brief 打印转换跟踪 (最早的在前)
+ */
+void System_State_Machine_PrintTrace(void);
+
 #endif
 
 #endif /* !_EXAMPLE_RAW_AG_H_ */
@@ -21,6 +21,10 @@
 #include "arm_math.h"
 #include "arm_const_structs.h"
 
+/* Deferred processing: when enabled, a full buffer is handed off to FFT_Worker_Run()
+ * in the main loop instead of running FFT/fine detection inside the sensor callback */
+#define ENABLE_FFT_DEFERRED     1
+
 /* FFT Configuration Parameters */
 #define FFT_SIZE                512     // FFT length (must be power of 2)
 #define FFT_BUFFER_SIZE         FFT_SIZE
@@ -47,11 +51,30 @@ typedef struct {
     float32_t magnitude_spectrum[FFT_OUTPUT_POINTS]; // Magnitude spectrum - 257 points
     uint32_t sample_count;           // Number of samples processed
     uint32_t timestamp;              // Processing timestamp
+    uint16_t correlation_id;         // Latency tracker ID of the coarse trigger this frame belongs to
 } fft_result_t;
 
+/* Deferred worker job stages (one stage per FFT_Worker_Run call) */
+typedef enum {
+    FFT_JOB_IDLE = 0,
+    FFT_JOB_TRANSFORM,              // window + CFFT + magnitude + peak search
+    FFT_JOB_CLASSIFY,               // fine detection
+    FFT_JOB_REPORT                  // debug output and host streaming
+} fft_job_stage_t;
+
+/* Deferred worker statistics */
+typedef struct {
+    uint32_t frames_submitted;      // Frames handed off by FFT_AddSample
+    uint32_t frames_dropped;        // Frames discarded because the worker was still busy
+    uint32_t transform_max_us;      // Worst-case stage run times
+    uint32_t classify_max_us;
+    uint32_t report_max_us;
+} fft_worker_stats_t;
+
 /* FFT Processor Structure */
 typedef struct {
-    float32_t time_buffer[FFT_BUFFER_SIZE];     // Time domain circular buffer
+    float32_t time_buffer[FFT_BUFFER_SIZE];     // Time domain circular buffer (acquisition side)
+    float32_t frame_buffer[FFT_SIZE];           // Ordered frame owned by the worker (processing side)
     float32_t fft_input[FFT_SIZE * 2];          // FFT input buffer (complex: real, imag, real, imag...)
     float32_t fft_output[FFT_SIZE];             // FFT magnitude output
 
@@ -65,6 +88,11 @@ typedef struct {
     bool is_triggered;                          // Current trigger state
 
     fft_result_t last_result;                   // Last FFT computation result
+    uint32_t frame_count;                       // Completed FFT frames since init
+
+    fft_job_stage_t job_stage;                  // Deferred worker stage
+    uint16_t job_correlation_id;                // Latency tracker ID captured when the frame was handed off
+    fft_worker_stats_t worker_stats;            // Deferred worker statistics
 } fft_processor_t;
 
 /* Public Function Declarations */
@@ -96,6 +124,35 @@ bool FFT_IsReady(void);
  */
 int FFT_Process(void);
 
+/**
+ * @brief Latency tracker correlation ID of the most recently transformed frame
+ * @return ID, 0 if the frame was not collected under a coarse trigger
+ */
+uint16_t FFT_GetFrameCorrelationId(void);
+
+/**
+ * @brief Check whether a handed-off frame is waiting for the deferred worker
+ * @return true if FFT_Worker_Run() has work to do
+ */
+bool FFT_Worker_Pending(void);
+
+/**
+ * @brief Run one stage of the deferred FFT job (call from the main loop)
+ * @return 1 if more stages remain, 0 if idle
+ */
+int FFT_Worker_Run(void);
+
+/**
+ * @brief Get deferred worker statistics
+ */
+const fft_worker_stats_t* FFT_Worker_GetStats(void);
+
+/**
+ * @brief Print deferred worker statistics
+ * @param reset: Clear the worst-case timings after printing
+ */
+void FFT_Worker_PrintStats(bool reset);
+
 /**
  * @brief Get the last FFT computation results
  * @return Pointer to fft_result_t structure
@@ -108,6 +165,12 @@ const fft_result_t* FFT_GetResults(void);
  */
 fft_state_t FFT_GetState(void);
 
+/**
+ * @brief Get number of completed FFT frames since init
+ * @return Frame count
+ */
+uint32_t FFT_GetFrameCount(void);
+
 /**
  * @brief Reset the FFT processor
  */
@@ -20,7 +20,7 @@ void FFT_RunBasicTest(void);
 
 /**
  * @brief Run FFT performance test
- * Measures FFT processing time
+ * Runs the DSP benchmark suite (all pipeline kernels, 256-2048 points) and prints the table
  */
 void FFT_RunPerformanceTest(void);
 
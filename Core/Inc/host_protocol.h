@@ -0,0 +1,230 @@
+/**
+ * @file host_protocol.h
+ * @brief 上位机串口(UART1)帧命令协议头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * UART1接收使用DMA循环缓冲 + 空闲线检测，主循环中解析帧。
+ *
+ * 帧格式 (小端):
+ *   AA 55 | CMD(1) | LEN(2) | PAYLOAD(LEN) | CRC16(2)
+ *   CRC16为Modbus CRC (多项式0xA001, 初值0xFFFF)，覆盖 CMD+LEN+PAYLOAD
+ *
+ * 应答帧: CMD = 请求CMD | 0x80, PAYLOAD[0] = 状态码(host_status_t)
+ * 主动上报帧(流数据)使用独立的CMD，不带状态码
+ *
+ * 波特率协商: 上位机在115200下发SET_BAUD，收到应答后双方切换速率，
+ * 上位机须在HOST_LINK_CONFIRM_TIMEOUT_MS内以新速率发送任一有效帧(如PING)确认，
+ * 否则固件回退到原速率；高速下短时间内UART错误过多也会自动回退到默认速率。
+ */
+
+#ifndef HOST_PROTOCOL_H
+#define HOST_PROTOCOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 协议配置 */
+#define ENABLE_HOST_PROTOCOL            1       // 使能帧命令协议
+#define HOST_PROTOCOL_LEGACY_COMMANDS   1       // 兼容旧版单字节命令(0x10/0x11/0x02/0x04，仅空闲线分隔的单字节)
+#define HOST_PROTOCOL_RX_DMA_SIZE       256     // DMA循环接收缓冲区大小
+#define HOST_PROTOCOL_MAX_PAYLOAD       128     // 接收帧最大载荷
+#define HOST_PROTOCOL_FRAME_TIMEOUT_MS  100     // 帧内字节间隔超时
+#define HOST_PROTOCOL_TX_TIMEOUT_MS     100     // 单次发送超时
+
+/* 链路速率配置 (USART1挂在APB2=84MHz，16倍过采样上限5.25Mbaud) */
+#define HOST_LINK_DEFAULT_BAUD          115200  // 上电及回退速率
+#define HOST_LINK_MIN_BAUD              9600
+#define HOST_LINK_MAX_BAUD              2000000
+#define HOST_LINK_MAX_BAUD_ERROR_PPM    20000   // 实际波特率允许偏差 (2%)
+#define HOST_LINK_CONFIRM_TIMEOUT_MS    1000    // 切换后等待确认帧的时间
+#define HOST_LINK_ERROR_WINDOW_MS       1000    // 错误统计窗口
+#define HOST_LINK_ERROR_FALLBACK_COUNT  8       // 窗口内错误数达到此值回退默认速率
+#define HOST_LINK_TEST_CHUNK_MAX        512     // 吞吐测试单帧最大数据长度
+
+/* 样本回放注入 (上位机经UART把记录的Z轴样本送入检测链，传感器样本在回放期间不进入检测链) */
+#define ENABLE_HOST_REPLAY              1
+#define HOST_REPLAY_LSB_PER_G           8192.0f // 样本编码: int16，与FIFO解码同一量程
+#define HOST_REPLAY_MAX_SAMPLES         (HOST_PROTOCOL_MAX_PAYLOAD / 2)
+
+#define HOST_FRAME_HEADER_0             0xAA
+#define HOST_FRAME_HEADER_1             0x55
+#define HOST_FRAME_RESPONSE_FLAG        0x80
+
+/* 命令码 */
+typedef enum {
+    /* 报警/系统控制 (与旧版单字节命令编号一致) */
+    HOST_CMD_TRIGGER_ALARM          = 0x10,
+    HOST_CMD_GET_STATUS             = 0x11,
+    HOST_CMD_LOW_POWER_STATS        = 0x20,
+    HOST_CMD_SET_MODE_CONTINUOUS    = 0x21,
+    HOST_CMD_SET_MODE_LOW_POWER     = 0x22,
+
+    /* 参数读写 */
+    HOST_CMD_GET_PARAM              = 0x30,     // 载荷: id(1)
+    HOST_CMD_SET_PARAM              = 0x31,     // 载荷: id(1) + value(float32)
+    HOST_CMD_GET_ALL_PARAMS         = 0x32,
+    HOST_CMD_RESET_PARAMS           = 0x33,
+
+    /* 统计查询 */
+    HOST_CMD_GET_STATS              = 0x40,
+    HOST_CMD_GET_TELEMETRY          = 0x41,     // 应答: 状态 + 当前窗口遥测载荷
+    HOST_CMD_GET_LOOP_STATS         = 0x42,     // 应答: 状态 + 主循环空闲率和各事件延迟
+    HOST_CMD_GET_STATE_TRACE        = 0x43,     // 应答: 状态 + 状态机转换跟踪 (最早的在前)
+    HOST_CMD_GET_PROFILE            = 0x44,     // 载荷: [reset(1)]，应答: 状态 + 分阶段耗时统计
+    HOST_CMD_GET_LATENCY            = 0x45,     // 应答: 状态 + 端到端检测延迟记录 (最坏情况 + 历史)
+    HOST_CMD_GET_SYSMON             = 0x46,     // 应答: 状态 + CPU负载、栈高水位和各状态负载
+    HOST_CMD_RUN_DSP_BENCH          = 0x47,     // 暂停采集运行DSP基准测试 (仅监测状态)，应答: 状态 + 暂停时长 + 各内核周期数
+    HOST_CMD_REPLAY_CONTROL         = 0x48,     // 载荷: start(1)，应答: 状态 + 本次回放计数
+    HOST_CMD_REPLAY_SAMPLES         = 0x49,     // 载荷: n*int16样本，应答: 状态 + 接收数(1)
+
+    /* 链路控制 */
+    HOST_CMD_SET_BAUD               = 0x60,     // 载荷: baud(4)，应答: 状态 + 实际baud(4)
+    HOST_CMD_PING                   = 0x61,     // 载荷任意，应答: 状态 + 原样回显 (回环误码测试)
+    HOST_CMD_LINK_TEST              = 0x62,     // 载荷: total_bytes(4) + chunk(2)
+    HOST_CMD_LINK_TEST_DATA         = 0x63,     // 上报: seq(4) + 测试图样
+    HOST_CMD_LINK_TEST_RESULT       = 0x64,     // 上报: 吞吐测试结果
+
+    /* 流控制 */
+    HOST_CMD_STREAM_CONTROL         = 0x50,     // 载荷: mask(1)
+    HOST_CMD_STREAM_SPECTRUM        = 0x51,     // 上报: 频谱
+    HOST_CMD_STREAM_DETECTION       = 0x52,     // 上报: 细检测结果
+    HOST_CMD_STREAM_TELEMETRY       = 0x53,     // 上报: 周期遥测 (格式见telemetry.h)
+} host_command_t;
+
+/* 应答状态码 */
+typedef enum {
+    HOST_STATUS_OK                  = 0x00,
+    HOST_STATUS_UNKNOWN_CMD         = 0x01,
+    HOST_STATUS_BAD_LENGTH          = 0x02,
+    HOST_STATUS_UNKNOWN_PARAM       = 0x03,
+    HOST_STATUS_OUT_OF_RANGE        = 0x04,
+    HOST_STATUS_BUSY                = 0x05,
+} host_status_t;
+
+/* 流数据掩码 */
+#define HOST_STREAM_SPECTRUM            (1U << 0)   // 每次FFT输出257点频谱
+#define HOST_STREAM_DETECTION           (1U << 1)   // 每次细检测输出特征和分类结果
+#define HOST_STREAM_TELEMETRY           (1U << 2)   // 周期遥测
+#define HOST_STREAM_ALL                 (HOST_STREAM_SPECTRUM | HOST_STREAM_DETECTION | HOST_STREAM_TELEMETRY)
+#define HOST_STREAM_DEFAULT             HOST_STREAM_TELEMETRY
+
+/* 链路统计 */
+typedef struct {
+    uint32_t rx_bytes;              // 接收字节数
+    uint32_t rx_frames;             // 有效帧数
+    uint32_t crc_errors;            // CRC错误帧数
+    uint32_t length_errors;         // 长度超限帧数
+    uint32_t timeouts;              // 帧内超时次数
+    uint32_t uart_errors;           // UART硬件错误(ORE/FE/NE)次数
+    uint32_t tx_frames;             // 发送帧数
+    uint32_t baud_rate;             // 当前波特率
+    uint32_t baud_fallbacks;        // 速率回退次数
+} host_link_stats_t;
+
+/**
+ * @brief 初始化命令协议并启动UART1 DMA循环接收
+ * @param huart UART句柄 (UART1)
+ * @return 0: 成功, <0: 失败
+ */
+int Host_Protocol_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 主循环中调用：解析DMA缓冲区中的新数据并执行命令
+ */
+void Host_Protocol_Process(void);
+
+/**
+ * @brief 是否有未处理的接收数据
+ * @return true: 有新数据
+ */
+bool Host_Protocol_HasPendingData(void);
+
+/**
+ * @brief 接收线路是否空闲 (最近一次空闲线事件后没有新字节；移位寄存器中未收完的字节无法检测)
+ * @return true: 空闲，可以修改波特率分频
+ */
+bool Host_Protocol_IsRxIdle(void);
+
+/**
+ * @brief 发送一帧数据 (阻塞发送，与printf共用UART1)
+ * @param cmd 命令码
+ * @param payload 载荷 (可为NULL)
+ * @param length 载荷长度
+ * @return 0: 成功, <0: 失败
+ */
+int Host_Protocol_SendFrame(uint8_t cmd, const uint8_t *payload, uint16_t length);
+
+/**
+ * @brief 上报频谱数据 (仅在HOST_STREAM_SPECTRUM使能时发送)
+ * @param timestamp_ms 时间戳
+ * @param dominant_freq 主频
+ * @param spectrum 幅值谱
+ * @param points 点数
+ */
+void Host_Protocol_StreamSpectrum(uint32_t timestamp_ms, float32_t dominant_freq,
+                                  const float32_t *spectrum, uint16_t points);
+
+#if ENABLE_FINE_DETECTION
+/**
+ * @brief 上报细检测结果 (仅在HOST_STREAM_DETECTION使能时发送)
+ * @param features 细检测特征
+ */
+void Host_Protocol_StreamDetection(const fine_detection_features_t *features);
+#endif
+
+/**
+ * @brief 上报遥测载荷 (仅在HOST_STREAM_TELEMETRY使能时发送)
+ * @param payload 遥测载荷
+ * @param length 载荷长度
+ */
+void Host_Protocol_StreamTelemetry(const uint8_t *payload, uint16_t length);
+
+/**
+ * @brief 获取当前流数据掩码
+ */
+uint8_t Host_Protocol_GetStreamMask(void);
+
+/**
+ * @brief 获取链路统计
+ */
+const host_link_stats_t* Host_Protocol_GetStats(void);
+
+/**
+ * @brief HAL_UARTEx_RxEventCallback中调用 (DMA半满/满/空闲线事件)
+ * @param huart UART句柄
+ * @param pos DMA缓冲区当前写位置
+ */
+void Host_Protocol_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos);
+
+/**
+ * @brief HAL_UART_TxCpltCallback中调用 (吞吐测试DMA发送完成)
+ * @param huart UART句柄
+ */
+void Host_Protocol_TxCpltCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief HAL_UART_ErrorCallback中调用：记录错误并重启DMA接收
+ * @param huart UART句柄
+ */
+void Host_Protocol_ErrorCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief STOP唤醒后恢复接收
+ *
+ * STOP期间UART和DMA寄存器保持，时钟恢复后DMA接收继续；
+ * 仅在接收已被终止 (错误回调失败等) 时复位解析器并重新启动DMA接收。
+ */
+void Host_Protocol_ResumeAfterStop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PROTOCOL_H */
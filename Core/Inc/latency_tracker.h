@@ -0,0 +1,141 @@
+/**
+ * @file latency_tracker.h
+ * @brief 端到端检测延迟跟踪头文件 (粗检测触发 -> 报警帧离开UART5)
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 粗检测触发时分配关联ID，ID随FFT帧、细检测结果、状态机和LoRa队列项传递，
+ * 各环节用同一ID打点。报警帧DMA发送完成时记录结束，分段延迟存入环形缓冲区，
+ * 并单独保留总延迟最大的一条 (合同考核指标为最坏情况延迟)。
+ *
+ * 时间基准为DWT_Timer_GetTimeUs (单调微秒时钟)；起点为使peak_factor超过
+ * 触发倍数的样本被粗检测处理的时刻，不含该样本在传感器FIFO中的停留时间。
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 跟踪配置 */
+#define ENABLE_LATENCY_TRACKER          1
+#define LATENCY_INFLIGHT_SLOTS          4       // 同时跟踪的未完成事件数 (满时覆盖最早的)
+#define LATENCY_HISTORY_DEPTH           8       // 已完成报警记录环形缓冲区深度
+#define LATENCY_MARK_NONE               0xFFFFFFFFU
+
+/* 打点 (按流水线顺序；某点已记录后，更早的点不再更新) */
+typedef enum {
+    LAT_MARK_COARSE_TRIGGER = 0,    // 粗检测触发 (起点)
+    LAT_MARK_FFT_FRAME,             // FFT帧计算完成
+    LAT_MARK_FINE_RESULT,           // 细检测分类完成
+    LAT_MARK_MINING_DETECTED,       // 状态机进入MINING_DETECTED
+    LAT_MARK_ALARM_SENDING,         // 状态机进入ALARM_SENDING (报警已入队)
+    LAT_MARK_LORA_TX_START,         // Modbus帧启动DMA发送
+    LAT_MARK_LORA_TX_DONE,          // 帧最后一个字节离开UART5 (终点)
+    LAT_MARK_COUNT
+} latency_mark_t;
+
+/* 一条延迟记录 */
+typedef struct {
+    uint16_t correlation_id;
+    uint64_t start_us;                          // 起点时刻
+    uint32_t delta_us[LAT_MARK_COUNT];          // 各打点相对起点的延迟, LATENCY_MARK_NONE表示未经过
+} latency_record_t;
+
+/* 跟踪统计 */
+typedef struct {
+    uint32_t started;               // 分配的ID数 (粗检测触发次数)
+    uint32_t completed;             // 完成的报警数
+    uint32_t abandoned;             // 未形成报警而被覆盖的ID数 (正常振动等)
+} latency_tracker_stats_t;
+
+#if ENABLE_LATENCY_TRACKER
+
+/**
+ * @brief 初始化 (需在DWT_Timer_Init之后调用)
+ */
+int Latency_Tracker_Init(void);
+
+/**
+ * @brief 开始跟踪新事件并设为当前活动ID (粗检测触发时调用)
+ * @return 关联ID (非0)
+ */
+uint16_t Latency_Tracker_Begin(void);
+
+/**
+ * @brief 当前活动ID (新采集的FFT帧归属于该ID)
+ * @return 关联ID, 0表示无活动事件
+ */
+uint16_t Latency_Tracker_GetActiveId(void);
+
+/**
+ * @brief 结束活动期 (粗检测回到空闲)，已开始的记录仍可继续打点
+ */
+void Latency_Tracker_EndActive(void);
+
+/**
+ * @brief 以当前时刻打点
+ * @param id 关联ID (0或已失效的ID被忽略)
+ */
+void Latency_Tracker_Mark(uint16_t id, latency_mark_t mark);
+
+/**
+ * @brief 以指定时刻打点 (时刻在别处采集，如中断中)
+ */
+void Latency_Tracker_MarkAt(uint16_t id, latency_mark_t mark, uint64_t time_us);
+
+/**
+ * @brief 完成记录：移入历史环形缓冲区并更新最坏情况
+ */
+void Latency_Tracker_Complete(uint16_t id);
+
+/**
+ * @brief 历史记录数 (<= LATENCY_HISTORY_DEPTH)
+ */
+uint8_t Latency_Tracker_GetHistoryCount(void);
+
+/**
+ * @brief 读取历史记录
+ * @param index 0为最早的一条
+ * @return 记录指针, 越界返回NULL
+ */
+const latency_record_t* Latency_Tracker_GetHistory(uint8_t index);
+
+/**
+ * @brief 总延迟最大的记录
+ * @return 记录指针, 尚无完成记录时返回NULL
+ */
+const latency_record_t* Latency_Tracker_GetWorst(void);
+
+/**
+ * @brief 获取统计
+ */
+const latency_tracker_stats_t* Latency_Tracker_GetStats(void);
+
+/**
+ * @brief 打印历史记录和最坏情况
+ */
+void Latency_Tracker_Print(void);
+
+#else
+
+#define Latency_Tracker_Begin()             (0U)
+#define Latency_Tracker_GetActiveId()       (0U)
+#define Latency_Tracker_EndActive()         ((void)0)
+#define Latency_Tracker_Mark(id, mark)      ((void)0)
+#define Latency_Tracker_MarkAt(id, mark, t) ((void)0)
+#define Latency_Tracker_Complete(id)        ((void)0)
+
+#endif /* ENABLE_LATENCY_TRACKER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCY_TRACKER_H */
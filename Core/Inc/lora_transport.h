@@ -0,0 +1,178 @@
+/**
+ * @file lora_transport.h
+ * @brief LoRa报警异步传输层头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 报警事件进入队列后由主循环非阻塞发送：
+ *   PE14上电 -> 等待模块启动 -> DMA发送 -> 等待应答 -> (超时重发) -> 断电
+ * 每次上电将一个完整事件摘要打包进一条Modbus写多寄存器帧，
+ * 队列中有多个事件时在同一次上电期间依次发出。
+ * 队列项为已编码的寄存器块，遥测等非报警数据也可通过PostRegisters复用同一链路。
+ */
+
+#ifndef LORA_TRANSPORT_H
+#define LORA_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 传输配置 */
+#define LORA_EVENT_QUEUE_SIZE           4       // 事件队列深度
+#define LORA_POWER_ON_DELAY_MS          500     // 模块上电启动时间
+#define LORA_RESPONSE_TIMEOUT_MS        2000    // 单次应答超时
+#define LORA_MAX_RETRIES                3       // 最大重发次数
+#define LORA_RETRY_BACKOFF_MS           200     // 重发退避基数 (第n次重发等待n*基数)
+
+/* Modbus帧配置 */
+#define LORA_MODBUS_SLAVE_ADDR          0x01    // 远端设备地址
+#define LORA_MODBUS_FUNC_WRITE_MULTI    0x46    // 写多寄存器功能码 (LoRa网关自定义)
+#define LORA_MODBUS_START_REG           0x0000  // 事件寄存器起始地址
+#define LORA_EVENT_REG_COUNT            10      // 事件摘要寄存器数
+#define LORA_MAX_REG_COUNT              16      // 单帧最大寄存器数
+
+/*
+ * 事件寄存器布局 (每个寄存器16位，大端):
+ *   R0  报警标志 (1=挖掘报警, 2=手动触发)
+ *   R1  事件序号
+ *   R2  时间戳高16位 (ms)
+ *   R3  时间戳低16位 (ms)
+ *   R4  置信度 x1000
+ *   R5  主频 x10 (Hz)
+ *   R6  低频能量占比 x1000
+ *   R7  中频能量占比 x1000
+ *   R8  高频能量占比 x1000
+ *   R9  频谱重心 x10 (Hz)
+ */
+
+/* 报警来源 */
+typedef enum {
+    LORA_EVENT_MINING = 1,      // 细检测判定为挖掘
+    LORA_EVENT_MANUAL = 2,      // 上位机手动触发
+} lora_event_type_t;
+
+/* 报警事件摘要 */
+typedef struct {
+    lora_event_type_t type;
+    uint16_t sequence;
+    uint32_t timestamp_ms;
+    float32_t confidence;
+    float32_t dominant_freq;
+    float32_t low_freq_ratio;
+    float32_t mid_freq_ratio;
+    float32_t high_freq_ratio;
+    float32_t spectral_centroid;
+    uint16_t correlation_id;        // 延迟跟踪关联ID (0=不跟踪)
+} lora_event_t;
+
+/* 传输状态 */
+typedef enum {
+    LORA_TRANSPORT_IDLE = 0,        // 空闲，模块断电
+    LORA_TRANSPORT_POWERING_ON,     // 已上电，等待模块启动
+    LORA_TRANSPORT_SENDING,         // DMA发送中
+    LORA_TRANSPORT_WAIT_RESPONSE,   // 等待应答
+    LORA_TRANSPORT_BACKOFF,         // 重发退避
+} lora_transport_state_t;
+
+/* 传输统计 */
+typedef struct {
+    uint32_t events_posted;         // 入队事件数
+    uint32_t events_dropped;        // 队列满丢弃数
+    uint32_t events_sent;           // 收到应答的事件数
+    uint32_t events_failed;         // 重发耗尽的事件数
+    uint32_t frames_sent;           // 发送帧数 (含重发)
+    uint32_t retries;               // 重发次数
+    uint32_t power_cycles;          // 模块上电次数
+} lora_transport_stats_t;
+
+/**
+ * @brief 初始化LoRa传输层并启动UART5接收
+ * @param huart UART句柄 (UART5)
+ * @return 0: 成功, <0: 失败
+ */
+int LoRa_Transport_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 事件入队
+ * @param event 事件摘要 (sequence由传输层分配)
+ * @return 0: 成功, -1: 参数错误, -2: 队列满
+ */
+int LoRa_Transport_PostEvent(const lora_event_t *event);
+
+/**
+ * @brief 任意寄存器块入队 (如遥测摘要)，与报警事件共用队列和重发策略
+ * @param start_reg 起始寄存器
+ * @param regs 寄存器值
+ * @param count 寄存器数 (<= LORA_MAX_REG_COUNT)
+ * @return 0: 成功, -1: 参数错误, -2: 队列满
+ */
+int LoRa_Transport_PostRegisters(uint16_t start_reg, const uint16_t *regs, uint8_t count);
+
+#if ENABLE_FINE_DETECTION
+/**
+ * @brief 由判定为挖掘的细检测结果生成挖掘报警事件并入队
+ * @param features 产生挖掘判定的帧 (NULL或无效时只上报事件类型和时间，不跟踪延迟)
+ * @return 0: 成功, <0: 失败
+ */
+int LoRa_Transport_PostDetection(const fine_detection_features_t *features);
+#endif
+
+/**
+ * @brief 主循环中调用：推进传输状态机，不阻塞
+ */
+void LoRa_Transport_Process(void);
+
+/**
+ * @brief 是否有事件正在发送或排队
+ */
+bool LoRa_Transport_IsBusy(void);
+
+/**
+ * @brief 获取当前传输状态
+ */
+lora_transport_state_t LoRa_Transport_GetState(void);
+
+/**
+ * @brief 获取传输统计
+ */
+const lora_transport_stats_t* LoRa_Transport_GetStats(void);
+
+/**
+ * @brief 打印传输统计
+ */
+void LoRa_Transport_PrintStats(void);
+
+/**
+ * @brief HAL_UART_TxCpltCallback中调用
+ */
+void LoRa_Transport_TxCpltCallback(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 上位机手动触发一次报警 (LORA_EVENT_MANUAL，不带检测特征，不跟踪延迟)
+ */
+void Trigger_Alarm_Cycle(void);
+
+#if ENABLE_FINE_DETECTION
+/**
+ * @brief 状态机挖掘判定后触发报警 (LORA_EVENT_MINING)
+ * @param features 产生挖掘判定的帧
+ */
+void Trigger_Alarm_Detection(const fine_detection_features_t *features);
+#else
+/**
+ * @brief 状态机挖掘判定后触发报警 (LORA_EVENT_MINING，无检测特征)
+ */
+void Trigger_Alarm_Detection(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LORA_TRANSPORT_H */
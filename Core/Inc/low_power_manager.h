@@ -32,10 +32,66 @@ extern "C" {
 #define RTC_WAKEUP_PERIOD_SEC           2       // RTC唤醒周期(秒)
 #define LOW_POWER_DEBUG_ENABLED         1       // 低功耗调试使能
 
-/* 功耗管理参数 */
-#define SLEEP_ENTRY_DELAY_MS            100     // 进入Sleep前延时
-#define WAKEUP_STABILIZE_DELAY_MS       50      // 唤醒后稳定延时
-#define SENSOR_STARTUP_DELAY_MS         10      // 传感器启动延时
+/*
+ * 自适应RTC轮询周期 (ENABLE_ADAPTIVE_RTC_PERIOD=1，只作用于RTC轮询方案，WOM/批处理下RTC仅为心跳)：
+ * 每轮唤醒检测结束后记录本轮粗检测触发数和挖掘判定数，保留最近LOW_POWER_ADAPTIVE_HISTORY轮。
+ *   本轮有触发或挖掘判定   -> 周期立即缩短到LOW_POWER_ADAPTIVE_MIN_MS (秒级以下，RTCCLK/16)
+ *   历史窗口内有挖掘判定   -> 保持LOW_POWER_ADAPTIVE_MIN_MS
+ *   历史窗口内只有触发     -> 周期逐轮加倍，不超过RTC_WAKEUP_PERIOD_SEC
+ *   整个历史窗口安静 (夜间) -> 周期逐轮加倍，不超过LOW_POWER_ADAPTIVE_MAX_MS
+ * 最坏检测延迟 = LOW_POWER_ADAPTIVE_MAX_MS + 一轮检测采集时间。
+ */
+#define ENABLE_ADAPTIVE_RTC_PERIOD      1       // 使能自适应RTC轮询周期
+#define LOW_POWER_ADAPTIVE_MIN_MS       500     // 活跃期唤醒周期
+#define LOW_POWER_ADAPTIVE_MAX_MS       16000   // 安静期唤醒周期上限 (最坏检测延迟)
+#define LOW_POWER_ADAPTIVE_HISTORY      8       // 触发历史轮数
+
+/*
+ * 运动唤醒模式 (ENABLE_WOM_WAKEUP=1)：
+ * 传感器LP模式运行WOM (阈值 = 触发倍数 x 学习到的基线RMS)，MCU处于STOP模式，
+ * 只有WOM中断 (PC7/EXTI) 才切换到LN 1kHz采集并运行检测流程；RTC降为低频健康心跳。
+ * 注意：STOP期间UART1不工作，上位机命令只在唤醒后的活跃期内处理。
+ * ENABLE_WOM_WAKEUP=0 时保持RTC定时轮询 + SLEEP的原有方式。
+ */
+#define ENABLE_WOM_WAKEUP               1       // 使能运动唤醒 + STOP模式
+#define WOM_HEARTBEAT_PERIOD_SEC        30      // 运动唤醒模式下RTC健康心跳周期(秒)
+
+/*
+ * 传感器FIFO批处理模式 (ENABLE_FIFO_BATCHING=1，优先于ENABLE_WOM_WAKEUP)：
+ * 传感器持续采集 (LN 1kHz，或双速率下的LP监测)，FIFO水位线提高到接近满；MCU处于STOP，
+ * 水位线中断唤醒后一次读空整个FIFO、全速处理积压样本并立即回到STOP。
+ * 样本连续无缺口，唤醒次数约为每包中断的1/LOW_POWER_BATCH_WATERMARK。RTC为健康心跳。
+ */
+#define ENABLE_FIFO_BATCHING            0       // 使能FIFO批处理 + STOP模式
+#define LOW_POWER_BATCH_WATERMARK       112     // 批处理水位线 (包)：1kHz下112ms，余16包给唤醒和读取
+#define LOW_POWER_BATCH_MARGIN_PACKETS  16      // 水位线距FIFO满的最小余量 (20字节包时按此收紧)
+
+/* STOP模式配置 (运动唤醒和RTC轮询共用) */
+#define LOW_POWER_POLL_USE_STOP         1       // RTC轮询方案的休眠使用STOP (0: SLEEP)
+#define LOW_POWER_STOP_FLASH_POWERDOWN  1       // STOP期间Flash掉电 (唤醒时间约多90us)
+#if LOW_POWER_STOP_FLASH_POWERDOWN
+#define LP_STOP_WAKEUP_US               113     // 数据手册tWUSTOP典型值：低功耗稳压器 + Flash掉电
+#else
+#define LP_STOP_WAKEUP_US               21      // 数据手册tWUSTOP典型值：低功耗稳压器
+#endif
+
+/* 休眠/唤醒过渡：按就绪条件等待 (不再固定延时)，以下为各阶段的超时上限 */
+#define SLEEP_ENTRY_TIMEOUT_MS          100     // 入睡前等待UART1发送完成 (TC)
+#define WAKEUP_CLOCK_TIMEOUT_MS         50      // 唤醒后等待HSE/PLL就绪且SYSCLK为PLL
+#define SENSOR_READY_TIMEOUT_MS         10      // 检测开始时等待传感器FIFO有样本 (INT1或FIFO_COUNT)
+
+/* 能耗估算模型 (数据手册典型值，25°C，mA) */
+#define LP_CURRENT_MCU_RUN_MA           21.0f   // 84MHz运行 (与DSP_BENCH_RUN_MA_84MHZ一致)
+#define LP_CURRENT_MCU_SLEEP_MA         8.0f    // 84MHz Sleep，时钟保持
+#define LP_CURRENT_MCU_STOP_MA          0.3f    // STOP，低功耗稳压器 + Flash掉电
+#define LP_CURRENT_SENSOR_LN_MA         0.28f   // IIM-42352 LN模式
+#define LP_CURRENT_SENSOR_LP_MA         0.045f  // IIM-42352 LP 50Hz (平均16次)
+#define LP_CURRENT_LORA_ON_MA           15.0f   // LoRa模块供电期间平均 (接收待机为主，含发送突发)
+#define LP_CURRENT_UART_TX_MA           1.0f    // USART1发送 (外设时钟 + TX驱动)
+#define LP_ESTIMATE_EVENTS_PER_HOUR     6.0f    // 无实测数据时的振动事件率
+#define LP_ESTIMATE_EVENT_ACTIVE_MS     1500    // 无实测数据时每次事件的活跃时间
+#define LP_ESTIMATE_HEARTBEAT_ACTIVE_MS 5       // 每次心跳的活跃时间 (时钟恢复 + WHO_AM_I)
+#define LP_ESTIMATE_BATCH_BURST_US      2500    // 无实测数据时每批的活跃时间 (时钟恢复 + 读FIFO + 处理)
 
 /* 功耗模式枚举 */
 typedef enum {
@@ -56,8 +112,26 @@ typedef enum {
 typedef enum {
     LOW_POWER_STATE_ACTIVE = 0, // 活跃状态
     LOW_POWER_STATE_SLEEP,      // Sleep状态
+    LOW_POWER_STATE_STOP,       // STOP状态 (运动唤醒模式)
 } low_power_state_t;
 
+/* 休眠/唤醒过渡阶段 */
+typedef enum {
+    LP_PHASE_UART_FLUSH = 0,    // 入睡前：UART1发送完成
+    LP_PHASE_CLOCK_READY,       // 唤醒后：时钟就绪 (STOP时含tWUSTOP和时钟恢复)
+    LP_PHASE_SENSOR_READY,      // 检测开始：传感器FIFO有样本
+    LP_PHASE_COUNT
+} low_power_phase_t;
+
+/* 过渡阶段耗时统计 (微秒，DWT测量) */
+typedef struct {
+    uint32_t count;             // 次数
+    uint32_t last_us;           // 最近一次
+    uint32_t max_us;            // 最大值
+    uint64_t total_us;          // 累计
+    uint32_t timeouts;          // 超时未就绪次数
+} low_power_phase_stats_t;
+
 /* 低功耗管理结构体 */
 typedef struct {
     // 配置参数
@@ -73,8 +147,46 @@ typedef struct {
     uint32_t fine_analysis_count;       // 细检测分析次数
     uint32_t alarm_count;               // 报警次数
     
+    // 运动唤醒统计
+    uint32_t stop_count;                // STOP次数
+    uint32_t wom_wakeup_count;          // WOM唤醒次数
+    uint32_t heartbeat_count;           // RTC心跳次数
+    uint32_t wom_active_time_ms;        // WOM唤醒后的检测活跃时间累计
+    uint8_t wom_armed;                  // 传感器当前处于WOM
+    uint8_t wom_threshold_lsb;          // 当前WOM阈值 (1g/256)
+
+    // FIFO批处理统计
+    uint8_t batch_armed;                // 传感器水位线已设为批处理水位线
+    uint16_t batch_watermark;           // 当前批处理水位线 (包)
+    uint32_t batch_count;               // 批次数 (水位线唤醒次数)
+    uint32_t batch_burst_us;            // 最近一批：唤醒 -> 回到STOP前 (含tWUSTOP)
+    uint32_t batch_burst_max_us;        // 最大值
+    uint64_t batch_active_us;           // 批处理活跃时间累计
+    uint32_t batch_armed_time;          // 开始批处理的时刻 (估算唤醒率)
+    uint32_t batch_count_at_heartbeat;  // 上次心跳时的批次数 (心跳间无批次则重新配置)
+
+    // STOP唤醒时延 (微秒，均含数据手册tWUSTOP)
+    uint32_t stop_clock_restore_us;     // 最近一次：唤醒 -> 84MHz恢复
+    uint32_t stop_wake_to_spi_us;       // 最近一次：唤醒 -> 首次SPI传输完成
+    uint32_t stop_wake_to_spi_max_us;   // 最大值
+    uint32_t stop_clock_fallback_count; // 快速恢复失败、回退SystemClock_Config的次数
+    uint32_t systick_repair_count;      // WOM切换后SysTick不是1ms节拍、已重新配置的次数
+
+    // 休眠/唤醒过渡各阶段耗时
+    low_power_phase_stats_t transition[LP_PHASE_COUNT];
+
+    // 自适应RTC轮询周期
+    uint32_t wakeup_period_ms;          // 当前RTC唤醒周期 (毫秒)
+    uint8_t trigger_history[LOW_POWER_ADAPTIVE_HISTORY];  // 最近各轮粗检测触发数 (饱和到255)
+    uint8_t mining_history[LOW_POWER_ADAPTIVE_HISTORY];   // 最近各轮挖掘判定数 (饱和到255)
+    uint8_t history_index;              // 下一轮写入位置
+    uint32_t cycle_trigger_base;        // 本轮开始时的粗检测触发累计
+    uint32_t cycle_mining_base;         // 本轮开始时的挖掘判定累计
+    uint32_t period_change_count;       // 周期调整次数
+
     // 功耗统计
-    uint32_t total_sleep_time_sec;      // 总Sleep时间
+    uint32_t total_sleep_time_ms;       // 总Sleep时间
+    uint32_t total_stop_time_ms;        // 总STOP时间 (RTC测量)
     uint32_t total_active_time_ms;      // 总活跃时间
     float32_t average_power_ma;         // 平均功耗
     
@@ -108,6 +220,54 @@ int LowPower_EnterSleep(void);
  */
 int LowPower_HandleWakeup(void);
 
+/**
+ * @brief 传感器进入运动唤醒 (LP + WOM)，阈值由学习到的基线RMS和触发倍数计算
+ * @return 0: 成功, <0: 失败
+ */
+int LowPower_ArmWakeOnMotion(void);
+
+/**
+ * @brief 进入STOP模式，唤醒后恢复84MHz时钟并用RTC补偿HAL时基
+ *
+ * 唤醒源：传感器INT1 (EXTI)、RTC心跳。中断在时钟恢复后才执行。
+ * @return 唤醒源 (WAKEUP_SOURCE_EXTERNAL = 传感器WOM, WAKEUP_SOURCE_RTC = 心跳)
+ */
+wakeup_source_t LowPower_EnterStop(void);
+
+/**
+ * @brief 传感器SPI传输完成时调用 (inv_io_hal_read_reg/write_reg)，记录STOP唤醒后首次传输的时延
+ */
+void LowPower_NoteSpiTransaction(void);
+
+/**
+ * @brief 处理WOM唤醒：读取WOM状态，传感器恢复LN采集
+ * @return 0: 成功, <0: 失败
+ */
+int LowPower_HandleMotionWakeup(void);
+
+/**
+ * @brief 处理RTC心跳：检查传感器在线 (失败时下次循环重新配置WOM/批处理水位线)
+ * @return 0: 成功, <0: 传感器无响应
+ */
+int LowPower_HandleHeartbeat(void);
+
+/**
+ * @brief 传感器FIFO水位线设为批处理水位线并清空FIFO
+ * @return 0: 成功, <0: 失败
+ */
+int LowPower_ArmFifoBatching(void);
+
+/**
+ * @brief 水位线唤醒：记录批次统计 (FIFO由主循环读取)
+ */
+void LowPower_BeginBatch(void);
+
+/**
+ * @brief 批处理完成判断：FIFO已读空、延后的DSP任务和LoRa发送都已完成
+ * @return true: 可以回到STOP
+ */
+bool LowPower_IsBatchComplete(void);
+
 /**
  * @brief 启动现有检测流程（完全复用v4.0逻辑）
  * @return 0: 成功, <0: 失败
@@ -120,6 +280,14 @@ int LowPower_StartDetectionProcess(void);
  */
 bool LowPower_IsDetectionComplete(void);
 
+/**
+ * @brief 记录一轮唤醒检测的结果并计算下一个RTC唤醒周期 (规则见ENABLE_ADAPTIVE_RTC_PERIOD)
+ * @param coarse_triggers 本轮粗检测触发数
+ * @param mining_detections 本轮挖掘判定数
+ * @return 下一个唤醒周期 (毫秒)
+ */
+uint32_t LowPower_AdaptWakeupPeriod(uint32_t coarse_triggers, uint32_t mining_detections);
+
 /**
  * @brief 功耗统计更新
  */
@@ -141,6 +309,38 @@ void LowPower_PrintStats(void);
  */
 void LowPower_PrintScenarios(void);
 
+/**
+ * @brief 估算RTC定时轮询 + SLEEP方案的平均电流
+ * @param period_ms 唤醒周期
+ * @param active_ms 每周期MCU运行时间 (入睡延时 + 稳定延时 + 采集)
+ * @return 平均电流 (mA)，传感器始终LN
+ */
+float32_t LowPower_EstimateRtcPollCurrent(uint32_t period_ms, uint32_t active_ms);
+
+/**
+ * @brief 估算运动唤醒 + STOP方案的平均电流
+ * @param events_per_hour 每小时WOM唤醒次数
+ * @param event_active_ms 每次唤醒的检测活跃时间 (MCU运行 + 传感器LN)
+ * @param heartbeat_period_sec RTC心跳周期
+ * @return 平均电流 (mA)
+ */
+float32_t LowPower_EstimateWomCurrent(float32_t events_per_hour, uint32_t event_active_ms,
+                                      uint32_t heartbeat_period_sec);
+
+/**
+ * @brief 估算FIFO批处理 + STOP方案的平均电流
+ * @param batches_per_sec 每秒批次数 (ODR / 水位线)
+ * @param burst_us 每批MCU运行时间
+ * @param sensor_ma 传感器电流 (LN或LP监测)
+ * @return 平均电流 (mA)
+ */
+float32_t LowPower_EstimateBatchCurrent(float32_t batches_per_sec, uint32_t burst_us, float32_t sensor_ma);
+
+/**
+ * @brief 打印两种方案的能耗对比 (有实测WOM数据时使用实测事件率和活跃时间)
+ */
+void LowPower_PrintEnergyEstimate(void);
+
 /**
  * @brief 设置功耗模式
  * @param mode 功耗模式
@@ -67,6 +67,9 @@ void Error_Handler(void);
 /* PE14 GPIO Test Function */
 void Test_PE14_GPIO(void);
 
+/* 系统时钟配置 (STOP模式唤醒后重新调用以恢复HSE + PLL) */
+void SystemClock_Config(void);
+
 /* Global variables */
 extern volatile uint32_t irq_from_device;
 /* USER CODE END EFP */
@@ -0,0 +1,146 @@
+/**
+ * @file modbus_rtu.h
+ * @brief Modbus RTU帧收发引擎头文件 (UART5 / LoRa模块)
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 接收使用DMA循环缓冲 + 空闲线事件，帧边界取空闲线事件时的DMA写指针 (中断中记录)，
+ * 与主循环的调度周期无关：背靠背的两帧只要之间有空闲线 (1个字符时间，小于t3.5) 就能分开。
+ * 帧完成后统一校验长度、CRC、地址和功能码，支持异常应答(功能码|0x80)。
+ */
+
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 引擎配置 */
+#define MODBUS_RTU_RX_DMA_SIZE          64      // DMA循环接收缓冲区
+#define MODBUS_RTU_MAX_FRAME            64      // 最大帧长 (LoRa应答远小于此值)
+#define MODBUS_RTU_MIN_FRAME            4       // 地址+功能码+CRC
+#define MODBUS_RTU_BOUNDARY_DEPTH       8       // 未处理的帧边界队列深度 (溢出时相邻帧合并，CRC校验失败)
+#define MODBUS_RTU_EXCEPTION_FLAG       0x80
+
+/* 标准异常码 */
+#define MODBUS_EX_ILLEGAL_FUNCTION      0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS       0x02
+#define MODBUS_EX_ILLEGAL_VALUE         0x03
+#define MODBUS_EX_DEVICE_FAILURE        0x04
+#define MODBUS_EX_ACKNOWLEDGE           0x05
+#define MODBUS_EX_DEVICE_BUSY           0x06
+
+/* 写寄存器应答检查结果 */
+typedef enum {
+    MODBUS_RTU_RESP_ACK = 0,            // 正常应答且与请求匹配
+    MODBUS_RTU_RESP_EXCEPTION,          // 异常应答
+    MODBUS_RTU_RESP_MISMATCH,           // 地址/功能码/寄存器与请求不符
+} modbus_rtu_response_t;
+
+/* 已校验的接收帧 */
+typedef struct {
+    uint8_t address;
+    uint8_t function;                   // 已去掉异常标志
+    bool is_exception;
+    uint8_t exception_code;
+    const uint8_t *pdu;                 // 功能码之后的数据 (不含CRC)
+    uint16_t pdu_length;
+    uint16_t frame_length;              // 整帧长度 (含地址和CRC)
+} modbus_rtu_frame_t;
+
+/* 接收统计 */
+typedef struct {
+    uint32_t frames_ok;                 // CRC正确的帧
+    uint32_t crc_errors;                // CRC错误
+    uint32_t length_errors;             // 过短/过长/长度与功能码不符
+    uint32_t exceptions;                // 异常应答
+    uint32_t uart_errors;               // UART硬件错误
+} modbus_rtu_stats_t;
+
+/**
+ * @brief 计算Modbus CRC16 (查表法)
+ * @param data 数据
+ * @param length 长度
+ * @return CRC16 (发送时低字节在前)
+ */
+uint16_t Modbus_RTU_CRC16(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief 增量计算Modbus CRC16，初值0xFFFF
+ */
+uint16_t Modbus_RTU_CRC16_Update(uint16_t crc, const uint8_t *data, uint16_t length);
+
+/**
+ * @brief 初始化接收引擎并启动DMA循环接收
+ * @param huart UART句柄
+ * @return 0: 成功, <0: 失败
+ */
+int Modbus_RTU_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief 主循环中调用：按空闲线边界切出下一帧 (上一帧被GetFrame取走前不切新帧)
+ */
+void Modbus_RTU_Process(void);
+
+/**
+ * @brief 获取一帧已校验的接收帧 (调用后该帧被消费)
+ * @param frame 输出帧信息，pdu指针在下一次Process前有效
+ * @return true: 有新帧
+ */
+bool Modbus_RTU_GetFrame(modbus_rtu_frame_t *frame);
+
+/**
+ * @brief 丢弃已接收但未处理的数据 (发送新请求前调用)
+ */
+void Modbus_RTU_Flush(void);
+
+/**
+ * @brief 接收线路是否空闲 (最近一次空闲线事件后没有新字节)
+ * @return true: 空闲，可以修改波特率分频
+ */
+bool Modbus_RTU_IsRxIdle(void);
+
+/**
+ * @brief 构建写多寄存器请求帧
+ * @param buffer 输出缓冲区 (至少 9 + quantity*2 字节)
+ * @param address 从站地址
+ * @param function 功能码
+ * @param start_reg 起始寄存器
+ * @param regs 寄存器值
+ * @param quantity 寄存器数
+ * @return 帧长度
+ */
+uint16_t Modbus_RTU_BuildWriteMultiple(uint8_t *buffer, uint8_t address, uint8_t function,
+                                       uint16_t start_reg, const uint16_t *regs, uint16_t quantity);
+
+/**
+ * @brief 检查写多寄存器应答 (回显起始地址和寄存器数)
+ */
+modbus_rtu_response_t Modbus_RTU_CheckWriteResponse(const modbus_rtu_frame_t *frame, uint8_t address,
+                                                    uint8_t function, uint16_t start_reg, uint16_t quantity);
+
+/**
+ * @brief 获取接收统计
+ */
+const modbus_rtu_stats_t* Modbus_RTU_GetStats(void);
+
+/**
+ * @brief HAL_UARTEx_RxEventCallback中调用：空闲线事件记录帧边界
+ */
+void Modbus_RTU_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos);
+
+/**
+ * @brief HAL_UART_ErrorCallback中调用：只重启DMA接收，缓冲区状态由主循环复位
+ */
+void Modbus_RTU_ErrorCallback(UART_HandleTypeDef *huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_RTU_H */
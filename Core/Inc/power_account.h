@@ -0,0 +1,165 @@
+/**
+ * @file power_account.h
+ * @brief 状态驻留能耗核算头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 按系统状态 (system_state_t) 和功耗负载分别累计微秒级驻留时间，用电流模型表折算电荷：
+ *   MCU     RUN / SLEEP / STOP，三者互斥
+ *   传感器  LN / LP / 关闭，互斥
+ *   外设    LoRa模块供电 (PE14)、UART1发送，可与其他负载叠加
+ * 时间基准为DWT_Timer_GetTimeUs，两次记账间隔须小于CYCCNT回绕周期 (84MHz下约51秒)。
+ * STOP期间CYCCNT停止，STOP时长由低功耗管理以RTC测量后通过Power_Account_AddStopTime补记。
+ * 阻塞式UART发送按字节数和波特率折算时间 (Power_Account_AddUartTx)。
+ *
+ * ENABLE_POWER_TRACE=1时，每次系统状态切换或分段超过POWER_TRACE_MAX_SEGMENT_MS，输出一行分段记录：
+ *   PWR_SEG,<t_ms>,<state>,<segment_us>,<run_us>,<sleep_us>,<stop_us>,<ln_us>,<lp_us>,<lora_us>,<uart_tx_us>
+ * 分段内的负载时间归属于<state>。主机工具Host/power_sim按不同电流模型和电池参数回放这些记录，预测电池寿命。
+ */
+
+#ifndef POWER_ACCOUNT_H
+#define POWER_ACCOUNT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"       // system_state_t
+#include "low_power_manager.h"      // 默认电流模型 LP_CURRENT_*
+
+/* 配置 */
+#define ENABLE_POWER_ACCOUNTING         1       // 使能驻留能耗核算
+#define ENABLE_POWER_TRACE              0       // 串口输出PWR_SEG分段记录 (供Host/power_sim回放)
+#define POWER_TRACE_MAX_SEGMENT_MS      60000   // 状态不变时的最长分段
+
+/* 功耗负载 */
+typedef enum {
+    POWER_LOAD_MCU_RUN = 0,     // MCU 84MHz运行
+    POWER_LOAD_MCU_SLEEP,       // MCU Sleep (WFI)
+    POWER_LOAD_MCU_STOP,        // MCU STOP
+    POWER_LOAD_SENSOR_LN,       // 传感器LN模式
+    POWER_LOAD_SENSOR_LP,       // 传感器LP模式 (WOM/双速率监测)
+    POWER_LOAD_LORA,            // LoRa模块供电 (PE14)
+    POWER_LOAD_UART_TX,         // UART1发送
+    POWER_LOAD_COUNT
+} power_load_t;
+
+#define POWER_LOAD_MASK(load)       (1UL << (uint32_t)(load))
+#define POWER_LOAD_MCU_MASK         (POWER_LOAD_MASK(POWER_LOAD_MCU_RUN) | \
+                                     POWER_LOAD_MASK(POWER_LOAD_MCU_SLEEP) | \
+                                     POWER_LOAD_MASK(POWER_LOAD_MCU_STOP))
+#define POWER_LOAD_SENSOR_MASK      (POWER_LOAD_MASK(POWER_LOAD_SENSOR_LN) | \
+                                     POWER_LOAD_MASK(POWER_LOAD_SENSOR_LP))
+
+/* 电流模型 (mA，按负载索引) */
+typedef struct {
+    float32_t load_ma[POWER_LOAD_COUNT];
+} power_model_t;
+
+/* 驻留统计 (上电以来累计) */
+typedef struct {
+    uint64_t total_us;                                      // 记账总时长
+    uint64_t load_us[POWER_LOAD_COUNT];                     // 各负载开启时间
+    uint64_t state_us[STATE_COUNT];                         // 各系统状态驻留时间
+    uint64_t state_load_us[STATE_COUNT][POWER_LOAD_COUNT];  // 各状态内的负载开启时间
+    uint32_t active_mask;                                   // 当前开启的负载
+    system_state_t state;                                   // 当前系统状态
+    uint32_t trace_segments;                                // 已输出的PWR_SEG分段
+} power_residency_t;
+
+/**
+ * @brief 初始化 (DWT_Timer_Init之后调用)：MCU运行、传感器LN、状态SYSTEM_INIT，默认电流模型
+ * @return 0: 成功
+ */
+int Power_Account_Init(void);
+
+/**
+ * @brief 切换MCU功耗模式
+ * @param mode POWER_LOAD_MCU_RUN / POWER_LOAD_MCU_SLEEP / POWER_LOAD_MCU_STOP
+ */
+void Power_Account_SetMcu(power_load_t mode);
+
+/**
+ * @brief 切换传感器功耗模式
+ * @param mode POWER_LOAD_SENSOR_LN / POWER_LOAD_SENSOR_LP，其他值表示传感器关闭
+ */
+void Power_Account_SetSensor(power_load_t mode);
+
+/**
+ * @brief 开关独立负载 (LoRa供电)
+ */
+void Power_Account_SetLoad(power_load_t load, bool on);
+
+/**
+ * @brief 记录阻塞式UART发送 (按10位/字节折算发送时间，归入当前状态)
+ */
+void Power_Account_AddUartTx(uint32_t bytes, uint32_t baud);
+
+/**
+ * @brief 切换系统状态 (状态机transition_to_state调用)，结束当前分段
+ */
+void Power_Account_SetState(system_state_t state);
+
+/**
+ * @brief 补记STOP时长 (CYCCNT在STOP期间停止)
+ *
+ * 按进入STOP时的负载和系统状态记账，在Power_Account_SetMcu(POWER_LOAD_MCU_RUN)之后调用。
+ * @param stop_ms RTC测得的STOP时长
+ */
+void Power_Account_AddStopTime(uint32_t stop_ms);
+
+/**
+ * @brief 主循环调用：推进记账，分段超过POWER_TRACE_MAX_SEGMENT_MS时输出
+ */
+void Power_Account_Process(void);
+
+/**
+ * @brief 获取驻留统计 (先推进到当前时刻)
+ */
+const power_residency_t* Power_Account_GetResidency(void);
+
+/**
+ * @brief 替换电流模型
+ */
+void Power_Account_SetModel(const power_model_t *model);
+
+/**
+ * @brief 当前电流模型
+ */
+const power_model_t* Power_Account_GetModel(void);
+
+/**
+ * @brief 默认电流模型 (LP_CURRENT_*，数据手册典型值)
+ */
+void Power_Account_DefaultModel(power_model_t *model);
+
+/**
+ * @brief 负载时间 x 模型电流
+ * @param load_us 各负载开启时间 (微秒)
+ * @return 电荷 (mA·s)
+ */
+float32_t Power_Account_Charge(const uint64_t load_us[POWER_LOAD_COUNT], const power_model_t *model);
+
+/**
+ * @brief 上电以来的平均电流 (当前模型)
+ * @return mA，无记账时间时为0
+ */
+float32_t Power_Account_AverageMa(void);
+
+/**
+ * @brief 打印各负载/各状态驻留时间和电荷
+ */
+void Power_Account_PrintStats(void);
+
+/**
+ * @brief 负载名称 (PWR_SEG列名与打印用)
+ */
+const char* Power_Account_LoadName(power_load_t load);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POWER_ACCOUNT_H */
@@ -0,0 +1,109 @@
+/**
+ * @file profiler.h
+ * @brief 基于DWT周期计数器的分阶段耗时统计头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 每个处理阶段记录次数、最小/最大/平均周期数和log2分桶直方图
+ * (第k桶统计耗时在[2^k, 2^(k+1))个周期内的次数)。
+ * 发布版本在编译选项中定义ENABLE_PROFILING=0，打点宏展开为空，不占用代码和RAM。
+ *
+ * 用法:
+ *   PROFILE_START(t);
+ *   ... 被测代码 ...
+ *   PROFILE_STOP(PROF_STAGE_FFT, t);
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef ENABLE_PROFILING
+#define ENABLE_PROFILING                1       // 发布版本定义为0
+#endif
+
+#define PROFILER_HIST_BUCKETS           24      // log2分桶数 (最后一桶包含更长耗时，84MHz下约100ms)
+
+/* 被测阶段 */
+typedef enum {
+    PROF_STAGE_FIFO_READ = 0,       // 一次FIFO突发读取 (含逐包回调)
+    PROF_STAGE_DECODE,              // 单包时间戳扩展/格式转换/安装矩阵
+    PROF_STAGE_HIGHPASS,            // 单样本高通滤波
+    PROF_STAGE_COARSE,              // 单样本粗检测
+    PROF_STAGE_FFT,                 // 加窗 + 512点CFFT
+    PROF_STAGE_MAGNITUDE,           // 幅值谱 + 归一化 + 峰值/能量
+    PROF_STAGE_FINE,                // 细检测特征提取与分类
+    PROF_STAGE_STATE_MACHINE,       // 一次状态机处理
+    PROF_STAGE_LORA_SEND,           // LoRa组帧并启动DMA发送
+    PROF_STAGE_COUNT
+} profiler_stage_t;
+
+/* 单阶段统计 */
+typedef struct {
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t sum_cycles;
+    uint32_t histogram[PROFILER_HIST_BUCKETS];
+} profiler_stats_t;
+
+#if ENABLE_PROFILING
+
+#include "dwt_timer.h"
+
+#define PROFILE_START(var)              uint32_t var = DWT_Timer_GetCycles()
+#define PROFILE_STOP(stage, var)        Profiler_Record((stage), DWT_Timer_GetCycles() - (var))
+
+/**
+ * @brief 清零全部统计 (需在DWT_Timer_Init之后调用)
+ */
+int Profiler_Init(void);
+
+/**
+ * @brief 记录一次阶段耗时
+ * @param stage 阶段
+ * @param cycles 耗时周期数
+ */
+void Profiler_Record(profiler_stage_t stage, uint32_t cycles);
+
+/**
+ * @brief 获取阶段统计
+ * @return 统计指针, stage越界时返回NULL
+ */
+const profiler_stats_t* Profiler_GetStats(profiler_stage_t stage);
+
+/**
+ * @brief 获取阶段名称
+ */
+const char* Profiler_GetStageName(profiler_stage_t stage);
+
+/**
+ * @brief 清零统计
+ */
+void Profiler_Reset(void);
+
+/**
+ * @brief 打印统计表和直方图
+ * @param reset 打印后清零
+ */
+void Profiler_Print(bool reset);
+
+#else
+
+#define PROFILE_START(var)
+#define PROFILE_STOP(stage, var)        ((void)0)
+
+#endif /* ENABLE_PROFILING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROFILER_H */
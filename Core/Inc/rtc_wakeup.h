@@ -26,6 +26,14 @@ extern "C" {
 #define RTC_LSI_FREQUENCY               32000                           // LSI频率：约32kHz
 #define RTC_WAKEUP_CLOCK_FREQ           1                               // 唤醒时钟频率：1Hz
 
+/*
+ * 秒级以下的周期改用RTCCLK/16 (LSI 32kHz -> 2kHz，0.5ms分辨率)，16位唤醒计数器最长32.768秒；
+ * 更长的周期仍用1Hz时钟。唤醒周期 = (计数值 + 1) 个唤醒时钟周期。
+ */
+#define RTC_WAKEUP_FINE_CLOCK_SOURCE    RTC_WAKEUPCLOCK_RTCCLK_DIV16    // 细分辨率时钟源：RTCCLK/16
+#define RTC_WAKEUP_FINE_CLOCK_FREQ      (RTC_LSI_FREQUENCY / 16)        // 2000Hz
+#define RTC_WAKEUP_FINE_MAX_MS          (65536UL * 1000UL / RTC_WAKEUP_FINE_CLOCK_FREQ)  // 32768ms
+
 /* RTC状态枚举 */
 typedef enum {
     RTC_STATE_UNINITIALIZED = 0,    // 未初始化
@@ -38,9 +46,11 @@ typedef enum {
 /* RTC统计结构体 */
 typedef struct {
     uint32_t wakeup_count;          // 唤醒次数
-    uint32_t wakeup_period_sec;     // 唤醒周期(秒)
+    uint32_t wakeup_period_sec;     // 唤醒周期(秒，秒级以下为0)
+    uint32_t wakeup_period_ms;      // 唤醒周期(毫秒)
+    uint32_t reconfigure_count;     // 周期重配置次数
     uint32_t last_wakeup_time;      // 上次唤醒时间
-    uint32_t total_wakeup_time;     // 总唤醒时间
+    uint32_t total_wakeup_time;     // 总唤醒时间(毫秒)
     rtc_state_t state;              // RTC状态
     bool is_wakeup_pending;         // 唤醒待处理标志
 } rtc_wakeup_stats_t;
@@ -64,6 +74,15 @@ int RTC_Wakeup_Init(void);
  */
 int RTC_Wakeup_Configure(uint32_t period_sec);
 
+/**
+ * @brief 按毫秒配置RTC唤醒定时器 (不超过RTC_WAKEUP_FINE_MAX_MS时使用RTCCLK/16)
+ *
+ * 重新装载唤醒计数器，下次唤醒在period_ms之后。周期未变化时直接返回。
+ * @param period_ms 唤醒周期(毫秒)
+ * @return 0: 成功, <0: 失败
+ */
+int RTC_Wakeup_ConfigureMs(uint32_t period_ms);
+
 /**
  * @brief 启动RTC唤醒定时器
  * @return 0: 成功, <0: 失败
@@ -93,6 +112,21 @@ bool RTC_Wakeup_IsPending(void);
  */
 void RTC_Wakeup_ClearFlag(void);
 
+/**
+ * @brief 读取RTC日历时间 (毫秒，按天回绕)
+ *
+ * SysTick在STOP期间停止，用RTC测量STOP时长并补偿HAL时基。
+ * 分辨率为同步预分频周期 (1/256秒)。
+ * @return 当天0点起的毫秒数 (0 ~ 86399999)
+ */
+uint32_t RTC_Wakeup_GetTimeMs(void);
+
+/**
+ * @brief STOP唤醒后重新同步日历影子寄存器 (读取时间之前调用)
+ * @return 0: 成功, <0: 失败
+ */
+int RTC_Wakeup_Resync(void);
+
 /**
  * @brief 获取RTC唤醒统计信息
  * @return RTC统计结构体指针
@@ -110,11 +144,6 @@ void RTC_Wakeup_PrintStats(void);
  */
 void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc);
 
-/* 内部函数声明 */
-static int RTC_Wakeup_ConfigureClock(void);
-static int RTC_Wakeup_ConfigureTimer(uint32_t period_sec);
-static void RTC_Wakeup_UpdateStats(void);
-
 #ifdef __cplusplus
 }
 #endif
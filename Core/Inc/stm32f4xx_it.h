@@ -57,6 +57,12 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void EXTI9_5_IRQHandler(void);
+void USART1_IRQHandler(void);
+void UART5_IRQHandler(void);
+void DMA1_Stream0_IRQHandler(void);
+void DMA1_Stream7_IRQHandler(void);
+void DMA2_Stream2_IRQHandler(void);
+void DMA2_Stream7_IRQHandler(void);
 void RTC_WKUP_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
@@ -0,0 +1,104 @@
+/**
+ * @file system_monitor.h
+ * @brief CPU负载、栈高水位与静态RAM占用监测头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * CPU负载 = 1 - 空闲周期 / 总周期。空闲周期在WFI处(主循环等待、低功耗休眠)上报，
+ * 每个节拍按当前系统状态归集，得到每秒负载和各状态负载。
+ * DWT在STOP期间停止计数，STOP时长按RTC测量值折算为当前频率下的周期数，
+ * 同时计入空闲和总周期，负载是相对墙钟时间而不只是唤醒时间。
+ *
+ * 栈高水位：启动时把当前SP以下未使用的主栈填充为固定图样，
+ * 之后从栈底向上扫描第一个被改写的字即为历史最深位置 (含中断嵌套)。
+ */
+
+#ifndef SYSTEM_MONITOR_H
+#define SYSTEM_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 监测配置 */
+#define ENABLE_SYSTEM_MONITOR           1
+#define SYSTEM_MONITOR_STACK_SIZE       0x400       // 与startup_stm32f407xx.s中Stack_Size一致
+#define SYSTEM_MONITOR_HEAP_SIZE        0x200       // 与startup_stm32f407xx.s中Heap_Size一致
+#define SYSTEM_MONITOR_RAM_SIZE         0x20000     // IRAM1 (SRAM1+SRAM2) 128KB
+#define SYSTEM_MONITOR_STACK_PAINT      0xC5C5C5C5U // 栈填充图样
+#define SYSTEM_MONITOR_PAINT_MARGIN     32          // 当前SP以下保留不填充的字节数
+#define SYSTEM_MONITOR_LOAD_WINDOW_MS   1000        // 负载统计窗口
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+#define SYSTEM_MONITOR_STATE_SLOTS      STATE_COUNT
+#else
+#define SYSTEM_MONITOR_STATE_SLOTS      1
+#endif
+
+/* 监测统计 */
+typedef struct {
+    uint16_t load_permille;                         // 最近一个完整窗口的CPU负载
+    uint16_t load_peak_permille;                    // 各窗口负载最大值
+    uint32_t windows;                               // 已完成的统计窗口数
+    uint32_t stack_size;                            // 主栈大小 (字节)
+    uint32_t stack_peak_bytes;                      // 主栈历史最大使用量
+    uint64_t state_total_cycles[SYSTEM_MONITOR_STATE_SLOTS];
+    uint64_t state_busy_cycles[SYSTEM_MONITOR_STATE_SLOTS];
+} system_monitor_stats_t;
+
+#if ENABLE_SYSTEM_MONITOR
+
+/**
+ * @brief 填充栈图样并打印静态RAM占用 (需在DWT_Timer_Init之后、尽早调用)
+ * @return 0: 成功
+ */
+int System_Monitor_Init(void);
+
+/**
+ * @brief 上报一段空闲时间 (WFI前后的DWT周期差)
+ */
+void System_Monitor_RecordIdle(uint32_t cycles);
+
+/**
+ * @brief 上报一段STOP时间 (RTC测量，DWT不计数的部分)，计为空闲
+ */
+void System_Monitor_RecordStop(uint32_t stop_ms);
+
+/**
+ * @brief 主循环节拍中调用：归集负载，窗口到期时更新每秒负载
+ */
+void System_Monitor_Process(void);
+
+/**
+ * @brief 扫描栈图样，返回主栈历史最大使用量 (字节)
+ */
+uint32_t System_Monitor_GetStackPeak(void);
+
+/**
+ * @brief 获取统计 (调用时刷新栈高水位)
+ */
+const system_monitor_stats_t* System_Monitor_GetStats(void);
+
+/**
+ * @brief 打印负载与栈高水位
+ * @param reset 打印后清零负载峰值和各状态统计
+ */
+void System_Monitor_PrintStats(bool reset);
+
+/**
+ * @brief 打印各模块静态RAM占用
+ */
+void System_Monitor_PrintRamUsage(void);
+
+#endif /* ENABLE_SYSTEM_MONITOR */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSTEM_MONITOR_H */
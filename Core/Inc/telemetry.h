@@ -0,0 +1,109 @@
+/**
+ * @file telemetry.h
+ * @brief 周期性二进制健康/性能遥测头文件
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 每TELEMETRY_PERIOD_MS汇总一次运行指标，通过上位机帧协议主动上报，
+ * 可选地按TELEMETRY_LORA_PERIOD_MS打包为寄存器块随LoRa上行。
+ *
+ * CPU负载 = 1 - (主循环等待时间 + 休眠时间) / 窗口时间，
+ * 时间由DWT周期计数器累计 (SysTick在休眠期间被挂起)。
+ *
+ * 上报载荷 (小端, 共TELEMETRY_PAYLOAD_SIZE字节):
+ *   version(1) timestamp_ms(4) window_ms(4)
+ *   cpu_load(2, 千分比) sleep_ratio(2, 千分比)
+ *   fifo_reads(4) fifo_overflows(4) samples(4) fft_frames(4)
+ *   coarse_triggers(4) fine_mining(4) fine_normal(4) uplink_ok(4) uplink_fail(4)
+ *   state_count(1) residency[state_count](2, 千分比)
+ * 计数器为上电以来累计值 (丢帧不丢数据)，比例类指标为本窗口值。
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 遥测配置 */
+#define ENABLE_TELEMETRY                1       // 使能周期遥测
+#define ENABLE_TELEMETRY_LORA           0       // 遥测摘要随LoRa上行 (占用空口时间，默认关闭)
+#define TELEMETRY_PERIOD_MS             10000   // 上位机上报周期
+#define TELEMETRY_LORA_PERIOD_MS        3600000 // LoRa上行周期 (1小时)
+#define TELEMETRY_VERSION               1
+
+/* LoRa遥测寄存器块 (紧接事件寄存器之后) */
+#define TELEMETRY_LORA_START_REG        0x0010
+#define TELEMETRY_LORA_REG_COUNT        12
+
+/*
+ * LoRa遥测寄存器布局 (窗口增量，饱和到16位):
+ *   R0  数据类型 (3=遥测)
+ *   R1  CPU负载 (千分比)
+ *   R2  休眠占比 (千分比)
+ *   R3  FIFO读取次数
+ *   R4  FIFO溢出次数
+ *   R5  FFT帧数
+ *   R6  粗检测触发次数
+ *   R7  细检测判定挖掘次数
+ *   R8  细检测判定正常次数
+ *   R9  上行成功次数
+ *   R10 上行失败次数
+ *   R11 监测状态驻留 (千分比)
+ */
+
+#define TELEMETRY_STATE_SLOTS           ((uint8_t)STATE_COUNT)
+#define TELEMETRY_PAYLOAD_SIZE          (9 + 4 + 9 * 4 + 1 + TELEMETRY_STATE_SLOTS * 2)
+
+/* 空闲类型 */
+typedef enum {
+    TELEMETRY_IDLE_WAIT = 0,        // 主循环等待事件 (WFI)
+    TELEMETRY_IDLE_SLEEP,           // 低功耗休眠
+} telemetry_idle_t;
+
+/**
+ * @brief 初始化遥测 (需在DWT_Timer_Init之后调用)
+ * @return 0: 成功
+ */
+int Telemetry_Init(void);
+
+/**
+ * @brief 主循环中调用：累计窗口时间，到期时上报
+ */
+void Telemetry_Process(void);
+
+/**
+ * @brief 进入空闲 (HAL_Delay / 休眠之前调用)
+ */
+void Telemetry_IdleEnter(telemetry_idle_t kind);
+
+/**
+ * @brief 退出空闲
+ */
+void Telemetry_IdleExit(void);
+
+/**
+ * @brief 记录一次FIFO读取结果
+ * @param rc GetDataFromInvDevice返回值 (>0为读出的样本包数)
+ */
+void Telemetry_RecordFifoRead(int rc);
+
+/**
+ * @brief 生成当前上报窗口的遥测载荷 (不结束窗口)
+ * @param buffer 输出缓冲区
+ * @param size 缓冲区大小 (>= TELEMETRY_PAYLOAD_SIZE)
+ * @return 载荷长度, <0: 缓冲区不足
+ */
+int Telemetry_BuildPayload(uint8_t *buffer, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H */
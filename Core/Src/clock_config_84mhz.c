@@ -56,6 +56,42 @@ void Clock_Config_Verify(void)
     printf("时钟配置验证完成!\n\n");
 }
 
+/**
+ * @brief STOP唤醒后快速恢复84MHz时钟
+ */
+int Clock_Config_RestoreAfterStop(void)
+{
+    uint32_t timeout;
+
+    SET_BIT(RCC->CR, RCC_CR_HSEON);
+    timeout = CLOCK_RESTORE_TIMEOUT_LOOPS;
+    while (READ_BIT(RCC->CR, RCC_CR_HSERDY) == 0U) {
+        if (--timeout == 0U) {
+            return -1;
+        }
+    }
+
+    /* RCC_PLLCFGR (M/N/P/Q、时钟源HSE) 在STOP期间保持 */
+    SET_BIT(RCC->CR, RCC_CR_PLLON);
+    timeout = CLOCK_RESTORE_TIMEOUT_LOOPS;
+    while (READ_BIT(RCC->CR, RCC_CR_PLLRDY) == 0U) {
+        if (--timeout == 0U) {
+            return -2;
+        }
+    }
+
+    /* AHB/APB分频和FLASH_ACR等待周期同样保持，直接切换SYSCLK */
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, RCC_CFGR_SW_PLL);
+    timeout = CLOCK_RESTORE_TIMEOUT_LOOPS;
+    while (READ_BIT(RCC->CFGR, RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+        if (--timeout == 0U) {
+            return -3;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief 获取当前系统时钟频率
  */
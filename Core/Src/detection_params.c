@@ -0,0 +1,218 @@
+/**
+ * @file detection_params.c
+ * @brief 检测算法运行时参数管理实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 参数表驱动：每个参数ID对应一个字段、类型和合法范围，
+ * 读写统一走表，新增参数只需在表中加一行。
+ */
+
+#include "detection_params.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+/* 参数值类型 */
+typedef enum {
+    PARAM_TYPE_FLOAT = 0,
+    PARAM_TYPE_U32
+} param_type_t;
+
+/* 参数描述表项 */
+typedef struct {
+    uint8_t id;
+    param_type_t type;
+    uint16_t offset;            // 在detection_params_t中的偏移
+    float32_t min_value;
+    float32_t max_value;
+    const char* name;
+} param_desc_t;
+
+#define PARAM_ENTRY(id, type, field, min, max) \
+    { (id), (type), (uint16_t)offsetof(detection_params_t, field), (min), (max), #field }
+
+/* 参数描述表 */
+static const param_desc_t param_table[] = {
+    PARAM_ENTRY(PARAM_ID_TRIGGER_MULTIPLIER,   PARAM_TYPE_FLOAT, trigger_multiplier,     1.0f,    50.0f),
+    PARAM_ENTRY(PARAM_ID_BASELINE_RMS,         PARAM_TYPE_FLOAT, baseline_rms_threshold, 0.00001f, 1.0f),
+    PARAM_ENTRY(PARAM_ID_RMS_WINDOW_SIZE,      PARAM_TYPE_U32,   rms_window_size,        10.0f,   (float32_t)RMS_WINDOW_SIZE),
+    PARAM_ENTRY(PARAM_ID_TRIGGER_DURATION_MS,  PARAM_TYPE_U32,   trigger_duration_ms,    100.0f,  60000.0f),
+    PARAM_ENTRY(PARAM_ID_COOLDOWN_TIME_MS,     PARAM_TYPE_U32,   cooldown_time_ms,       0.0f,    600000.0f),
+
+    PARAM_ENTRY(PARAM_ID_LOW_FREQ_MIN,         PARAM_TYPE_FLOAT, low_freq_min,           0.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_LOW_FREQ_MAX,         PARAM_TYPE_FLOAT, low_freq_max,           0.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_MID_FREQ_MIN,         PARAM_TYPE_FLOAT, mid_freq_min,           0.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_MID_FREQ_MAX,         PARAM_TYPE_FLOAT, mid_freq_max,           0.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_HIGH_FREQ_MIN,        PARAM_TYPE_FLOAT, high_freq_min,          0.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_HIGH_FREQ_MAX,        PARAM_TYPE_FLOAT, high_freq_max,          0.0f,    500.0f),
+
+    PARAM_ENTRY(PARAM_ID_LOW_FREQ_THRESHOLD,   PARAM_TYPE_FLOAT, low_freq_threshold,     0.01f,   1.0f),
+    PARAM_ENTRY(PARAM_ID_MID_FREQ_THRESHOLD,   PARAM_TYPE_FLOAT, mid_freq_threshold,     0.01f,   1.0f),
+    PARAM_ENTRY(PARAM_ID_DOMINANT_FREQ_MAX,    PARAM_TYPE_FLOAT, dominant_freq_max,      1.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_CENTROID_MAX,         PARAM_TYPE_FLOAT, centroid_max,           1.0f,    500.0f),
+    PARAM_ENTRY(PARAM_ID_CONFIDENCE_THRESHOLD, PARAM_TYPE_FLOAT, confidence_threshold,   0.0f,    1.0f),
+};
+
+#define PARAM_TABLE_SIZE    (sizeof(param_table) / sizeof(param_table[0]))
+
+/* 频带上下限参数对：写入后必须保持 min < max */
+static const struct {
+    uint8_t min_id;
+    uint8_t max_id;
+} band_table[] = {
+    { PARAM_ID_LOW_FREQ_MIN,  PARAM_ID_LOW_FREQ_MAX  },
+    { PARAM_ID_MID_FREQ_MIN,  PARAM_ID_MID_FREQ_MAX  },
+    { PARAM_ID_HIGH_FREQ_MIN, PARAM_ID_HIGH_FREQ_MAX },
+};
+
+#define BAND_TABLE_SIZE     (sizeof(band_table) / sizeof(band_table[0]))
+
+/* 运行时参数 */
+static detection_params_t g_detection_params;
+static uint8_t param_id_list[PARAM_TABLE_SIZE];
+
+static const param_desc_t* find_param(uint8_t param_id)
+{
+    for (uint32_t i = 0; i < PARAM_TABLE_SIZE; i++) {
+        if (param_table[i].id == param_id) {
+            return &param_table[i];
+        }
+    }
+    return NULL;
+}
+
+int Detection_Params_Init(void)
+{
+    Detection_Params_ResetDefaults();
+
+    for (uint32_t i = 0; i < PARAM_TABLE_SIZE; i++) {
+        param_id_list[i] = param_table[i].id;
+    }
+
+    printf("=== DETECTION PARAMS INITIALIZED (%u params) ===\r\n", (unsigned)PARAM_TABLE_SIZE);
+    return 0;
+}
+
+const detection_params_t* Detection_Params_Get(void)
+{
+    return &g_detection_params;
+}
+
+int Detection_Params_GetValue(uint8_t param_id, float32_t* value)
+{
+    const param_desc_t* desc = find_param(param_id);
+
+    if (value == NULL) {
+        return -2;
+    }
+    if (desc == NULL) {
+        return -1;
+    }
+
+    const uint8_t* base = (const uint8_t*)&g_detection_params + desc->offset;
+    if (desc->type == PARAM_TYPE_U32) {
+        *value = (float32_t)(*(const uint32_t*)base);
+    } else {
+        *value = *(const float32_t*)base;
+    }
+    return 0;
+}
+
+int Detection_Params_SetValue(uint8_t param_id, float32_t value)
+{
+    const param_desc_t* desc = find_param(param_id);
+
+    if (desc == NULL) {
+        return -1;
+    }
+    if (!(value >= desc->min_value && value <= desc->max_value)) {
+        printf("PARAMS: %s=%.6f out of range [%.6f, %.6f]\r\n",
+               desc->name, value, desc->min_value, desc->max_value);
+        return -3;
+    }
+
+    /* 频带另一端的当前值：写入后 min >= max 的频带为空，拒绝 */
+    for (uint32_t i = 0; i < BAND_TABLE_SIZE; i++) {
+        float32_t other;
+        if (param_id == band_table[i].min_id) {
+            Detection_Params_GetValue(band_table[i].max_id, &other);
+            if (!(value < other)) {
+                printf("PARAMS: %s=%.6f not below band max %.6f\r\n", desc->name, value, other);
+                return -4;
+            }
+        } else if (param_id == band_table[i].max_id) {
+            Detection_Params_GetValue(band_table[i].min_id, &other);
+            if (!(value > other)) {
+                printf("PARAMS: %s=%.6f not above band min %.6f\r\n", desc->name, value, other);
+                return -4;
+            }
+        }
+    }
+
+    uint8_t* base = (uint8_t*)&g_detection_params + desc->offset;
+    if (desc->type == PARAM_TYPE_U32) {
+        *(uint32_t*)base = (uint32_t)(value + 0.5f);
+    } else {
+        *(float32_t*)base = value;
+    }
+
+#if ENABLE_COARSE_DETECTION
+    /* 窗口长度/基线变化需要同步粗检测器状态 */
+    if (param_id == PARAM_ID_RMS_WINDOW_SIZE) {
+        Coarse_Detector_Reset();
+    } else if (param_id == PARAM_ID_BASELINE_RMS) {
+        Coarse_Detector_SetBaseline(value);
+    }
+#endif
+
+    printf("PARAMS: %s set to %.6f\r\n", desc->name, value);
+    return 0;
+}
+
+const uint8_t* Detection_Params_GetIdList(uint8_t* count)
+{
+    if (count) {
+        *count = (uint8_t)PARAM_TABLE_SIZE;
+    }
+    return param_id_list;
+}
+
+void Detection_Params_ResetDefaults(void)
+{
+    memset(&g_detection_params, 0, sizeof(g_detection_params));
+
+#if ENABLE_COARSE_DETECTION
+    g_detection_params.trigger_multiplier     = TRIGGER_MULTIPLIER;
+    g_detection_params.baseline_rms_threshold = BASELINE_RMS_THRESHOLD;
+    g_detection_params.rms_window_size        = RMS_WINDOW_SIZE;
+    g_detection_params.trigger_duration_ms    = TRIGGER_DURATION_MS;
+    g_detection_params.cooldown_time_ms       = COOLDOWN_TIME_MS;
+#endif
+
+#if ENABLE_FINE_DETECTION
+    g_detection_params.low_freq_min  = FINE_DETECTION_LOW_FREQ_MIN;
+    g_detection_params.low_freq_max  = FINE_DETECTION_LOW_FREQ_MAX;
+    g_detection_params.mid_freq_min  = FINE_DETECTION_MID_FREQ_MIN;
+    g_detection_params.mid_freq_max  = FINE_DETECTION_MID_FREQ_MAX;
+    g_detection_params.high_freq_min = FINE_DETECTION_HIGH_FREQ_MIN;
+    g_detection_params.high_freq_max = FINE_DETECTION_HIGH_FREQ_MAX;
+
+    g_detection_params.low_freq_threshold   = FINE_DETECTION_LOW_FREQ_THRESHOLD;
+    g_detection_params.mid_freq_threshold   = FINE_DETECTION_MID_FREQ_THRESHOLD;
+    g_detection_params.dominant_freq_max    = FINE_DETECTION_DOMINANT_FREQ_MAX;
+    g_detection_params.centroid_max         = FINE_DETECTION_CENTROID_MAX;
+    g_detection_params.confidence_threshold = FINE_DETECTION_CONFIDENCE_THRESHOLD;
+#endif
+}
+
+void Detection_Params_Print(void)
+{
+    printf("=== DETECTION PARAMS ===\r\n");
+    for (uint32_t i = 0; i < PARAM_TABLE_SIZE; i++) {
+        float32_t value = 0.0f;
+        Detection_Params_GetValue(param_table[i].id, &value);
+        printf("  [0x%02X] %s = %.6f\r\n", param_table[i].id, param_table[i].name, value);
+    }
+    printf("========================\r\n");
+}
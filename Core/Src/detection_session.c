@@ -0,0 +1,298 @@
+/**
+ * @file detection_session.c
+ * @brief 低功耗唤醒检测会话实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 会话只观察检测链 (样本计数、粗检测、状态机、LoRa、延后FFT任务)，不改变检测算法。
+ */
+
+#include "detection_session.h"
+#include "main.h"
+#include "detection_params.h"
+#include "lora_transport.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 私有变量 */
+static detection_session_t session;
+static detection_session_stats_t stats;
+
+static const char* const phase_names[DETECTION_PHASE_COUNT] = {
+    "idle", "warmup", "coarse", "analysis", "alarm"
+};
+static const char* const end_names[DETECTION_END_COUNT] = {
+    "none", "quiet", "normal", "alarm", "budget"
+};
+
+/* 私有函数声明 */
+static void enter_phase(detection_phase_t phase, uint32_t now_ms, uint32_t samples);
+static void finish(detection_end_t reason, uint32_t now_ms, uint32_t samples);
+static detection_phase_t implied_phase(void);
+static bool coarse_quiet(void);
+static uint32_t trigger_count(void);
+
+int Detection_Session_Begin(void)
+{
+    int rc = session.active ? -1 : 0;
+    uint32_t now = HAL_GetTick();
+    uint32_t samples = Vibration_Pipeline_GetSampleCount();
+
+    memset(&session, 0, sizeof(session));
+    session.active = true;
+    session.start_ms = now;
+    session.start_samples = samples;
+    session.trigger_base = trigger_count();
+    stats.sessions++;
+    enter_phase(DETECTION_PHASE_WARMUP, now, samples);
+
+    return rc;
+}
+
+bool Detection_Session_Process(void)
+{
+    if (!session.active) {
+        return true;
+    }
+
+    uint32_t now = HAL_GetTick();
+    uint32_t samples = Vibration_Pipeline_GetSampleCount();
+
+    // 状态机进入触发/报警状态时按实际进展升级阶段 (不回退)
+    detection_phase_t implied = implied_phase();
+    if (implied > session.phase) {
+        enter_phase(implied, now, samples);
+    }
+
+    bool lora_busy = LoRa_Transport_IsBusy();
+#if ENABLE_FFT_DEFERRED
+    bool dsp_busy = FFT_Worker_Pending();
+#else
+    bool dsp_busy = false;
+#endif
+
+    detection_end_t reason = DETECTION_END_NONE;
+
+    switch (session.phase) {
+        case DETECTION_PHASE_WARMUP:
+            if (samples - session.phase_start_samples >= DETECTION_WARMUP_SAMPLES) {
+                enter_phase(DETECTION_PHASE_COARSE, now, samples);
+            }
+            break;
+
+        case DETECTION_PHASE_COARSE:
+            // 一个完整的新窗口低于触发电平即可证明安静
+            if (samples - session.phase_start_samples >= Detection_Params_Get()->rms_window_size &&
+                coarse_quiet()) {
+                reason = DETECTION_END_QUIET;
+            }
+            break;
+
+        case DETECTION_PHASE_ANALYSIS:
+            if (implied == DETECTION_PHASE_IDLE && !dsp_busy) {
+                reason = DETECTION_END_NORMAL;
+            }
+            break;
+
+        case DETECTION_PHASE_ALARM:
+            if (implied == DETECTION_PHASE_IDLE && !lora_busy) {
+                reason = DETECTION_END_ALARM;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (reason == DETECTION_END_NONE) {
+        detection_budget_t budget = Detection_Session_GetBudget(session.phase);
+        uint32_t phase_ms = now - session.phase_start_ms;
+        uint32_t phase_samples = samples - session.phase_start_samples;
+
+        if ((budget.max_ms > 0 && phase_ms >= budget.max_ms) ||
+            (budget.max_samples > 0 && phase_samples >= budget.max_samples)) {
+            reason = DETECTION_END_BUDGET;
+        }
+    }
+
+    // LoRa收发和延后的FFT任务有各自的超时，完成前不能休眠
+    if (reason == DETECTION_END_NONE || lora_busy || dsp_busy) {
+        return false;
+    }
+
+    finish(reason, now, samples);
+    return true;
+}
+
+detection_phase_t Detection_Session_GetPhase(void)
+{
+    return session.phase;
+}
+
+const detection_session_t* Detection_Session_Get(void)
+{
+    return &session;
+}
+
+const detection_session_stats_t* Detection_Session_GetStats(void)
+{
+    return &stats;
+}
+
+detection_budget_t Detection_Session_GetBudget(detection_phase_t phase)
+{
+    detection_budget_t budget = {0, 0};
+
+    switch (phase) {
+        case DETECTION_PHASE_WARMUP:
+            budget.max_samples = DETECTION_WARMUP_SAMPLES;
+            budget.max_ms = DETECTION_WARMUP_BUDGET_MS;
+            break;
+        case DETECTION_PHASE_COARSE:
+            budget.max_samples = DETECTION_COARSE_WINDOWS * Detection_Params_Get()->rms_window_size;
+            budget.max_ms = DETECTION_COARSE_BUDGET_MS;
+            break;
+        case DETECTION_PHASE_ANALYSIS:
+            budget.max_samples = DETECTION_ANALYSIS_SAMPLES;
+            budget.max_ms = DETECTION_ANALYSIS_BUDGET_MS;
+            break;
+        case DETECTION_PHASE_ALARM:
+            budget.max_ms = DETECTION_ALARM_BUDGET_MS;
+            break;
+        default:
+            break;
+    }
+
+    return budget;
+}
+
+const char* Detection_Session_PhaseName(detection_phase_t phase)
+{
+    return (phase < DETECTION_PHASE_COUNT) ? phase_names[phase] : "?";
+}
+
+const char* Detection_Session_EndName(detection_end_t reason)
+{
+    return (reason < DETECTION_END_COUNT) ? end_names[reason] : "?";
+}
+
+void Detection_Session_PrintStats(void)
+{
+    if (stats.sessions == 0) {
+        return;
+    }
+
+    uint32_t ended = stats.sessions - (session.active ? 1U : 0U);
+    printf("=== DETECTION SESSIONS (%lu, avg %lu ms, max %lu ms) ===\r\n", stats.sessions,
+           ended ? (uint32_t)(stats.total_ms / ended) : 0U, stats.max_ms);
+    printf("  End: quiet %lu, normal %lu, alarm %lu, budget %lu\r\n",
+           stats.end_count[DETECTION_END_QUIET], stats.end_count[DETECTION_END_NORMAL],
+           stats.end_count[DETECTION_END_ALARM], stats.end_count[DETECTION_END_BUDGET]);
+    for (int i = DETECTION_PHASE_WARMUP; i < DETECTION_PHASE_COUNT; i++) {
+        detection_budget_t budget = Detection_Session_GetBudget((detection_phase_t)i);
+        uint32_t entered = stats.phase_entered[i];
+        printf("  %-8s entered %5lu  avg %5lu ms  budget %4lu samples / %5lu ms  exceeded %lu\r\n",
+               phase_names[i], entered, entered ? (uint32_t)(stats.phase_ms_total[i] / entered) : 0U,
+               budget.max_samples, budget.max_ms, stats.budget_exceeded[i]);
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 结算当前阶段并进入新阶段
+ */
+static void enter_phase(detection_phase_t phase, uint32_t now_ms, uint32_t samples)
+{
+    if (session.phase != DETECTION_PHASE_IDLE) {
+        uint32_t ms = now_ms - session.phase_start_ms;
+        session.phase_ms[session.phase] += ms;
+        session.phase_samples[session.phase] += samples - session.phase_start_samples;
+        stats.phase_ms_total[session.phase] += ms;
+    }
+
+    session.phase = phase;
+    session.phase_start_ms = now_ms;
+    session.phase_start_samples = samples;
+    if (phase != DETECTION_PHASE_IDLE) {
+        stats.phase_entered[phase]++;
+    }
+}
+
+static void finish(detection_end_t reason, uint32_t now_ms, uint32_t samples)
+{
+    session.end_phase = session.phase;
+    if (reason == DETECTION_END_BUDGET) {
+        stats.budget_exceeded[session.phase]++;
+    }
+    enter_phase(DETECTION_PHASE_IDLE, now_ms, samples);
+
+    session.active = false;
+    session.end_reason = reason;
+    session.duration_ms = now_ms - session.start_ms;
+
+    stats.end_count[reason]++;
+    stats.total_ms += session.duration_ms;
+    if (session.duration_ms > stats.max_ms) {
+        stats.max_ms = session.duration_ms;
+    }
+}
+
+/**
+ * @brief 状态机当前状态对应的会话阶段 (MONITORING等稳定状态为IDLE)
+ */
+static detection_phase_t implied_phase(void)
+{
+#if ENABLE_SYSTEM_STATE_MACHINE
+    switch (System_State_Machine_GetCurrentState()) {
+        case STATE_COARSE_TRIGGERED:
+        case STATE_FINE_ANALYSIS:
+            return DETECTION_PHASE_ANALYSIS;
+
+        case STATE_MINING_DETECTED:
+        case STATE_ALARM_SENDING:
+        case STATE_ALARM_COMPLETE:
+        case STATE_ERROR_HANDLING:
+            return DETECTION_PHASE_ALARM;
+
+        default:
+            return DETECTION_PHASE_IDLE;
+    }
+#elif ENABLE_COARSE_DETECTION
+    return (Coarse_Detector_GetState() == COARSE_STATE_TRIGGERED) ? DETECTION_PHASE_ANALYSIS
+                                                                  : DETECTION_PHASE_IDLE;
+#else
+    return DETECTION_PHASE_IDLE;
+#endif
+}
+
+/**
+ * @brief 粗检测窗口安静：本会话无新触发、未处于触发状态 (或该次触发已序贯判定) 且RMS低于触发电平
+ */
+static bool coarse_quiet(void)
+{
+#if ENABLE_COARSE_DETECTION
+    const coarse_detector_t *cd = Coarse_Detector_GetInfo();
+#if ENABLE_SEQUENTIAL_DECISION
+    bool settled = cd->state != COARSE_STATE_TRIGGERED || Sequential_Decision_IsDecided();
+#else
+    bool settled = cd->state != COARSE_STATE_TRIGGERED;
+#endif
+
+    return trigger_count() == session.trigger_base && settled &&
+           cd->current_rms < Detection_Params_Get()->trigger_multiplier * cd->baseline_rms;
+#else
+    return true;
+#endif
+}
+
+static uint32_t trigger_count(void)
+{
+#if ENABLE_COARSE_DETECTION
+    return Coarse_Detector_GetInfo()->trigger_count;
+#else
+    return 0;
+#endif
+}
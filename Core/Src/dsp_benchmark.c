@@ -0,0 +1,363 @@
+/**
+ * @file dsp_benchmark.c
+ * @brief 检测流水线DSP内核周期级基准测试实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 每次重复前重新生成输入 (生成时间不计入)，计时只包住内核本身。
+ * 工作缓冲区为静态分配的2*DSP_BENCH_MAX_SIZE个float (2048点时16KB)，
+ * 不与FFT处理器共用，基准测试不会破坏正在采集的帧。
+ */
+
+#include "dsp_benchmark.h"
+
+#if ENABLE_DSP_BENCHMARK
+
+#include "example-raw-data.h"
+#include "fft_processor.h"
+#include "detection_params.h"
+#include "dwt_timer.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define BENCH_STAGES            (HIGHPASS_FILTER_ORDER / 2)
+#define BENCH_SIGNAL_FREQ_1     12.0f       // Hz, 挖掘频段
+#define BENCH_SIGNAL_FREQ_2     60.0f       // Hz, 高频干扰
+#define BENCH_PI                3.14159265f
+
+/* 私有变量 */
+static float32_t bench_buffer[2 * DSP_BENCH_MAX_SIZE];
+static float32_t rms_window[RMS_WINDOW_SIZE];
+static dsp_bench_result_t bench_results[DSP_BENCH_MAX_RESULTS];
+static uint16_t bench_result_count = 0;
+static volatile float32_t bench_sink;       // 防止编译器优化掉内核输出
+
+static const char *const kernel_names[DSP_BENCH_KERNEL_COUNT] = {
+    "biquad_sample", "biquad_block", "rms_window", "rms_running", "cfft", "rfft",
+    "magnitude", "magnitude_sq", "band_energy", "centroid", "fine_detector"
+};
+
+/* 私有函数声明 */
+static void fill_signal(float32_t *dst, uint32_t n);
+static void fill_spectrum(uint32_t n);
+static const arm_cfft_instance_f32* cfft_instance(uint32_t n);
+static int prepare(dsp_bench_kernel_t kernel, uint32_t n, arm_rfft_fast_instance_f32 *rfft);
+static void run_kernel(dsp_bench_kernel_t kernel, uint32_t n, arm_rfft_fast_instance_f32 *rfft);
+static void biquad_per_sample(const float32_t *in, float32_t *out, uint32_t n);
+static void biquad_block(const float32_t *in, float32_t *out, uint32_t n);
+static void rms_recompute(const float32_t *in, uint32_t n);
+static void rms_running(const float32_t *in, uint32_t n);
+
+int DSP_Benchmark_Run(void)
+{
+    arm_rfft_fast_instance_f32 rfft;
+
+    bench_result_count = 0;
+    for (uint8_t k = 0; k < DSP_BENCH_KERNEL_COUNT; k++) {
+        for (uint32_t n = DSP_BENCH_MIN_SIZE; n <= DSP_BENCH_MAX_SIZE; n <<= 1) {
+            if (bench_result_count >= DSP_BENCH_MAX_RESULTS) {
+                return bench_result_count;
+            }
+
+            dsp_bench_result_t *result = &bench_results[bench_result_count];
+            result->kernel = k;
+            result->size = (uint16_t)n;
+            result->cycles_min = 0xFFFFFFFFU;
+            result->cycles_max = 0;
+
+            bool measured = false;
+            for (uint8_t r = 0; r < DSP_BENCH_REPEATS; r++) {
+                if (prepare((dsp_bench_kernel_t)k, n, &rfft) != 0) {
+                    break;      // 该尺寸不适用 (细检测只支持FFT_SIZE)
+                }
+
+                uint32_t start = DWT_Timer_GetCycles();
+                run_kernel((dsp_bench_kernel_t)k, n, &rfft);
+                uint32_t cycles = DWT_Timer_GetCycles() - start;
+
+                if (cycles < result->cycles_min) {
+                    result->cycles_min = cycles;
+                }
+                if (cycles > result->cycles_max) {
+                    result->cycles_max = cycles;
+                }
+                measured = true;
+            }
+
+            if (measured) {
+                bench_result_count++;
+            }
+        }
+    }
+
+    return bench_result_count;
+}
+
+const dsp_bench_result_t* DSP_Benchmark_GetResults(uint16_t *count)
+{
+    if (count != NULL) {
+        *count = bench_result_count;
+    }
+    return bench_results;
+}
+
+const char* DSP_Benchmark_GetKernelName(uint8_t kernel)
+{
+    return (kernel < DSP_BENCH_KERNEL_COUNT) ? kernel_names[kernel] : "?";
+}
+
+void DSP_Benchmark_PrintTable(uint32_t counter_hz)
+{
+    printf("=== DSP BENCHMARK (counter %lu Hz, min of %d runs) ===\r\n",
+           counter_hz, DSP_BENCH_REPEATS);
+    printf("%-14s %5s %10s %8s %10s %10s %9s %9s\r\n",
+           "kernel", "N", "cycles", "cyc/pt", "us@84MHz", "us@168MHz", "uJ@84MHz", "uJ@168MHz");
+
+    for (uint16_t i = 0; i < bench_result_count; i++) {
+        const dsp_bench_result_t *result = &bench_results[i];
+        float32_t us_84 = (float32_t)result->cycles_min / 84.0f;
+        float32_t us_168 = (float32_t)result->cycles_min / 168.0f;
+
+        printf("%-14s %5u %10lu %8.2f %10.2f %10.2f %9.3f %9.3f\r\n",
+               DSP_Benchmark_GetKernelName(result->kernel), result->size, result->cycles_min,
+               (float32_t)result->cycles_min / (float32_t)result->size, us_84, us_168,
+               DSP_BENCH_RUN_MA_84MHZ * DSP_BENCH_SUPPLY_V * us_84 / 1000.0f,
+               DSP_BENCH_RUN_MA_168MHZ * DSP_BENCH_SUPPLY_V * us_168 / 1000.0f);
+    }
+    printf("========================\r\n");
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 1kHz采样的双音信号加确定性噪声 (每次结果可复现)
+ */
+static void fill_signal(float32_t *dst, uint32_t n)
+{
+    uint32_t seed = 12345;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t t = (float32_t)i / SAMPLING_FREQUENCY;
+        seed = seed * 1103515245U + 12345U;
+        dst[i] = 0.05f * sinf(2.0f * BENCH_PI * BENCH_SIGNAL_FREQ_1 * t) +
+                 0.02f * sinf(2.0f * BENCH_PI * BENCH_SIGNAL_FREQ_2 * t) +
+                 0.002f * ((float32_t)(seed >> 16) / 65536.0f - 0.5f);
+    }
+}
+
+/**
+ * @brief 在bench_buffer[0..n/2]生成单边幅值谱 (与fft_transform相同的归一化)
+ */
+static void fill_spectrum(uint32_t n)
+{
+    float32_t *signal = &bench_buffer[DSP_BENCH_MAX_SIZE];
+
+    fill_signal(signal, n);
+    for (uint32_t i = 0; i < n; i++) {      // 就地交织：写入位置只覆盖已读过的样本
+        bench_buffer[2 * i] = signal[i];
+        bench_buffer[2 * i + 1] = 0.0f;
+    }
+    arm_cfft_f32(cfft_instance(n), bench_buffer, 0, 1);
+    arm_cmplx_mag_f32(bench_buffer, bench_buffer, n);
+    for (uint32_t i = 0; i <= n / 2; i++) {
+        bench_buffer[i] *= ((i > 0 && i < n / 2) ? 2.0f : 1.0f) / (float32_t)n;
+    }
+}
+
+static const arm_cfft_instance_f32* cfft_instance(uint32_t n)
+{
+    switch (n) {
+        case 256:  return &arm_cfft_sR_f32_len256;
+        case 512:  return &arm_cfft_sR_f32_len512;
+        case 1024: return &arm_cfft_sR_f32_len1024;
+        default:   return &arm_cfft_sR_f32_len2048;
+    }
+}
+
+/**
+ * @brief 准备输入 (不计时)
+ * @return 0: 就绪, -1: 该尺寸不适用
+ */
+static int prepare(dsp_bench_kernel_t kernel, uint32_t n, arm_rfft_fast_instance_f32 *rfft)
+{
+    switch (kernel) {
+        case DSP_BENCH_BIQUAD_SAMPLE:
+        case DSP_BENCH_BIQUAD_BLOCK:
+        case DSP_BENCH_RMS_WINDOW:
+        case DSP_BENCH_RMS_RUNNING:
+            fill_signal(bench_buffer, n);
+            memset(rms_window, 0, sizeof(rms_window));
+            return 0;
+
+        case DSP_BENCH_CFFT:
+        case DSP_BENCH_MAGNITUDE:
+        case DSP_BENCH_MAGNITUDE_SQUARED:
+            fill_signal(&bench_buffer[DSP_BENCH_MAX_SIZE], n);
+            for (uint32_t i = 0; i < n; i++) {
+                bench_buffer[2 * i] = bench_buffer[DSP_BENCH_MAX_SIZE + i];
+                bench_buffer[2 * i + 1] = 0.0f;
+            }
+            if (kernel != DSP_BENCH_CFFT) {
+                arm_cfft_f32(cfft_instance(n), bench_buffer, 0, 1);
+            }
+            return 0;
+
+        case DSP_BENCH_RFFT:
+            fill_signal(bench_buffer, n);
+            return (arm_rfft_fast_init_f32(rfft, (uint16_t)n) == ARM_MATH_SUCCESS) ? 0 : -1;
+
+        case DSP_BENCH_BAND_ENERGY:
+        case DSP_BENCH_CENTROID:
+            fill_spectrum(n);
+            return 0;
+
+        case DSP_BENCH_FINE_DETECTOR:
+            if (n != FFT_SIZE) {
+                return -1;
+            }
+            fill_spectrum(n);
+            return 0;
+
+        default:
+            return -1;
+    }
+}
+
+static void run_kernel(dsp_bench_kernel_t kernel, uint32_t n, arm_rfft_fast_instance_f32 *rfft)
+{
+    const detection_params_t *params = Detection_Params_Get();
+    uint32_t bins = n / 2 + 1;
+
+    switch (kernel) {
+        case DSP_BENCH_BIQUAD_SAMPLE:
+            biquad_per_sample(bench_buffer, &bench_buffer[n], n);
+            break;
+
+        case DSP_BENCH_BIQUAD_BLOCK:
+            biquad_block(bench_buffer, &bench_buffer[n], n);
+            break;
+
+        case DSP_BENCH_RMS_WINDOW:
+            rms_recompute(bench_buffer, n);
+            break;
+
+        case DSP_BENCH_RMS_RUNNING:
+            rms_running(bench_buffer, n);
+            break;
+
+        case DSP_BENCH_CFFT:
+            arm_cfft_f32(cfft_instance(n), bench_buffer, 0, 1);
+            break;
+
+        case DSP_BENCH_RFFT:
+            arm_rfft_fast_f32(rfft, bench_buffer, &bench_buffer[n], 0);
+            break;
+
+        case DSP_BENCH_MAGNITUDE:
+            arm_cmplx_mag_f32(bench_buffer, bench_buffer, n);
+            break;
+
+        case DSP_BENCH_MAGNITUDE_SQUARED:
+            arm_cmplx_mag_squared_f32(bench_buffer, bench_buffer, n);
+            break;
+
+        case DSP_BENCH_BAND_ENERGY:
+            bench_sink = Fine_Detector_TotalEnergy(bench_buffer, bins) +
+                Fine_Detector_BandEnergy(bench_buffer, bins, params->low_freq_min, params->low_freq_max) +
+                Fine_Detector_BandEnergy(bench_buffer, bins, params->mid_freq_min, params->mid_freq_max) +
+                Fine_Detector_BandEnergy(bench_buffer, bins, params->high_freq_min, params->high_freq_max);
+            break;
+
+        case DSP_BENCH_CENTROID:
+            bench_sink = Fine_Detector_SpectralCentroid(bench_buffer, bins);
+            break;
+
+        case DSP_BENCH_FINE_DETECTOR: {
+            fine_detection_features_t features;
+            Fine_Detector_Extract(bench_buffer, bins, BENCH_SIGNAL_FREQ_1, &features);
+            bench_sink = features.confidence_score;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 逐样本直接I型级联biquad，与Highpass_Filter_Process的每样本运算相同
+ */
+static void biquad_per_sample(const float32_t *in, float32_t *out, uint32_t n)
+{
+    const float32_t *c = Highpass_Filter_GetCoeffs();
+    float32_t state[BENCH_STAGES][4] = {{0.0f}};   // x1, x2, y1, y2
+
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t x = in[i];
+        for (uint32_t s = 0; s < BENCH_STAGES; s++) {
+            const float32_t *k = &c[5 * s];
+            float32_t *z = state[s];
+            float32_t y = k[0] * x + k[1] * z[0] + k[2] * z[1] + k[3] * z[2] + k[4] * z[3];
+            z[1] = z[0]; z[0] = x;
+            z[3] = z[2]; z[2] = y;
+            x = y;
+        }
+        out[i] = x;
+    }
+}
+
+static void biquad_block(const float32_t *in, float32_t *out, uint32_t n)
+{
+    arm_biquad_casd_df1_inst_f32 instance;
+    float32_t state[4 * BENCH_STAGES] = {0.0f};    // DF1每段4个状态
+
+    instance.numStages = BENCH_STAGES;
+    instance.pCoeffs = (float32_t *)Highpass_Filter_GetCoeffs();
+    instance.pState = state;
+    arm_biquad_cascade_df1_f32(&instance, (float32_t *)in, out, n);
+}
+
+/**
+ * @brief 每个样本重新累加整个窗口 (Coarse_Detector_Process现行做法)
+ */
+static void rms_recompute(const float32_t *in, uint32_t n)
+{
+    uint32_t index = 0;
+    float32_t rms = 0.0f;
+
+    for (uint32_t i = 0; i < n; i++) {
+        rms_window[index] = in[i] * in[i];
+        index = (index + 1) % RMS_WINDOW_SIZE;
+
+        float32_t sum_squares = 0.0f;
+        for (uint32_t w = 0; w < RMS_WINDOW_SIZE; w++) {
+            sum_squares += rms_window[w];
+        }
+        rms = sqrtf(sum_squares / RMS_WINDOW_SIZE);
+    }
+    bench_sink = rms;
+}
+
+/**
+ * @brief 滑动累加和：加入新平方值、减去被替换的旧值
+ */
+static void rms_running(const float32_t *in, uint32_t n)
+{
+    uint32_t index = 0;
+    float32_t sum_squares = 0.0f;
+    float32_t rms = 0.0f;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t square = in[i] * in[i];
+        sum_squares += square - rms_window[index];
+        rms_window[index] = square;
+        index = (index + 1) % RMS_WINDOW_SIZE;
+        rms = sqrtf(sum_squares / RMS_WINDOW_SIZE);
+    }
+    bench_sink = rms;
+}
+
+#endif /* ENABLE_DSP_BENCHMARK */
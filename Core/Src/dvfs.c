@@ -0,0 +1,454 @@
+/**
+ * @file dvfs.c
+ * @brief 按系统状态切换内核频率 (DVFS) 实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 切换前先结算DWT微秒时钟 (DWT_Timer_GetTimeUs按当前SystemCoreClock换算周期数)，
+ * HAL_RCC_ClockConfig更新SystemCoreClock并按新HCLK重配SysTick。
+ */
+
+#include "dvfs.h"
+#include "main.h"
+#include "clock_config_84mhz.h"
+#include "dwt_timer.h"
+#include "power_account.h"
+#include "host_protocol.h"
+#include "modbus_rtu.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 外部变量声明 */
+extern UART_HandleTypeDef huart1;
+extern UART_HandleTypeDef huart5;
+extern SPI_HandleTypeDef hspi1;
+
+static const dvfs_op_config_t op_configs[DVFS_OP_COUNT] = {
+    [DVFS_OP_MONITOR]  = { "21MHz",  21000000U,  RCC_PLLP_DIV4, RCC_SYSCLK_DIV4, RCC_HCLK_DIV1, RCC_HCLK_DIV1,
+                           FLASH_LATENCY_0, PWR_REGULATOR_VOLTAGE_SCALE2, DVFS_RUN_MA_21MHZ, DVFS_SLEEP_MA_21MHZ },
+    [DVFS_OP_NOMINAL]  = { "84MHz",  84000000U,  RCC_PLLP_DIV4, RCC_SYSCLK_DIV1, RCC_HCLK_DIV2, RCC_HCLK_DIV1,
+                           FLASH_LATENCY_2, PWR_REGULATOR_VOLTAGE_SCALE2, DVFS_RUN_MA_84MHZ, DVFS_SLEEP_MA_84MHZ },
+    [DVFS_OP_ANALYSIS] = { "168MHz", 168000000U, RCC_PLLP_DIV2, RCC_SYSCLK_DIV1, RCC_HCLK_DIV4, RCC_HCLK_DIV2,
+                           FLASH_LATENCY_5, PWR_REGULATOR_VOLTAGE_SCALE1, DVFS_RUN_MA_168MHZ, DVFS_SLEEP_MA_168MHZ },
+};
+
+/* 私有变量 */
+static dvfs_stats_t stats;
+static bool initialized = false;
+static uint32_t spi1_target_hz = 0;         // 上电配置下的SPI1时钟，各工作点保持不变
+static uint32_t last_switch_ms = 0;
+static uint64_t segment_start_us = 0;       // 当前工作点驻留段起点
+static uint64_t segment_run_start_us = 0;
+static uint64_t detection_start_us = 0;     // 本次检测 (ANALYSIS段) 起点
+static uint64_t detection_run_start_us = 0;
+
+/* 私有函数声明 */
+static dvfs_op_t op_for_state(system_state_t state);
+static bool peripherals_idle(void);
+static int apply_clock(const dvfs_op_config_t *cfg);
+static void rederive_peripherals(void);
+static void uart_set_baud(UART_HandleTypeDef *huart, uint32_t pclk);
+static uint32_t uart_pclk(const dvfs_op_config_t *cfg, const UART_HandleTypeDef *huart);
+static bool uart_baud_fits(const UART_HandleTypeDef *huart, uint32_t pclk);
+static uint64_t run_time_us(void);
+static void account_segment(void);
+
+int Dvfs_Init(void)
+{
+    memset(&stats, 0, sizeof(stats));
+
+    // SPI1按上电时的PCLK2和预分频确定目标时钟 (BR = 预分频 2^(n+1))
+    uint32_t br = (hspi1.Init.BaudRatePrescaler & SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+    spi1_target_hz = HAL_RCC_GetPCLK2Freq() >> (br + 1U);
+
+    // 上电时钟即84MHz，只有调压等级 (Scale 1) 不同：重新锁定PLL切到Scale 2。
+    // 启动输出仍在发送时跳过，以Scale 1运行到首次切换
+    int rc = 0;
+    if (peripherals_idle()) {
+        rc = apply_clock(&op_configs[DVFS_OP_NOMINAL]);
+        if (rc != 0) {
+            SystemClock_Config();
+            stats.switch_errors++;
+        }
+        rederive_peripherals();
+    }
+
+    stats.op = DVFS_OP_NOMINAL;
+    stats.enter_count[DVFS_OP_NOMINAL] = 1;
+    segment_start_us = DWT_Timer_GetTimeUs();
+    segment_run_start_us = run_time_us();
+    last_switch_ms = HAL_GetTick();
+    initialized = true;
+
+    printf("DVFS: %s, SPI1 %lu Hz, ops %s/%s/%s\r\n", ENABLE_DVFS ? "enabled" : "disabled",
+           spi1_target_hz, op_configs[DVFS_OP_MONITOR].name, op_configs[DVFS_OP_NOMINAL].name,
+           op_configs[DVFS_OP_ANALYSIS].name);
+    return (rc == 0) ? 0 : -1;
+}
+
+void Dvfs_Process(void)
+{
+    if (!initialized) {
+        return;
+    }
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    dvfs_op_t target = op_for_state(System_State_Machine_GetCurrentState());
+
+    if (target == stats.op) {
+        return;
+    }
+    // 降频前保持最短停留，状态在触发/监测之间抖动时不反复重新锁定PLL
+    if (target < stats.op && (HAL_GetTick() - last_switch_ms) < DVFS_MIN_DWELL_MS) {
+        return;
+    }
+
+    Dvfs_SetOperatingPoint(target);
+#endif
+}
+
+int Dvfs_SetOperatingPoint(dvfs_op_t op)
+{
+    if (!initialized || op >= DVFS_OP_COUNT) {
+        return -1;
+    }
+    if (op == stats.op) {
+        return 0;
+    }
+    if (!peripherals_idle()) {
+        stats.deferred_count++;
+        return -3;
+    }
+    // 分频后BRR < 16的波特率无法实现，保持当前工作点
+    if (!uart_baud_fits(&huart1, uart_pclk(&op_configs[op], &huart1)) ||
+        !uart_baud_fits(&huart5, uart_pclk(&op_configs[op], &huart5))) {
+        stats.refused_count++;
+        return -4;
+    }
+
+    // 结算旧工作点 (DWT周期按旧频率换算)，切换耗时计入新工作点
+    dvfs_op_t previous = stats.op;
+    account_segment();
+    if (previous == DVFS_OP_ANALYSIS) {
+        stats.detections++;
+    }
+
+    uint32_t start = DWT_Timer_GetCycles();
+    int rc = apply_clock(&op_configs[op]);
+    if (rc != 0) {
+        // 中途失败可能停在HSI，按上电配置完整重配 (失败时Error_Handler)
+        SystemClock_Config();
+        stats.switch_errors++;
+        op = DVFS_OP_NOMINAL;
+    }
+    rederive_peripherals();
+
+    // 切换期间的周期数按新频率换算，PLL重新锁定时在HSI下运行，结果为近似值
+    stats.last_switch_us = DWT_Timer_ElapsedUs(start);
+    if (stats.last_switch_us > stats.max_switch_us) {
+        stats.max_switch_us = stats.last_switch_us;
+    }
+
+    stats.op = op;
+    stats.enter_count[op]++;
+    last_switch_ms = HAL_GetTick();
+
+    if (op == DVFS_OP_ANALYSIS) {
+        detection_start_us = segment_start_us;
+        detection_run_start_us = segment_run_start_us;
+    }
+
+    return (rc == 0) ? 0 : -2;
+}
+
+dvfs_op_t Dvfs_GetOperatingPoint(void)
+{
+    return stats.op;
+}
+
+const dvfs_op_config_t* Dvfs_GetOpConfig(dvfs_op_t op)
+{
+    return (op < DVFS_OP_COUNT) ? &op_configs[op] : NULL;
+}
+
+uint32_t Dvfs_GetMinUartClock(const UART_HandleTypeDef *huart)
+{
+#if ENABLE_DVFS
+    uint32_t min = UINT32_MAX;
+    for (int i = 0; i < DVFS_OP_COUNT; i++) {
+        uint32_t pclk = uart_pclk(&op_configs[i], huart);
+        if (pclk < min) {
+            min = pclk;
+        }
+    }
+    return min;
+#else
+    return (huart->Instance == USART1 || huart->Instance == USART6) ?
+           HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+#endif
+}
+
+void Dvfs_NotifyClockReset(void)
+{
+    if (!initialized) {
+        return;
+    }
+
+    account_segment();
+    if (stats.op == DVFS_OP_ANALYSIS) {
+        stats.detections++;
+    }
+    rederive_peripherals();
+    stats.op = DVFS_OP_NOMINAL;
+    stats.enter_count[DVFS_OP_NOMINAL]++;
+    last_switch_ms = HAL_GetTick();
+}
+
+const dvfs_stats_t* Dvfs_GetStats(void)
+{
+    if (initialized) {
+        account_segment();
+    }
+    return &stats;
+}
+
+float32_t Dvfs_EstimateDetectionEnergy(dvfs_op_t op)
+{
+    if (op >= DVFS_OP_COUNT || stats.detections == 0) {
+        return -1.0f;
+    }
+
+    const dvfs_op_config_t *cfg = &op_configs[op];
+    float32_t wall_us = (float32_t)stats.detection_us / stats.detections;
+    float32_t cycles = (float32_t)stats.detection_cycles / stats.detections;
+    float32_t run_us = cycles / (cfg->hclk_hz / 1000000U);
+
+    if (run_us > wall_us) {
+        return -1.0f;
+    }
+
+    // mA x us x V = nJ
+    float32_t nj = (run_us * cfg->run_ma + (wall_us - run_us) * cfg->sleep_ma) * DVFS_SUPPLY_V;
+    return nj * 1e-6f;
+}
+
+void Dvfs_PrintStats(void)
+{
+    const dvfs_stats_t *s = Dvfs_GetStats();
+
+    if (!initialized) {
+        return;
+    }
+
+    printf("=== DVFS (%s, switch last %lu us / max %lu us, deferred %lu, refused %lu, errors %lu) ===\r\n",
+           op_configs[s->op].name, s->last_switch_us, s->max_switch_us, s->deferred_count, s->refused_count,
+           s->switch_errors);
+    for (int i = 0; i < DVFS_OP_COUNT; i++) {
+        printf("  %-6s entered %5lu  time %8lu ms  run %8lu ms\r\n", op_configs[i].name, s->enter_count[i],
+               (uint32_t)(s->time_us[i] / 1000U), (uint32_t)(s->run_us[i] / 1000U));
+    }
+    if (s->detections > 0) {
+        printf("  Detections: %lu, avg %lu ms wall, %lu kcycles\r\n", s->detections,
+               (uint32_t)(s->detection_us / s->detections / 1000U),
+               (uint32_t)(s->detection_cycles / s->detections / 1000U));
+        for (int i = 0; i < DVFS_OP_COUNT; i++) {
+            float32_t mj = Dvfs_EstimateDetectionEnergy((dvfs_op_t)i);
+            if (mj < 0.0f) {
+                printf("  Energy/detection @%-6s: overrun (cannot keep up)\r\n", op_configs[i].name);
+            } else {
+                printf("  Energy/detection @%-6s: %.3f mJ\r\n", op_configs[i].name, mj);
+            }
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 状态 -> 工作点
+ */
+static dvfs_op_t op_for_state(system_state_t state)
+{
+    switch (state) {
+        case STATE_MONITORING:
+        case STATE_IDLE_SLEEP:
+        case STATE_LOW_POWER_SLEEP_PREPARE:
+        case STATE_LOW_POWER_SLEEP_MODE:
+            return DVFS_OP_MONITOR;
+
+        case STATE_COARSE_TRIGGERED:
+        case STATE_FINE_ANALYSIS:
+        case STATE_MINING_DETECTED:
+            return DVFS_OP_ANALYSIS;
+
+        default:
+            return DVFS_OP_NOMINAL;
+    }
+}
+
+/**
+ * @brief UART1/UART5收发都空闲、SPI1空闲 (收发中修改分频会损坏正在移入/移出的字节)
+ *
+ * 循环DMA接收一直处于BUSY_RX，接收空闲按协议模块记录的空闲线事件判断。
+ */
+static bool peripherals_idle(void)
+{
+    return huart1.gState == HAL_UART_STATE_READY && __HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC) != RESET &&
+           huart5.gState == HAL_UART_STATE_READY && __HAL_UART_GET_FLAG(&huart5, UART_FLAG_TC) != RESET &&
+           Host_Protocol_IsRxIdle() && Modbus_RTU_IsRxIdle() &&
+           hspi1.State == HAL_SPI_STATE_READY;
+}
+
+/**
+ * @brief 配置PLL、总线分频、Flash等待周期和调压等级
+ */
+static int apply_clock(const dvfs_op_config_t *cfg)
+{
+    RCC_ClkInitTypeDef clk = {0};
+    uint32_t pllp = (((RCC->PLLCFGR & RCC_PLLCFGR_PLLP) >> RCC_PLLCFGR_PLLP_Pos) + 1U) * 2U;
+    uint32_t vos = READ_BIT(PWR->CR, PWR_CR_VOS);
+
+    clk.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+
+    if (pllp != cfg->pllp || vos != cfg->voltage_scale) {
+        RCC_OscInitTypeDef osc = {0};
+
+        // PLL作为系统时钟时不能重配：先切到HSI (16MHz，0WS)
+        clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+        clk.AHBCLKDivider = RCC_SYSCLK_DIV1;
+        clk.APB1CLKDivider = RCC_HCLK_DIV1;
+        clk.APB2CLKDivider = RCC_HCLK_DIV1;
+        if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_0) != HAL_OK) {
+            return -1;
+        }
+
+        // VOS只能在PLL关闭时修改
+        __HAL_RCC_PLL_DISABLE();
+        uint32_t timeout = CLOCK_RESTORE_TIMEOUT_LOOPS;
+        while (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) != RESET) {
+            if (--timeout == 0U) {
+                return -2;
+            }
+        }
+        __HAL_PWR_VOLTAGESCALING_CONFIG(cfg->voltage_scale);
+
+        osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+        osc.PLL.PLLState = RCC_PLL_ON;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+        osc.PLL.PLLM = PLL_M_VALUE;
+        osc.PLL.PLLN = PLL_N_VALUE;
+        osc.PLL.PLLP = cfg->pllp;
+        osc.PLL.PLLQ = PLL_Q_VALUE;
+        if (HAL_RCC_OscConfig(&osc) != HAL_OK) {
+            return -3;
+        }
+    }
+
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    clk.AHBCLKDivider = cfg->ahb_div;
+    clk.APB1CLKDivider = cfg->apb1_div;
+    clk.APB2CLKDivider = cfg->apb2_div;
+    if (HAL_RCC_ClockConfig(&clk, cfg->flash_latency) != HAL_OK) {
+        return -4;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 按当前PCLK重算UART波特率和SPI1预分频
+ */
+static void rederive_peripherals(void)
+{
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+
+    uart_set_baud(&huart1, pclk2);                      // USART1: APB2
+    uart_set_baud(&huart5, HAL_RCC_GetPCLK1Freq());     // UART5: APB1
+
+    // SPI1 (APB2)：不超过目标时钟的最小预分频
+    uint32_t br = 0;
+    while (br < 7U && (pclk2 >> (br + 1U)) > spi1_target_hz) {
+        br++;
+    }
+    hspi1.Init.BaudRatePrescaler = br << SPI_CR1_BR_Pos;
+    MODIFY_REG(hspi1.Instance->CR1, SPI_CR1_BR, hspi1.Init.BaudRatePrescaler);
+}
+
+static void uart_set_baud(UART_HandleTypeDef *huart, uint32_t pclk)
+{
+    if (huart->Instance == NULL) {
+        return;
+    }
+
+    if (huart->Init.OverSampling == UART_OVERSAMPLING_8) {
+        huart->Instance->BRR = UART_BRR_SAMPLING8(pclk, huart->Init.BaudRate);
+    } else {
+        huart->Instance->BRR = UART_BRR_SAMPLING16(pclk, huart->Init.BaudRate);
+    }
+}
+
+/**
+ * @brief 工作点下UART所在APB总线的时钟 (USART1/USART6在APB2，其余在APB1)
+ */
+static uint32_t uart_pclk(const dvfs_op_config_t *cfg, const UART_HandleTypeDef *huart)
+{
+    uint32_t div = (huart->Instance == USART1 || huart->Instance == USART6) ? cfg->apb2_div : cfg->apb1_div;
+
+    switch (div) {
+        case RCC_HCLK_DIV2:  return cfg->hclk_hz / 2U;
+        case RCC_HCLK_DIV4:  return cfg->hclk_hz / 4U;
+        case RCC_HCLK_DIV8:  return cfg->hclk_hz / 8U;
+        case RCC_HCLK_DIV16: return cfg->hclk_hz / 16U;
+        default:             return cfg->hclk_hz;
+    }
+}
+
+/**
+ * @brief 当前波特率在给定PCLK下能否实现 (USARTDIV >= 1，即BRR >= 16)
+ */
+static bool uart_baud_fits(const UART_HandleTypeDef *huart, uint32_t pclk)
+{
+    if (huart->Instance == NULL || huart->Init.BaudRate == 0U) {
+        return true;
+    }
+
+    uint32_t brr = (huart->Init.OverSampling == UART_OVERSAMPLING_8) ?
+                   UART_BRR_SAMPLING8(pclk, huart->Init.BaudRate) : UART_BRR_SAMPLING16(pclk, huart->Init.BaudRate);
+    return brr >= 16U;
+}
+
+/**
+ * @brief MCU运行时间 (power_account累计；未使能时按墙钟时间)
+ */
+static uint64_t run_time_us(void)
+{
+#if ENABLE_POWER_ACCOUNTING
+    return Power_Account_GetResidency()->load_us[POWER_LOAD_MCU_RUN];
+#else
+    return DWT_Timer_GetTimeUs();
+#endif
+}
+
+/**
+ * @brief 结算当前工作点自上次结算以来的驻留时间，ANALYSIS下同时计入本次检测
+ */
+static void account_segment(void)
+{
+    uint64_t now = DWT_Timer_GetTimeUs();
+    uint64_t run = run_time_us();
+    dvfs_op_t op = stats.op;
+
+    stats.time_us[op] += now - segment_start_us;
+    stats.run_us[op] += run - segment_run_start_us;
+    segment_start_us = now;
+    segment_run_start_us = run;
+
+    if (op == DVFS_OP_ANALYSIS) {
+        stats.detection_us += now - detection_start_us;
+        stats.detection_cycles += (run - detection_run_start_us) * (op_configs[op].hclk_hz / 1000000U);
+        detection_start_us = now;
+        detection_run_start_us = run;
+    }
+}
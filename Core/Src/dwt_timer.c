@@ -0,0 +1,62 @@
+/**
+ * @file dwt_timer.c
+ * @brief DWT周期计数器高精度计时实现
+ * @date 2026-10-19
+ * @version v1.0
+ */
+
+#include "dwt_timer.h"
+
+/* 64位微秒时钟扩展状态 */
+static uint64_t time_us = 0;
+static uint64_t time_remainder_cycles = 0;
+static uint32_t time_last_cycles = 0;
+
+int DWT_Timer_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    time_us = 0;
+    time_remainder_cycles = 0;
+    time_last_cycles = 0;
+
+    /* 计数器不走说明芯片没有实现DWT */
+    __NOP();
+    __NOP();
+    return (DWT->CYCCNT != 0) ? 0 : -1;
+}
+
+uint32_t DWT_Timer_CyclesToUs(uint32_t cycles)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    if (cycles_per_us == 0) {
+        cycles_per_us = 1;
+    }
+    return cycles / cycles_per_us;
+}
+
+uint32_t DWT_Timer_ElapsedUs(uint32_t start_cycles)
+{
+    return DWT_Timer_CyclesToUs(DWT->CYCCNT - start_cycles);
+}
+
+uint64_t DWT_Timer_GetTimeUs(void)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    if (cycles_per_us == 0) {
+        cycles_per_us = 1;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t now = DWT->CYCCNT;
+    time_remainder_cycles += now - time_last_cycles;
+    time_last_cycles = now;
+    time_us += time_remainder_cycles / cycles_per_us;
+    time_remainder_cycles %= cycles_per_us;
+    uint64_t result = time_us;
+    __set_PRIMASK(primask);
+
+    return result;
+}
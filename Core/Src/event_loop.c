@@ -0,0 +1,190 @@
+/**
+ * @file event_loop.c
+ * @brief 事件驱动主循环实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * WFI前先关中断再检查事件掩码，避免"检查为空 -> 中断投递 -> 进入WFI"的竞争：
+ * PRIMASK置位时挂起的中断仍能唤醒WFI，开中断后ISR立即执行。
+ */
+
+#include "event_loop.h"
+#include "dwt_timer.h"
+#include "system_monitor.h"
+#include "power_account.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 私有变量 */
+static volatile uint32_t pending_mask = 0;
+static volatile uint32_t post_cycles[EVENT_COUNT];
+static volatile uint32_t tick_divider = 0;
+static event_loop_stats_t loop_stats;
+static uint32_t window_start_cycles = 0;
+
+/* 私有函数声明 */
+static void accumulate_window(void);
+
+int Event_Loop_Init(void)
+{
+    pending_mask = 0;
+    tick_divider = 0;
+    memset(&loop_stats, 0, sizeof(loop_stats));
+    window_start_cycles = DWT_Timer_GetCycles();
+
+    printf("EVENT_LOOP: %s (tick %d ms)\r\n",
+           ENABLE_EVENT_LOOP ? "WFI event-driven" : "HAL_Delay polling", EVENT_LOOP_TICK_MS);
+    return 0;
+}
+
+void Event_Post(event_id_t id)
+{
+    if (id >= EVENT_COUNT) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!(pending_mask & EVENT_MASK(id))) {
+        post_cycles[id] = DWT_Timer_GetCycles();
+        pending_mask |= EVENT_MASK(id);
+    }
+    loop_stats.events[id].posted++;
+    __set_PRIMASK(primask);
+}
+
+uint32_t Event_Loop_Fetch(void)
+{
+    uint32_t events;
+    uint32_t posted[EVENT_COUNT];
+
+    __disable_irq();
+    events = pending_mask;
+    pending_mask = 0;
+    for (uint8_t i = 0; i < EVENT_COUNT; i++) {
+        posted[i] = post_cycles[i];
+    }
+    __enable_irq();
+
+    if (events == 0) {
+        return 0;
+    }
+
+    uint32_t now = DWT_Timer_GetCycles();
+    for (uint8_t i = 0; i < EVENT_COUNT; i++) {
+        if (events & EVENT_MASK(i)) {
+            event_stats_t *stats = &loop_stats.events[i];
+            uint32_t latency_us = DWT_Timer_CyclesToUs(now - posted[i]);
+            stats->dispatched++;
+            stats->latency_last_us = latency_us;
+            stats->latency_sum_us += latency_us;
+            if (latency_us > stats->latency_max_us) {
+                stats->latency_max_us = latency_us;
+            }
+        }
+    }
+    return events;
+}
+
+void Event_Loop_WaitForEvent(void)
+{
+    accumulate_window();
+
+#if ENABLE_EVENT_LOOP
+    for (;;) {
+        __disable_irq();
+        if (pending_mask != 0) {
+            __enable_irq();
+            break;
+        }
+
+        Power_Account_SetMcu(POWER_LOAD_MCU_SLEEP);
+        uint32_t start = DWT_Timer_GetCycles();
+        __DSB();
+        __WFI();
+        uint32_t idle = DWT_Timer_GetCycles() - start;
+        Power_Account_SetMcu(POWER_LOAD_MCU_RUN);
+        loop_stats.idle_cycles += idle;
+#if ENABLE_SYSTEM_MONITOR
+        System_Monitor_RecordIdle(idle);
+#endif
+        loop_stats.wakeups++;
+        __enable_irq();     // 唤醒源ISR在此执行
+    }
+#else
+    /* 旧版轮询：固定让出1ms，每轮都视为节拍 */
+    uint32_t start = DWT_Timer_GetCycles();
+    HAL_Delay(1);
+    uint32_t idle = DWT_Timer_GetCycles() - start;
+    loop_stats.idle_cycles += idle;
+#if ENABLE_SYSTEM_MONITOR
+    System_Monitor_RecordIdle(idle);
+#endif
+    loop_stats.wakeups++;
+    Event_Post(EVENT_TICK);
+#endif
+}
+
+void Event_Loop_TickHandler(void)
+{
+    if (++tick_divider >= EVENT_LOOP_TICK_MS) {
+        tick_divider = 0;
+        (void)DWT_Timer_GetTimeUs();   // 保持64位微秒时钟在CYCCNT回绕前推进
+        Event_Post(EVENT_TICK);
+    }
+}
+
+uint16_t Event_Loop_GetIdlePermille(void)
+{
+    accumulate_window();
+    if (loop_stats.total_cycles == 0) {
+        return 0;
+    }
+    if (loop_stats.idle_cycles >= loop_stats.total_cycles) {
+        return 1000;
+    }
+    return (uint16_t)((loop_stats.idle_cycles * 1000U) / loop_stats.total_cycles);
+}
+
+const event_loop_stats_t* Event_Loop_GetStats(void)
+{
+    accumulate_window();
+    return &loop_stats;
+}
+
+void Event_Loop_PrintStats(bool reset)
+{
+    static const char *const names[EVENT_COUNT] = {
+        "SENSOR_FIFO", "HOST_RX", "HOST_TX", "LORA_RX", "LORA_TX", "RTC_WAKEUP", "DSP_JOB", "TICK"
+    };
+    uint16_t idle = Event_Loop_GetIdlePermille();
+
+    printf("EVENT_LOOP: idle %u.%u%%, busy %u.%u%%, wakeups %lu\r\n",
+           idle / 10, idle % 10, (1000 - idle) / 10, (1000 - idle) % 10, loop_stats.wakeups);
+    for (uint8_t i = 0; i < EVENT_COUNT; i++) {
+        const event_stats_t *stats = &loop_stats.events[i];
+        if (stats->dispatched == 0) {
+            continue;
+        }
+        printf("  %-11s posted=%lu dispatched=%lu latency avg=%lu max=%lu us\r\n",
+               names[i], stats->posted, stats->dispatched,
+               (uint32_t)(stats->latency_sum_us / stats->dispatched), stats->latency_max_us);
+    }
+
+    if (reset) {
+        __disable_irq();
+        memset(&loop_stats, 0, sizeof(loop_stats));
+        __enable_irq();
+        window_start_cycles = DWT_Timer_GetCycles();
+    }
+}
+
+/**
+ * @brief 把窗口起点以来的周期数计入total (每次读取统计时调用，两次间隔需小于CYCCNT回绕周期)
+ */
+static void accumulate_window(void)
+{
+    uint32_t now = DWT_Timer_GetCycles();
+    loop_stats.total_cycles += now - window_start_cycles;
+    window_start_cycles = now;
+}
@@ -23,6 +23,7 @@
 
 /* Project specific includes */
 #include "example-raw-data.h"
+#include "Iim423xxDriver_HL_apex.h"   // 运动唤醒 (WOM)
 
 /* Clock calibration module */
 #include "helperClockCalib.h"
@@ -32,6 +33,13 @@
 /* FFT Processing */
 #include "fft_processor.h"
 
+/* 运行时检测参数 */
+#include "detection_params.h"
+#include "dwt_timer.h"     // 状态转换跟踪时间戳
+#include "profiler.h"      // 分阶段耗时直方图
+#include "latency_tracker.h" // 端到端延迟打点
+#include "power_account.h"   // 状态/传感器模式驻留能耗核算
+
 
 /* --------------------------------------------------------------------------------------
  *  Static and extern variables
@@ -43,12 +51,42 @@ static struct inv_iim423xx icm_driver;
 /* structure allowing to handle clock calibration */
 static clk_calib_t clk_calib;
 
+/* Worst-case number of packets drained by one FIFO read */
+static uint32_t fifo_peak_packets = 0;
+
+/* 采集配置 (ConfigureInvDevice记录，退出运动唤醒时恢复) */
+static IIM423XX_ACCEL_CONFIG0_ODR_t active_accel_odr = IIM423XX_ACCEL_CONFIG0_ODR_1_KHZ;
+static uint8_t active_low_noise = 1;
+
+/* 回放期间传感器样本不进入检测链 (样本由上位机注入) */
+static bool pipeline_replay_active = false;
+
+/* 进入检测链的样本累计 (检测会话按此计算各阶段样本预算) */
+static volatile uint32_t pipeline_sample_count = 0;
+
+#if ENABLE_DUAL_RATE_SENSOR
+#if !(ENABLE_DATA_PREPROCESSING && ENABLE_COARSE_DETECTION)
+#error "ENABLE_DUAL_RATE_SENSOR requires ENABLE_DATA_PREPROCESSING and ENABLE_COARSE_DETECTION"
+#endif
+/* 双速率采集状态 (Sensor_Rate_Process在主循环中切换) */
+static sensor_rate_stats_t sensor_rate_stats = { SENSOR_RATE_ACTIVE };
+static volatile bool rate_active_requested = false;   // 监测路径检测到预触发 (FIFO回调中置位)
+static bool monitor_settling = false;                 // 进入LP后的第一个RMS窗口不做预触发判断
+static uint32_t rate_last_activity = 0;               // LN下最近一次非安静时刻
+#endif
+
 /* Buffer to keep track of the timestamp when iim423xx data ready interrupt fires. */
 // extern  RINGBUFFER(timestamp_buffer, 64, uint64_t);
 
 #if ENABLE_DATA_PREPROCESSING
 /* 高通滤波器实例 */
 static highpass_filter_t z_axis_filter;
+
+/* 直接形式IIR滤波器状态变量 (避开CMSIS DSP)，Highpass_Filter_Reset清零 */
+static float32_t hp_x1 = 0.0f, hp_x2 = 0.0f;        // 输入延迟
+static float32_t hp_y1 = 0.0f, hp_y2 = 0.0f;        // 输出延迟
+static float32_t hp_x1_2 = 0.0f, hp_x2_2 = 0.0f;    // 第二段输入延迟
+static float32_t hp_y1_2 = 0.0f, hp_y2_2 = 0.0f;    // 第二段输出延迟
 #endif
 
 #if ENABLE_COARSE_DETECTION
@@ -59,12 +97,25 @@ static coarse_detector_t coarse_detector;
 #if ENABLE_FINE_DETECTION
 /* 细检测算法实例 */
 static bool fine_detector_initialized = false;
+static fine_detection_features_t last_fine_features;   // 最近一次细检测结果
+static fine_detection_features_t decision_features;    // 最近一次通知状态机的结果所对应的帧
+#endif
+
+#if ENABLE_SEQUENTIAL_DECISION
+#if !(ENABLE_COARSE_DETECTION && ENABLE_FINE_DETECTION)
+#error "ENABLE_SEQUENTIAL_DECISION requires ENABLE_COARSE_DETECTION and ENABLE_FINE_DETECTION"
+#endif
+/* 序贯判定状态 (每次粗检测触发时复位) */
+static sequential_decision_t seq_decision;
 #endif
 
 #if ENABLE_SYSTEM_STATE_MACHINE
 /* 阶段5：系统状态机全局变量 */
 static system_state_machine_t g_state_machine;
 static uint8_t state_machine_initialized = 0;
+#if ENABLE_FINE_DETECTION
+static fine_detection_features_t alarm_features;       // 触发当前报警的细检测结果 (报警事件摘要)
+#endif
 
 /* 状态名称字符串 (用于调试输出) */
 static const char* state_names[STATE_COUNT] = {
@@ -77,9 +128,30 @@ static const char* state_names[STATE_COUNT] = {
     "ALARM_SENDING",
     "ALARM_COMPLETE",
     "ERROR_HANDLING",
-    "SYSTEM_RESET"
+    "SYSTEM_RESET",
+    "LP_SLEEP_PREPARE",
+    "LP_SLEEP_MODE",
+    "LP_WAKEUP",
+    "LP_DETECTION_ACTIVE"
 };
 
+/* 事件名称字符串 (用于跟踪输出) */
+static const char* event_names[SM_EVENT_COUNT] = {
+    "COARSE_TRIGGER",
+    "FINE_MINING",
+    "FINE_NORMAL",
+    "ALARM_OK",
+    "ALARM_FAIL",
+    "TIMEOUT",
+    "ALWAYS",
+    "FAULT"
+};
+
+/* 状态转换跟踪环形缓冲区 */
+static state_trace_entry_t state_trace[STATE_TRACE_DEPTH];
+static uint8_t state_trace_head = 0;     // 下一条写入位置
+static uint8_t state_trace_count = 0;    // 有效记录数
+
 #endif
 
 #if ENABLE_DATA_PREPROCESSING
@@ -91,6 +163,22 @@ static const float32_t highpass_coeffs[10] = {
     /* 第二个biquad段 (b0, b1, b2, a1, a2) */
     1.0000000f, -2.0000000f, 1.0000000f, 1.9752696f, -0.9762448f
 };
+
+#if ENABLE_DUAL_RATE_SENSOR
+/* 同一滤波器 (4阶Butterworth, 5Hz截止) 在LP监测ODR (100Hz) 下的系数 */
+static const float32_t highpass_coeffs_monitor[10] = {
+    0.6620158f, -1.3240316f, 0.6620158f, 1.4796742f, -0.5558215f,
+    1.0000000f, -2.0000000f, 1.0000000f, 1.7009643f, -0.7884997f
+};
+#endif
+
+/* Highpass_Filter_Process使用的系数 (随采样率切换) */
+static const float32_t *hp_active_coeffs = highpass_coeffs;
+#endif
+
+#if ENABLE_COARSE_DETECTION
+/* RMS窗口样本数除数 (SAMPLING_FREQ / 当前采样率)，窗口时长保持不变 */
+static uint32_t coarse_rate_div = 1;
 #endif
 
 /*
@@ -114,6 +202,11 @@ static int32_t icm_mounting_matrix[9] = { (1<<30),     0,           0,
  *  static function declaration
  * -------------------------------------------------------------------------------------- */
 static void apply_mounting_matrix(const int32_t matrix[9], int32_t raw[3]);
+#if ENABLE_DUAL_RATE_SENSOR
+static int apply_sensor_rate(sensor_rate_t rate);
+static void monitor_process_sample(float32_t filtered_z_g);
+static float32_t dual_rate_pretrigger_mult(void);
+#endif
 
 /* --------------------------------------------------------------------------------------
  *  Functions definition
@@ -224,6 +317,8 @@ int ConfigureInvDevice(uint8_t is_low_noise_mode,
 	}
 	
 	rc |= inv_iim423xx_set_accel_frequency(&icm_driver, acc_freq);
+	active_accel_odr = acc_freq;
+	active_low_noise = is_low_noise_mode;
 	
 
 	{
@@ -250,7 +345,7 @@ int ConfigureInvDevice(uint8_t is_low_noise_mode,
 		rc |= inv_iim423xx_enable_accel_low_noise_mode(&icm_driver);
 	else
 		rc |= inv_iim423xx_enable_accel_low_power_mode(&icm_driver);
-	
+	Power_Account_SetSensor(is_low_noise_mode ? POWER_LOAD_SENSOR_LN : POWER_LOAD_SENSOR_LP);
 
 	return rc;
 }
@@ -263,15 +358,237 @@ int GetDataFromInvDevice(void)
 	 * HandleInvDeviceFifoPacket) will be called for each valid packet extracted from 
 	 * FIFO.
 	 */
-	return inv_iim423xx_get_data_from_fifo(&icm_driver);
+	PROFILE_START(read_start);
+	int rc = inv_iim423xx_get_data_from_fifo(&icm_driver);
+	PROFILE_STOP(PROF_STAGE_FIFO_READ, read_start);
+
+	if (rc > 0 && (uint32_t)rc > fifo_peak_packets)
+		fifo_peak_packets = (uint32_t)rc;
+
+	return rc;
+}
+
+uint32_t GetInvDeviceFifoOverflowCount(void)
+{
+	return icm_driver.fifo_full_count;
+}
+
+uint32_t GetInvDeviceFifoPeakPackets(bool reset)
+{
+	uint32_t peak = fifo_peak_packets;
+
+	if (reset)
+		fifo_peak_packets = 0;
+
+	return peak;
+}
+
+int InvDevice_SetFifoWatermark(uint16_t packets, bool flush)
+{
+	int rc;
+
+	if (packets == 0 || packets > InvDevice_GetFifoCapacityPackets())
+		return INV_ERROR_BAD_ARG;
+
+	rc = inv_iim423xx_configure_fifo_wm(&icm_driver, packets);
+	if (flush)
+		rc |= inv_iim423xx_reset_fifo(&icm_driver);
+
+	return rc;
+}
+
+int InvDevice_FlushFifo(void)
+{
+	return inv_iim423xx_reset_fifo(&icm_driver);
+}
+
+uint16_t InvDevice_GetFifoCapacityPackets(void)
+{
+	/* 2KB FIFO：16字节包128个，20字节 (高分辨率) 包102个 */
+	return icm_driver.fifo_highres_enabled ? (2048 / FIFO_20BYTES_PACKET_SIZE) : INV_FIFO_CAPACITY_PACKETS;
+}
+
+uint8_t InvDevice_WomThresholdFromRms(float32_t trigger_rms_g)
+{
+	/* WOM比较50Hz相邻样本之差，按RMS折算为差值幅度后量化为1g/256 */
+	float32_t lsb = trigger_rms_g * 1000.0f * WOM_DIFF_PER_RMS / WOM_THRESHOLD_MG_PER_LSB;
+
+	if (!(lsb > WOM_THRESHOLD_MIN_LSB))
+		return WOM_THRESHOLD_MIN_LSB;
+	if (lsb > WOM_THRESHOLD_MAX_LSB)
+		return WOM_THRESHOLD_MAX_LSB;
+
+	return (uint8_t)(lsb + 0.5f);
+}
+
+int InvDevice_EnterWakeOnMotion(uint8_t threshold_lsb)
+{
+	int rc = 0;
+	uint8_t status;
+	inv_iim423xx_interrupt_parameter_t config_int = {(inv_iim423xx_interrupt_value)0};
+
+	/* LP模式：WOM由唤醒振荡器按WOM_ACCEL_ODR运行 */
+	rc |= inv_iim423xx_set_accel_frequency(&icm_driver, WOM_ACCEL_ODR);
+	rc |= inv_iim423xx_set_accel_lp_avg(&icm_driver, WOM_ACCEL_LP_AVG);
+	rc |= inv_iim423xx_enable_accel_low_power_mode(&icm_driver);
+	Power_Account_SetSensor(POWER_LOAD_SENSOR_LP);
+
+	rc |= inv_iim423xx_configure_smd_wom(&icm_driver, threshold_lsb, threshold_lsb, threshold_lsb,
+	                                     IIM423XX_SMD_CONFIG_WOM_INT_MODE_ORED,
+	                                     IIM423XX_SMD_CONFIG_WOM_MODE_CMP_PREV);
+
+	rc |= inv_iim423xx_get_config_int1(&icm_driver, &config_int);
+	config_int.INV_IIM423XX_WOM_X = INV_IIM423XX_ENABLE;
+	config_int.INV_IIM423XX_WOM_Y = INV_IIM423XX_ENABLE;
+	config_int.INV_IIM423XX_WOM_Z = INV_IIM423XX_ENABLE;
+	rc |= inv_iim423xx_set_config_int1(&icm_driver, &config_int);
+
+	/* 使能WOM并关闭FIFO水位线中断 */
+	rc |= inv_iim423xx_enable_wom(&icm_driver);
+
+	/* 清除切换期间残留的WOM状态 */
+	rc |= inv_iim423xx_read_reg(&icm_driver, MPUREG_INT_STATUS2, 1, &status);
+
+	return rc;
+}
+
+int InvDevice_ExitWakeOnMotion(void)
+{
+	int rc = 0;
+
+	rc |= inv_iim423xx_disable_wom(&icm_driver);
+
+#if ENABLE_DUAL_RATE_SENSOR
+	/* 恢复采集配置并按1kHz重设滤波器/RMS窗口 (同时复位FIFO) */
+	rc |= apply_sensor_rate(SENSOR_RATE_ACTIVE);
+#else
+	rc |= inv_iim423xx_set_accel_frequency(&icm_driver, active_accel_odr);
+	if (active_low_noise)
+		rc |= inv_iim423xx_enable_accel_low_noise_mode(&icm_driver);
+	else
+		rc |= inv_iim423xx_enable_accel_low_power_mode(&icm_driver);
+	Power_Account_SetSensor(active_low_noise ? POWER_LOAD_SENSOR_LN : POWER_LOAD_SENSOR_LP);
+
+	/* 丢弃LP模式下累积的样本 */
+	rc |= inv_iim423xx_reset_fifo(&icm_driver);
+#endif
+
+	return rc;
+}
+
+int InvDevice_ReadWomStatus(uint8_t *axis_mask)
+{
+	uint8_t status = 0;
+	int rc = inv_iim423xx_read_reg(&icm_driver, MPUREG_INT_STATUS2, 1, &status);
+
+	if (axis_mask != NULL)
+		*axis_mask = status & (BIT_INT_STATUS2_WOM_X_INT | BIT_INT_STATUS2_WOM_Y_INT | BIT_INT_STATUS2_WOM_Z_INT);
+
+	return rc;
+}
+
+int InvDevice_GetFifoCount(uint16_t *packets)
+{
+	uint8_t data[2] = {0, 0};
+	int rc = inv_iim423xx_read_reg(&icm_driver, MPUREG_FIFO_COUNTH, 2, data);
+
+	/* 驱动初始化时配置为按包计数、小端 */
+	if (packets != NULL)
+		*packets = (uint16_t)((data[1] << 8) | data[0]);
+
+	return rc;
+}
+
+int InvDevice_CheckAlive(void)
+{
+	uint8_t who_am_i = 0;
+	int rc = inv_iim423xx_get_who_am_i(&icm_driver, &who_am_i);
+
+	if (rc != INV_ERROR_SUCCESS)
+		return rc;
+
+	return (who_am_i == ICM_WHOAMI) ? 0 : INV_ERROR;
+}
+
+#if ENABLE_DUAL_RATE_SENSOR
+int Sensor_Rate_Set(sensor_rate_t rate)
+{
+	if (rate == sensor_rate_stats.rate)
+		return 0;
+
+	return apply_sensor_rate(rate);
+}
+
+void Sensor_Rate_Process(void)
+{
+	uint32_t now = HAL_GetTick();
+	bool busy;
+
+	if (pipeline_replay_active)
+		return;
+
+	if (sensor_rate_stats.rate == SENSOR_RATE_MONITOR) {
+		if (rate_active_requested) {
+			rate_active_requested = false;
+			if (Sensor_Rate_Set(SENSOR_RATE_ACTIVE) == 0)
+				printf("SENSOR_RATE: pre-trigger RMS=%.6f (monitor baseline %.6f), switched to LN\r\n",
+				       coarse_detector.current_rms, sensor_rate_stats.monitor_baseline_rms);
+		}
+		return;
+	}
+
+	/* LN下只有检测链完全空闲且RMS低于预触发电平才累计安静时间 */
+	busy = (coarse_detector.state != COARSE_STATE_IDLE) || !coarse_detector.window_full ||
+	       (coarse_detector.peak_factor > dual_rate_pretrigger_mult());
+#if ENABLE_SYSTEM_STATE_MACHINE
+	switch (System_State_Machine_GetCurrentState()) {
+	case STATE_COARSE_TRIGGERED:
+	case STATE_FINE_ANALYSIS:
+	case STATE_MINING_DETECTED:
+	case STATE_ALARM_SENDING:
+		busy = true;
+		break;
+	default:
+		break;
+	}
+#endif
+#if ENABLE_FFT_DEFERRED
+	busy = busy || FFT_Worker_Pending();
+#endif
+
+	if (busy) {
+		rate_last_activity = now;
+		return;
+	}
+
+	if (now - rate_last_activity >= DUAL_RATE_ACTIVE_HOLD_MS)
+		Sensor_Rate_Set(SENSOR_RATE_MONITOR);
+}
+
+sensor_rate_t Sensor_Rate_Get(void)
+{
+	return sensor_rate_stats.rate;
 }
 
+float32_t Sensor_Rate_GetSampleHz(void)
+{
+	return (sensor_rate_stats.rate == SENSOR_RATE_MONITOR) ? DUAL_RATE_MONITOR_HZ : SAMPLING_FREQ;
+}
+
+const sensor_rate_stats_t* Sensor_Rate_GetStats(void)
+{
+	return &sensor_rate_stats;
+}
+#endif
+
 
 void HandleInvDeviceFifoPacket(inv_iim423xx_sensor_event_t * event)
 {
 	uint64_t irq_timestamp = 0, extended_timestamp;
 	int32_t accel[3];
 	
+	PROFILE_START(decode_start);
+
 	/*
 	 * Extract the timestamp that was buffered when current packet IRQ fired. See 
 	 * ext_interrupt_cb() in main.c for more details.
@@ -313,45 +630,13 @@ void HandleInvDeviceFifoPacket(inv_iim423xx_sensor_event_t * event)
 	 */
 	if (event->sensor_mask & (1 << INV_IIM423XX_SENSOR_ACCEL)) {
 		// Convert to float and normalize (assuming 4g range, 16-bit data)
-		float32_t accel_x_g = (float32_t)accel[0] / 8192.0f; // Convert to g units
-		float32_t accel_y_g = (float32_t)accel[1] / 8192.0f;
-		float32_t accel_z_g = (float32_t)accel[2] / 8192.0f;
+		float32_t accel_z_g = (float32_t)accel[2] / 8192.0f; // Convert to g units
+		PROFILE_STOP(PROF_STAGE_DECODE, decode_start);
 
-#if ENABLE_DATA_PREPROCESSING
-		// 应用高通滤波器到Z轴数据 (用于震动分析)
-		float32_t filtered_z_g = Highpass_Filter_Process(accel_z_g);
-
-#if ENABLE_COARSE_DETECTION
-		// 粗检测算法处理
-		int trigger_detected = Coarse_Detector_Process(filtered_z_g);
-
-		// 阶段3：使用FFT触发控制
-		// FFT应该在TRIGGERED和COOLDOWN状态下都保持激活
-		coarse_detection_state_t current_state = Coarse_Detector_GetState();
-		bool should_trigger = (trigger_detected ||
-		                      current_state == COARSE_STATE_TRIGGERED ||
-		                      current_state == COARSE_STATE_COOLDOWN);
-		FFT_SetTriggerState(should_trigger);
-
-		// 调试输出FFT触发状态
-		static uint32_t fft_debug_counter = 0;
-		fft_debug_counter++;
-		if (fft_debug_counter % 1000 == 0) {
-			printf("FFT_DEBUG: should_trigger=%d state=%d\r\n", should_trigger, current_state);
+		if (!pipeline_replay_active) {
+			Vibration_Pipeline_ProcessSample(accel_z_g);
 		}
 
-		// FFT处理现在由触发状态自动控制
-		int result = FFT_AddSample(filtered_z_g);
-#else
-		// 使用滤波后的数据进行FFT处理 (连续模式)
-		int result = FFT_AddSample(filtered_z_g);
-#endif
-
-#else
-		// 原始处理方式 (向后兼容)
-		int result = FFT_AddSample(accel_z_g);
-#endif
-
 		// 数据处理完成 - 阶段1高通滤波器工作正常，阶段2粗检测集成
 	}
 
@@ -365,10 +650,179 @@ void HandleInvDeviceFifoPacket(inv_iim423xx_sensor_event_t * event)
 
 }
 
+void Vibration_Pipeline_SetReplay(bool active)
+{
+	pipeline_replay_active = active;
+}
+
+bool Vibration_Pipeline_IsReplay(void)
+{
+	return pipeline_replay_active;
+}
+
+uint32_t Vibration_Pipeline_GetSampleCount(void)
+{
+	return pipeline_sample_count;
+}
+
+void Vibration_Pipeline_ProcessSample(float32_t accel_z_g)
+{
+	pipeline_sample_count++;
+
+#if ENABLE_DATA_PREPROCESSING
+	// 应用高通滤波器到Z轴数据 (用于震动分析)
+	PROFILE_START(hp_start);
+	float32_t filtered_z_g = Highpass_Filter_Process(accel_z_g);
+	PROFILE_STOP(PROF_STAGE_HIGHPASS, hp_start);
+
+#if ENABLE_DUAL_RATE_SENSOR
+	// LP监测：只更新RMS判断预触发，不进入粗检测状态机和FFT
+	if (sensor_rate_stats.rate == SENSOR_RATE_MONITOR) {
+		monitor_process_sample(filtered_z_g);
+		return;
+	}
+#endif
+
+#if ENABLE_COARSE_DETECTION
+	// 粗检测算法处理
+	PROFILE_START(coarse_start);
+	int trigger_detected = Coarse_Detector_Process(filtered_z_g);
+	PROFILE_STOP(PROF_STAGE_COARSE, coarse_start);
+
+	// 阶段3：使用FFT触发控制
+	// FFT应该在TRIGGERED和COOLDOWN状态下都保持激活
+	coarse_detection_state_t current_state = Coarse_Detector_GetState();
+	bool should_trigger = (trigger_detected ||
+	                      current_state == COARSE_STATE_TRIGGERED ||
+	                      current_state == COARSE_STATE_COOLDOWN);
+#if ENABLE_SEQUENTIAL_DECISION
+	// 本次触发已判定：停止采集，冷却期内不再产生帧 (也不会留下过期的细检测结果)
+	should_trigger = should_trigger && !Sequential_Decision_IsDecided();
+#endif
+	FFT_SetTriggerState(should_trigger);
+
+	// 调试输出FFT触发状态
+	static uint32_t fft_debug_counter = 0;
+	fft_debug_counter++;
+	if (fft_debug_counter % 1000 == 0) {
+		printf("FFT_DEBUG: should_trigger=%d state=%d\r\n", should_trigger, current_state);
+	}
+#endif
+
+	// FFT处理由触发状态自动控制 (无粗检测时为连续模式)
+	FFT_AddSample(filtered_z_g);
+#else
+	// 原始处理方式 (向后兼容)
+	FFT_AddSample(accel_z_g);
+#endif
+}
+
 /* --------------------------------------------------------------------------------------
  *  Static functions definition
  * -------------------------------------------------------------------------------------- */
 
+#if ENABLE_DUAL_RATE_SENSOR
+/**
+ * \brief 重配置传感器ODR/功耗模式并按新采样率重设滤波器和RMS窗口
+ */
+static int apply_sensor_rate(sensor_rate_t rate)
+{
+	int rc = 0;
+	uint32_t now = HAL_GetTick();
+	float32_t sample_hz;
+
+	if (rate == SENSOR_RATE_MONITOR) {
+		rc |= inv_iim423xx_set_accel_frequency(&icm_driver, DUAL_RATE_MONITOR_ODR);
+		rc |= inv_iim423xx_set_accel_lp_avg(&icm_driver, DUAL_RATE_MONITOR_LP_AVG);
+		rc |= inv_iim423xx_enable_accel_low_power_mode(&icm_driver);
+		sample_hz = DUAL_RATE_MONITOR_HZ;
+	} else {
+		rc |= inv_iim423xx_set_accel_frequency(&icm_driver, active_accel_odr);
+		if (active_low_noise)
+			rc |= inv_iim423xx_enable_accel_low_noise_mode(&icm_driver);
+		else
+			rc |= inv_iim423xx_enable_accel_low_power_mode(&icm_driver);
+		sample_hz = SAMPLING_FREQ;
+	}
+
+	Power_Account_SetSensor((rate == SENSOR_RATE_ACTIVE && active_low_noise) ?
+	                        POWER_LOAD_SENSOR_LN : POWER_LOAD_SENSOR_LP);
+
+	/* 丢弃旧ODR下的样本，新样本统一按新采样率处理 */
+	rc |= inv_iim423xx_reset_fifo(&icm_driver);
+	if (rc != 0) {
+		sensor_rate_stats.switch_errors++;
+		return rc;
+	}
+
+	Highpass_Filter_SetSampleRate(sample_hz);
+	Coarse_Detector_SetSampleRate(sample_hz);
+
+	if (sensor_rate_stats.rate == SENSOR_RATE_MONITOR)
+		sensor_rate_stats.monitor_time_ms += now - sensor_rate_stats.rate_enter_time;
+	else
+		sensor_rate_stats.active_time_ms += now - sensor_rate_stats.rate_enter_time;
+
+	if (rate != sensor_rate_stats.rate) {
+		if (rate == SENSOR_RATE_MONITOR)
+			sensor_rate_stats.to_monitor_count++;
+		else
+			sensor_rate_stats.to_active_count++;
+	}
+
+	if (rate == SENSOR_RATE_ACTIVE) {
+		/* FFT缓冲区只接收1kHz样本 */
+		FFT_Reset();
+	} else {
+		monitor_settling = true;
+	}
+
+	sensor_rate_stats.rate = rate;
+	sensor_rate_stats.rate_enter_time = now;
+	rate_active_requested = false;
+	rate_last_activity = now;
+
+	return 0;
+}
+
+/**
+ * \brief LP监测样本：RMS超过预触发电平时请求切换到LN，安静时跟踪监测基线
+ */
+static void monitor_process_sample(float32_t filtered_z_g)
+{
+	float32_t baseline;
+
+	if (!Coarse_Detector_UpdateRms(filtered_z_g))
+		return;
+
+	/* 进入LP后的第一个窗口：窗口内全是LP样本后才学习/比较 */
+	if (monitor_settling) {
+		if (coarse_detector.window_index != 0)
+			return;
+		monitor_settling = false;
+		if (sensor_rate_stats.monitor_baseline_rms <= 0.0f)
+			sensor_rate_stats.monitor_baseline_rms = coarse_detector.current_rms;
+		return;
+	}
+
+	baseline = sensor_rate_stats.monitor_baseline_rms;
+	if (baseline > 0.0f && coarse_detector.current_rms > baseline * dual_rate_pretrigger_mult()) {
+		rate_active_requested = true;
+		return;
+	}
+
+	/* 每个完整窗口更新一次基线 */
+	if (coarse_detector.window_index == 0)
+		sensor_rate_stats.monitor_baseline_rms = (1.0f - DUAL_RATE_BASELINE_ALPHA) * baseline +
+		                                         DUAL_RATE_BASELINE_ALPHA * coarse_detector.current_rms;
+}
+
+static float32_t dual_rate_pretrigger_mult(void)
+{
+	return 1.0f + (Detection_Params_Get()->trigger_multiplier - 1.0f) * DUAL_RATE_PRETRIGGER_RATIO;
+}
+#endif
+
 static void apply_mounting_matrix(const int32_t matrix[9], int32_t raw[3])
 {
 	unsigned i;
@@ -455,12 +909,6 @@ float32_t Highpass_Filter_Process(float32_t input)
     static uint32_t process_count = 0;
     static uint32_t debug_count = 0;
 
-    // 直接形式IIR滤波器状态变量 (避开CMSIS DSP)
-    static float32_t x1 = 0.0f, x2 = 0.0f;  // 输入延迟
-    static float32_t y1 = 0.0f, y2 = 0.0f;  // 输出延迟
-    static float32_t x1_2 = 0.0f, x2_2 = 0.0f;  // 第二段输入延迟
-    static float32_t y1_2 = 0.0f, y2_2 = 0.0f;  // 第二段输出延迟
-
     process_count++;
     debug_count++;
 
@@ -471,32 +919,71 @@ float32_t Highpass_Filter_Process(float32_t input)
         return input;
     }
 
-    // 第一个biquad段: b0=0.959782, b1=-1.919564, b2=0.959782, a1=1.942638, a2=-0.943597
-    float32_t stage1_out = 0.959782f * input + (-1.919564f) * x1 + 0.959782f * x2
-                          + 1.942638f * y1 + (-0.943597f) * y2;
+    const float32_t *c = hp_active_coeffs;
+
+    // 第一个biquad段: c[0..4] = b0, b1, b2, a1, a2
+    float32_t stage1_out = c[0] * input + c[1] * hp_x1 + c[2] * hp_x2
+                          + c[3] * hp_y1 + c[4] * hp_y2;
 
     // 更新第一段状态
-    x2 = x1; x1 = input;
-    y2 = y1; y1 = stage1_out;
+    hp_x2 = hp_x1; hp_x1 = input;
+    hp_y2 = hp_y1; hp_y1 = stage1_out;
 
-    // 第二个biquad段: b0=1.000000, b1=-2.000000, b2=1.000000, a1=1.975270, a2=-0.976245
-    float32_t stage2_out = 1.000000f * stage1_out + (-2.000000f) * x1_2 + 1.000000f * x2_2
-                          + 1.975270f * y1_2 + (-0.976245f) * y2_2;
+    // 第二个biquad段: c[5..9]
+    float32_t stage2_out = c[5] * stage1_out + c[6] * hp_x1_2 + c[7] * hp_x2_2
+                          + c[8] * hp_y1_2 + c[9] * hp_y2_2;
 
     // 更新第二段状态
-    x2_2 = x1_2; x1_2 = stage1_out;
-    y2_2 = y1_2; y1_2 = stage2_out;
+    hp_x2_2 = hp_x1_2; hp_x1_2 = stage1_out;
+    hp_y2_2 = hp_y1_2; hp_y1_2 = stage2_out;
 
     // 滤波器工作正常，无需调试输出
 
     return stage2_out;
 }
 
+const float32_t* Highpass_Filter_GetCoeffs(void)
+{
+    return hp_active_coeffs;
+}
+
+int Highpass_Filter_SetSampleRate(float32_t sample_hz)
+{
+    const float32_t *coeffs = NULL;
+    float32_t level = hp_x1;
+
+    if (fabsf(sample_hz - SAMPLING_FREQ) < 0.5f) {
+        coeffs = highpass_coeffs;
+    }
+#if ENABLE_DUAL_RATE_SENSOR
+    else if (fabsf(sample_hz - DUAL_RATE_MONITOR_HZ) < 0.5f) {
+        coeffs = highpass_coeffs_monitor;
+    }
+#endif
+    if (coeffs == NULL) {
+        return -1;
+    }
+
+    hp_active_coeffs = coeffs;
+    for (int i = 0; i < 10; i++) {
+        z_axis_filter.filter_coeffs[i] = coeffs[i];
+    }
+
+    // 以上一个输入电平 (重力分量) 装入稳态：高通输出为0，切换后无阶跃瞬态
+    hp_x1 = hp_x2 = level;
+    hp_y1 = hp_y2 = 0.0f;
+    hp_x1_2 = hp_x2_2 = hp_y1_2 = hp_y2_2 = 0.0f;
+
+    return 0;
+}
+
 void Highpass_Filter_Reset(void)
 {
     if (z_axis_filter.is_initialized) {
         // 清零滤波器状态，保持系数不变
         memset(z_axis_filter.filter_state, 0, sizeof(z_axis_filter.filter_state));
+        hp_x1 = hp_x2 = hp_y1 = hp_y2 = 0.0f;
+        hp_x1_2 = hp_x2_2 = hp_y1_2 = hp_y2_2 = 0.0f;
     }
 }
 #endif
@@ -512,7 +999,7 @@ int Coarse_Detector_Init(void)
     memset(&coarse_detector, 0, sizeof(coarse_detector_t));
 
     // 初始化参数
-    coarse_detector.baseline_rms = BASELINE_RMS_THRESHOLD;  // 初始基线RMS
+    coarse_detector.baseline_rms = Detection_Params_Get()->baseline_rms_threshold;  // 初始基线RMS
     coarse_detector.state = COARSE_STATE_IDLE;
     coarse_detector.window_index = 0;
     coarse_detector.window_full = false;
@@ -523,18 +1010,23 @@ int Coarse_Detector_Init(void)
     return 0;
 }
 
-int Coarse_Detector_Process(float32_t filtered_sample)
+/**
+ * \brief 当前采样率下的RMS窗口样本数 (窗口时长 = rms_window_size @ SAMPLING_FREQ)
+ */
+static uint32_t coarse_window_size(void)
 {
-    static uint32_t debug_counter = 0;
-    debug_counter++;
+    uint32_t window_size = Detection_Params_Get()->rms_window_size / coarse_rate_div;
 
-    if (!coarse_detector.is_initialized) {
-        return 0;
-    }
+    return (window_size > 0) ? window_size : 1;
+}
+
+bool Coarse_Detector_UpdateRms(float32_t filtered_sample)
+{
+    uint32_t window_size = coarse_window_size();
 
     // 添加样本到RMS滑动窗口
     coarse_detector.rms_window[coarse_detector.window_index] = filtered_sample * filtered_sample;  // 平方值
-    coarse_detector.window_index = (coarse_detector.window_index + 1) % RMS_WINDOW_SIZE;
+    coarse_detector.window_index = (coarse_detector.window_index + 1) % window_size;
 
     if (!coarse_detector.window_full && coarse_detector.window_index == 0) {
         coarse_detector.window_full = true;
@@ -542,13 +1034,50 @@ int Coarse_Detector_Process(float32_t filtered_sample)
     }
 
     // 计算当前RMS (仅在窗口满后)
+    if (!coarse_detector.window_full) {
+        return false;
+    }
+
+    float32_t sum_squares = 0.0f;
+    for (uint32_t i = 0; i < window_size; i++) {
+        sum_squares += coarse_detector.rms_window[i];
+    }
+    coarse_detector.current_rms = sqrtf(sum_squares / window_size);
+
+    return true;
+}
+
+void Coarse_Detector_SetSampleRate(float32_t sample_hz)
+{
+    uint32_t div = (sample_hz > 0.0f) ? (uint32_t)(SAMPLING_FREQ / sample_hz + 0.5f) : 1;
+    float32_t mean_square = coarse_detector.current_rms * coarse_detector.current_rms;
+
+    coarse_rate_div = (div > 0) ? div : 1;
+    coarse_detector.window_index = 0;
+
+    // 以当前均方值预填新窗口，RMS连续，切换后没有一个窗口长度的盲区
     if (coarse_detector.window_full) {
-        float32_t sum_squares = 0.0f;
-        for (int i = 0; i < RMS_WINDOW_SIZE; i++) {
-            sum_squares += coarse_detector.rms_window[i];
+        uint32_t window_size = coarse_window_size();
+        for (uint32_t i = 0; i < window_size; i++) {
+            coarse_detector.rms_window[i] = mean_square;
         }
-        coarse_detector.current_rms = sqrtf(sum_squares / RMS_WINDOW_SIZE);
+    } else {
+        memset(coarse_detector.rms_window, 0, sizeof(coarse_detector.rms_window));
+    }
+}
 
+int Coarse_Detector_Process(float32_t filtered_sample)
+{
+    static uint32_t debug_counter = 0;
+    debug_counter++;
+
+    if (!coarse_detector.is_initialized) {
+        return 0;
+    }
+
+    const detection_params_t* params = Detection_Params_Get();
+
+    if (Coarse_Detector_UpdateRms(filtered_sample)) {
         // 计算峰值因子
         coarse_detector.peak_factor = coarse_detector.current_rms / coarse_detector.baseline_rms;
 
@@ -564,10 +1093,14 @@ int Coarse_Detector_Process(float32_t filtered_sample)
 
         switch (coarse_detector.state) {
             case COARSE_STATE_IDLE:
-                if (coarse_detector.peak_factor > TRIGGER_MULTIPLIER) {
+                if (coarse_detector.peak_factor > params->trigger_multiplier) {
                     coarse_detector.state = COARSE_STATE_TRIGGERED;
                     coarse_detector.trigger_start_time = current_time;
                     coarse_detector.trigger_count++;
+                    coarse_detector.correlation_id = Latency_Tracker_Begin();
+#if ENABLE_SEQUENTIAL_DECISION
+                    Sequential_Decision_Reset();
+#endif
                     printf("COARSE_TRIGGER: RMS=%.6f peak_factor=%.2f TRIGGERED!\r\n",
                            coarse_detector.current_rms, coarse_detector.peak_factor);
 
@@ -581,15 +1114,16 @@ int Coarse_Detector_Process(float32_t filtered_sample)
                 break;
 
             case COARSE_STATE_TRIGGERED:
-                if (current_time - coarse_detector.trigger_start_time > TRIGGER_DURATION_MS) {
+                if (current_time - coarse_detector.trigger_start_time > params->trigger_duration_ms) {
                     coarse_detector.state = COARSE_STATE_COOLDOWN;
                     coarse_detector.cooldown_start_time = current_time;
                 }
                 break;
 
             case COARSE_STATE_COOLDOWN:
-                if (current_time - coarse_detector.cooldown_start_time > COOLDOWN_TIME_MS) {
+                if (current_time - coarse_detector.cooldown_start_time > params->cooldown_time_ms) {
                     coarse_detector.state = COARSE_STATE_IDLE;
+                    Latency_Tracker_EndActive();
                     // 更新基线RMS (简单的指数移动平均)
                     coarse_detector.baseline_rms = 0.95f * coarse_detector.baseline_rms + 0.05f * coarse_detector.current_rms;
                 }
@@ -609,11 +1143,24 @@ void Coarse_Detector_Reset(void)
 {
     if (coarse_detector.is_initialized) {
         coarse_detector.state = COARSE_STATE_IDLE;
+        Latency_Tracker_EndActive();
         coarse_detector.window_index = 0;
         coarse_detector.window_full = false;
         memset(coarse_detector.rms_window, 0, sizeof(coarse_detector.rms_window));
     }
 }
+
+void Coarse_Detector_SetBaseline(float32_t baseline_rms)
+{
+    if (baseline_rms > 0.0f) {
+        coarse_detector.baseline_rms = baseline_rms;
+    }
+}
+
+const coarse_detector_t* Coarse_Detector_GetInfo(void)
+{
+    return &coarse_detector;
+}
 #endif
 
 #if ENABLE_FINE_DETECTION
@@ -628,10 +1175,10 @@ int Fine_Detector_Init(void)
     return 0;
 }
 
-static float32_t calculate_frequency_bin_energy(const float32_t* magnitude_spectrum,
-                                               uint32_t spectrum_length,
-                                               float32_t freq_min,
-                                               float32_t freq_max)
+float32_t Fine_Detector_BandEnergy(const float32_t* magnitude_spectrum,
+                                   uint32_t spectrum_length,
+                                   float32_t freq_min,
+                                   float32_t freq_max)
 {
     // FFT配置：采样频率1000Hz，FFT大小512，频率分辨率1.953125Hz
     const float32_t freq_resolution = 1000.0f / 512.0f;  // 1.953125 Hz
@@ -654,8 +1201,8 @@ static float32_t calculate_frequency_bin_energy(const float32_t* magnitude_spect
     return energy;
 }
 
-static float32_t calculate_total_energy(const float32_t* magnitude_spectrum,
-                                       uint32_t spectrum_length)
+float32_t Fine_Detector_TotalEnergy(const float32_t* magnitude_spectrum,
+                                    uint32_t spectrum_length)
 {
     float32_t total_energy = 0.0f;
 
@@ -667,8 +1214,8 @@ static float32_t calculate_total_energy(const float32_t* magnitude_spectrum,
     return total_energy;
 }
 
-static float32_t calculate_spectral_centroid(const float32_t* magnitude_spectrum,
-                                            uint32_t spectrum_length)
+float32_t Fine_Detector_SpectralCentroid(const float32_t* magnitude_spectrum,
+                                         uint32_t spectrum_length)
 {
     const float32_t freq_resolution = 1000.0f / 512.0f;  // 1.953125 Hz
 
@@ -700,19 +1247,21 @@ static float32_t calculate_confidence_score(const fine_detection_features_t* fea
     const float32_t w_dom = 0.2f;    // 主频权重
     const float32_t w_cent = 0.2f;   // 频谱重心权重
 
+    const detection_params_t* params = Detection_Params_Get();
+
     // 计算各项得分 (0-1范围)
-    float32_t low_freq_score = (features->low_freq_energy > FINE_DETECTION_LOW_FREQ_THRESHOLD) ?
-                               (features->low_freq_energy / FINE_DETECTION_LOW_FREQ_THRESHOLD) : 0.0f;
+    float32_t low_freq_score = (features->low_freq_energy > params->low_freq_threshold) ?
+                               (features->low_freq_energy / params->low_freq_threshold) : 0.0f;
     if (low_freq_score > 1.0f) low_freq_score = 1.0f;
 
-    float32_t mid_freq_score = 1.0f - fabsf(features->mid_freq_energy - FINE_DETECTION_MID_FREQ_THRESHOLD) / FINE_DETECTION_MID_FREQ_THRESHOLD;
+    float32_t mid_freq_score = 1.0f - fabsf(features->mid_freq_energy - params->mid_freq_threshold) / params->mid_freq_threshold;
     if (mid_freq_score < 0.0f) mid_freq_score = 0.0f;
 
-    float32_t dominant_freq_score = (features->dominant_frequency < FINE_DETECTION_DOMINANT_FREQ_MAX) ?
-                                   (FINE_DETECTION_DOMINANT_FREQ_MAX - features->dominant_frequency) / FINE_DETECTION_DOMINANT_FREQ_MAX : 0.0f;
+    float32_t dominant_freq_score = (features->dominant_frequency < params->dominant_freq_max) ?
+                                   (params->dominant_freq_max - features->dominant_frequency) / params->dominant_freq_max : 0.0f;
 
-    float32_t centroid_score = (features->spectral_centroid < FINE_DETECTION_CENTROID_MAX) ?
-                              (FINE_DETECTION_CENTROID_MAX - features->spectral_centroid) / FINE_DETECTION_CENTROID_MAX : 0.0f;
+    float32_t centroid_score = (features->spectral_centroid < params->centroid_max) ?
+                              (params->centroid_max - features->spectral_centroid) / params->centroid_max : 0.0f;
 
     // 加权计算总置信度
     float32_t confidence = w_low * low_freq_score +
@@ -727,22 +1276,22 @@ static float32_t calculate_confidence_score(const fine_detection_features_t* fea
     return confidence;
 }
 
-int Fine_Detector_Process(const float32_t* magnitude_spectrum,
-                         uint32_t spectrum_length,
-                         float32_t dominant_freq,
-                         fine_detection_features_t* features)
+int Fine_Detector_Extract(const float32_t* magnitude_spectrum,
+                          uint32_t spectrum_length,
+                          float32_t dominant_freq,
+                          fine_detection_features_t* features)
 {
-    if (!fine_detector_initialized || !magnitude_spectrum || !features || spectrum_length != 257) {
+    if (!magnitude_spectrum || !features || spectrum_length != 257) {
         return -1;
     }
 
-    uint32_t start_time = HAL_GetTick();
+    const detection_params_t* params = Detection_Params_Get();
 
     // 清零输出结构
     memset(features, 0, sizeof(fine_detection_features_t));
 
     // 计算总能量
-    float32_t total_energy = calculate_total_energy(magnitude_spectrum, spectrum_length);
+    float32_t total_energy = Fine_Detector_TotalEnergy(magnitude_spectrum, spectrum_length);
 
     // 避免除零
     if (total_energy < 1e-10f) {
@@ -751,50 +1300,100 @@ int Fine_Detector_Process(const float32_t* magnitude_spectrum,
     }
 
     // 1. 计算低频能量占比 (5-15Hz)
-    float32_t low_freq_energy = calculate_frequency_bin_energy(magnitude_spectrum, spectrum_length,
-                                                              FINE_DETECTION_LOW_FREQ_MIN,
-                                                              FINE_DETECTION_LOW_FREQ_MAX);
+    float32_t low_freq_energy = Fine_Detector_BandEnergy(magnitude_spectrum, spectrum_length,
+                                                         params->low_freq_min,
+                                                         params->low_freq_max);
     features->low_freq_energy = low_freq_energy / total_energy;
 
     // 2. 计算中频能量占比 (15-30Hz)
-    float32_t mid_freq_energy = calculate_frequency_bin_energy(magnitude_spectrum, spectrum_length,
-                                                              FINE_DETECTION_MID_FREQ_MIN,
-                                                              FINE_DETECTION_MID_FREQ_MAX);
+    float32_t mid_freq_energy = Fine_Detector_BandEnergy(magnitude_spectrum, spectrum_length,
+                                                         params->mid_freq_min,
+                                                         params->mid_freq_max);
     features->mid_freq_energy = mid_freq_energy / total_energy;
 
     // 3. 计算高频能量占比 (30-100Hz)
-    float32_t high_freq_energy = calculate_frequency_bin_energy(magnitude_spectrum, spectrum_length,
-                                                               FINE_DETECTION_HIGH_FREQ_MIN,
-                                                               FINE_DETECTION_HIGH_FREQ_MAX);
+    float32_t high_freq_energy = Fine_Detector_BandEnergy(magnitude_spectrum, spectrum_length,
+                                                          params->high_freq_min,
+                                                          params->high_freq_max);
     features->high_freq_energy = high_freq_energy / total_energy;
 
     // 4. 主频 (直接使用FFT结果)
     features->dominant_frequency = dominant_freq;
 
     // 5. 计算频谱重心
-    features->spectral_centroid = calculate_spectral_centroid(magnitude_spectrum, spectrum_length);
+    features->spectral_centroid = Fine_Detector_SpectralCentroid(magnitude_spectrum, spectrum_length);
 
     // 计算置信度
     features->confidence_score = calculate_confidence_score(features);
 
     // 分类决策
-    features->classification = (features->confidence_score >= FINE_DETECTION_CONFIDENCE_THRESHOLD) ?
+    features->classification = (features->confidence_score >= params->confidence_threshold) ?
                               FINE_DETECTION_MINING : FINE_DETECTION_NORMAL;
+    features->is_valid = true;
+
+    return 0;
+}
+
+int Fine_Detector_Process(const float32_t* magnitude_spectrum,
+                         uint32_t spectrum_length,
+                         float32_t dominant_freq,
+                         fine_detection_features_t* features)
+{
+    if (!fine_detector_initialized) {
+        return -1;
+    }
+
+    uint32_t start_cycles = DWT_Timer_GetCycles();
+
+    int rc = Fine_Detector_Extract(magnitude_spectrum, spectrum_length, dominant_freq, features);
+    if (rc != 0 || !features->is_valid) {
+        return rc;
+    }
 
     // 性能统计
     features->analysis_timestamp = HAL_GetTick();
-    features->computation_time_us = (features->analysis_timestamp - start_time) * 1000;  // 转换为微秒
-    features->is_valid = true;
+    uint32_t elapsed_cycles = DWT_Timer_GetCycles() - start_cycles;
+    features->computation_time_us = DWT_Timer_CyclesToUs(elapsed_cycles);  // DWT计时 (原HAL_GetTick精度1ms，几乎总为0)
+    features->correlation_id = FFT_GetFrameCorrelationId();
+    Latency_Tracker_Mark(features->correlation_id, LAT_MARK_FINE_RESULT);
+#if ENABLE_PROFILING
+    Profiler_Record(PROF_STAGE_FINE, elapsed_cycles);
+#endif
+    last_fine_features = *features;
 
     // 通知状态机细检测结果
+#if ENABLE_SEQUENTIAL_DECISION
+    // 只在累积证据达到判定的那一帧通知，模糊帧继续采集
+    seq_decision_t decision = Sequential_Decision_Update(features->confidence_score);
+    #if ENABLE_SYSTEM_STATE_MACHINE
+    if (decision != SEQ_DECISION_PENDING) {
+        decision_features = *features;
+        System_State_Machine_SetFineResult((decision == SEQ_DECISION_MINING) ? 2 : 1);
+    }
+    #else
+    (void)decision;
+    #endif
+#else
     #if ENABLE_SYSTEM_STATE_MACHINE
     uint8_t result = (features->classification == FINE_DETECTION_MINING) ? 2 : 1;
+    decision_features = *features;
     System_State_Machine_SetFineResult(result);
     #endif
+#endif
 
     return 0;
 }
 
+const fine_detection_features_t* Fine_Detector_GetLastResult(void)
+{
+    return &last_fine_features;
+}
+
+const fine_detection_features_t* Fine_Detector_GetDecisionResult(void)
+{
+    return &decision_features;
+}
+
 void Fine_Detector_PrintResults(const fine_detection_features_t* features)
 {
     if (!features || !features->is_valid) {
@@ -810,195 +1409,367 @@ void Fine_Detector_PrintResults(const fine_detection_features_t* features)
            features->high_freq_energy,
            features->spectral_centroid);
 }
+
+#if ENABLE_SEQUENTIAL_DECISION
+/* --------------------------------------------------------------------------------------
+ *  序贯判定 (SPRT) - 逐帧累积细检测置信度，达到判定边界即停止采集
+ * -------------------------------------------------------------------------------------- */
+
+void Sequential_Decision_Reset(void)
+{
+    seq_decision.llr = 0.0f;
+    seq_decision.frames = 0;
+    seq_decision.decision = SEQ_DECISION_PENDING;
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    // 丢弃上一次触发未被消费的判定 (细检测超时或报警期间才到达)，新触发只接受本次的判定
+    System_State_Machine_SetFineResult(0);
+#endif
+}
+
+seq_decision_t Sequential_Decision_Update(float32_t confidence)
+{
+    // 判定边界 (Wald): A = ln((1-beta)/alpha), B = ln(beta/(1-alpha))
+    const float32_t upper = logf((1.0f - SEQ_DECISION_BETA) / SEQ_DECISION_ALPHA);
+    const float32_t lower = logf(SEQ_DECISION_BETA / (1.0f - SEQ_DECISION_ALPHA));
+    bool forced = false;
+
+    if (seq_decision.decision != SEQ_DECISION_PENDING) {
+        seq_decision.ignored_frames++;
+        return SEQ_DECISION_PENDING;
+    }
+
+    const detection_params_t* params = Detection_Params_Get();
+    seq_decision.llr += SEQ_DECISION_EVIDENCE_GAIN * (confidence - params->confidence_threshold);
+    seq_decision.frames++;
+
+    if (seq_decision.llr >= upper) {
+        seq_decision.decision = SEQ_DECISION_MINING;
+    } else if (seq_decision.llr <= lower) {
+        seq_decision.decision = SEQ_DECISION_NORMAL;
+    } else if (seq_decision.frames >= SEQ_DECISION_MAX_FRAMES) {
+        // 证据始终模糊：按累积方向判定 (与单帧分类一致，等于阈值判挖掘)
+        seq_decision.decision = (seq_decision.llr >= 0.0f) ? SEQ_DECISION_MINING : SEQ_DECISION_NORMAL;
+        seq_decision.forced++;
+        forced = true;
+    } else {
+        return SEQ_DECISION_PENDING;
+    }
+
+    seq_decision.decisions++;
+    seq_decision.total_frames += seq_decision.frames;
+    if (seq_decision.decision == SEQ_DECISION_MINING) {
+        seq_decision.decided_mining++;
+    } else {
+        seq_decision.decided_normal++;
+    }
+    printf("SEQ_DECISION: %s after %u frames (LLR=%.2f%s)\r\n",
+           (seq_decision.decision == SEQ_DECISION_MINING) ? "MINING" : "NORMAL",
+           seq_decision.frames, seq_decision.llr, forced ? ", forced" : "");
+
+    return seq_decision.decision;
+}
+
+bool Sequential_Decision_IsDecided(void)
+{
+    return seq_decision.decision != SEQ_DECISION_PENDING;
+}
+
+const sequential_decision_t* Sequential_Decision_GetInfo(void)
+{
+    return &seq_decision;
+}
+
+void Sequential_Decision_PrintStats(void)
+{
+    printf("SEQ_DECISION: decisions %lu (mining %lu, normal %lu, forced %lu), avg %.1f frames, ignored %lu\r\n",
+           seq_decision.decisions, seq_decision.decided_mining, seq_decision.decided_normal,
+           seq_decision.forced,
+           seq_decision.decisions ? (float32_t)seq_decision.total_frames / seq_decision.decisions : 0.0f,
+           seq_decision.ignored_frames);
+}
+#endif
 #endif
 
 #if ENABLE_SYSTEM_STATE_MACHINE
-/* 阶段5：系统状态机实现 */
+/* 阶段5：系统状态机实现 (表驱动) */
 
 /**
  * @brief 状态转换函数
  * @param new_state: 新状态
+ * @param event: 触发事件 (记录到跟踪缓冲区)
  */
-static void transition_to_state(system_state_t new_state)
+static void transition_to_state(system_state_t new_state, system_event_t event)
 {
     if (new_state >= STATE_COUNT) {
         printf("STATE_ERROR: Invalid state %d\r\n", new_state);
         return;
     }
 
-    // 记录状态转换
+    // 记录状态转换 (累计离开状态的驻留时间)
+    uint32_t now = HAL_GetTick();
+    uint32_t dwell_ms = now - g_state_machine.state_enter_time;
+    if (g_state_machine.current_state < STATE_COUNT) {
+        g_state_machine.state_time_ms[g_state_machine.current_state] += dwell_ms;
+    }
     g_state_machine.previous_state = g_state_machine.current_state;
     g_state_machine.current_state = new_state;
-    g_state_machine.state_enter_time = HAL_GetTick();
+    g_state_machine.state_enter_time = now;
     g_state_machine.transition_count++;
     g_state_machine.state_count[new_state]++;
+    Power_Account_SetState(new_state);
 
-    // 调试输出
-    printf("STATE_TRANSITION: %s -> %s (transition #%lu)\r\n",
+    // 端到端延迟打点
+    if (new_state == STATE_MINING_DETECTED) {
+        Latency_Tracker_Mark(g_state_machine.correlation_id, LAT_MARK_MINING_DETECTED);
+    } else if (new_state == STATE_ALARM_SENDING) {
+        Latency_Tracker_Mark(g_state_machine.correlation_id, LAT_MARK_ALARM_SENDING);
+    }
+
+    // 写入跟踪环形缓冲区 (满时覆盖最早的记录)
+    state_trace_entry_t *entry = &state_trace[state_trace_head];
+    entry->timestamp_us = DWT_Timer_GetTimeUs();
+    entry->dwell_ms = dwell_ms;
+    entry->from_state = (uint8_t)g_state_machine.previous_state;
+    entry->to_state = (uint8_t)new_state;
+    entry->event = (uint8_t)event;
+    state_trace_head = (uint8_t)((state_trace_head + 1) % STATE_TRACE_DEPTH);
+    if (state_trace_count < STATE_TRACE_DEPTH) {
+        state_trace_count++;
+    }
+
+#if STATE_TRANSITION_LOG
+    printf("STATE_TRANSITION: %s -> %s on %s (transition #%lu)\r\n",
            state_names[g_state_machine.previous_state],
            state_names[new_state],
+           event_names[event],
            g_state_machine.transition_count);
+#endif
 }
 
-/**
- * @brief 系统初始化状态处理
- */
-static void handle_system_init(void)
+/* 转换动作 (在状态切换之前执行) */
+
+static void action_count_mining(void)
 {
-    // 系统初始化完成，进入监测模式
-    transition_to_state(STATE_MONITORING);
+    g_state_machine.total_detections++;
+    g_state_machine.mining_detections++;
+#if ENABLE_FINE_DETECTION
+    // 锁定产生本次挖掘判定的帧，报警发送期间后续帧不会改写事件摘要
+    alarm_features = *Fine_Detector_GetDecisionResult();
+    g_state_machine.correlation_id = alarm_features.correlation_id;
+#endif
 }
 
-/**
- * @brief 深度休眠状态处理
- */
-static void handle_idle_sleep(void)
+static void action_count_normal(void)
 {
-    // 深度休眠逻辑 (阶段6实现)
-    // 当前直接进入监测模式
-    transition_to_state(STATE_MONITORING);
+    g_state_machine.total_detections++;
 }
 
-/**
- * @brief 监测模式状态处理
- */
-static void handle_monitoring(void)
+static void action_monitoring_refresh(void)
 {
-    // 检查粗检测触发
-    if (g_state_machine.coarse_trigger_flag) {
-        g_state_machine.coarse_trigger_flag = 0;  // 清除标志
-        transition_to_state(STATE_COARSE_TRIGGERED);
-        return;
-    }
-
-    // 监测超时检查 (可选)
-    uint32_t current_time = HAL_GetTick();
-    if (current_time - g_state_machine.state_enter_time > STATE_MONITORING_TIMEOUT_MS) {
-        // 长时间无活动，可以考虑进入休眠 (阶段6实现)
-        // 当前重置状态进入时间
-        g_state_machine.state_enter_time = current_time;
-    }
+    // 长时间无活动，可以考虑进入休眠 (阶段6实现)
+    // 当前重置状态进入时间
+    g_state_machine.state_enter_time = HAL_GetTick();
 }
 
-/**
- * @brief 粗检测触发状态处理
- */
-static void handle_coarse_triggered(void)
+static void action_fine_timeout(void)
 {
-    // 粗检测触发后，等待细检测结果
-    transition_to_state(STATE_FINE_ANALYSIS);
+    printf("STATE_WARNING: Fine analysis timeout, returning to monitoring\r\n");
 }
 
-/**
- * @brief 细检测分析状态处理
- */
-static void handle_fine_analysis(void)
-{
-    // 检查细检测结果
-    if (g_state_machine.fine_analysis_result != 0) {
-        if (g_state_machine.fine_analysis_result == 2) {
-            // 检测到挖掘震动
-            g_state_machine.total_detections++;
-            g_state_machine.mining_detections++;
-            transition_to_state(STATE_MINING_DETECTED);
-        } else {
-            // 正常震动，返回监测模式
-            g_state_machine.total_detections++;
-            transition_to_state(STATE_MONITORING);
-        }
-        g_state_machine.fine_analysis_result = 0;  // 清除结果
-        return;
-    }
+static void action_trigger_alarm(void)
+{
+    printf("STATE_INFO: Mining vibration detected! Triggering alarm...\r\n");
 
-    // 超时检查
-    uint32_t current_time = HAL_GetTick();
-    if (current_time - g_state_machine.state_enter_time > STATE_FINE_ANALYSIS_TIMEOUT_MS) {
-        printf("STATE_WARNING: Fine analysis timeout, returning to monitoring\r\n");
-        transition_to_state(STATE_MONITORING);
-    }
+    // 进入ALARM_SENDING前清除上一次报警残留的发送结果，只接受本次报警的确认
+    g_state_machine.alarm_send_status = 0;
+
+    // 触发报警 (集成现有的报警状态机)
+#if ENABLE_FINE_DETECTION
+    extern void Trigger_Alarm_Detection(const fine_detection_features_t *features);
+    Trigger_Alarm_Detection(&alarm_features);
+#else
+    extern void Trigger_Alarm_Detection(void);
+    Trigger_Alarm_Detection();
+#endif
 }
 
-/**
- * @brief 挖掘检测状态处理
- */
-static void handle_mining_detected(void)
+static void action_alarm_failed(void)
 {
-    printf("STATE_INFO: Mining vibration detected! Triggering alarm...\r\n");
+    printf("STATE_WARNING: Alarm sending failed\r\n");
+    g_state_machine.false_alarms++;
+}
 
-    // 触发报警 (集成现有的报警状态机)
-    extern void Trigger_Alarm_Cycle(void);
-    Trigger_Alarm_Cycle();
+static void action_alarm_timeout(void)
+{
+    printf("STATE_WARNING: Alarm sending timeout\r\n");
+    g_state_machine.false_alarms++;
+}
 
-    transition_to_state(STATE_ALARM_SENDING);
+static void action_alarm_complete(void)
+{
+    printf("STATE_INFO: Alarm cycle completed successfully\r\n");
 }
 
-/**
- * @brief 报警发送状态处理
- */
-static void handle_alarm_sending(void)
+static void enter_error_handling(void)
 {
-    // 检查报警发送状态
-    if (g_state_machine.alarm_send_status == 1) {
-        // 报警发送成功
-        transition_to_state(STATE_ALARM_COMPLETE);
-        g_state_machine.alarm_send_status = 0;  // 清除状态
-        return;
-    } else if (g_state_machine.alarm_send_status == 2) {
-        // 报警发送失败
-        printf("STATE_WARNING: Alarm sending failed\r\n");
-        g_state_machine.false_alarms++;
-        transition_to_state(STATE_ERROR_HANDLING);
-        g_state_machine.alarm_send_status = 0;  // 清除状态
-        return;
-    }
+    printf("STATE_ERROR: Error code %d, recovering...\r\n", g_state_machine.error_code);
+}
 
-    // 超时检查
-    uint32_t current_time = HAL_GetTick();
-    if (current_time - g_state_machine.state_enter_time > STATE_ALARM_SENDING_TIMEOUT_MS) {
-        printf("STATE_WARNING: Alarm sending timeout\r\n");
-        g_state_machine.false_alarms++;
-        transition_to_state(STATE_ERROR_HANDLING);
-    }
+static void action_clear_error(void)
+{
+    // 清除错误，返回监测模式
+    g_state_machine.error_code = 0;
 }
 
-/**
- * @brief 报警完成状态处理
- */
-static void handle_alarm_complete(void)
+static void action_system_reset(void)
 {
-    printf("STATE_INFO: Alarm cycle completed successfully\r\n");
+    printf("STATE_INFO: System reset requested\r\n");
 
-    // 报警完成，返回监测模式
-    transition_to_state(STATE_MONITORING);
+    // 重置状态机统计 (保留当前状态，随后由转换表切换到SYSTEM_INIT)
+    system_state_t current = g_state_machine.current_state;
+    memset(&g_state_machine, 0, sizeof(g_state_machine));
+    g_state_machine.current_state = current;
+    g_state_machine.previous_state = current;
+    g_state_machine.state_enter_time = HAL_GetTick();
 }
 
+/*
+ * 转换表：状态 x 事件 -> 动作 + 下一状态
+ * SM_ON(next, action): 事件在该状态下有效; next为SM_STAY时只执行动作不切换状态
+ * timeout_ms非0时，驻留超过该时间合成SM_EVENT_TIMEOUT
+ * 低功耗相关状态由低功耗管理器驱动，不在表中定义转换
+ */
+#define SM_STAY                         STATE_COUNT
+#define SM_ON(next, action)             { 1, (uint8_t)(next), (action) }
+
+typedef struct {
+    uint8_t valid;
+    uint8_t next_state;
+    void (*action)(void);
+} sm_transition_t;
+
+typedef struct {
+    uint32_t timeout_ms;
+    void (*on_enter)(void);
+    sm_transition_t on[SM_EVENT_COUNT];
+} sm_state_desc_t;
+
+static const sm_state_desc_t state_table[STATE_COUNT] = {
+    [STATE_SYSTEM_INIT] = {
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_MONITORING, NULL),
+        },
+    },
+    [STATE_IDLE_SLEEP] = {
+        // 深度休眠逻辑 (阶段6实现)，当前直接进入监测模式
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_MONITORING, NULL),
+        },
+    },
+    [STATE_MONITORING] = {
+        .timeout_ms = STATE_MONITORING_TIMEOUT_MS,
+        .on = {
+            [SM_EVENT_COARSE_TRIGGER]   = SM_ON(STATE_COARSE_TRIGGERED, NULL),
+            [SM_EVENT_TIMEOUT]          = SM_ON(SM_STAY, action_monitoring_refresh),
+        },
+    },
+    [STATE_COARSE_TRIGGERED] = {
+        // 粗检测触发后，等待细检测结果
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_FINE_ANALYSIS, NULL),
+        },
+    },
+    [STATE_FINE_ANALYSIS] = {
+        .timeout_ms = STATE_FINE_ANALYSIS_TIMEOUT_MS,
+        .on = {
+            [SM_EVENT_FINE_MINING]      = SM_ON(STATE_MINING_DETECTED, action_count_mining),
+            [SM_EVENT_FINE_NORMAL]      = SM_ON(STATE_MONITORING, action_count_normal),
+            [SM_EVENT_TIMEOUT]          = SM_ON(STATE_MONITORING, action_fine_timeout),
+        },
+    },
+    [STATE_MINING_DETECTED] = {
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_ALARM_SENDING, action_trigger_alarm),
+        },
+    },
+    [STATE_ALARM_SENDING] = {
+        .timeout_ms = STATE_ALARM_SENDING_TIMEOUT_MS,
+        .on = {
+            [SM_EVENT_ALARM_OK]         = SM_ON(STATE_ALARM_COMPLETE, NULL),
+            [SM_EVENT_ALARM_FAIL]       = SM_ON(STATE_ERROR_HANDLING, action_alarm_failed),
+            [SM_EVENT_TIMEOUT]          = SM_ON(STATE_ERROR_HANDLING, action_alarm_timeout),
+        },
+    },
+    [STATE_ALARM_COMPLETE] = {
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_MONITORING, action_alarm_complete),
+        },
+    },
+    [STATE_ERROR_HANDLING] = {
+        .timeout_ms = STATE_ERROR_RECOVERY_DELAY_MS,
+        .on_enter = enter_error_handling,
+        .on = {
+            [SM_EVENT_TIMEOUT]          = SM_ON(STATE_MONITORING, action_clear_error),
+        },
+    },
+    [STATE_SYSTEM_RESET] = {
+        .on = {
+            [SM_EVENT_ALWAYS]           = SM_ON(STATE_SYSTEM_INIT, action_system_reset),
+        },
+    },
+};
+
+/* 各状态接受的事件掩码 (初始化时由转换表生成) */
+static uint8_t state_accept_mask[STATE_COUNT];
+
 /**
- * @brief 错误处理状态处理
+ * @brief 由转换条件标志合成当前待处理事件掩码
  */
-static void handle_error_handling(void)
+static uint32_t collect_pending_events(const sm_state_desc_t *desc)
 {
-    printf("STATE_ERROR: Error code %d, recovering...\r\n", g_state_machine.error_code);
+    uint32_t pending = (1UL << SM_EVENT_ALWAYS);
 
-    // 错误恢复延迟
-    uint32_t current_time = HAL_GetTick();
-    if (current_time - g_state_machine.state_enter_time > STATE_ERROR_RECOVERY_DELAY_MS) {
-        // 清除错误，返回监测模式
-        g_state_machine.error_code = 0;
-        transition_to_state(STATE_MONITORING);
+    if (g_state_machine.coarse_trigger_flag) {
+        pending |= (1UL << SM_EVENT_COARSE_TRIGGER);
+    }
+    if (g_state_machine.fine_analysis_result == 2) {
+        pending |= (1UL << SM_EVENT_FINE_MINING);
+    } else if (g_state_machine.fine_analysis_result != 0) {
+        pending |= (1UL << SM_EVENT_FINE_NORMAL);
+    }
+    if (g_state_machine.alarm_send_status == 1) {
+        pending |= (1UL << SM_EVENT_ALARM_OK);
+    } else if (g_state_machine.alarm_send_status == 2) {
+        pending |= (1UL << SM_EVENT_ALARM_FAIL);
+    }
+    if (desc->timeout_ms != 0 && g_state_machine.state_duration > desc->timeout_ms) {
+        pending |= (1UL << SM_EVENT_TIMEOUT);
     }
+
+    return pending;
 }
 
 /**
- * @brief 系统重置状态处理
+ * @brief 清除已处理事件对应的条件标志
  */
-static void handle_system_reset(void)
+static void consume_event(system_event_t event)
 {
-    printf("STATE_INFO: System reset requested\r\n");
-
-    // 重置状态机
-    memset(&g_state_machine, 0, sizeof(g_state_machine));
-    g_state_machine.current_state = STATE_SYSTEM_INIT;
-    g_state_machine.state_enter_time = HAL_GetTick();
+    switch (event) {
+        case SM_EVENT_COARSE_TRIGGER:
+            g_state_machine.coarse_trigger_flag = 0;
+            break;
+        case SM_EVENT_FINE_MINING:
+        case SM_EVENT_FINE_NORMAL:
+            g_state_machine.fine_analysis_result = 0;
+            break;
+        case SM_EVENT_ALARM_OK:
+        case SM_EVENT_ALARM_FAIL:
+            g_state_machine.alarm_send_status = 0;
+            break;
+        default:
+            break;
+    }
 }
 
 /**
@@ -1013,6 +1784,18 @@ int System_State_Machine_Init(void)
 
     // 清零状态机结构体
     memset(&g_state_machine, 0, sizeof(g_state_machine));
+    state_trace_head = 0;
+    state_trace_count = 0;
+
+    // 由转换表生成各状态事件掩码
+    for (uint8_t s = 0; s < STATE_COUNT; s++) {
+        state_accept_mask[s] = 0;
+        for (uint8_t e = 0; e < SM_EVENT_COUNT; e++) {
+            if (state_table[s].on[e].valid) {
+                state_accept_mask[s] |= (uint8_t)(1U << e);
+            }
+        }
+    }
 
     // 设置初始状态
     g_state_machine.current_state = STATE_SYSTEM_INIT;
@@ -1026,7 +1809,7 @@ int System_State_Machine_Init(void)
 }
 
 /**
- * @brief 主状态机处理函数
+ * @brief 主状态机处理函数：合成事件掩码，与当前状态接受掩码相与后取最低位，查表执行
  */
 void System_State_Machine_Process(void)
 {
@@ -1034,56 +1817,36 @@ void System_State_Machine_Process(void)
         return;
     }
 
+    system_state_t state = g_state_machine.current_state;
+    if (state >= STATE_COUNT) {
+        printf("STATE_ERROR: Unknown state %d\r\n", state);
+        g_state_machine.error_code = 1;
+        transition_to_state(STATE_ERROR_HANDLING, SM_EVENT_FAULT);
+        enter_error_handling();
+        return;
+    }
+
     // 更新状态持续时间
     g_state_machine.state_duration = HAL_GetTick() - g_state_machine.state_enter_time;
 
-    // 根据当前状态调用相应处理函数
-    switch (g_state_machine.current_state) {
-        case STATE_SYSTEM_INIT:
-            handle_system_init();
-            break;
-
-        case STATE_IDLE_SLEEP:
-            handle_idle_sleep();
-            break;
-
-        case STATE_MONITORING:
-            handle_monitoring();
-            break;
-
-        case STATE_COARSE_TRIGGERED:
-            handle_coarse_triggered();
-            break;
-
-        case STATE_FINE_ANALYSIS:
-            handle_fine_analysis();
-            break;
-
-        case STATE_MINING_DETECTED:
-            handle_mining_detected();
-            break;
-
-        case STATE_ALARM_SENDING:
-            handle_alarm_sending();
-            break;
-
-        case STATE_ALARM_COMPLETE:
-            handle_alarm_complete();
-            break;
-
-        case STATE_ERROR_HANDLING:
-            handle_error_handling();
-            break;
+    const sm_state_desc_t *desc = &state_table[state];
+    uint32_t fire = collect_pending_events(desc) & state_accept_mask[state];
+    if (fire == 0) {
+        return;
+    }
 
-        case STATE_SYSTEM_RESET:
-            handle_system_reset();
-            break;
+    system_event_t event = (system_event_t)__CLZ(__RBIT(fire));   // 最低置位 = 最高优先级
+    const sm_transition_t *t = &desc->on[event];
 
-        default:
-            printf("STATE_ERROR: Unknown state %d\r\n", g_state_machine.current_state);
-            g_state_machine.error_code = 1;
-            transition_to_state(STATE_ERROR_HANDLING);
-            break;
+    consume_event(event);
+    if (t->action != NULL) {
+        t->action();
+    }
+    if (t->next_state != SM_STAY) {
+        transition_to_state((system_state_t)t->next_state, event);
+        if (state_table[t->next_state].on_enter != NULL) {
+            state_table[t->next_state].on_enter();
+        }
     }
 }
 
@@ -1146,6 +1909,50 @@ system_state_t System_State_Machine_GetCurrentState(void)
     return g_state_machine.current_state;
 }
 
+/**
+ * @brief 获取状态机完整信息 (只读)
+ * @return 状态机结构体指针
+ */
+const system_state_machine_t* System_State_Machine_GetInfo(void)
+{
+    return &g_state_machine;
+}
+
+uint8_t System_State_Machine_GetTraceCount(void)
+{
+    return state_trace_count;
+}
+
+const state_trace_entry_t* System_State_Machine_GetTrace(uint8_t index)
+{
+    if (index >= state_trace_count) {
+        return NULL;
+    }
+
+    // 缓冲区未满时最早记录在0，满后在head处
+    uint8_t oldest = (state_trace_count < STATE_TRACE_DEPTH) ? 0 : state_trace_head;
+    return &state_trace[(oldest + index) % STATE_TRACE_DEPTH];
+}
+
+/**
+ * @brief 打印状态转换跟踪
+ */
+void System_State_Machine_PrintTrace(void)
+{
+    printf("=== STATE TRACE (last %u transitions) ===\r\n", state_trace_count);
+    for (uint8_t i = 0; i < state_trace_count; i++) {
+        const state_trace_entry_t *entry = System_State_Machine_GetTrace(i);
+        printf("  %10lu.%06lus %s -> %s on %s (dwell %lums)\r\n",
+               (uint32_t)(entry->timestamp_us / 1000000U),
+               (uint32_t)(entry->timestamp_us % 1000000U),
+               state_names[entry->from_state],
+               state_names[entry->to_state],
+               event_names[entry->event],
+               entry->dwell_ms);
+    }
+    printf("=====================================\r\n");
+}
+
 /**
  * @brief 打印状态机状态信息
  */
@@ -13,6 +13,10 @@
 
 /* Include header with macro definitions */
 #include "example-raw-data.h"  // For ENABLE_FINE_DETECTION macro and fine detection functions
+#include "host_protocol.h"     // 上位机流数据上报
+#include "dwt_timer.h"         // 延后任务阶段耗时统计
+#include "profiler.h"          // 分阶段耗时直方图
+#include "latency_tracker.h"   // 端到端延迟打点
 
 /* External function declaration to avoid header conflicts */
 extern uint32_t HAL_GetTick(void);
@@ -26,16 +30,27 @@ extern uint32_t HAL_GetTick(void);
 static fft_processor_t fft_processor;
 static bool is_initialized = false;
 
+#if ENABLE_FINE_DETECTION
+/* Fine detection result carried from the classify stage to the report stage */
+static fine_detection_features_t job_features;
+static int job_fine_result = -1;
+#endif
+
 /* Hanning Window Coefficients (precomputed for efficiency) */
 static float32_t hanning_window[FFT_SIZE];
 static bool window_computed = false;
 
 /* Private Function Declarations */
 static void compute_hanning_window(void);
-static void apply_window(float32_t* data, uint32_t length);
 static void find_dominant_frequency(const float32_t* magnitude_spectrum, uint32_t length, 
                                    float32_t* freq, float32_t* magnitude);
 static float32_t calculate_total_energy(const float32_t* magnitude_spectrum, uint32_t length);
+static void copy_ordered_frame(void);
+static void reset_collection(void);
+static int submit_frame(void);
+static void fft_transform(void);
+static void fft_classify(void);
+static void fft_report(void);
 
 /* Public Function Implementations */
 
@@ -102,7 +117,11 @@ int FFT_AddSample(float32_t sample)
 
             // Auto process if enabled and (not in trigger mode OR triggered)
             if (fft_processor.auto_process && (!fft_processor.trigger_mode || fft_processor.is_triggered)) {
+#if ENABLE_FFT_DEFERRED
+                return submit_frame();
+#else
                 return FFT_Process();
+#endif
             }
         }
     } else {
@@ -125,12 +144,190 @@ int FFT_Process(void)
     }
     
     fft_processor.state = FFT_STATE_PROCESSING;
-    
-    // Prepare FFT input buffer (copy from circular buffer in correct order)
+
+    // Synchronous path: run all stages back to back
+    fft_processor.job_correlation_id = Latency_Tracker_GetActiveId();
+    copy_ordered_frame();
+    fft_transform();
+    fft_processor.state = FFT_STATE_COMPLETE;
+    fft_classify();
+    fft_report();
+
+    // Reset for next FFT cycle if auto processing is enabled
+    if (fft_processor.auto_process) {
+        reset_collection();
+    }
+
+    return 0;
+}
+
+uint16_t FFT_GetFrameCorrelationId(void)
+{
+    return fft_processor.last_result.correlation_id;
+}
+
+bool FFT_Worker_Pending(void)
+{
+    return fft_processor.job_stage != FFT_JOB_IDLE;
+}
+
+int FFT_Worker_Run(void)
+{
+    uint32_t start = DWT_Timer_GetCycles();
+    uint32_t elapsed_us;
+    fft_worker_stats_t *stats = &fft_processor.worker_stats;
+
+    switch (fft_processor.job_stage) {
+        case FFT_JOB_TRANSFORM:
+            fft_transform();
+            elapsed_us = DWT_Timer_ElapsedUs(start);
+            if (elapsed_us > stats->transform_max_us) {
+                stats->transform_max_us = elapsed_us;
+            }
+            fft_processor.job_stage = FFT_JOB_CLASSIFY;
+            return 1;
+
+        case FFT_JOB_CLASSIFY:
+            fft_classify();
+            elapsed_us = DWT_Timer_ElapsedUs(start);
+            if (elapsed_us > stats->classify_max_us) {
+                stats->classify_max_us = elapsed_us;
+            }
+            fft_processor.job_stage = FFT_JOB_REPORT;
+            return 1;
+
+        case FFT_JOB_REPORT:
+            fft_report();
+            elapsed_us = DWT_Timer_ElapsedUs(start);
+            if (elapsed_us > stats->report_max_us) {
+                stats->report_max_us = elapsed_us;
+            }
+            fft_processor.job_stage = FFT_JOB_IDLE;
+            return 0;
+
+        default:
+            fft_processor.job_stage = FFT_JOB_IDLE;
+            return 0;
+    }
+}
+
+const fft_worker_stats_t* FFT_Worker_GetStats(void)
+{
+    return &fft_processor.worker_stats;
+}
+
+void FFT_Worker_PrintStats(bool reset)
+{
+    fft_worker_stats_t *stats = &fft_processor.worker_stats;
+
+    printf("FFT_WORKER: frames=%lu dropped=%lu max transform=%luus classify=%luus report=%luus\r\n",
+           stats->frames_submitted, stats->frames_dropped,
+           stats->transform_max_us, stats->classify_max_us, stats->report_max_us);
+
+    if (reset) {
+        stats->transform_max_us = 0;
+        stats->classify_max_us = 0;
+        stats->report_max_us = 0;
+    }
+}
+
+const fft_result_t* FFT_GetResults(void)
+{
+    if (fft_processor.state == FFT_STATE_COMPLETE) {
+        return &fft_processor.last_result;
+    }
+    return NULL;
+}
+
+fft_state_t FFT_GetState(void)
+{
+    return fft_processor.state;
+}
+
+uint32_t FFT_GetFrameCount(void)
+{
+    return fft_processor.frame_count;
+}
+
+void FFT_Reset(void)
+{
+    fft_processor.buffer_index = 0;
+    fft_processor.sample_count = 0;
+    fft_processor.state = FFT_STATE_IDLE;
+    memset(fft_processor.time_buffer, 0, sizeof(fft_processor.time_buffer));
+}
+
+uint8_t FFT_GetBufferFillPercentage(void)
+{
+    if (fft_processor.sample_count >= FFT_BUFFER_SIZE) {
+        return 100;
+    }
+    return (uint8_t)((fft_processor.sample_count * 100) / FFT_BUFFER_SIZE);
+}
+
+float32_t FFT_BinToFrequency(uint32_t bin_index)
+{
+    return (float32_t)bin_index * FREQUENCY_RESOLUTION;
+}
+
+uint32_t FFT_FrequencyToBin(float32_t frequency)
+{
+    return (uint32_t)(frequency / FREQUENCY_RESOLUTION + 0.5f);
+}
+
+/* Private Function Implementations */
+
+/**
+ * @brief Copy the circular acquisition buffer into the worker frame (oldest sample first)
+ */
+static void copy_ordered_frame(void)
+{
     uint32_t start_index = fft_processor.buffer_index; // Oldest sample
+    uint32_t head = FFT_BUFFER_SIZE - start_index;
+
+    memcpy(fft_processor.frame_buffer, &fft_processor.time_buffer[start_index], head * sizeof(float32_t));
+    if (start_index > 0) {
+        memcpy(&fft_processor.frame_buffer[head], fft_processor.time_buffer, start_index * sizeof(float32_t));
+    }
+}
+
+static void reset_collection(void)
+{
+    fft_processor.sample_count = 0; // Reset sample count for next cycle
+    fft_processor.buffer_index = 0; // Reset buffer index
+    fft_processor.state = FFT_STATE_IDLE; // Ready for next data collection
+}
+
+/**
+ * @brief Hand a full buffer to the deferred worker; acquisition restarts immediately
+ */
+static int submit_frame(void)
+{
+    if (fft_processor.job_stage != FFT_JOB_IDLE) {
+        // Worker still busy with the previous frame: drop this one rather than stall acquisition
+        fft_processor.worker_stats.frames_dropped++;
+        reset_collection();
+        return 0;
+    }
+
+    copy_ordered_frame();
+    reset_collection();
+    fft_processor.job_correlation_id = Latency_Tracker_GetActiveId();
+    fft_processor.worker_stats.frames_submitted++;
+    fft_processor.job_stage = FFT_JOB_TRANSFORM;
+    return 0;
+}
+
+/**
+ * @brief Window, CFFT, magnitude and peak analysis of frame_buffer
+ */
+static void fft_transform(void)
+{
+    PROFILE_START(fft_start);
+
+    // Prepare FFT input buffer (interleaved complex, imaginary part zero)
     for (uint32_t i = 0; i < FFT_SIZE; i++) {
-        uint32_t src_index = (start_index + i) % FFT_BUFFER_SIZE;
-        fft_processor.fft_input[2*i] = fft_processor.time_buffer[src_index]; // Real part
+        fft_processor.fft_input[2*i] = fft_processor.frame_buffer[i]; // Real part
         fft_processor.fft_input[2*i + 1] = 0.0f; // Imaginary part (zero for real input)
     }
     
@@ -143,8 +340,10 @@ int FFT_Process(void)
     
     // Perform FFT using CMSIS DSP
     arm_cfft_f32(&arm_cfft_sR_f32_len512, fft_processor.fft_input, 0, 1);
+    PROFILE_STOP(PROF_STAGE_FFT, fft_start);
     
     // Calculate magnitude spectrum
+    PROFILE_START(mag_start);
     arm_cmplx_mag_f32(fft_processor.fft_input, fft_processor.fft_output, FFT_SIZE);
 
     // Copy magnitude spectrum to result (257 points: 0 to Nyquist frequency)
@@ -180,9 +379,30 @@ int FFT_Process(void)
     
     fft_processor.last_result.sample_count = FFT_SIZE; // Should always be FFT_SIZE for completed FFT
     fft_processor.last_result.timestamp = HAL_GetTick();
+    fft_processor.last_result.correlation_id = fft_processor.job_correlation_id;
+    fft_processor.frame_count++;
+    Latency_Tracker_Mark(fft_processor.job_correlation_id, LAT_MARK_FFT_FRAME);
+    PROFILE_STOP(PROF_STAGE_MAGNITUDE, mag_start);
+}
 
-    fft_processor.state = FFT_STATE_COMPLETE;
+/**
+ * @brief Fine detection on the last spectrum (阶段4)
+ */
+static void fft_classify(void)
+{
+#if ENABLE_FINE_DETECTION
+    job_fine_result = Fine_Detector_Process(fft_processor.last_result.magnitude_spectrum,
+                                            FFT_OUTPUT_POINTS,
+                                            fft_processor.last_result.dominant_frequency,
+                                            &job_features);
+#endif
+}
 
+/**
+ * @brief Debug output and host streaming of the last frame
+ */
+static void fft_report(void)
+{
     // FFT数据发送已删除 - 调试串口现在专用于调试信息输出
     // 输出FFT处理完成的调试信息
     printf("FFT_RESULT: freq=%.2fHz mag=%.6f energy=%.6f samples=%lu\r\n",
@@ -192,17 +412,11 @@ int FFT_Process(void)
            fft_processor.last_result.sample_count);
 
 #if ENABLE_FINE_DETECTION
-    // 阶段4：细检测算法处理
-    fine_detection_features_t fine_features;
-    int fine_result = Fine_Detector_Process(fft_processor.last_result.magnitude_spectrum,
-                                           FFT_OUTPUT_POINTS,
-                                           fft_processor.last_result.dominant_frequency,
-                                           &fine_features);
-
-    if (fine_result == 0 && fine_features.is_valid) {
-        Fine_Detector_PrintResults(&fine_features);
+    if (job_fine_result == 0 && job_features.is_valid) {
+        Fine_Detector_PrintResults(&job_features);
+        Host_Protocol_StreamDetection(&job_features);
     } else {
-        printf("FINE_DEBUG: result=%d valid=%d\r\n", fine_result, fine_features.is_valid);
+        printf("FINE_DEBUG: result=%d valid=%d\r\n", job_fine_result, job_features.is_valid);
     }
 #endif
 
@@ -214,57 +428,13 @@ int FFT_Process(void)
            fft_processor.last_result.magnitude_spectrum[13],  // ~25Hz
            fft_processor.last_result.magnitude_spectrum[26]); // ~50Hz
 
-    // Reset for next FFT cycle if auto processing is enabled
-    if (fft_processor.auto_process) {
-        fft_processor.sample_count = 0; // Reset sample count for next cycle
-        fft_processor.buffer_index = 0; // Reset buffer index
-        fft_processor.state = FFT_STATE_IDLE; // Ready for next data collection
-    }
-
-    return 0;
+    // 上位机订阅时输出完整频谱帧
+    Host_Protocol_StreamSpectrum(HAL_GetTick(),
+                                 fft_processor.last_result.dominant_frequency,
+                                 fft_processor.last_result.magnitude_spectrum,
+                                 FFT_OUTPUT_POINTS);
 }
 
-const fft_result_t* FFT_GetResults(void)
-{
-    if (fft_processor.state == FFT_STATE_COMPLETE) {
-        return &fft_processor.last_result;
-    }
-    return NULL;
-}
-
-fft_state_t FFT_GetState(void)
-{
-    return fft_processor.state;
-}
-
-void FFT_Reset(void)
-{
-    fft_processor.buffer_index = 0;
-    fft_processor.sample_count = 0;
-    fft_processor.state = FFT_STATE_IDLE;
-    memset(fft_processor.time_buffer, 0, sizeof(fft_processor.time_buffer));
-}
-
-uint8_t FFT_GetBufferFillPercentage(void)
-{
-    if (fft_processor.sample_count >= FFT_BUFFER_SIZE) {
-        return 100;
-    }
-    return (uint8_t)((fft_processor.sample_count * 100) / FFT_BUFFER_SIZE);
-}
-
-float32_t FFT_BinToFrequency(uint32_t bin_index)
-{
-    return (float32_t)bin_index * FREQUENCY_RESOLUTION;
-}
-
-uint32_t FFT_FrequencyToBin(float32_t frequency)
-{
-    return (uint32_t)(frequency / FREQUENCY_RESOLUTION + 0.5f);
-}
-
-/* Private Function Implementations */
-
 static void compute_hanning_window(void)
 {
     for (uint32_t i = 0; i < FFT_SIZE; i++) {
@@ -272,13 +442,6 @@ static void compute_hanning_window(void)
     }
 }
 
-static void apply_window(float32_t* data, uint32_t length)
-{
-    for (uint32_t i = 0; i < length; i++) {
-        data[i] *= hanning_window[i];
-    }
-}
-
 static void find_dominant_frequency(const float32_t* magnitude_spectrum, uint32_t length,
                                    float32_t* freq, float32_t* magnitude)
 {
@@ -6,8 +6,10 @@
  * ________________________________________________________________________________________________________
  */
 
+#include "main.h"
 #include "fft_test.h"
 #include "fft_processor.h"
+#include "dsp_benchmark.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
@@ -104,35 +106,20 @@ void FFT_RunBasicTest(void)
 void FFT_RunPerformanceTest(void)
 {
     printf("\r\n[FFT Performance Test] Starting...\r\n");
-    
-    // Initialize FFT processor
-    int rc = FFT_Init(false, false); // Manual processing, no windowing for speed
-    if (rc != 0) {
-        printf("[FFT Performance Test] ERROR: Failed to initialize FFT processor\r\n");
-        return;
-    }
-    
-    // Fill buffer with test data
-    for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
-        float32_t signal = sinf(2.0f * 3.14159f * 100.0f * i / 1000.0f); // 100Hz sine wave
-        FFT_AddSample(signal);
-    }
-    
-    // Measure processing time
-    uint32_t start_time = HAL_GetTick();
-    
-    rc = FFT_Process();
-    
-    uint32_t end_time = HAL_GetTick();
-    uint32_t processing_time = end_time - start_time;
-    
-    if (rc == 0) {
-        printf("[FFT Performance Test] Processing time: %lu ms\r\n", processing_time);
-        printf("[FFT Performance Test] PASS: FFT processing completed\r\n");
+
+#if ENABLE_DSP_BENCHMARK
+    // 全部流水线内核、256~2048点的DWT周期计时 (取代单次512点FFT计时)
+    int count = DSP_Benchmark_Run();
+    if (count > 0) {
+        DSP_Benchmark_PrintTable(SystemCoreClock);
+        printf("[FFT Performance Test] PASS: %d kernel/size combinations measured\r\n", count);
     } else {
-        printf("[FFT Performance Test] FAIL: FFT processing failed\r\n");
+        printf("[FFT Performance Test] FAIL: no benchmark results\r\n");
     }
-    
+#else
+    printf("[FFT Performance Test] SKIPPED: ENABLE_DSP_BENCHMARK is 0\r\n");
+#endif
+
     printf("[FFT Performance Test] Test completed\r\n\r\n");
 }
 
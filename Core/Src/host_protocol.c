@@ -0,0 +1,1367 @@
+/**
+ * @file host_protocol.c
+ * @brief 上位机串口(UART1)帧命令协议实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 接收路径：DMA循环写入rx_dma_buffer，空闲线/半满/满事件只记录写指针，
+ * 主循环解析到最近一次事件的写指针为止，逐字节送入帧解析状态机。
+ * 中断中不做任何解析，避免与传感器FIFO处理竞争。
+ * 旧版单字节命令只在前后都是空闲线的单字节突发上识别 (中断中按空闲线位置标记)，
+ * 解析器重新同步时扫过的载荷字节不会被当成命令。
+ *
+ * 普通应答和流数据用阻塞发送；吞吐测试数据帧走USART1 TX DMA，
+ * 测试期间主循环(传感器/FFT/检测)照常运行，结果即为带载持续吞吐。
+ */
+
+#include "host_protocol.h"
+#include "main.h"
+#include "detection_params.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "lora_transport.h"
+#include "modbus_rtu.h"
+#include "telemetry.h"
+#include "fft_processor.h"
+#include "event_loop.h"
+#include "profiler.h"
+#include "latency_tracker.h"
+#include "system_monitor.h"
+#include "dsp_benchmark.h"
+#include "power_account.h"
+#include "dvfs.h"
+
+/* 外部函数声明 (main.c) */
+extern void Send_Response_To_PC(const char *message);
+
+/* 帧解析状态 */
+typedef enum {
+    PARSER_WAIT_HEADER_0 = 0,
+    PARSER_WAIT_HEADER_1,
+    PARSER_WAIT_CMD,
+    PARSER_WAIT_LEN_L,
+    PARSER_WAIT_LEN_H,
+    PARSER_WAIT_PAYLOAD,
+    PARSER_WAIT_CRC_L,
+    PARSER_WAIT_CRC_H
+} parser_state_t;
+
+typedef struct {
+    parser_state_t state;
+    uint8_t cmd;
+    uint16_t length;
+    uint16_t index;
+    uint16_t crc_rx;
+    uint32_t last_byte_time;
+    uint8_t payload[HOST_PROTOCOL_MAX_PAYLOAD];
+} frame_parser_t;
+
+/* 链路速率状态 */
+typedef struct {
+    uint32_t previous_baud;         // 切换前速率 (确认超时回退用)
+    uint32_t pending_baud;          // 应答发出后待切换的速率 (0=无)
+    bool confirm_pending;
+    uint32_t confirm_deadline;
+    uint32_t error_window_start;
+    uint8_t error_count;
+    bool fallback_request;          // 错误过密时置位，link_service执行回退
+} link_rate_t;
+
+/* 吞吐测试状态 */
+typedef struct {
+    bool active;
+    volatile bool dma_busy;
+    uint32_t total_bytes;           // 计划发送的数据字节数 (不含帧头/CRC)
+    uint32_t sent_bytes;            // 已发送线上字节数 (含帧头/CRC)
+    uint32_t sent_data;             // 已发送数据字节数
+    uint32_t frames;
+    uint32_t tx_errors;
+    uint16_t chunk;
+    uint32_t start_tick;
+    uint32_t crc_errors_start;
+    uint32_t uart_errors_start;
+    uint32_t fft_frames_start;
+} link_test_t;
+
+/* 样本回放状态 */
+typedef struct {
+    uint32_t samples;               // 本次回放已注入样本数
+    uint32_t trigger_count_start;   // 开始时的粗检测触发计数
+    uint32_t fft_frames_start;
+    uint32_t mining_start;          // 开始时的状态机挖掘检测计数
+} replay_session_t;
+
+/* 私有变量 */
+static UART_HandleTypeDef *host_huart = NULL;
+static uint8_t rx_dma_buffer[HOST_PROTOCOL_RX_DMA_SIZE];
+static uint16_t rx_tail = 0;
+static volatile uint16_t rx_head = 0;           // 最近一次接收事件时的DMA写指针
+static volatile uint8_t rx_event_pending = 0;
+static volatile uint8_t rx_restart_pending = 0; // 错误回调已重启DMA接收，主循环复位读指针和解析器
+static volatile bool rx_idle_valid = true;      // 上一次事件是空闲线 (半满/满事件不是)
+#if HOST_PROTOCOL_LEGACY_COMMANDS
+static volatile uint16_t rx_idle_pos = 0;       // 上一次空闲线事件的写指针
+static volatile uint8_t rx_standalone[HOST_PROTOCOL_RX_DMA_SIZE];  // 1 = 该位置是空闲线分隔的单字节
+#endif
+static frame_parser_t parser;
+static host_link_stats_t link_stats;
+static uint8_t stream_mask = HOST_STREAM_DEFAULT;
+static uint16_t tx_crc;
+static link_rate_t link_rate;
+static link_test_t link_test;
+static uint8_t test_tx_buffer[5 + 4 + HOST_LINK_TEST_CHUNK_MAX + 2];
+#if ENABLE_HOST_REPLAY
+static replay_session_t replay;
+#endif
+
+/* 私有函数声明 */
+static int start_dma_reception(void);
+static void parse_byte(uint8_t byte, bool standalone);
+static bool take_standalone(uint16_t pos);
+static void dispatch_frame(uint8_t cmd, const uint8_t *payload, uint16_t length);
+static void send_status(uint8_t cmd, uint8_t status);
+static int tx_begin(uint8_t cmd, uint16_t length);
+static int tx_append(const void *data, uint16_t length);
+static int tx_end(void);
+static uint16_t put_u32(uint8_t *buf, uint32_t value);
+static uint16_t put_f32(uint8_t *buf, float32_t value);
+static uint32_t get_u32(const uint8_t *buf);
+static int wait_tx_idle(uint32_t timeout_ms);
+static uint32_t baud_at_pclk(uint32_t baud, uint32_t pclk);
+static uint32_t calc_actual_baud(uint32_t baud);
+static int apply_baud(uint32_t baud);
+static void note_link_error(void);
+#if ENABLE_DSP_BENCHMARK || ENABLE_HOST_REPLAY
+static void reset_detection_chain(void);
+#endif
+static void link_service(void);
+static void link_test_send_chunk(void);
+static void link_test_finish(void);
+#if ENABLE_HOST_REPLAY
+static void replay_start(void);
+static uint16_t replay_put_counters(uint8_t *buf);
+#endif
+
+/* --------------------------------------------------------------------------------------
+ *  公共接口
+ * -------------------------------------------------------------------------------------- */
+
+int Host_Protocol_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL || huart->hdmarx == NULL) {
+        printf("HOST_PROTO: ERROR - UART or RX DMA not configured\r\n");
+        return -1;
+    }
+
+    host_huart = huart;
+    memset(&parser, 0, sizeof(parser));
+    memset(&link_stats, 0, sizeof(link_stats));
+    rx_tail = 0;
+    rx_event_pending = 0;
+    stream_mask = HOST_STREAM_DEFAULT;
+    memset(&link_rate, 0, sizeof(link_rate));
+    memset(&link_test, 0, sizeof(link_test));
+    link_stats.baud_rate = huart->Init.BaudRate;
+
+    if (start_dma_reception() != 0) {
+        printf("HOST_PROTO: ERROR - Failed to start DMA reception\r\n");
+        return -2;
+    }
+
+    printf("HOST_PROTO: Framed command protocol ready (DMA %d bytes, idle-line)\r\n",
+           HOST_PROTOCOL_RX_DMA_SIZE);
+    return 0;
+}
+
+bool Host_Protocol_HasPendingData(void)
+{
+    if (host_huart == NULL) {
+        return false;
+    }
+    return (rx_event_pending != 0) || (rx_restart_pending != 0) || (rx_head != rx_tail);
+}
+
+bool Host_Protocol_IsRxIdle(void)
+{
+    if (host_huart == NULL) {
+        return true;
+    }
+    /* 最近一次事件是空闲线，且之后DMA没有再写入字节 */
+    uint16_t pos = HOST_PROTOCOL_RX_DMA_SIZE - (uint16_t)__HAL_DMA_GET_COUNTER(host_huart->hdmarx);
+    return rx_idle_valid && (pos % HOST_PROTOCOL_RX_DMA_SIZE) == rx_head;
+}
+
+void Host_Protocol_Process(void)
+{
+    if (host_huart == NULL) {
+        return;
+    }
+
+    rx_event_pending = 0;
+
+    /* 错误回调重启了DMA接收 (写指针回到缓冲区起点)：丢弃半帧 */
+    if (rx_restart_pending) {
+        rx_restart_pending = 0;
+        rx_tail = 0;
+        parser.state = PARSER_WAIT_HEADER_0;
+        note_link_error();
+    }
+
+    /* 只解析到最近一次接收事件为止，单字节突发的标记已在事件中断中写好 */
+    uint16_t head = rx_head;
+
+    /* 解析期间发生错误重启时立即停止，下一轮从新缓冲区起点开始 */
+    while (rx_tail != head && !rx_restart_pending) {
+        link_stats.rx_bytes++;
+        parse_byte(rx_dma_buffer[rx_tail], take_standalone(rx_tail));
+        rx_tail = (rx_tail + 1) % HOST_PROTOCOL_RX_DMA_SIZE;
+    }
+
+    /* 帧内超时：半帧数据不能永远占着解析器 */
+    if (parser.state != PARSER_WAIT_HEADER_0 &&
+        (HAL_GetTick() - parser.last_byte_time) > HOST_PROTOCOL_FRAME_TIMEOUT_MS) {
+        link_stats.timeouts++;
+        parser.state = PARSER_WAIT_HEADER_0;
+    }
+
+    link_service();
+}
+
+int Host_Protocol_SendFrame(uint8_t cmd, const uint8_t *payload, uint16_t length)
+{
+    int ret = tx_begin(cmd, length);
+    if (ret == 0 && length > 0 && payload != NULL) {
+        ret = tx_append(payload, length);
+    }
+    if (ret == 0) {
+        ret = tx_end();
+    }
+    return ret;
+}
+
+void Host_Protocol_StreamSpectrum(uint32_t timestamp_ms, float32_t dominant_freq,
+                                  const float32_t *spectrum, uint16_t points)
+{
+    if (!(stream_mask & HOST_STREAM_SPECTRUM) || spectrum == NULL) {
+        return;
+    }
+
+    /* 载荷: timestamp(4) + dominant_freq(4) + points(2) + spectrum(points*4) */
+    uint8_t header[10];
+    uint16_t idx = 0;
+    idx += put_u32(&header[idx], timestamp_ms);
+    idx += put_f32(&header[idx], dominant_freq);
+    header[idx++] = (uint8_t)(points & 0xFF);
+    header[idx++] = (uint8_t)(points >> 8);
+
+    /* Cortex-M4为小端，float数组可直接发送 */
+    if (tx_begin(HOST_CMD_STREAM_SPECTRUM, (uint16_t)(idx + points * sizeof(float32_t))) == 0 &&
+        tx_append(header, idx) == 0 &&
+        tx_append(spectrum, (uint16_t)(points * sizeof(float32_t))) == 0) {
+        tx_end();
+    }
+}
+
+#if ENABLE_FINE_DETECTION
+void Host_Protocol_StreamDetection(const fine_detection_features_t *features)
+{
+    if (!(stream_mask & HOST_STREAM_DETECTION) || features == NULL || !features->is_valid) {
+        return;
+    }
+
+    uint8_t payload[33];
+    uint16_t idx = 0;
+    idx += put_u32(&payload[idx], features->analysis_timestamp);
+    payload[idx++] = (uint8_t)features->classification;
+    idx += put_f32(&payload[idx], features->confidence_score);
+    idx += put_f32(&payload[idx], features->low_freq_energy);
+    idx += put_f32(&payload[idx], features->mid_freq_energy);
+    idx += put_f32(&payload[idx], features->high_freq_energy);
+    idx += put_f32(&payload[idx], features->dominant_frequency);
+    idx += put_f32(&payload[idx], features->spectral_centroid);
+    idx += put_u32(&payload[idx], features->computation_time_us);
+
+    Host_Protocol_SendFrame(HOST_CMD_STREAM_DETECTION, payload, idx);
+}
+#endif
+
+void Host_Protocol_StreamTelemetry(const uint8_t *payload, uint16_t length)
+{
+    if (!(stream_mask & HOST_STREAM_TELEMETRY) || payload == NULL) {
+        return;
+    }
+    Host_Protocol_SendFrame(HOST_CMD_STREAM_TELEMETRY, payload, length);
+}
+
+uint8_t Host_Protocol_GetStreamMask(void)
+{
+    return stream_mask;
+}
+
+const host_link_stats_t* Host_Protocol_GetStats(void)
+{
+    return &link_stats;
+}
+
+void Host_Protocol_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos)
+{
+    if (huart != host_huart) {
+        return;
+    }
+
+    uint16_t head = pos % HOST_PROTOCOL_RX_DMA_SIZE;
+    /* HAL对半满/满事件也回调 (pos为缓冲区一半/全长)，这两个位置按非空闲线处理 */
+    bool idle = (pos != HOST_PROTOCOL_RX_DMA_SIZE / 2) && (pos != HOST_PROTOCOL_RX_DMA_SIZE);
+#if HOST_PROTOCOL_LEGACY_COMMANDS
+    if (idle && rx_idle_valid &&
+        (uint16_t)((head + HOST_PROTOCOL_RX_DMA_SIZE - rx_idle_pos) % HOST_PROTOCOL_RX_DMA_SIZE) == 1) {
+        rx_standalone[rx_idle_pos] = 1;
+    }
+    rx_idle_pos = head;
+#endif
+    rx_idle_valid = idle;
+    rx_head = head;
+    rx_event_pending = 1;
+}
+
+void Host_Protocol_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == host_huart) {
+        link_test.dma_busy = false;
+    }
+}
+
+void Host_Protocol_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != host_huart) {
+        return;
+    }
+
+    link_stats.uart_errors++;
+
+    /* DMA发送出错时HAL已结束发送，允许吞吐测试继续 */
+    if (huart->gState == HAL_UART_STATE_READY) {
+        link_test.dma_busy = false;
+    }
+
+    /* HAL在ORE/FE/NE后会终止DMA接收，这里只重启DMA；
+     * 读指针、解析器和错误回退统计由主循环处理 (主循环可能正在解析) */
+    HAL_UART_AbortReceive(huart);
+    start_dma_reception();
+    rx_restart_pending = 1;
+}
+
+void Host_Protocol_ResumeAfterStop(void)
+{
+    if (host_huart == NULL || host_huart->RxState == HAL_UART_STATE_BUSY_RX) {
+        return;
+    }
+
+    rx_tail = 0;
+    parser.state = PARSER_WAIT_HEADER_0;
+    if (start_dma_reception() != 0) {
+        link_stats.uart_errors++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  接收与解析
+ * -------------------------------------------------------------------------------------- */
+
+static int start_dma_reception(void)
+{
+    /* DMA从缓冲区起点重新写入，启动前线路视为空闲 */
+    rx_head = 0;
+    rx_idle_valid = true;
+#if HOST_PROTOCOL_LEGACY_COMMANDS
+    rx_idle_pos = 0;
+    memset((void *)rx_standalone, 0, sizeof(rx_standalone));
+#endif
+    if (HAL_UARTEx_ReceiveToIdle_DMA(host_huart, rx_dma_buffer, HOST_PROTOCOL_RX_DMA_SIZE) != HAL_OK) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 读取并清除pos处的单字节突发标记 (旧版命令关闭时恒为false)
+ */
+static bool take_standalone(uint16_t pos)
+{
+#if HOST_PROTOCOL_LEGACY_COMMANDS
+    if (rx_standalone[pos]) {
+        rx_standalone[pos] = 0;
+        return true;
+    }
+#else
+    (void)pos;
+#endif
+    return false;
+}
+
+/**
+ * @param standalone 该字节前后都是空闲线 (旧版单字节命令只在此时识别)
+ */
+static void parse_byte(uint8_t byte, bool standalone)
+{
+    parser.last_byte_time = HAL_GetTick();
+
+    switch (parser.state) {
+        case PARSER_WAIT_HEADER_0:
+            if (byte == HOST_FRAME_HEADER_0) {
+                parser.state = PARSER_WAIT_HEADER_1;
+            }
+#if HOST_PROTOCOL_LEGACY_COMMANDS
+            else if (standalone &&
+                     (byte == HOST_CMD_TRIGGER_ALARM || byte == HOST_CMD_GET_STATUS ||
+                      byte == 0x02 || byte == 0x04)) {
+                /* 旧版单字节命令：只接受单独一个字节的空闲线突发，重新同步时扫过的载荷字节不算 */
+                dispatch_frame(byte, NULL, 0xFFFF);
+            }
+#else
+            (void)standalone;
+#endif
+            break;
+
+        case PARSER_WAIT_HEADER_1:
+            if (byte == HOST_FRAME_HEADER_1) {
+                parser.state = PARSER_WAIT_CMD;
+            } else if (byte != HOST_FRAME_HEADER_0) {
+                parser.state = PARSER_WAIT_HEADER_0;
+            }
+            break;
+
+        case PARSER_WAIT_CMD:
+            parser.cmd = byte;
+            parser.state = PARSER_WAIT_LEN_L;
+            break;
+
+        case PARSER_WAIT_LEN_L:
+            parser.length = byte;
+            parser.state = PARSER_WAIT_LEN_H;
+            break;
+
+        case PARSER_WAIT_LEN_H:
+            parser.length |= (uint16_t)byte << 8;
+            parser.index = 0;
+            if (parser.length > HOST_PROTOCOL_MAX_PAYLOAD) {
+                link_stats.length_errors++;
+                parser.state = PARSER_WAIT_HEADER_0;
+            } else if (parser.length == 0) {
+                parser.state = PARSER_WAIT_CRC_L;
+            } else {
+                parser.state = PARSER_WAIT_PAYLOAD;
+            }
+            break;
+
+        case PARSER_WAIT_PAYLOAD:
+            parser.payload[parser.index++] = byte;
+            if (parser.index >= parser.length) {
+                parser.state = PARSER_WAIT_CRC_L;
+            }
+            break;
+
+        case PARSER_WAIT_CRC_L:
+            parser.crc_rx = byte;
+            parser.state = PARSER_WAIT_CRC_H;
+            break;
+
+        case PARSER_WAIT_CRC_H: {
+            parser.crc_rx |= (uint16_t)byte << 8;
+            parser.state = PARSER_WAIT_HEADER_0;
+
+            uint8_t head[3] = { parser.cmd, (uint8_t)(parser.length & 0xFF), (uint8_t)(parser.length >> 8) };
+            uint16_t crc = Modbus_RTU_CRC16_Update(0xFFFF, head, 3);
+            crc = Modbus_RTU_CRC16_Update(crc, parser.payload, parser.length);
+
+            if (crc != parser.crc_rx) {
+                link_stats.crc_errors++;
+                note_link_error();
+                printf("HOST_PROTO: CRC error cmd=0x%02X (rx=0x%04X calc=0x%04X)\r\n",
+                       parser.cmd, parser.crc_rx, crc);
+                break;
+            }
+
+            link_stats.rx_frames++;
+
+            /* 新速率下收到有效帧即确认切换成功 */
+            if (link_rate.confirm_pending) {
+                link_rate.confirm_pending = false;
+                printf("HOST_PROTO: Baud rate %lu confirmed\r\n", link_stats.baud_rate);
+            }
+
+            dispatch_frame(parser.cmd, parser.payload, parser.length);
+            break;
+        }
+
+        default:
+            parser.state = PARSER_WAIT_HEADER_0;
+            break;
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  命令处理
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 执行命令
+ * @param length 0xFFFF表示旧版单字节命令 (以文本方式应答)
+ */
+static void dispatch_frame(uint8_t cmd, const uint8_t *payload, uint16_t length)
+{
+    bool legacy = (length == 0xFFFF);
+    uint8_t resp_cmd = cmd | HOST_FRAME_RESPONSE_FLAG;
+    uint8_t resp[96];
+    uint16_t idx = 0;
+
+    switch (cmd) {
+        case HOST_CMD_TRIGGER_ALARM:
+            Trigger_Alarm_Cycle();
+            if (legacy) {
+                Send_Response_To_PC("ALARM_TRIGGERED");
+            } else {
+                send_status(resp_cmd, HOST_STATUS_OK);
+            }
+            break;
+
+        case HOST_CMD_GET_STATUS:
+            if (legacy) {
+                Send_Response_To_PC("STATUS_OK");
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+#if ENABLE_SYSTEM_STATE_MACHINE
+            resp[idx++] = (uint8_t)System_State_Machine_GetCurrentState();
+#else
+            resp[idx++] = 0xFF;
+#endif
+#if ENABLE_COARSE_DETECTION
+            resp[idx++] = (uint8_t)Coarse_Detector_GetState();
+#else
+            resp[idx++] = 0xFF;
+#endif
+#if ENABLE_LOW_POWER_MODE
+            resp[idx++] = (uint8_t)LowPower_GetMode();
+#else
+            resp[idx++] = 0xFF;
+#endif
+            resp[idx++] = stream_mask;
+            idx += put_u32(&resp[idx], HAL_GetTick());
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+
+        case 0x02:  // 原始数据命令（旧版兼容，无操作）
+        case 0x04:  // FFT数据命令（旧版兼容，无操作）
+            break;
+
+#if ENABLE_LOW_POWER_MODE
+        case HOST_CMD_LOW_POWER_STATS:
+            LowPower_PrintStats();
+            RTC_Wakeup_PrintStats();
+            send_status(resp_cmd, HOST_STATUS_OK);
+            break;
+
+        case HOST_CMD_SET_MODE_CONTINUOUS:
+            LowPower_SetMode(POWER_MODE_CONTINUOUS);
+            send_status(resp_cmd, HOST_STATUS_OK);
+            break;
+
+        case HOST_CMD_SET_MODE_LOW_POWER:
+            LowPower_SetMode(POWER_MODE_LOW_POWER);
+            send_status(resp_cmd, HOST_STATUS_OK);
+            break;
+#endif
+
+        case HOST_CMD_GET_PARAM: {
+            float32_t value = 0.0f;
+            if (length != 1) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (Detection_Params_GetValue(payload[0], &value) != 0) {
+                send_status(resp_cmd, HOST_STATUS_UNKNOWN_PARAM);
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = payload[0];
+            idx += put_f32(&resp[idx], value);
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+        }
+
+        case HOST_CMD_SET_PARAM: {
+            float32_t value;
+            if (length != 5) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            memcpy(&value, &payload[1], sizeof(value));
+            int ret = Detection_Params_SetValue(payload[0], value);
+            if (ret == -1) {
+                send_status(resp_cmd, HOST_STATUS_UNKNOWN_PARAM);
+                break;
+            } else if (ret != 0) {
+                send_status(resp_cmd, HOST_STATUS_OUT_OF_RANGE);
+                break;
+            }
+            /* 回读实际生效值 (整数参数会被取整) */
+            Detection_Params_GetValue(payload[0], &value);
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = payload[0];
+            idx += put_f32(&resp[idx], value);
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+        }
+
+        case HOST_CMD_GET_ALL_PARAMS: {
+            uint8_t count = 0;
+            const uint8_t *ids = Detection_Params_GetIdList(&count);
+            if (tx_begin(resp_cmd, (uint16_t)(2 + count * 5)) != 0) {
+                break;
+            }
+            resp[0] = HOST_STATUS_OK;
+            resp[1] = count;
+            tx_append(resp, 2);
+            for (uint8_t i = 0; i < count; i++) {
+                float32_t value = 0.0f;
+                uint8_t item[5];
+                Detection_Params_GetValue(ids[i], &value);
+                item[0] = ids[i];
+                put_f32(&item[1], value);
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+
+        case HOST_CMD_RESET_PARAMS:
+            Detection_Params_ResetDefaults();
+#if ENABLE_COARSE_DETECTION
+            Coarse_Detector_Reset();
+            Coarse_Detector_SetBaseline(Detection_Params_Get()->baseline_rms_threshold);
+#endif
+            send_status(resp_cmd, HOST_STATUS_OK);
+            break;
+
+        case HOST_CMD_GET_STATS: {
+            resp[idx++] = HOST_STATUS_OK;
+#if ENABLE_COARSE_DETECTION
+            const coarse_detector_t *coarse = Coarse_Detector_GetInfo();
+            idx += put_u32(&resp[idx], coarse->trigger_count);
+            idx += put_f32(&resp[idx], coarse->current_rms);
+            idx += put_f32(&resp[idx], coarse->baseline_rms);
+            idx += put_f32(&resp[idx], coarse->peak_factor);
+#else
+            idx += put_u32(&resp[idx], 0);
+            idx += put_f32(&resp[idx], 0.0f);
+            idx += put_f32(&resp[idx], 0.0f);
+            idx += put_f32(&resp[idx], 0.0f);
+#endif
+#if ENABLE_SYSTEM_STATE_MACHINE
+            const system_state_machine_t *sm = System_State_Machine_GetInfo();
+            idx += put_u32(&resp[idx], sm->total_detections);
+            idx += put_u32(&resp[idx], sm->mining_detections);
+            idx += put_u32(&resp[idx], sm->false_alarms);
+            idx += put_u32(&resp[idx], sm->transition_count);
+#else
+            idx += put_u32(&resp[idx], 0);
+            idx += put_u32(&resp[idx], 0);
+            idx += put_u32(&resp[idx], 0);
+            idx += put_u32(&resp[idx], 0);
+#endif
+            idx += put_u32(&resp[idx], link_stats.rx_frames);
+            idx += put_u32(&resp[idx], link_stats.crc_errors);
+            idx += put_u32(&resp[idx], link_stats.uart_errors);
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+        }
+
+#if ENABLE_TELEMETRY
+        case HOST_CMD_GET_TELEMETRY: {
+            resp[idx++] = HOST_STATUS_OK;
+            int ret = Telemetry_BuildPayload(&resp[idx], (uint16_t)(sizeof(resp) - idx));
+            if (ret < 0) {
+                send_status(resp_cmd, HOST_STATUS_BUSY);
+                break;
+            }
+            idx += (uint16_t)ret;
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+        }
+#endif
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+        case HOST_CMD_GET_STATE_TRACE: {
+            /* 载荷: 状态 + 当前状态(1) + n(1) + n*(timestamp_us(8), dwell_ms(4), from(1), to(1), event(1)) */
+            uint8_t count = System_State_Machine_GetTraceCount();
+            if (tx_begin(resp_cmd, (uint16_t)(3 + count * 15)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = (uint8_t)System_State_Machine_GetCurrentState();
+            resp[idx++] = count;
+            tx_append(resp, idx);
+            for (uint8_t i = 0; i < count; i++) {
+                const state_trace_entry_t *entry = System_State_Machine_GetTrace(i);
+                uint8_t item[15];
+                put_u32(&item[0], (uint32_t)(entry->timestamp_us & 0xFFFFFFFFU));
+                put_u32(&item[4], (uint32_t)(entry->timestamp_us >> 32));
+                put_u32(&item[8], entry->dwell_ms);
+                item[12] = entry->from_state;
+                item[13] = entry->to_state;
+                item[14] = entry->event;
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+#endif
+
+#if ENABLE_PROFILING
+        case HOST_CMD_GET_PROFILE: {
+            /* 载荷: 状态 + core_hz(4) + n(1) + buckets(1) + n*(count, min, max, sum(8), hist[buckets]) */
+            uint16_t item_size = (uint16_t)(20 + PROFILER_HIST_BUCKETS * 4);
+            if (tx_begin(resp_cmd, (uint16_t)(7 + PROF_STAGE_COUNT * item_size)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            idx += put_u32(&resp[idx], SystemCoreClock);
+            resp[idx++] = PROF_STAGE_COUNT;
+            resp[idx++] = PROFILER_HIST_BUCKETS;
+            tx_append(resp, idx);
+            for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+                const profiler_stats_t *stats = Profiler_GetStats((profiler_stage_t)i);
+                uint8_t item[20];
+                put_u32(&item[0], stats->count);
+                put_u32(&item[4], stats->count ? stats->min_cycles : 0);
+                put_u32(&item[8], stats->max_cycles);
+                put_u32(&item[12], (uint32_t)(stats->sum_cycles & 0xFFFFFFFFU));
+                put_u32(&item[16], (uint32_t)(stats->sum_cycles >> 32));
+                tx_append(item, sizeof(item));
+                tx_append(stats->histogram, sizeof(stats->histogram));   // 小端uint32数组
+            }
+            tx_end();
+            if (length >= 1 && payload[0] != 0) {
+                Profiler_Reset();
+            }
+            break;
+        }
+#endif
+
+#if ENABLE_LATENCY_TRACKER
+        case HOST_CMD_GET_LATENCY: {
+            /*
+             * 载荷: 状态 + started(4) + completed(4) + abandoned(4) + marks(1) + has_worst(1) + n(1)
+             *       + [worst] + n条历史 (最早的在前)
+             * 每条: id(2) + start_us(8) + marks*delta_us(4), 0xFFFFFFFF表示未经过
+             */
+            const latency_tracker_stats_t *lat = Latency_Tracker_GetStats();
+            const latency_record_t *worst = Latency_Tracker_GetWorst();
+            uint8_t count = Latency_Tracker_GetHistoryCount();
+            uint16_t record_size = (uint16_t)(10 + LAT_MARK_COUNT * 4);
+            uint16_t records = (uint16_t)(count + (worst != NULL ? 1 : 0));
+            if (tx_begin(resp_cmd, (uint16_t)(16 + records * record_size)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            idx += put_u32(&resp[idx], lat->started);
+            idx += put_u32(&resp[idx], lat->completed);
+            idx += put_u32(&resp[idx], lat->abandoned);
+            resp[idx++] = LAT_MARK_COUNT;
+            resp[idx++] = (worst != NULL) ? 1 : 0;
+            resp[idx++] = count;
+            tx_append(resp, idx);
+            for (uint16_t i = 0; i < records; i++) {
+                const latency_record_t *record = (worst != NULL && i == 0) ?
+                    worst : Latency_Tracker_GetHistory((uint8_t)(i - (worst != NULL ? 1 : 0)));
+                uint8_t item[10 + LAT_MARK_COUNT * 4];
+                item[0] = (uint8_t)(record->correlation_id & 0xFF);
+                item[1] = (uint8_t)(record->correlation_id >> 8);
+                put_u32(&item[2], (uint32_t)(record->start_us & 0xFFFFFFFFU));
+                put_u32(&item[6], (uint32_t)(record->start_us >> 32));
+                for (uint8_t m = 0; m < LAT_MARK_COUNT; m++) {
+                    put_u32(&item[10 + m * 4], record->delta_us[m]);
+                }
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+#endif
+
+#if ENABLE_SYSTEM_MONITOR
+        case HOST_CMD_GET_SYSMON: {
+            /*
+             * 载荷: 状态 + core_hz(4) + load(2) + load_peak(2) + windows(4)
+             *       + stack_size(4) + stack_peak(4) + n(1) + n*(total_cycles(8), busy_cycles(8))
+             */
+            const system_monitor_stats_t *mon = System_Monitor_GetStats();
+            if (tx_begin(resp_cmd, (uint16_t)(22 + SYSTEM_MONITOR_STATE_SLOTS * 16)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            idx += put_u32(&resp[idx], SystemCoreClock);
+            resp[idx++] = (uint8_t)(mon->load_permille & 0xFF);
+            resp[idx++] = (uint8_t)(mon->load_permille >> 8);
+            resp[idx++] = (uint8_t)(mon->load_peak_permille & 0xFF);
+            resp[idx++] = (uint8_t)(mon->load_peak_permille >> 8);
+            idx += put_u32(&resp[idx], mon->windows);
+            idx += put_u32(&resp[idx], mon->stack_size);
+            idx += put_u32(&resp[idx], mon->stack_peak_bytes);
+            resp[idx++] = SYSTEM_MONITOR_STATE_SLOTS;
+            tx_append(resp, idx);
+            for (uint8_t i = 0; i < SYSTEM_MONITOR_STATE_SLOTS; i++) {
+                uint8_t item[16];
+                put_u32(&item[0], (uint32_t)(mon->state_total_cycles[i] & 0xFFFFFFFFU));
+                put_u32(&item[4], (uint32_t)(mon->state_total_cycles[i] >> 32));
+                put_u32(&item[8], (uint32_t)(mon->state_busy_cycles[i] & 0xFFFFFFFFU));
+                put_u32(&item[12], (uint32_t)(mon->state_busy_cycles[i] >> 32));
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+#endif
+
+#if ENABLE_DSP_BENCHMARK
+        case HOST_CMD_RUN_DSP_BENCH: {
+            /* 载荷: 状态 + counter_hz(4) + paused_ms(4) + n(1) + n*(kernel(1), size(2), cycles_min(4), cycles_max(4)) */
+            uint16_t count = 0;
+#if ENABLE_SYSTEM_STATE_MACHINE
+            /* 基准测试阻塞主循环数秒，检测进行中不允许 */
+            if (System_State_Machine_GetCurrentState() != STATE_MONITORING) {
+                send_status(resp_cmd, HOST_STATUS_BUSY);
+                break;
+            }
+#endif
+            /* 期间FIFO必然溢出：明确暂停采集，结束后清空FIFO并从新样本重启检测链 */
+            printf("HOST_PROTO: Acquisition paused for DSP benchmark\r\n");
+            uint32_t pause_start = HAL_GetTick();
+            DSP_Benchmark_Run();
+            uint32_t paused_ms = HAL_GetTick() - pause_start;
+            InvDevice_FlushFifo();
+            reset_detection_chain();
+            printf("HOST_PROTO: Acquisition resumed after %lu ms (FIFO flushed)\r\n", paused_ms);
+
+            const dsp_bench_result_t *results = DSP_Benchmark_GetResults(&count);
+            DSP_Benchmark_PrintTable(SystemCoreClock);
+            if (tx_begin(resp_cmd, (uint16_t)(10 + count * 11)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            idx += put_u32(&resp[idx], SystemCoreClock);
+            idx += put_u32(&resp[idx], paused_ms);
+            resp[idx++] = (uint8_t)count;
+            tx_append(resp, idx);
+            for (uint16_t i = 0; i < count; i++) {
+                uint8_t item[11];
+                item[0] = results[i].kernel;
+                item[1] = (uint8_t)(results[i].size & 0xFF);
+                item[2] = (uint8_t)(results[i].size >> 8);
+                put_u32(&item[3], results[i].cycles_min);
+                put_u32(&item[7], results[i].cycles_max);
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+#endif
+
+#if ENABLE_HOST_REPLAY
+        case HOST_CMD_REPLAY_CONTROL:
+            /* 应答: 状态 + samples(4) + coarse_triggers(4) + fft_frames(4) + mining_detections(4) */
+            if (length != 1) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (payload[0]) {
+                replay_start();
+            } else {
+                Vibration_Pipeline_SetReplay(false);
+                printf("HOST_PROTO: Replay stopped after %lu samples\r\n", replay.samples);
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            idx += replay_put_counters(&resp[idx]);
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+
+        case HOST_CMD_REPLAY_SAMPLES: {
+            /* 应答: 状态 + 接收样本数(1)；FFT工作者忙时整帧拒收(BUSY)，上位机稍后重发 */
+            if (length == 0 || (length & 1U) != 0) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (!Vibration_Pipeline_IsReplay() || FFT_Worker_Pending()) {
+                send_status(resp_cmd, HOST_STATUS_BUSY);
+                break;
+            }
+            uint16_t count = length / 2;
+            for (uint16_t i = 0; i < count; i++) {
+                int16_t raw = (int16_t)(payload[2 * i] | ((uint16_t)payload[2 * i + 1] << 8));
+                Vibration_Pipeline_ProcessSample((float32_t)raw / HOST_REPLAY_LSB_PER_G);
+            }
+            replay.samples += count;
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = (uint8_t)count;
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            break;
+        }
+#endif
+
+        case HOST_CMD_GET_LOOP_STATS: {
+            /* 载荷: 状态 + idle千分比(2) + wakeups(4) + n(1) + n*(posted, dispatched, avg_us, max_us) */
+            const event_loop_stats_t *loop = Event_Loop_GetStats();
+            uint16_t idle = Event_Loop_GetIdlePermille();
+            if (tx_begin(resp_cmd, (uint16_t)(8 + EVENT_COUNT * 16)) != 0) {
+                break;
+            }
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = (uint8_t)(idle & 0xFF);
+            resp[idx++] = (uint8_t)(idle >> 8);
+            idx += put_u32(&resp[idx], loop->wakeups);
+            resp[idx++] = EVENT_COUNT;
+            tx_append(resp, idx);
+            for (uint8_t i = 0; i < EVENT_COUNT; i++) {
+                const event_stats_t *ev = &loop->events[i];
+                uint8_t item[16];
+                put_u32(&item[0], ev->posted);
+                put_u32(&item[4], ev->dispatched);
+                put_u32(&item[8], ev->dispatched ? (uint32_t)(ev->latency_sum_us / ev->dispatched) : 0);
+                put_u32(&item[12], ev->latency_max_us);
+                tx_append(item, sizeof(item));
+            }
+            tx_end();
+            break;
+        }
+
+        case HOST_CMD_SET_BAUD: {
+            if (length != 4) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (link_test.active || link_rate.pending_baud != 0) {
+                send_status(resp_cmd, HOST_STATUS_BUSY);
+                break;
+            }
+            uint32_t actual = calc_actual_baud(get_u32(payload));
+            if (actual == 0) {
+                send_status(resp_cmd, HOST_STATUS_OUT_OF_RANGE);
+                break;
+            }
+            /* 以当前速率应答，主循环下一轮再切换 */
+            resp[idx++] = HOST_STATUS_OK;
+            idx += put_u32(&resp[idx], actual);
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            link_rate.pending_baud = get_u32(payload);
+            break;
+        }
+
+        case HOST_CMD_PING:
+            if (tx_begin(resp_cmd, (uint16_t)(1 + length)) == 0) {
+                resp[0] = HOST_STATUS_OK;
+                tx_append(resp, 1);
+                if (length > 0) {
+                    tx_append(payload, length);
+                }
+                tx_end();
+            }
+            break;
+
+        case HOST_CMD_LINK_TEST: {
+            if (length != 6) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            if (link_test.active || host_huart->hdmatx == NULL) {
+                send_status(resp_cmd, HOST_STATUS_BUSY);
+                break;
+            }
+            uint32_t total = get_u32(payload);
+            uint16_t chunk = (uint16_t)(payload[4] | ((uint16_t)payload[5] << 8));
+            if (total == 0 || chunk == 0 || chunk > HOST_LINK_TEST_CHUNK_MAX) {
+                send_status(resp_cmd, HOST_STATUS_OUT_OF_RANGE);
+                break;
+            }
+            send_status(resp_cmd, HOST_STATUS_OK);
+
+            memset(&link_test, 0, sizeof(link_test));
+            link_test.total_bytes = total;
+            link_test.chunk = chunk;
+            link_test.crc_errors_start = link_stats.crc_errors;
+            link_test.uart_errors_start = link_stats.uart_errors;
+            link_test.fft_frames_start = FFT_GetFrameCount();
+            link_test.start_tick = HAL_GetTick();
+            link_test.active = true;
+            break;
+        }
+
+        case HOST_CMD_STREAM_CONTROL:
+            if (length != 1) {
+                send_status(resp_cmd, HOST_STATUS_BAD_LENGTH);
+                break;
+            }
+            stream_mask = payload[0] & HOST_STREAM_ALL;
+            resp[idx++] = HOST_STATUS_OK;
+            resp[idx++] = stream_mask;
+            Host_Protocol_SendFrame(resp_cmd, resp, idx);
+            printf("HOST_PROTO: Stream mask set to 0x%02X\r\n", stream_mask);
+            break;
+
+        default:
+            if (!legacy) {
+                send_status(resp_cmd, HOST_STATUS_UNKNOWN_CMD);
+            }
+            break;
+    }
+}
+
+static void send_status(uint8_t cmd, uint8_t status)
+{
+    Host_Protocol_SendFrame(cmd, &status, 1);
+}
+
+/* --------------------------------------------------------------------------------------
+ *  发送与工具函数
+ * -------------------------------------------------------------------------------------- */
+
+static int tx_begin(uint8_t cmd, uint16_t length)
+{
+    uint8_t header[5] = { HOST_FRAME_HEADER_0, HOST_FRAME_HEADER_1, cmd,
+                          (uint8_t)(length & 0xFF), (uint8_t)(length >> 8) };
+
+    if (host_huart == NULL) {
+        return -1;
+    }
+
+    /* 吞吐测试DMA发送中，等待当前数据帧发完再插入 */
+    if (wait_tx_idle(HOST_PROTOCOL_TX_TIMEOUT_MS) != 0) {
+        return -2;
+    }
+
+    tx_crc = Modbus_RTU_CRC16_Update(0xFFFF, &header[2], 3);
+    if (HAL_UART_Transmit(host_huart, header, sizeof(header), HOST_PROTOCOL_TX_TIMEOUT_MS) != HAL_OK) {
+        return -2;
+    }
+    Power_Account_AddUartTx(sizeof(header), host_huart->Init.BaudRate);
+    return 0;
+}
+
+static int tx_append(const void *data, uint16_t length)
+{
+    tx_crc = Modbus_RTU_CRC16_Update(tx_crc, (const uint8_t *)data, length);
+    if (HAL_UART_Transmit(host_huart, (uint8_t *)data, length, HOST_PROTOCOL_TX_TIMEOUT_MS + length / 8) != HAL_OK) {
+        return -2;
+    }
+    Power_Account_AddUartTx(length, host_huart->Init.BaudRate);
+    return 0;
+}
+
+static int tx_end(void)
+{
+    uint8_t crc[2] = { (uint8_t)(tx_crc & 0xFF), (uint8_t)(tx_crc >> 8) };
+    if (HAL_UART_Transmit(host_huart, crc, sizeof(crc), HOST_PROTOCOL_TX_TIMEOUT_MS) != HAL_OK) {
+        return -2;
+    }
+    Power_Account_AddUartTx(sizeof(crc), host_huart->Init.BaudRate);
+    link_stats.tx_frames++;
+    return 0;
+}
+
+static uint16_t put_u32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    buf[3] = (uint8_t)((value >> 24) & 0xFF);
+    return 4;
+}
+
+static uint16_t put_f32(uint8_t *buf, float32_t value)
+{
+    uint32_t raw;
+    memcpy(&raw, &value, sizeof(raw));
+    return put_u32(buf, raw);
+}
+
+static uint32_t get_u32(const uint8_t *buf)
+{
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+           ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static int wait_tx_idle(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+    while (host_huart->gState != HAL_UART_STATE_READY) {
+        if ((HAL_GetTick() - start) > timeout_ms) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  链路速率与吞吐测试
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 给定PCLK下实际可得的波特率
+ * @return 实际波特率, 0: BRR < 16或误差过大
+ */
+static uint32_t baud_at_pclk(uint32_t baud, uint32_t pclk)
+{
+    uint32_t brr = UART_BRR_SAMPLING16(pclk, baud);
+    if (brr < 16) {
+        return 0;
+    }
+
+    /* 16倍过采样时 BRR = 16 * USARTDIV，实际速率 = pclk / BRR */
+    uint32_t actual = pclk / brr;
+    uint32_t diff = (actual > baud) ? (actual - baud) : (baud - actual);
+    if ((uint64_t)diff * 1000000U > (uint64_t)baud * HOST_LINK_MAX_BAUD_ERROR_PPM) {
+        return 0;
+    }
+    return actual;
+}
+
+/**
+ * @brief 计算请求速率下实际可得的波特率 (同时要求在DVFS最低PCLK下也能实现)
+ * @return 当前时钟下的实际波特率, 0: 超出范围或误差过大
+ */
+static uint32_t calc_actual_baud(uint32_t baud)
+{
+    if (baud < HOST_LINK_MIN_BAUD || baud > HOST_LINK_MAX_BAUD) {
+        return 0;
+    }
+
+    /* 降频后DVFS按新PCLK重算BRR，最低工作点下实现不了的速率现在就拒绝 */
+    if (baud_at_pclk(baud, Dvfs_GetMinUartClock(host_huart)) == 0) {
+        return 0;
+    }
+
+    uint32_t pclk = (host_huart->Instance == USART1 || host_huart->Instance == USART6) ?
+                    HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+    return baud_at_pclk(baud, pclk);
+}
+
+/**
+ * @brief 切换UART1波特率并重启DMA接收
+ */
+static int apply_baud(uint32_t baud)
+{
+    if (calc_actual_baud(baud) == 0) {
+        return -1;
+    }
+
+    /* 等待移位寄存器发空，避免最后一个字节以新速率发出 */
+    wait_tx_idle(HOST_PROTOCOL_TX_TIMEOUT_MS);
+    uint32_t start = HAL_GetTick();
+    while (__HAL_UART_GET_FLAG(host_huart, UART_FLAG_TC) == RESET &&
+           (HAL_GetTick() - start) <= HOST_PROTOCOL_TX_TIMEOUT_MS) {
+    }
+
+    HAL_UART_AbortReceive(host_huart);
+    __HAL_UART_DISABLE(host_huart);
+    host_huart->Init.BaudRate = baud;
+    host_huart->Instance->BRR = UART_BRR_SAMPLING16(
+        (host_huart->Instance == USART1 || host_huart->Instance == USART6) ?
+        HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq(), baud);
+    __HAL_UART_ENABLE(host_huart);
+
+    rx_tail = 0;
+    parser.state = PARSER_WAIT_HEADER_0;
+    link_rate.error_count = 0;
+    link_rate.error_window_start = HAL_GetTick();
+    link_stats.baud_rate = baud;
+
+    return start_dma_reception();
+}
+
+/**
+ * @brief 记录一次链路错误 (主循环中调用)，高速下错误过密时请求回退
+ */
+static void note_link_error(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (link_stats.baud_rate == HOST_LINK_DEFAULT_BAUD) {
+        return;
+    }
+    if ((now - link_rate.error_window_start) > HOST_LINK_ERROR_WINDOW_MS) {
+        link_rate.error_window_start = now;
+        link_rate.error_count = 0;
+    }
+    if (++link_rate.error_count >= HOST_LINK_ERROR_FALLBACK_COUNT) {
+        link_rate.fallback_request = true;
+    }
+}
+
+/**
+ * @brief 主循环中推进速率切换、确认超时、错误回退和吞吐测试
+ */
+static void link_service(void)
+{
+    if (link_rate.pending_baud != 0) {
+        uint32_t target = link_rate.pending_baud;
+        link_rate.pending_baud = 0;
+        link_rate.previous_baud = link_stats.baud_rate;
+        printf("HOST_PROTO: Switching baud %lu -> %lu\r\n", link_stats.baud_rate, target);
+        if (apply_baud(target) == 0) {
+            link_rate.confirm_pending = true;
+            link_rate.confirm_deadline = HAL_GetTick() + HOST_LINK_CONFIRM_TIMEOUT_MS;
+        }
+    }
+
+    if (link_rate.confirm_pending && (int32_t)(HAL_GetTick() - link_rate.confirm_deadline) >= 0) {
+        link_rate.confirm_pending = false;
+        link_stats.baud_fallbacks++;
+        apply_baud(link_rate.previous_baud);
+        printf("HOST_PROTO: Baud change not confirmed, reverted to %lu\r\n", link_stats.baud_rate);
+    }
+
+    if (link_rate.fallback_request) {
+        link_rate.fallback_request = false;
+        link_rate.confirm_pending = false;
+        link_stats.baud_fallbacks++;
+        link_test.active = false;
+        apply_baud(HOST_LINK_DEFAULT_BAUD);
+        printf("HOST_PROTO: Too many link errors, fell back to %d baud\r\n", HOST_LINK_DEFAULT_BAUD);
+    }
+
+    if (link_test.active && !link_test.dma_busy && host_huart->gState == HAL_UART_STATE_READY) {
+        if (link_test.sent_data >= link_test.total_bytes) {
+            link_test_finish();
+        } else {
+            link_test_send_chunk();
+        }
+    }
+}
+
+/**
+ * @brief 构建一帧测试数据并以DMA发出: seq(4) + 图样((seq + i) & 0xFF)
+ */
+static void link_test_send_chunk(void)
+{
+    uint32_t remaining = link_test.total_bytes - link_test.sent_data;
+    uint16_t data_len = (remaining < link_test.chunk) ? (uint16_t)remaining : link_test.chunk;
+    uint16_t payload_len = (uint16_t)(4 + data_len);
+    uint16_t idx = 0;
+    uint32_t seq = link_test.frames;
+
+    test_tx_buffer[idx++] = HOST_FRAME_HEADER_0;
+    test_tx_buffer[idx++] = HOST_FRAME_HEADER_1;
+    test_tx_buffer[idx++] = HOST_CMD_LINK_TEST_DATA;
+    test_tx_buffer[idx++] = (uint8_t)(payload_len & 0xFF);
+    test_tx_buffer[idx++] = (uint8_t)(payload_len >> 8);
+    idx += put_u32(&test_tx_buffer[idx], seq);
+    for (uint16_t i = 0; i < data_len; i++) {
+        test_tx_buffer[idx++] = (uint8_t)(seq + i);
+    }
+    uint16_t crc = Modbus_RTU_CRC16(&test_tx_buffer[2], (uint16_t)(idx - 2));
+    test_tx_buffer[idx++] = (uint8_t)(crc & 0xFF);
+    test_tx_buffer[idx++] = (uint8_t)(crc >> 8);
+
+    link_test.dma_busy = true;
+    if (HAL_UART_Transmit_DMA(host_huart, test_tx_buffer, idx) != HAL_OK) {
+        link_test.dma_busy = false;
+        link_test.tx_errors++;
+        if (link_test.tx_errors > 16) {
+            link_test_finish();
+        }
+        return;
+    }
+
+    link_test.frames++;
+    link_test.sent_data += data_len;
+    link_test.sent_bytes += idx;
+    link_stats.tx_frames++;
+    Power_Account_AddUartTx(idx, host_huart->Init.BaudRate);
+}
+
+/**
+ * @brief 结束吞吐测试并上报结果
+ */
+static void link_test_finish(void)
+{
+    uint32_t elapsed_ms = HAL_GetTick() - link_test.start_tick;
+    uint8_t payload[36];
+    uint16_t idx = 0;
+
+    link_test.active = false;
+    if (elapsed_ms == 0) {
+        elapsed_ms = 1;
+    }
+
+    /* 载荷: 线上字节/帧数/耗时/字节每秒/波特率/发送错误/接收CRC错误/UART错误/期间FFT帧数 */
+    idx += put_u32(&payload[idx], link_test.sent_bytes);
+    idx += put_u32(&payload[idx], link_test.frames);
+    idx += put_u32(&payload[idx], elapsed_ms);
+    idx += put_u32(&payload[idx], (uint32_t)((uint64_t)link_test.sent_bytes * 1000U / elapsed_ms));
+    idx += put_u32(&payload[idx], link_stats.baud_rate);
+    idx += put_u32(&payload[idx], link_test.tx_errors);
+    idx += put_u32(&payload[idx], link_stats.crc_errors - link_test.crc_errors_start);
+    idx += put_u32(&payload[idx], link_stats.uart_errors - link_test.uart_errors_start);
+    idx += put_u32(&payload[idx], FFT_GetFrameCount() - link_test.fft_frames_start);
+
+    Host_Protocol_SendFrame(HOST_CMD_LINK_TEST_RESULT, payload, idx);
+}
+
+#if ENABLE_DSP_BENCHMARK || ENABLE_HOST_REPLAY
+/**
+ * @brief 样本流中断后清空高通/粗检测滑动窗口/FFT缓冲 (基线保留)
+ */
+static void reset_detection_chain(void)
+{
+#if ENABLE_DATA_PREPROCESSING
+    Highpass_Filter_Reset();
+#endif
+#if ENABLE_COARSE_DETECTION
+    Coarse_Detector_Reset();
+#endif
+    FFT_Reset();
+}
+#endif
+
+#if ENABLE_HOST_REPLAY
+/**
+ * @brief 开始回放：清空高通/粗检测/FFT状态，记录计数起点，传感器样本停止进入检测链
+ */
+static void replay_start(void)
+{
+    Vibration_Pipeline_SetReplay(true);
+    reset_detection_chain();
+#if ENABLE_COARSE_DETECTION
+    Coarse_Detector_SetBaseline(Detection_Params_Get()->baseline_rms_threshold);
+#endif
+
+    memset(&replay, 0, sizeof(replay));
+#if ENABLE_COARSE_DETECTION
+    replay.trigger_count_start = Coarse_Detector_GetInfo()->trigger_count;
+#endif
+    replay.fft_frames_start = FFT_GetFrameCount();
+#if ENABLE_SYSTEM_STATE_MACHINE
+    replay.mining_start = System_State_Machine_GetInfo()->mining_detections;
+#endif
+    printf("HOST_PROTO: Replay started\r\n");
+}
+
+static uint16_t replay_put_counters(uint8_t *buf)
+{
+    uint16_t idx = 0;
+    uint32_t triggers = 0;
+    uint32_t mining = 0;
+#if ENABLE_COARSE_DETECTION
+    triggers = Coarse_Detector_GetInfo()->trigger_count - replay.trigger_count_start;
+#endif
+#if ENABLE_SYSTEM_STATE_MACHINE
+    mining = System_State_Machine_GetInfo()->mining_detections - replay.mining_start;
+#endif
+    idx += put_u32(&buf[idx], replay.samples);
+    idx += put_u32(&buf[idx], triggers);
+    idx += put_u32(&buf[idx], FFT_GetFrameCount() - replay.fft_frames_start);
+    idx += put_u32(&buf[idx], mining);
+    return idx;
+}
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file latency_tracker.c
+ * @brief 端到端检测延迟跟踪实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 所有打点均在主循环上下文中调用 (UART5发送完成时刻在中断中采集，
+ * 由LoRa传输层在主循环中用MarkAt补记)，因此不需要关中断。
+ */
+
+#include "latency_tracker.h"
+
+#if ENABLE_LATENCY_TRACKER
+
+#include "dwt_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 私有变量 */
+static latency_record_t inflight[LATENCY_INFLIGHT_SLOTS];
+static uint8_t inflight_next = 0;           // 下一个分配的槽 (轮转覆盖)
+static latency_record_t history[LATENCY_HISTORY_DEPTH];
+static uint8_t history_head = 0;
+static uint8_t history_count = 0;
+static latency_record_t worst;
+static bool worst_valid = false;
+static uint16_t next_id = 1;
+static uint16_t active_id = 0;
+static latency_tracker_stats_t tracker_stats;
+
+static const char *const mark_names[LAT_MARK_COUNT] = {
+    "coarse", "fft", "fine", "mining", "alarm_q", "tx_start", "tx_done"
+};
+
+/* 私有函数声明 */
+static latency_record_t* find_record(uint16_t id);
+static void clear_record(latency_record_t *record);
+static void print_record(const char *label, const latency_record_t *record);
+
+int Latency_Tracker_Init(void)
+{
+    for (uint8_t i = 0; i < LATENCY_INFLIGHT_SLOTS; i++) {
+        clear_record(&inflight[i]);
+    }
+    memset(history, 0, sizeof(history));
+    history_head = 0;
+    history_count = 0;
+    worst_valid = false;
+    inflight_next = 0;
+    active_id = 0;
+    memset(&tracker_stats, 0, sizeof(tracker_stats));
+    return 0;
+}
+
+uint16_t Latency_Tracker_Begin(void)
+{
+    latency_record_t *record = &inflight[inflight_next];
+    inflight_next = (uint8_t)((inflight_next + 1) % LATENCY_INFLIGHT_SLOTS);
+
+    if (record->correlation_id != 0) {
+        tracker_stats.abandoned++;
+    }
+
+    clear_record(record);
+    record->correlation_id = next_id;
+    record->start_us = DWT_Timer_GetTimeUs();
+    record->delta_us[LAT_MARK_COARSE_TRIGGER] = 0;
+
+    active_id = next_id;
+    next_id++;
+    if (next_id == 0) {
+        next_id = 1;    // 0保留为"无ID"
+    }
+
+    tracker_stats.started++;
+    return active_id;
+}
+
+uint16_t Latency_Tracker_GetActiveId(void)
+{
+    return active_id;
+}
+
+void Latency_Tracker_EndActive(void)
+{
+    active_id = 0;
+}
+
+void Latency_Tracker_Mark(uint16_t id, latency_mark_t mark)
+{
+    if (id == 0) {
+        return;
+    }
+    Latency_Tracker_MarkAt(id, mark, DWT_Timer_GetTimeUs());
+}
+
+void Latency_Tracker_MarkAt(uint16_t id, latency_mark_t mark, uint64_t time_us)
+{
+    if (mark >= LAT_MARK_COUNT) {
+        return;
+    }
+
+    latency_record_t *record = find_record(id);
+    if (record == NULL) {
+        return;
+    }
+
+    /* 流水线已推进到更晚的点：忽略 (如报警后同一触发期内的后续FFT帧) */
+    for (uint8_t m = (uint8_t)(mark + 1); m < LAT_MARK_COUNT; m++) {
+        if (record->delta_us[m] != LATENCY_MARK_NONE) {
+            return;
+        }
+    }
+
+    uint64_t delta = (time_us > record->start_us) ? (time_us - record->start_us) : 0;
+    record->delta_us[mark] = (delta > 0xFFFFFFFEU) ? 0xFFFFFFFEU : (uint32_t)delta;
+}
+
+void Latency_Tracker_Complete(uint16_t id)
+{
+    latency_record_t *record = find_record(id);
+    if (record == NULL) {
+        return;
+    }
+
+    history[history_head] = *record;
+    history_head = (uint8_t)((history_head + 1) % LATENCY_HISTORY_DEPTH);
+    if (history_count < LATENCY_HISTORY_DEPTH) {
+        history_count++;
+    }
+
+    uint32_t total = record->delta_us[LAT_MARK_LORA_TX_DONE];
+    if (!worst_valid || (total != LATENCY_MARK_NONE && total > worst.delta_us[LAT_MARK_LORA_TX_DONE])) {
+        worst = *record;
+        worst_valid = true;
+    }
+
+    tracker_stats.completed++;
+    print_record("LATENCY", record);
+    clear_record(record);
+}
+
+uint8_t Latency_Tracker_GetHistoryCount(void)
+{
+    return history_count;
+}
+
+const latency_record_t* Latency_Tracker_GetHistory(uint8_t index)
+{
+    if (index >= history_count) {
+        return NULL;
+    }
+    uint8_t oldest = (history_count < LATENCY_HISTORY_DEPTH) ? 0 : history_head;
+    return &history[(oldest + index) % LATENCY_HISTORY_DEPTH];
+}
+
+const latency_record_t* Latency_Tracker_GetWorst(void)
+{
+    return worst_valid ? &worst : NULL;
+}
+
+const latency_tracker_stats_t* Latency_Tracker_GetStats(void)
+{
+    return &tracker_stats;
+}
+
+void Latency_Tracker_Print(void)
+{
+    printf("=== DETECTION LATENCY (started=%lu completed=%lu abandoned=%lu) ===\r\n",
+           tracker_stats.started, tracker_stats.completed, tracker_stats.abandoned);
+    for (uint8_t i = 0; i < history_count; i++) {
+        print_record("  ", Latency_Tracker_GetHistory(i));
+    }
+    if (worst_valid) {
+        print_record("  WORST", &worst);
+    }
+    printf("=====================================\r\n");
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+static latency_record_t* find_record(uint16_t id)
+{
+    if (id == 0) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < LATENCY_INFLIGHT_SLOTS; i++) {
+        if (inflight[i].correlation_id == id) {
+            return &inflight[i];
+        }
+    }
+    return NULL;
+}
+
+static void clear_record(latency_record_t *record)
+{
+    record->correlation_id = 0;
+    record->start_us = 0;
+    for (uint8_t m = 0; m < LAT_MARK_COUNT; m++) {
+        record->delta_us[m] = LATENCY_MARK_NONE;
+    }
+}
+
+static void print_record(const char *label, const latency_record_t *record)
+{
+    printf("%s #%u:", label, record->correlation_id);
+    for (uint8_t m = 1; m < LAT_MARK_COUNT; m++) {
+        if (record->delta_us[m] != LATENCY_MARK_NONE) {
+            printf(" %s=%lu.%03lums", mark_names[m],
+                   record->delta_us[m] / 1000, record->delta_us[m] % 1000);
+        } else {
+            printf(" %s=-", mark_names[m]);
+        }
+    }
+    printf("\r\n");
+}
+
+#endif /* ENABLE_LATENCY_TRACKER */
@@ -0,0 +1,441 @@
+/**
+ * @file lora_transport.c
+ * @brief LoRa报警异步传输层实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 替代原Process_Alarm_State_Machine：原实现在上电后HAL_Delay(500)阻塞，
+ * 发送使用阻塞HAL_UART_Transmit，且每次上电只写一个寄存器(先1后0)。
+ * 现在全部由时间戳驱动，检测流程在报警期间保持全速运行。
+ */
+
+#include "lora_transport.h"
+#include "main.h"
+#include "modbus_rtu.h"
+#include "profiler.h"
+#include "latency_tracker.h"
+#include "dwt_timer.h"
+#include "power_account.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 外部函数声明 (main.c) */
+extern void Send_Response_To_PC(const char *message);
+
+/* LoRa模块电源控制 (PE14) */
+#define LORA_POWER_ON()     do { HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_SET); \
+                                 Power_Account_SetLoad(POWER_LOAD_LORA, true); } while (0)
+#define LORA_POWER_OFF()    do { HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_RESET); \
+                                 Power_Account_SetLoad(POWER_LOAD_LORA, false); } while (0)
+
+/* 最大帧长: 地址+功能码+起始地址(2)+寄存器数(2)+字节数+数据+CRC(2) */
+#define LORA_FRAME_MAX_LENGTH   (7 + LORA_MAX_REG_COUNT * 2 + 2)
+
+/* 队列项：已编码的寄存器块 */
+typedef struct {
+    uint16_t sequence;
+    uint16_t start_reg;
+    uint8_t reg_count;
+    bool is_alarm;                          // 挖掘报警：发送结果通知系统状态机
+    bool is_event;                          // 报警事件 (挖掘/手动)：发送结果报告上位机，遥测不报告
+    uint16_t correlation_id;                // 延迟跟踪关联ID (0=不跟踪)
+    uint16_t regs[LORA_MAX_REG_COUNT];
+} lora_queue_item_t;
+
+/* 传输层状态 */
+typedef struct {
+    lora_transport_state_t state;
+    uint32_t state_enter_time;
+    uint8_t retry_count;
+
+    lora_queue_item_t queue[LORA_EVENT_QUEUE_SIZE];
+    uint8_t queue_head;
+    uint8_t queue_tail;
+    uint8_t queue_count;
+    uint16_t next_sequence;
+
+    lora_transport_stats_t stats;
+} lora_transport_t;
+
+/* 私有变量 */
+static UART_HandleTypeDef *lora_huart = NULL;
+static lora_transport_t lora_transport;
+static uint8_t lora_tx_frame[LORA_FRAME_MAX_LENGTH];       // DMA发送期间必须保持有效
+static volatile uint8_t lora_tx_done = 0;
+static volatile uint64_t lora_tx_done_us = 0;                // 发送完成时刻 (中断中采集)
+
+/* 私有函数声明 */
+static void enter_state(lora_transport_state_t state);
+static lora_queue_item_t* queue_alloc(void);
+static int send_head_event(void);
+static void complete_head_event(bool success);
+static uint16_t scale_to_u16(float32_t value, float32_t scale);
+
+/* --------------------------------------------------------------------------------------
+ *  公共接口
+ * -------------------------------------------------------------------------------------- */
+
+int LoRa_Transport_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL) {
+        return -1;
+    }
+
+    lora_huart = huart;
+    memset(&lora_transport, 0, sizeof(lora_transport));
+    lora_transport.state = LORA_TRANSPORT_IDLE;
+
+    LORA_POWER_OFF();
+
+    if (Modbus_RTU_Init(huart) != 0) {
+        return -2;
+    }
+
+    printf("LORA_TX: Async transport ready (queue=%d, retries=%d, timeout=%dms)\r\n",
+           LORA_EVENT_QUEUE_SIZE, LORA_MAX_RETRIES, LORA_RESPONSE_TIMEOUT_MS);
+    return 0;
+}
+
+int LoRa_Transport_PostEvent(const lora_event_t *event)
+{
+    if (event == NULL) {
+        return -1;
+    }
+
+    lora_queue_item_t *slot = queue_alloc();
+    if (slot == NULL) {
+        return -2;
+    }
+
+    slot->start_reg = LORA_MODBUS_START_REG;
+    slot->reg_count = LORA_EVENT_REG_COUNT;
+    /* 手动事件不是状态机发起的，其结果不能确认状态机正在等待的报警 */
+    slot->is_alarm = (event->type == LORA_EVENT_MINING);
+    slot->is_event = true;
+    slot->correlation_id = event->correlation_id;
+    slot->regs[0] = (uint16_t)event->type;
+    slot->regs[1] = slot->sequence;
+    slot->regs[2] = (uint16_t)(event->timestamp_ms >> 16);
+    slot->regs[3] = (uint16_t)(event->timestamp_ms & 0xFFFF);
+    slot->regs[4] = scale_to_u16(event->confidence, 1000.0f);
+    slot->regs[5] = scale_to_u16(event->dominant_freq, 10.0f);
+    slot->regs[6] = scale_to_u16(event->low_freq_ratio, 1000.0f);
+    slot->regs[7] = scale_to_u16(event->mid_freq_ratio, 1000.0f);
+    slot->regs[8] = scale_to_u16(event->high_freq_ratio, 1000.0f);
+    slot->regs[9] = scale_to_u16(event->spectral_centroid, 10.0f);
+
+    printf("LORA_TX: Event #%u queued (type=%d, pending=%u)\r\n",
+           slot->sequence, event->type, lora_transport.queue_count);
+    return 0;
+}
+
+int LoRa_Transport_PostRegisters(uint16_t start_reg, const uint16_t *regs, uint8_t count)
+{
+    if (regs == NULL || count == 0 || count > LORA_MAX_REG_COUNT) {
+        return -1;
+    }
+
+    lora_queue_item_t *slot = queue_alloc();
+    if (slot == NULL) {
+        return -2;
+    }
+
+    slot->start_reg = start_reg;
+    slot->reg_count = count;
+    slot->is_alarm = false;
+    slot->is_event = false;
+    memcpy(slot->regs, regs, count * sizeof(uint16_t));
+    return 0;
+}
+
+#if ENABLE_FINE_DETECTION
+int LoRa_Transport_PostDetection(const fine_detection_features_t *features)
+{
+    lora_event_t event;
+    memset(&event, 0, sizeof(event));
+
+    event.type = LORA_EVENT_MINING;         // 只在挖掘判定后上报；序贯判定的判定帧单帧分类可能为正常
+    event.timestamp_ms = HAL_GetTick();
+    if (features != NULL && features->is_valid) {
+        event.timestamp_ms = features->analysis_timestamp;
+        event.confidence = features->confidence_score;
+        event.dominant_freq = features->dominant_frequency;
+        event.low_freq_ratio = features->low_freq_energy;
+        event.mid_freq_ratio = features->mid_freq_energy;
+        event.high_freq_ratio = features->high_freq_energy;
+        event.spectral_centroid = features->spectral_centroid;
+        event.correlation_id = features->correlation_id;
+    }
+
+    return LoRa_Transport_PostEvent(&event);
+}
+#endif
+
+void LoRa_Transport_Process(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t elapsed = now - lora_transport.state_enter_time;
+
+    switch (lora_transport.state) {
+        case LORA_TRANSPORT_IDLE:
+            if (lora_transport.queue_count > 0) {
+                LORA_POWER_ON();
+                lora_transport.stats.power_cycles++;
+                lora_transport.retry_count = 0;
+                enter_state(LORA_TRANSPORT_POWERING_ON);
+                printf("LoRa powered ON (PE14=HIGH), waiting %dms for startup\r\n", LORA_POWER_ON_DELAY_MS);
+            }
+            break;
+
+        case LORA_TRANSPORT_POWERING_ON:
+            if (elapsed >= LORA_POWER_ON_DELAY_MS) {
+                send_head_event();
+            }
+            break;
+
+        case LORA_TRANSPORT_SENDING:
+            if (lora_tx_done) {
+                lora_tx_done = 0;
+                /* 重发时覆盖为最后一次发送完成的时间，记录在事件结束时完成 */
+                Latency_Tracker_MarkAt(lora_transport.queue[lora_transport.queue_head].correlation_id,
+                                       LAT_MARK_LORA_TX_DONE, lora_tx_done_us);
+                enter_state(LORA_TRANSPORT_WAIT_RESPONSE);
+            } else if (elapsed > LORA_RESPONSE_TIMEOUT_MS) {
+                /* DMA未完成，视为本次发送失败 */
+                HAL_UART_AbortTransmit(lora_huart);
+                printf("LORA_TX: DMA transmit timeout\r\n");
+                enter_state(LORA_TRANSPORT_BACKOFF);
+            }
+            break;
+
+        case LORA_TRANSPORT_WAIT_RESPONSE: {
+            modbus_rtu_frame_t frame;
+
+            Modbus_RTU_Process();
+            if (Modbus_RTU_GetFrame(&frame)) {
+                const lora_queue_item_t *head = &lora_transport.queue[lora_transport.queue_head];
+                modbus_rtu_response_t resp = Modbus_RTU_CheckWriteResponse(&frame,
+                                                LORA_MODBUS_SLAVE_ADDR, LORA_MODBUS_FUNC_WRITE_MULTI,
+                                                head->start_reg, head->reg_count);
+                if (resp == MODBUS_RTU_RESP_ACK) {
+                    complete_head_event(true);
+                } else if (resp == MODBUS_RTU_RESP_EXCEPTION) {
+                    printf("LORA_TX: Exception response 0x%02X\r\n", frame.exception_code);
+                    if (frame.exception_code == MODBUS_EX_ACKNOWLEDGE ||
+                        frame.exception_code == MODBUS_EX_DEVICE_BUSY) {
+                        enter_state(LORA_TRANSPORT_BACKOFF);     // 远端忙，稍后重发
+                    } else {
+                        complete_head_event(false);             // 请求本身被拒绝，重发无意义
+                    }
+                } else {
+                    /* 不属于本请求的帧(如迟到的旧应答)，继续等待 */
+                    printf("LORA_TX: Ignoring unrelated frame (addr=0x%02X fc=0x%02X)\r\n",
+                           frame.address, frame.function);
+                }
+            } else if (elapsed > LORA_RESPONSE_TIMEOUT_MS) {
+                printf("LORA_TX: Response timeout (attempt %u)\r\n", lora_transport.retry_count + 1);
+                enter_state(LORA_TRANSPORT_BACKOFF);
+            }
+            break;
+        }
+
+        case LORA_TRANSPORT_BACKOFF:
+            if (lora_transport.retry_count >= LORA_MAX_RETRIES) {
+                complete_head_event(false);
+            } else if (elapsed >= (uint32_t)LORA_RETRY_BACKOFF_MS * (lora_transport.retry_count + 1)) {
+                lora_transport.retry_count++;
+                lora_transport.stats.retries++;
+                send_head_event();
+            }
+            break;
+
+        default:
+            enter_state(LORA_TRANSPORT_IDLE);
+            break;
+    }
+}
+
+bool LoRa_Transport_IsBusy(void)
+{
+    return (lora_transport.state != LORA_TRANSPORT_IDLE) || (lora_transport.queue_count > 0);
+}
+
+lora_transport_state_t LoRa_Transport_GetState(void)
+{
+    return lora_transport.state;
+}
+
+const lora_transport_stats_t* LoRa_Transport_GetStats(void)
+{
+    return &lora_transport.stats;
+}
+
+void LoRa_Transport_PrintStats(void)
+{
+    const lora_transport_stats_t *s = &lora_transport.stats;
+    printf("=== LORA TRANSPORT STATS ===\r\n");
+    printf("Events: posted=%lu sent=%lu failed=%lu dropped=%lu\r\n",
+           s->events_posted, s->events_sent, s->events_failed, s->events_dropped);
+    printf("Frames: sent=%lu retries=%lu power_cycles=%lu\r\n",
+           s->frames_sent, s->retries, s->power_cycles);
+    printf("============================\r\n");
+}
+
+void LoRa_Transport_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart == lora_huart) {
+        lora_tx_done_us = DWT_Timer_GetTimeUs();
+        lora_tx_done = 1;
+    }
+}
+
+void Trigger_Alarm_Cycle(void)
+{
+    lora_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.type = LORA_EVENT_MANUAL;
+    event.timestamp_ms = HAL_GetTick();
+    LoRa_Transport_PostEvent(&event);
+}
+
+#if ENABLE_FINE_DETECTION
+void Trigger_Alarm_Detection(const fine_detection_features_t *features)
+{
+    LoRa_Transport_PostDetection(features);
+}
+#else
+void Trigger_Alarm_Detection(void)
+{
+    lora_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.type = LORA_EVENT_MINING;
+    event.timestamp_ms = HAL_GetTick();
+    LoRa_Transport_PostEvent(&event);
+}
+#endif
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+static void enter_state(lora_transport_state_t state)
+{
+    lora_transport.state = state;
+    lora_transport.state_enter_time = HAL_GetTick();
+}
+
+/**
+ * @brief 分配队尾空位并分配序号，队列满时返回NULL
+ */
+static lora_queue_item_t* queue_alloc(void)
+{
+    if (lora_transport.queue_count >= LORA_EVENT_QUEUE_SIZE) {
+        lora_transport.stats.events_dropped++;
+        printf("LORA_TX: Event queue full, event dropped\r\n");
+        return NULL;
+    }
+
+    lora_queue_item_t *slot = &lora_transport.queue[lora_transport.queue_tail];
+    memset(slot, 0, sizeof(*slot));
+    slot->sequence = lora_transport.next_sequence++;
+
+    lora_transport.queue_tail = (lora_transport.queue_tail + 1) % LORA_EVENT_QUEUE_SIZE;
+    lora_transport.queue_count++;
+    lora_transport.stats.events_posted++;
+    return slot;
+}
+
+/**
+ * @brief 将队首寄存器块打包为写多寄存器帧并启动DMA发送
+ */
+static int send_head_event(void)
+{
+    const lora_queue_item_t *event = &lora_transport.queue[lora_transport.queue_head];
+    uint16_t length;
+
+    PROFILE_START(send_start);
+    length = Modbus_RTU_BuildWriteMultiple(lora_tx_frame, LORA_MODBUS_SLAVE_ADDR,
+                                           LORA_MODBUS_FUNC_WRITE_MULTI, event->start_reg,
+                                           event->regs, event->reg_count);
+
+    /* 丢弃上次残留的应答字节 */
+    Modbus_RTU_Flush();
+
+    lora_tx_done = 0;
+    enter_state(LORA_TRANSPORT_SENDING);
+    if (HAL_UART_Transmit_DMA(lora_huart, lora_tx_frame, length) != HAL_OK) {
+        printf("LORA_TX: DMA transmit start failed\r\n");
+        enter_state(LORA_TRANSPORT_BACKOFF);
+        return -1;
+    }
+    PROFILE_STOP(PROF_STAGE_LORA_SEND, send_start);
+    Latency_Tracker_Mark(event->correlation_id, LAT_MARK_LORA_TX_START);
+
+    lora_transport.stats.frames_sent++;
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    if (event->is_alarm) {
+        System_State_Machine_SetAlarmStatus(0);  // 进行中
+    }
+#endif
+
+    printf("LORA_TX: Event #%u sent (%u bytes, attempt %u)\r\n",
+           event->sequence, length, lora_transport.retry_count + 1);
+    return 0;
+}
+
+/**
+ * @brief 队首事件结束 (成功、被拒绝或重发耗尽)，队列空时断电
+ */
+static void complete_head_event(bool success)
+{
+    uint16_t sequence = lora_transport.queue[lora_transport.queue_head].sequence;
+    bool is_alarm = lora_transport.queue[lora_transport.queue_head].is_alarm;
+    bool is_event = lora_transport.queue[lora_transport.queue_head].is_event;
+    unsigned attempts = lora_transport.retry_count + 1U;
+
+    Latency_Tracker_Complete(lora_transport.queue[lora_transport.queue_head].correlation_id);
+
+    lora_transport.queue_head = (lora_transport.queue_head + 1) % LORA_EVENT_QUEUE_SIZE;
+    lora_transport.queue_count--;
+    lora_transport.retry_count = 0;
+
+    if (success) {
+        lora_transport.stats.events_sent++;
+        printf("LORA_TX: Event #%u acknowledged (attempt %u)\r\n", sequence, attempts);
+    } else {
+        lora_transport.stats.events_failed++;
+        printf("LORA_TX: Event #%u failed after %u attempt(s)\r\n", sequence, attempts);
+    }
+
+    /* 遥测不是报警，不向上位机报告报警发送结果 */
+    if (is_event) {
+        Send_Response_To_PC(success ? "ALARM_EVENT_SENT" : "ALARM_EVENT_TIMEOUT");
+    }
+#if ENABLE_SYSTEM_STATE_MACHINE
+    if (is_alarm) {
+        System_State_Machine_SetAlarmStatus(success ? 1 : 2);
+    }
+#endif
+
+    if (lora_transport.queue_count > 0) {
+        /* 模块保持上电，直接发送下一个事件 */
+        send_head_event();
+    } else {
+        LORA_POWER_OFF();
+        enter_state(LORA_TRANSPORT_IDLE);
+        printf("LoRa powered OFF (PE14=LOW)\n");
+    }
+}
+
+static uint16_t scale_to_u16(float32_t value, float32_t scale)
+{
+    float32_t scaled = value * scale + 0.5f;
+    if (!(scaled > 0.0f)) {
+        return 0;
+    }
+    if (scaled >= 65535.0f) {
+        return 0xFFFF;
+    }
+    return (uint16_t)scaled;
+}
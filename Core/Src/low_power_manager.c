@@ -13,6 +13,16 @@
 #include "rtc_wakeup.h"
 #include "main.h"
 #include "example-raw-data.h"
+#include "lora_transport.h"
+#include "fft_processor.h"
+#include "detection_params.h"
+#include "host_protocol.h"
+#include "clock_config_84mhz.h"
+#include "dwt_timer.h"
+#include "power_account.h"
+#include "dvfs.h"
+#include "detection_session.h"
+#include "system_monitor.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -21,9 +31,44 @@ static low_power_manager_t g_low_power_manager;
 static power_mode_t g_current_power_mode = POWER_MODE_CONTINUOUS;
 static bool g_low_power_initialized = false;
 
+/* STOP唤醒后首次SPI传输的计时起点 (时钟恢复完成时刻，DWT周期) */
+static uint32_t g_spi_latency_start = 0;
+static volatile bool g_spi_latency_pending = false;
+
+/* 当前批次：STOP唤醒后时钟恢复完成时刻 (DWT周期)，LowPower_IsBatchComplete结算 */
+static uint32_t g_batch_start = 0;
+static bool g_batch_open = false;
+
 /* 外部变量声明 */
 extern volatile uint32_t irq_from_device;
 
+/* 传感器INT1在irq_from_device中的位 (main.c中的TO_MASK(INV_GPIO_INT1)) */
+#define LOW_POWER_SENSOR_INT1_MASK      0x01U
+
+/* RTC日历一天的毫秒数 (STOP时长按天回绕计算) */
+#define LOW_POWER_RTC_DAY_MS            86400000UL
+
+/* 进入STOP前等待UART1发送完成的上限 */
+#define LOW_POWER_UART_DRAIN_MS         20
+
+extern UART_HandleTypeDef huart1;
+
+/* 过渡阶段名称与超时上限 (按low_power_phase_t索引) */
+static const char* const g_phase_names[LP_PHASE_COUNT] = {"uart flush", "clock ready", "sensor ready"};
+static const uint32_t g_phase_timeout_ms[LP_PHASE_COUNT] = {
+    SLEEP_ENTRY_TIMEOUT_MS, WAKEUP_CLOCK_TIMEOUT_MS, SENSOR_READY_TIMEOUT_MS
+};
+
+/* 私有函数声明 */
+static uint32_t LowPower_StopAndRestore(void);
+static bool LowPower_WaitUartIdle(uint32_t timeout_ms);
+static bool LowPower_WaitClockReady(uint32_t timeout_ms);
+static void LowPower_CheckSysTick(const char *where);
+static bool LowPower_WaitSensorReady(uint32_t timeout_ms);
+static void LowPower_RecordPhase(low_power_phase_t phase, uint32_t elapsed_us, bool ready);
+static uint32_t LowPower_TransitionUs(void);
+static void LowPower_GetActivityCounts(uint32_t *triggers, uint32_t *minings);
+
 /**
  * @brief 低功耗管理初始化
  */
@@ -35,7 +80,12 @@ int LowPower_Init(void)
     memset(&g_low_power_manager, 0, sizeof(low_power_manager_t));
     
     // 初始化配置参数
+#if ENABLE_FIFO_BATCHING || ENABLE_WOM_WAKEUP
+    g_low_power_manager.wakeup_period_sec = WOM_HEARTBEAT_PERIOD_SEC;  // RTC只作健康心跳
+#else
     g_low_power_manager.wakeup_period_sec = RTC_WAKEUP_PERIOD_SEC;
+#endif
+    g_low_power_manager.wakeup_period_ms = g_low_power_manager.wakeup_period_sec * 1000U;
     g_low_power_manager.debug_enabled = LOW_POWER_DEBUG_ENABLED;
     g_low_power_manager.low_power_enabled = ENABLE_LOW_POWER_MODE;
     
@@ -95,35 +145,47 @@ int LowPower_EnterSleep(void)
 
     // RTC唤醒定时器应该已经在主循环中启动了，这里不需要重复启动
     
-    // 延时确保系统稳定
-    HAL_Delay(SLEEP_ENTRY_DELAY_MS);
-    
     if (g_low_power_manager.debug_enabled) {
         printf("LOW_POWER: System entering sleep mode now...\r\n");
-        // 确保调试信息发送完成
-        HAL_Delay(10);
     }
 
-    // 暂停SysTick中断以避免频繁唤醒
-    HAL_SuspendTick();
+    // 等待调试输出发送完成 (TC置位)，替代固定延时
+    uint32_t phase_start = DWT_Timer_GetCycles();
+    bool ready = LowPower_WaitUartIdle(SLEEP_ENTRY_TIMEOUT_MS);
+    LowPower_RecordPhase(LP_PHASE_UART_FLUSH, DWT_Timer_ElapsedUs(phase_start), ready);
 
     // 暂时禁用传感器GPIO中断（PC7）
     HAL_NVIC_DisableIRQ(EXTI9_5_IRQn);
 
+#if LOW_POWER_POLL_USE_STOP
+    // 进入STOP模式，只有RTC能唤醒；HAL时基按RTC补偿
+    g_low_power_manager.stop_count++;
+    g_low_power_manager.current_state = LOW_POWER_STATE_STOP;
+    g_low_power_manager.total_stop_time_ms += LowPower_StopAndRestore();
+#else
+    // 暂停SysTick中断以避免频繁唤醒
+    HAL_SuspendTick();
+
     // 进入Sleep模式
+    Power_Account_SetMcu(POWER_LOAD_MCU_SLEEP);
     HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
-
-    // 恢复传感器GPIO中断
-    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+    Power_Account_SetMcu(POWER_LOAD_MCU_RUN);
 
     // 恢复SysTick中断
     HAL_ResumeTick();
+#endif
+
+    // 恢复传感器GPIO中断
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
     
     // 唤醒后执行
     g_low_power_manager.is_sleeping = false;
+    g_low_power_manager.current_state = LOW_POWER_STATE_ACTIVE;
     uint32_t sleep_end_time = HAL_GetTick();
     uint32_t sleep_duration = sleep_end_time - sleep_start_time;
-    g_low_power_manager.total_sleep_time_sec += sleep_duration / 1000;
+#if !LOW_POWER_POLL_USE_STOP
+    g_low_power_manager.total_sleep_time_ms += sleep_duration;
+#endif
     
     if (g_low_power_manager.debug_enabled) {
         // 检查唤醒原因
@@ -140,8 +202,14 @@ int LowPower_EnterSleep(void)
     // 重新启用外设
     LowPower_EnablePeripherals();
     
-    // 稳定延时
-    HAL_Delay(WAKEUP_STABILIZE_DELAY_MS);
+    // 确认时钟就绪，替代固定稳定延时 (STOP唤醒的时钟恢复已在LowPower_StopAndRestore中完成，计入本阶段)
+    phase_start = DWT_Timer_GetCycles();
+    ready = LowPower_WaitClockReady(WAKEUP_CLOCK_TIMEOUT_MS);
+    uint32_t clock_us = DWT_Timer_ElapsedUs(phase_start);
+#if LOW_POWER_POLL_USE_STOP
+    clock_us += g_low_power_manager.stop_clock_restore_us;
+#endif
+    LowPower_RecordPhase(LP_PHASE_CLOCK_READY, clock_us, ready);
     
     return 0;
 }
@@ -172,6 +240,278 @@ int LowPower_HandleWakeup(void)
     return 0;
 }
 
+/**
+ * @brief 传感器进入运动唤醒 (LP + WOM)
+ */
+int LowPower_ArmWakeOnMotion(void)
+{
+    if (!g_low_power_initialized) {
+        return -1;
+    }
+
+    // 唤醒阈值与粗检测触发一致：触发倍数 x 学习到的基线RMS
+    const detection_params_t* params = Detection_Params_Get();
+#if ENABLE_COARSE_DETECTION
+    float32_t baseline_rms = Coarse_Detector_GetInfo()->baseline_rms;
+#else
+    float32_t baseline_rms = params->baseline_rms_threshold;
+#endif
+    uint8_t threshold = InvDevice_WomThresholdFromRms(params->trigger_multiplier * baseline_rms);
+
+    int rc = InvDevice_EnterWakeOnMotion(threshold);
+    LowPower_CheckSysTick("WOM enter");
+    if (rc != 0) {
+        printf("LOW_POWER: ERROR - Failed to enter wake-on-motion: %d\r\n", rc);
+        return -2;
+    }
+
+    // 进入WOM前已到达的FIFO中断不能当作运动唤醒
+    irq_from_device &= ~LOW_POWER_SENSOR_INT1_MASK;
+
+    g_low_power_manager.wom_armed = true;
+    g_low_power_manager.wom_threshold_lsb = threshold;
+
+    if (g_low_power_manager.debug_enabled) {
+        printf("LOW_POWER: WOM armed, baseline %.5f g x %.2f -> %u LSB (%.1f mg)\r\n",
+               baseline_rms, params->trigger_multiplier, threshold,
+               threshold * WOM_THRESHOLD_MG_PER_LSB);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 进入STOP模式
+ */
+wakeup_source_t LowPower_EnterStop(void)
+{
+    if (!g_low_power_initialized) {
+        return WAKEUP_SOURCE_NONE;
+    }
+
+    if (g_low_power_manager.debug_enabled) {
+        printf("LOW_POWER: Entering STOP mode...\r\n");
+    }
+
+    g_low_power_manager.stop_count++;
+    g_low_power_manager.is_sleeping = true;
+    g_low_power_manager.current_state = LOW_POWER_STATE_STOP;
+
+    uint32_t stop_ms = LowPower_StopAndRestore();
+
+    g_low_power_manager.total_stop_time_ms += stop_ms;
+    g_low_power_manager.is_sleeping = false;
+    g_low_power_manager.current_state = LOW_POWER_STATE_ACTIVE;
+
+    wakeup_source_t source = WAKEUP_SOURCE_NONE;
+    if (irq_from_device & LOW_POWER_SENSOR_INT1_MASK) {
+        source = WAKEUP_SOURCE_EXTERNAL;
+    } else if (RTC_Wakeup_IsPending()) {
+        source = WAKEUP_SOURCE_RTC;
+    }
+
+    if (g_low_power_manager.debug_enabled) {
+        printf("LOW_POWER: Woke up from STOP by %s (duration: %lu ms)\r\n",
+               (source == WAKEUP_SOURCE_EXTERNAL) ? "WOM" :
+               (source == WAKEUP_SOURCE_RTC) ? "RTC heartbeat" : "OTHER", stop_ms);
+    }
+
+    return source;
+}
+
+/**
+ * @brief 记录STOP唤醒后首次SPI传输的时延
+ */
+void LowPower_NoteSpiTransaction(void)
+{
+    if (!g_spi_latency_pending) {
+        return;
+    }
+    g_spi_latency_pending = false;
+
+    uint32_t latency_us = g_low_power_manager.stop_clock_restore_us +
+                          DWT_Timer_ElapsedUs(g_spi_latency_start);
+    g_low_power_manager.stop_wake_to_spi_us = latency_us;
+    if (latency_us > g_low_power_manager.stop_wake_to_spi_max_us) {
+        g_low_power_manager.stop_wake_to_spi_max_us = latency_us;
+    }
+}
+
+/**
+ * @brief 处理WOM唤醒
+ */
+int LowPower_HandleMotionWakeup(void)
+{
+    if (!g_low_power_initialized) {
+        return -1;
+    }
+
+    uint8_t axes = 0;
+    int rc = InvDevice_ReadWomStatus(&axes);
+
+    // INT1此时是WOM中断，不是FIFO水位线
+    irq_from_device &= ~LOW_POWER_SENSOR_INT1_MASK;
+
+    rc |= InvDevice_ExitWakeOnMotion();
+    LowPower_CheckSysTick("WOM exit");
+    g_low_power_manager.wom_armed = false;
+
+    g_low_power_manager.wom_wakeup_count++;
+    g_low_power_manager.wakeup_count++;
+    g_low_power_manager.last_wakeup_time = HAL_GetTick();
+    g_low_power_manager.wakeup_source = WAKEUP_SOURCE_EXTERNAL;
+
+    if (g_low_power_manager.debug_enabled) {
+        printf("LOW_POWER: Motion wakeup (count: %lu, axes: %s%s%s, threshold: %u LSB)\r\n",
+               g_low_power_manager.wom_wakeup_count,
+               (axes & BIT_INT_STATUS2_WOM_X_INT) ? "X" : "",
+               (axes & BIT_INT_STATUS2_WOM_Y_INT) ? "Y" : "",
+               (axes & BIT_INT_STATUS2_WOM_Z_INT) ? "Z" : "",
+               g_low_power_manager.wom_threshold_lsb);
+    }
+
+    if (rc != 0) {
+        printf("LOW_POWER: ERROR - Failed to restore acquisition mode: %d\r\n", rc);
+        return -2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 处理RTC心跳
+ */
+int LowPower_HandleHeartbeat(void)
+{
+    if (!g_low_power_initialized) {
+        return -1;
+    }
+
+    g_low_power_manager.heartbeat_count++;
+    RTC_Wakeup_ClearFlag();
+
+    int rc = InvDevice_CheckAlive();
+    if (rc != 0) {
+        printf("LOW_POWER: ERROR - Sensor heartbeat check failed: %d\r\n", rc);
+        g_low_power_manager.wom_armed = false;  // 下次循环重新配置WOM
+        g_low_power_manager.batch_armed = false;
+        return -2;
+    }
+
+#if ENABLE_FIFO_BATCHING
+    // 整个心跳周期没有水位线唤醒：FIFO满后停止写入就不会再有中断，清空FIFO重新开始
+    if (g_low_power_manager.batch_armed &&
+        g_low_power_manager.batch_count == g_low_power_manager.batch_count_at_heartbeat) {
+        printf("LOW_POWER: WARNING - No FIFO batch since last heartbeat, re-arming\r\n");
+        g_low_power_manager.batch_armed = false;
+    }
+    g_low_power_manager.batch_count_at_heartbeat = g_low_power_manager.batch_count;
+#endif
+
+    if (g_low_power_manager.debug_enabled) {
+#if ENABLE_FIFO_BATCHING
+        printf("LOW_POWER: Heartbeat %lu, sensor OK, %lu batches\r\n",
+               g_low_power_manager.heartbeat_count, g_low_power_manager.batch_count);
+#else
+        printf("LOW_POWER: Heartbeat %lu, sensor OK, WOM %s\r\n",
+               g_low_power_manager.heartbeat_count,
+               g_low_power_manager.wom_armed ? "armed" : "not armed");
+#endif
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 设置批处理水位线
+ */
+int LowPower_ArmFifoBatching(void)
+{
+    if (!g_low_power_initialized) {
+        return -1;
+    }
+
+    // 20字节包时FIFO只能容纳102包，水位线同样保留唤醒余量
+    uint16_t capacity = InvDevice_GetFifoCapacityPackets();
+    uint16_t watermark = LOW_POWER_BATCH_WATERMARK;
+    if (watermark + LOW_POWER_BATCH_MARGIN_PACKETS > capacity) {
+        watermark = capacity - LOW_POWER_BATCH_MARGIN_PACKETS;
+    }
+
+    int rc = InvDevice_SetFifoWatermark(watermark, true);
+    if (rc != 0) {
+        printf("LOW_POWER: ERROR - Failed to set FIFO batch watermark: %d\r\n", rc);
+        return -2;
+    }
+
+    // 清空FIFO之前到达的水位线中断已经无效
+    irq_from_device &= ~LOW_POWER_SENSOR_INT1_MASK;
+
+    g_low_power_manager.batch_armed = true;
+    g_low_power_manager.batch_watermark = watermark;
+    if (g_low_power_manager.batch_armed_time == 0) {
+        g_low_power_manager.batch_armed_time = HAL_GetTick();
+    }
+
+    if (g_low_power_manager.debug_enabled) {
+        printf("LOW_POWER: FIFO batching armed, watermark %u/%u packets\r\n", watermark, capacity);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 开始一批
+ */
+void LowPower_BeginBatch(void)
+{
+    g_low_power_manager.batch_count++;
+    g_low_power_manager.wakeup_count++;
+    g_low_power_manager.last_wakeup_time = HAL_GetTick();
+    g_low_power_manager.wakeup_source = WAKEUP_SOURCE_EXTERNAL;
+
+    g_batch_start = g_spi_latency_start;
+    g_batch_open = true;
+}
+
+/**
+ * @brief 批处理完成判断
+ */
+bool LowPower_IsBatchComplete(void)
+{
+    if (!g_low_power_initialized) {
+        return true;
+    }
+
+    // 处理期间又到达的水位线中断在同一批内读取
+    bool sensor_idle = !(irq_from_device & LOW_POWER_SENSOR_INT1_MASK);
+
+    // STOP期间UART5不能唤醒，LoRa发送必须在活跃期内完成
+    bool alarm_idle = !LoRa_Transport_IsBusy();
+
+#if ENABLE_FFT_DEFERRED
+    bool dsp_idle = !FFT_Worker_Pending();
+#else
+    bool dsp_idle = true;
+#endif
+
+    if (!(sensor_idle && alarm_idle && dsp_idle)) {
+        return false;
+    }
+
+    if (g_batch_open) {
+        g_batch_open = false;
+        uint32_t burst_us = g_low_power_manager.stop_clock_restore_us + DWT_Timer_ElapsedUs(g_batch_start);
+        g_low_power_manager.batch_burst_us = burst_us;
+        if (burst_us > g_low_power_manager.batch_burst_max_us) {
+            g_low_power_manager.batch_burst_max_us = burst_us;
+        }
+        g_low_power_manager.batch_active_us += burst_us;
+    }
+
+    return true;
+}
+
 /**
  * @brief 启动现有检测流程（完全复用v4.0逻辑）
  */
@@ -183,12 +523,15 @@ int LowPower_StartDetectionProcess(void)
     
     g_low_power_manager.detection_count++;
     g_low_power_manager.detection_start_time = HAL_GetTick();
+    LowPower_GetActivityCounts(&g_low_power_manager.cycle_trigger_base,
+                               &g_low_power_manager.cycle_mining_base);
     
     if (g_low_power_manager.debug_enabled) {
         printf("LOW_POWER: Starting detection process (count: %lu)\r\n", g_low_power_manager.detection_count);
         printf("LOW_POWER: === SCENARIO ANALYSIS START ===\r\n");
-        printf("LOW_POWER: Will collect 200 samples for coarse detection\r\n");
-        printf("LOW_POWER: Sensor startup delay: %d ms\r\n", SENSOR_STARTUP_DELAY_MS);
+        printf("LOW_POWER: Session: warmup %d samples, coarse window %lu samples, quiet -> sleep\r\n",
+               DETECTION_WARMUP_SAMPLES, Detection_Params_Get()->rms_window_size);
+        printf("LOW_POWER: Sensor ready timeout: %d ms\r\n", SENSOR_READY_TIMEOUT_MS);
 
 #if ENABLE_SYSTEM_STATE_MACHINE
         // 显示当前系统状态
@@ -197,8 +540,13 @@ int LowPower_StartDetectionProcess(void)
 #endif
     }
     
-    // 传感器启动延时
-    HAL_Delay(SENSOR_STARTUP_DELAY_MS);
+    // 等待传感器FIFO有样本，替代固定启动延时
+    uint32_t phase_start = DWT_Timer_GetCycles();
+    bool ready = LowPower_WaitSensorReady(SENSOR_READY_TIMEOUT_MS);
+    LowPower_RecordPhase(LP_PHASE_SENSOR_READY, DWT_Timer_ElapsedUs(phase_start), ready);
+
+    // 检测会话从滤波器稳定阶段开始计样本
+    Detection_Session_Begin();
     
     // 注意：这里不直接调用现有的检测函数，而是让主循环继续运行现有的检测逻辑
     // 现有的检测流程会在主循环中自动执行：
@@ -221,49 +569,56 @@ bool LowPower_IsDetectionComplete(void)
         return true;  // 如果未初始化，认为检测完成
     }
     
-    // 检测完成的判断逻辑：
-    // 1. 如果没有传感器中断待处理
-    // 2. 并且系统状态机处于稳定状态
-    // 3. 并且没有LoRa报警正在进行
-    
-    bool sensor_idle = (irq_from_device == 0);
-    
-#if ENABLE_SYSTEM_STATE_MACHINE
-    // 获取系统状态机状态
-    system_state_t current_state = System_State_Machine_GetCurrentState();
-    bool state_machine_idle = (current_state == STATE_MONITORING ||
-                              current_state == STATE_IDLE_SLEEP);
-#else
-    bool state_machine_idle = true;  // 如果状态机未启用，认为空闲
-#endif
-    
-    // 检查是否有报警正在进行
-    bool alarm_idle = true;  // 这里可以添加报警状态检查
-    
-    bool detection_complete = sensor_idle && state_machine_idle && alarm_idle;
+    // 检测会话按阶段判定完成：粗检测窗口安静、细检测正常或报警流程结束，且LoRa/延后FFT空闲
+    bool detection_complete = Detection_Session_Process();
     
     if (detection_complete && g_low_power_manager.detection_start_time > 0) {
         // 更新检测结束时间和统计
         g_low_power_manager.detection_end_time = HAL_GetTick();
         uint32_t detection_duration = g_low_power_manager.detection_end_time - g_low_power_manager.detection_start_time;
         g_low_power_manager.total_active_time_ms += detection_duration;
+        if (g_low_power_manager.wakeup_source == WAKEUP_SOURCE_EXTERNAL) {
+            g_low_power_manager.wom_active_time_ms += detection_duration;
+        }
+
+        uint32_t triggers, minings;
+        LowPower_GetActivityCounts(&triggers, &minings);
+        triggers -= g_low_power_manager.cycle_trigger_base;
+        minings -= g_low_power_manager.cycle_mining_base;
+        g_low_power_manager.coarse_trigger_count += triggers;
+#if ENABLE_ADAPTIVE_RTC_PERIOD && !(ENABLE_WOM_WAKEUP || ENABLE_FIFO_BATCHING)
+        // 下一次RTC唤醒按本轮及近期触发历史调整 (计数器重新装载，从现在起计时)
+        RTC_Wakeup_ConfigureMs(LowPower_AdaptWakeupPeriod(triggers, minings));
+#endif
         
         if (g_low_power_manager.debug_enabled) {
-            printf("LOW_POWER: Detection completed (duration: %lu ms)\r\n", detection_duration);
+            const detection_session_t *session = Detection_Session_Get();
+
+            printf("LOW_POWER: Detection completed (duration: %lu ms, end: %s in %s)\r\n", detection_duration,
+                   Detection_Session_EndName(session->end_reason), Detection_Session_PhaseName(session->end_phase));
+            printf("LOW_POWER: Phases: warmup %lu ms/%lu, coarse %lu ms/%lu, analysis %lu ms/%lu, alarm %lu ms\r\n",
+                   session->phase_ms[DETECTION_PHASE_WARMUP], session->phase_samples[DETECTION_PHASE_WARMUP],
+                   session->phase_ms[DETECTION_PHASE_COARSE], session->phase_samples[DETECTION_PHASE_COARSE],
+                   session->phase_ms[DETECTION_PHASE_ANALYSIS], session->phase_samples[DETECTION_PHASE_ANALYSIS],
+                   session->phase_ms[DETECTION_PHASE_ALARM]);
             printf("LOW_POWER: === SCENARIO ANALYSIS END ===\r\n");
 
-            // 分析检测场景
-            if (detection_duration < 300) {
-                printf("LOW_POWER: >>> SCENARIO 1: No vibration detected (quick completion)\r\n");
-                printf("LOW_POWER: >>> Expected: 200 samples -> Coarse detection [NOT TRIGGERED] -> Sleep\r\n");
-            } else if (detection_duration < 2000) {
-                printf("LOW_POWER: >>> SCENARIO 2: Normal vibration detected (moderate duration)\r\n");
-                printf("LOW_POWER: >>> Expected: 200 samples -> Coarse [TRIGGERED] -> 512 samples -> FFT -> Fine [NORMAL] -> Sleep\r\n");
-            } else {
-                printf("LOW_POWER: >>> SCENARIO 2/3: Complex analysis or alarm process\r\n");
-                printf("LOW_POWER: >>> Expected: Full detection chain with possible LoRa alarm\r\n");
+            // 按会话结束原因区分场景
+            switch (session->end_reason) {
+                case DETECTION_END_QUIET:
+                    printf("LOW_POWER: >>> SCENARIO 1: No vibration detected (coarse window quiet)\r\n");
+                    break;
+                case DETECTION_END_NORMAL:
+                    printf("LOW_POWER: >>> SCENARIO 2: Vibration analysed, classified normal\r\n");
+                    break;
+                case DETECTION_END_ALARM:
+                    printf("LOW_POWER: >>> SCENARIO 3: Mining detected, alarm process finished\r\n");
+                    break;
+                default:
+                    printf("LOW_POWER: >>> Phase budget exhausted in %s, sleeping\r\n",
+                           Detection_Session_PhaseName(session->end_phase));
+                    break;
             }
-            printf("LOW_POWER: >>> Power saving achieved: Sleep mode between detections\r\n");
         }
         
         // 重置检测开始时间
@@ -273,6 +628,48 @@ bool LowPower_IsDetectionComplete(void)
     return detection_complete;
 }
 
+/**
+ * @brief 记录一轮检测结果并计算下一个唤醒周期
+ */
+uint32_t LowPower_AdaptWakeupPeriod(uint32_t coarse_triggers, uint32_t mining_detections)
+{
+    uint8_t idx = g_low_power_manager.history_index;
+    bool recent_trigger = false;
+    bool recent_mining = false;
+
+    g_low_power_manager.trigger_history[idx] = (coarse_triggers > 255U) ? 255U : (uint8_t)coarse_triggers;
+    g_low_power_manager.mining_history[idx] = (mining_detections > 255U) ? 255U : (uint8_t)mining_detections;
+    g_low_power_manager.history_index = (uint8_t)((idx + 1U) % LOW_POWER_ADAPTIVE_HISTORY);
+
+    for (int i = 0; i < LOW_POWER_ADAPTIVE_HISTORY; i++) {
+        recent_trigger |= (g_low_power_manager.trigger_history[i] != 0);
+        recent_mining |= (g_low_power_manager.mining_history[i] != 0);
+    }
+
+    uint32_t period_ms = g_low_power_manager.wakeup_period_ms;
+    if (coarse_triggers > 0 || mining_detections > 0 || recent_mining) {
+        period_ms = LOW_POWER_ADAPTIVE_MIN_MS;
+    } else {
+        // 安静轮次逐轮加倍：活跃结束后几轮内恢复到基准周期，整个历史窗口安静后才放宽到上限
+        uint32_t limit_ms = recent_trigger ? RTC_WAKEUP_PERIOD_SEC * 1000U : LOW_POWER_ADAPTIVE_MAX_MS;
+        period_ms = (period_ms * 2U > limit_ms) ? limit_ms : period_ms * 2U;
+        if (period_ms < LOW_POWER_ADAPTIVE_MIN_MS) {
+            period_ms = LOW_POWER_ADAPTIVE_MIN_MS;
+        }
+    }
+
+    if (period_ms != g_low_power_manager.wakeup_period_ms) {
+        g_low_power_manager.period_change_count++;
+        if (g_low_power_manager.debug_enabled) {
+            printf("LOW_POWER: Wakeup period %lu -> %lu ms (triggers %lu, mining %lu)\r\n",
+                   g_low_power_manager.wakeup_period_ms, period_ms, coarse_triggers, mining_detections);
+        }
+        g_low_power_manager.wakeup_period_ms = period_ms;
+    }
+
+    return period_ms;
+}
+
 /**
  * @brief 功耗统计更新
  */
@@ -282,16 +679,27 @@ void LowPower_UpdatePowerStats(void)
         return;
     }
     
-    // 计算平均功耗（简化估算）
-    uint32_t total_time_sec = g_low_power_manager.total_sleep_time_sec + 
-                             (g_low_power_manager.total_active_time_ms / 1000);
+    // 计算平均功耗（按能耗模型估算）
+#if ENABLE_POWER_ACCOUNTING
+    // 按实测的各负载驻留时间折算 (含LoRa、UART发送和WFI空闲)
+    g_low_power_manager.average_power_ma = Power_Account_AverageMa();
+#else
+    float sleep_sec = g_low_power_manager.total_sleep_time_ms / 1000.0f;
+    float stop_sec = g_low_power_manager.total_stop_time_ms / 1000.0f;
+    float active_sec = g_low_power_manager.total_active_time_ms / 1000.0f +
+                       g_low_power_manager.batch_active_us / 1000000.0f;
+    float total_time_sec = sleep_sec + stop_sec + active_sec;
     
-    if (total_time_sec > 0) {
-        // 估算平均功耗：Sleep时0.1mA，Active时10mA
-        float sleep_power = g_low_power_manager.total_sleep_time_sec * 0.1f;
-        float active_power = (g_low_power_manager.total_active_time_ms / 1000.0f) * 10.0f;
-        g_low_power_manager.average_power_ma = (sleep_power + active_power) / total_time_sec;
+    if (total_time_sec > 0.0f) {
+        // Sleep: MCU Sleep + 传感器LN；STOP: MCU STOP + 传感器LP(WOM)或LN(轮询/批处理)；活跃: MCU运行 + 传感器LN
+        float sleep_power = sleep_sec * (LP_CURRENT_MCU_SLEEP_MA + LP_CURRENT_SENSOR_LN_MA);
+        float stop_power = stop_sec * (LP_CURRENT_MCU_STOP_MA +
+                                       ((ENABLE_WOM_WAKEUP && !ENABLE_FIFO_BATCHING) ?
+                                        LP_CURRENT_SENSOR_LP_MA : LP_CURRENT_SENSOR_LN_MA));
+        float active_power = active_sec * (LP_CURRENT_MCU_RUN_MA + LP_CURRENT_SENSOR_LN_MA);
+        g_low_power_manager.average_power_ma = (sleep_power + stop_power + active_power) / total_time_sec;
     }
+#endif
 }
 
 /**
@@ -318,20 +726,66 @@ void LowPower_PrintStats(void)
     printf("Sleep count: %lu\r\n", g_low_power_manager.sleep_count);
     printf("Wakeup count: %lu\r\n", g_low_power_manager.wakeup_count);
     printf("Detection count: %lu\r\n", g_low_power_manager.detection_count);
-    printf("Total sleep time: %lu sec\r\n", g_low_power_manager.total_sleep_time_sec);
+    printf("Total sleep time: %lu ms\r\n", g_low_power_manager.total_sleep_time_ms);
+#if ENABLE_ADAPTIVE_RTC_PERIOD && !(ENABLE_WOM_WAKEUP || ENABLE_FIFO_BATCHING)
+    printf("Wakeup period: %lu ms (%lu changes, range %d-%d ms), coarse triggers: %lu\r\n",
+           g_low_power_manager.wakeup_period_ms, g_low_power_manager.period_change_count,
+           LOW_POWER_ADAPTIVE_MIN_MS, LOW_POWER_ADAPTIVE_MAX_MS, g_low_power_manager.coarse_trigger_count);
+#endif
+#if ENABLE_WOM_WAKEUP || LOW_POWER_POLL_USE_STOP
+    printf("STOP count: %lu, total STOP time: %lu ms\r\n",
+           g_low_power_manager.stop_count, g_low_power_manager.total_stop_time_ms);
+    // 唤醒到首次读FIFO必须小于FIFO可缓冲的时间，否则丢样本
+    printf("STOP wake: clock %lu us, first SPI %lu us (max %lu us), FIFO depth %lu us, fallbacks %lu, tick repairs %lu\r\n",
+           g_low_power_manager.stop_clock_restore_us, g_low_power_manager.stop_wake_to_spi_us,
+           g_low_power_manager.stop_wake_to_spi_max_us,
+           (uint32_t)(INV_FIFO_CAPACITY_PACKETS * 1000000.0f / SAMPLING_FREQ),
+           g_low_power_manager.stop_clock_fallback_count, g_low_power_manager.systick_repair_count);
+#endif
+    for (int i = 0; i < LP_PHASE_COUNT; i++) {
+        const low_power_phase_stats_t *p = &g_low_power_manager.transition[i];
+        if (p->count == 0) {
+            continue;
+        }
+        printf("Transition %-12s: last %lu us, avg %lu us, max %lu us, timeouts %lu/%lu\r\n",
+               g_phase_names[i], p->last_us, (uint32_t)(p->total_us / p->count), p->max_us,
+               p->timeouts, p->count);
+    }
+#if ENABLE_FIFO_BATCHING
+    printf("FIFO batches: %lu (watermark %u packets), heartbeats: %lu\r\n",
+           g_low_power_manager.batch_count, g_low_power_manager.batch_watermark,
+           g_low_power_manager.heartbeat_count);
+    printf("Batch burst: last %lu us, max %lu us, total %lu ms, FIFO overflows %lu\r\n",
+           g_low_power_manager.batch_burst_us, g_low_power_manager.batch_burst_max_us,
+           (uint32_t)(g_low_power_manager.batch_active_us / 1000U), GetInvDeviceFifoOverflowCount());
+#elif ENABLE_WOM_WAKEUP
+    printf("WOM wakeups: %lu, heartbeats: %lu\r\n",
+           g_low_power_manager.wom_wakeup_count, g_low_power_manager.heartbeat_count);
+    printf("WOM threshold: %u LSB (%.1f mg)\r\n", g_low_power_manager.wom_threshold_lsb,
+           g_low_power_manager.wom_threshold_lsb * WOM_THRESHOLD_MG_PER_LSB);
+#endif
     printf("Total active time: %lu ms\r\n", g_low_power_manager.total_active_time_ms);
     printf("Average power: %.2f mA\r\n", g_low_power_manager.average_power_ma);
     printf("Current state: %s\r\n",
-           (g_low_power_manager.current_state == LOW_POWER_STATE_SLEEP) ? "SLEEP" : "ACTIVE");
+           (g_low_power_manager.current_state == LOW_POWER_STATE_SLEEP) ? "SLEEP" :
+           (g_low_power_manager.current_state == LOW_POWER_STATE_STOP) ? "STOP" : "ACTIVE");
 
     // 计算功耗优化效果
     if (g_low_power_manager.total_active_time_ms > 0) {
-        uint32_t total_time_ms = g_low_power_manager.total_sleep_time_sec * 1000 + g_low_power_manager.total_active_time_ms;
-        float sleep_ratio = (float)(g_low_power_manager.total_sleep_time_sec * 1000) / total_time_ms * 100.0f;
+        uint32_t idle_time_ms = g_low_power_manager.total_sleep_time_ms + g_low_power_manager.total_stop_time_ms;
+        uint32_t total_time_ms = idle_time_ms + g_low_power_manager.total_active_time_ms;
+        float sleep_ratio = (float)idle_time_ms / total_time_ms * 100.0f;
         printf("Sleep ratio: %.1f%% (Power saving achieved!)\r\n", sleep_ratio);
     }
 
     printf("============================\r\n");
+    Detection_Session_PrintStats();
+#if ENABLE_SEQUENTIAL_DECISION
+    Sequential_Decision_PrintStats();
+#endif
+#if ENABLE_POWER_ACCOUNTING
+    Power_Account_PrintStats();
+#endif
 }
 
 /**
@@ -356,6 +810,123 @@ void LowPower_PrintScenarios(void)
     printf("================================\r\n");
 }
 
+/**
+ * @brief 估算RTC定时轮询 + SLEEP方案的平均电流
+ */
+float32_t LowPower_EstimateRtcPollCurrent(uint32_t period_ms, uint32_t active_ms)
+{
+    if (period_ms == 0) {
+        return 0.0f;
+    }
+
+    float32_t duty = (active_ms >= period_ms) ? 1.0f : (float32_t)active_ms / period_ms;
+
+    return duty * LP_CURRENT_MCU_RUN_MA + (1.0f - duty) * LP_CURRENT_MCU_SLEEP_MA +
+           LP_CURRENT_SENSOR_LN_MA;
+}
+
+/**
+ * @brief 估算运动唤醒 + STOP方案的平均电流
+ */
+float32_t LowPower_EstimateWomCurrent(float32_t events_per_hour, uint32_t event_active_ms,
+                                      uint32_t heartbeat_period_sec)
+{
+    float32_t idle_ma = LP_CURRENT_MCU_STOP_MA + LP_CURRENT_SENSOR_LP_MA;
+    float32_t event_duty = events_per_hour * event_active_ms / 3600000.0f;
+    float32_t heartbeat_duty = 0.0f;
+
+    if (heartbeat_period_sec > 0) {
+        heartbeat_duty = LP_ESTIMATE_HEARTBEAT_ACTIVE_MS / (heartbeat_period_sec * 1000.0f);
+    }
+    if (event_duty + heartbeat_duty > 1.0f) {
+        event_duty = 1.0f - heartbeat_duty;
+    }
+
+    return idle_ma +
+           event_duty * (LP_CURRENT_MCU_RUN_MA + LP_CURRENT_SENSOR_LN_MA - idle_ma) +
+           heartbeat_duty * (LP_CURRENT_MCU_RUN_MA - LP_CURRENT_MCU_STOP_MA);
+}
+
+/**
+ * @brief 估算FIFO批处理 + STOP方案的平均电流
+ */
+float32_t LowPower_EstimateBatchCurrent(float32_t batches_per_sec, uint32_t burst_us, float32_t sensor_ma)
+{
+    float32_t duty = batches_per_sec * burst_us / 1000000.0f;
+
+    if (duty > 1.0f) {
+        duty = 1.0f;
+    }
+
+    return LP_CURRENT_MCU_STOP_MA + sensor_ma + duty * (LP_CURRENT_MCU_RUN_MA - LP_CURRENT_MCU_STOP_MA);
+}
+
+/**
+ * @brief 打印两种方案的能耗对比
+ */
+void LowPower_PrintEnergyEstimate(void)
+{
+    const detection_params_t* params = Detection_Params_Get();
+
+    // RTC轮询：每周期休眠/唤醒过渡 (UART发完 + 时钟就绪 + 传感器就绪) + 安静会话 (滤波器稳定 + 一个RMS窗口)
+    uint32_t window_ms = (uint32_t)(params->rms_window_size * 1000.0f / SAMPLING_FREQ);
+    uint32_t warmup_ms = (uint32_t)(DETECTION_WARMUP_SAMPLES * 1000.0f / SAMPLING_FREQ);
+    uint32_t poll_period_ms = RTC_WAKEUP_PERIOD_SEC * 1000;
+    uint32_t poll_active_ms = (LowPower_TransitionUs() + 999U) / 1000U + warmup_ms + window_ms;
+    float32_t poll_ma = LowPower_EstimateRtcPollCurrent(poll_period_ms, poll_active_ms);
+
+    // 运动唤醒：有实测WOM数据时使用实测事件率和每次活跃时间
+    float32_t events_per_hour = LP_ESTIMATE_EVENTS_PER_HOUR;
+    uint32_t event_active_ms = LP_ESTIMATE_EVENT_ACTIVE_MS;
+    bool measured = (g_low_power_manager.wom_wakeup_count > 0 && HAL_GetTick() > 0);
+    if (measured) {
+        events_per_hour = g_low_power_manager.wom_wakeup_count * 3600000.0f / HAL_GetTick();
+        event_active_ms = g_low_power_manager.wom_active_time_ms / g_low_power_manager.wom_wakeup_count;
+    }
+    float32_t wom_ma = LowPower_EstimateWomCurrent(events_per_hour, event_active_ms,
+                                                   WOM_HEARTBEAT_PERIOD_SEC);
+
+    printf("=== ENERGY ESTIMATE ===\r\n");
+    printf("RTC poll + SLEEP: %lu ms active / %lu ms, sensor LN -> %.3f mA (%.1f mAh/day), "
+           "coverage %.1f%%\r\n",
+           poll_active_ms, poll_period_ms, poll_ma, poll_ma * 24.0f,
+           100.0f * window_ms / poll_period_ms);
+    printf("WOM + STOP: %.1f events/h x %lu ms (%s), heartbeat %d s -> %.3f mA (%.1f mAh/day), "
+           "coverage 100%%\r\n",
+           events_per_hour, event_active_ms, measured ? "measured" : "assumed",
+           WOM_HEARTBEAT_PERIOD_SEC, wom_ma, wom_ma * 24.0f);
+#if ENABLE_ADAPTIVE_RTC_PERIOD
+    // 自适应轮询：安静期按周期上限估算 (活跃期与固定周期相同)
+    float32_t quiet_ma = LowPower_EstimateRtcPollCurrent(LOW_POWER_ADAPTIVE_MAX_MS, poll_active_ms);
+    printf("RTC poll adaptive (quiet, %d ms): %.3f mA (%.1f mAh/day), worst-case delay %lu ms\r\n",
+           LOW_POWER_ADAPTIVE_MAX_MS, quiet_ma, quiet_ma * 24.0f,
+           (uint32_t)LOW_POWER_ADAPTIVE_MAX_MS + poll_active_ms);
+#endif
+    if (wom_ma > 0.0f) {
+        printf("Reduction: %.1fx\r\n", poll_ma / wom_ma);
+    }
+
+#if ENABLE_FIFO_BATCHING
+    // FIFO批处理：有实测数据时使用实测唤醒率和每批活跃时间
+    uint16_t watermark = g_low_power_manager.batch_watermark ? g_low_power_manager.batch_watermark
+                                                             : LOW_POWER_BATCH_WATERMARK;
+    float32_t batches_per_sec = SAMPLING_FREQ / watermark;
+    uint32_t burst_us = LP_ESTIMATE_BATCH_BURST_US;
+    uint32_t batch_elapsed_ms = HAL_GetTick() - g_low_power_manager.batch_armed_time;
+    bool batch_measured = (g_low_power_manager.batch_count > 0 && batch_elapsed_ms > 0);
+    if (batch_measured) {
+        batches_per_sec = g_low_power_manager.batch_count * 1000.0f / batch_elapsed_ms;
+        burst_us = (uint32_t)(g_low_power_manager.batch_active_us / g_low_power_manager.batch_count);
+    }
+    float32_t batch_ma = LowPower_EstimateBatchCurrent(batches_per_sec, burst_us, LP_CURRENT_SENSOR_LN_MA);
+    printf("FIFO batch + STOP: %.2f wakeups/s x %lu us (%s), sensor LN -> %.3f mA (%.1f mAh/day), "
+           "coverage 100%% (vs %.0f wakeups/s per packet)\r\n",
+           batches_per_sec, burst_us, batch_measured ? "measured" : "assumed",
+           batch_ma, batch_ma * 24.0f, SAMPLING_FREQ / INV_FIFO_DEFAULT_WATERMARK);
+#endif
+    printf("=======================\r\n");
+}
+
 /**
  * @brief 设置功耗模式
  */
@@ -376,6 +947,185 @@ power_mode_t LowPower_GetMode(void)
 
 
 
+/**
+ * @brief STOP并恢复
+ *
+ * 低功耗稳压器 + Flash掉电进入STOP。中断在STOP期间屏蔽，唤醒源挂起后先以寄存器级
+ * 快速恢复84MHz时钟，再执行中断服务 (UART波特率等依赖84MHz)。
+ * SPI/DMA寄存器在STOP期间保持，无需重新初始化；UART1接收被终止时重新启动。
+ * @return STOP时长 (ms, RTC测量)
+ */
+static uint32_t LowPower_StopAndRestore(void)
+{
+    // STOP期间UART时钟停止，先发完最后一个字节
+    LowPower_WaitUartIdle(LOW_POWER_UART_DRAIN_MS);
+
+    uint32_t stop_start_ms = RTC_Wakeup_GetTimeMs();
+
+    __disable_irq();
+    HAL_SuspendTick();
+
+#if LOW_POWER_STOP_FLASH_POWERDOWN
+    HAL_PWREx_EnableFlashPowerDown();
+#endif
+    Power_Account_SetMcu(POWER_LOAD_MCU_STOP);
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // 唤醒后SYSCLK为HSI，DWT按HSI计数直到切回PLL
+    uint32_t wake_cycles = DWT_Timer_GetCycles();
+    int clock_rc = Clock_Config_RestoreAfterStop();
+    uint32_t restored_cycles = DWT_Timer_GetCycles();
+
+#if LOW_POWER_STOP_FLASH_POWERDOWN
+    HAL_PWREx_DisableFlashPowerDown();
+#endif
+    HAL_ResumeTick();
+    Power_Account_SetMcu(POWER_LOAD_MCU_RUN);
+    __enable_irq();
+
+    if (clock_rc != 0) {
+        // HSE/PLL未在超时内就绪：开中断后由HAL完整重配 (带超时和Error_Handler)
+        SystemClock_Config();
+        g_low_power_manager.stop_clock_fallback_count++;
+#if ENABLE_DVFS
+        Dvfs_NotifyClockReset();
+#endif
+        restored_cycles = DWT_Timer_GetCycles();
+    }
+
+    g_low_power_manager.stop_clock_restore_us = LP_STOP_WAKEUP_US +
+                                                (restored_cycles - wake_cycles) / (HSI_VALUE / 1000000U);
+    g_spi_latency_start = restored_cycles;
+    g_spi_latency_pending = true;
+
+    // SysTick在STOP期间停止，按RTC测量的时长补偿HAL时基
+    RTC_Wakeup_Resync();
+    uint32_t stop_ms = (RTC_Wakeup_GetTimeMs() + LOW_POWER_RTC_DAY_MS - stop_start_ms) % LOW_POWER_RTC_DAY_MS;
+    uwTick += stop_ms;
+    Power_Account_AddStopTime(stop_ms);
+#if ENABLE_SYSTEM_MONITOR
+    System_Monitor_RecordStop(stop_ms);
+#endif
+
+    Host_Protocol_ResumeAfterStop();
+
+    return stop_ms;
+}
+
+/**
+ * @brief 读取粗检测触发和挖掘判定的累计数 (自适应唤醒周期按轮次差值计算)
+ */
+static void LowPower_GetActivityCounts(uint32_t *triggers, uint32_t *minings)
+{
+    *triggers = Coarse_Detector_GetInfo()->trigger_count;
+#if ENABLE_SYSTEM_STATE_MACHINE
+    *minings = System_State_Machine_GetInfo()->state_count[STATE_MINING_DETECTED];
+#else
+    *minings = 0;
+#endif
+}
+
+/**
+ * @brief 等待UART1发送完成 (DMA发送结束且移位寄存器为空)
+ * @return true: 已发送完成, false: 超时
+ */
+static bool LowPower_WaitUartIdle(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (huart1.gState != HAL_UART_STATE_READY || __HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC) == RESET) {
+        if ((HAL_GetTick() - start) >= timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 传感器模式切换后确认SysTick仍是1ms节拍 (uwTick按毫秒累加STOP时间)，否则重新配置
+ */
+static void LowPower_CheckSysTick(const char *where)
+{
+    uint32_t expected = SystemCoreClock / 1000U - 1U;
+
+    if (SysTick->LOAD != expected) {
+        printf("LOW_POWER: ERROR - SysTick LOAD %lu after %s (expected %lu), reconfiguring\r\n",
+               SysTick->LOAD, where, expected);
+        HAL_InitTick(TICK_INT_PRIORITY);
+        g_low_power_manager.systick_repair_count++;
+    }
+}
+
+/**
+ * @brief 等待HSE/PLL就绪且SYSCLK为PLL
+ * @return true: 时钟就绪, false: 超时
+ */
+static bool LowPower_WaitClockReady(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (__HAL_RCC_GET_FLAG(RCC_FLAG_HSERDY) == RESET || __HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == RESET ||
+           __HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+        if ((HAL_GetTick() - start) >= timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 等待传感器有可读样本：INT1 (FIFO水位线) 已到达或FIFO_COUNT非零
+ * @return true: 有样本, false: 超时 (检测流程照常继续，由FIFO中断驱动)
+ */
+static bool LowPower_WaitSensorReady(uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick();
+    uint16_t packets = 0;
+
+    do {
+        if (irq_from_device & LOW_POWER_SENSOR_INT1_MASK) {
+            return true;
+        }
+        if (InvDevice_GetFifoCount(&packets) == 0 && packets > 0) {
+            return true;
+        }
+    } while ((HAL_GetTick() - start) < timeout_ms);
+
+    return false;
+}
+
+/**
+ * @brief 记录一次过渡阶段耗时
+ */
+static void LowPower_RecordPhase(low_power_phase_t phase, uint32_t elapsed_us, bool ready)
+{
+    low_power_phase_stats_t *p = &g_low_power_manager.transition[phase];
+
+    p->count++;
+    p->last_us = elapsed_us;
+    if (elapsed_us > p->max_us) {
+        p->max_us = elapsed_us;
+    }
+    p->total_us += elapsed_us;
+    if (!ready) {
+        p->timeouts++;
+    }
+}
+
+/**
+ * @brief 每轮休眠/唤醒过渡的平均耗时 (微秒)，尚无实测的阶段按超时上限计
+ */
+static uint32_t LowPower_TransitionUs(void)
+{
+    uint32_t us = 0;
+
+    for (int i = 0; i < LP_PHASE_COUNT; i++) {
+        const low_power_phase_stats_t *p = &g_low_power_manager.transition[i];
+        us += (p->count > 0) ? (uint32_t)(p->total_us / p->count) : g_phase_timeout_ms[i] * 1000U;
+    }
+    return us;
+}
+
 /**
  * @brief 保存系统状态
  */
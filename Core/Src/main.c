@@ -29,6 +29,20 @@
 /* FFT Processing */
 #include "fft_processor.h"
 #include "fft_test.h"
+/* Host command protocol */
+#include "host_protocol.h"
+#include "detection_params.h"
+/* LoRa alarm transport */
+#include "lora_transport.h"
+#include "modbus_rtu.h"
+#include "dwt_timer.h"
+#include "telemetry.h"
+#include "event_loop.h"
+#include "profiler.h"
+#include "latency_tracker.h"
+#include "system_monitor.h"
+#include "power_account.h"
+#include "dvfs.h"
 // #include "simple_protocol_test.h"  // 直接在main.c中实现
 
 #include "arm_math.h"
@@ -99,6 +113,10 @@ SPI_HandleTypeDef hspi1;
 
 UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart5;
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
+DMA_HandleTypeDef hdma_uart5_rx;
+DMA_HandleTypeDef hdma_uart5_tx;
 
 /* USER CODE BEGIN PV */
 #if ENABLE_LOW_POWER_MODE
@@ -106,36 +124,12 @@ UART_HandleTypeDef huart5;
 extern RTC_HandleTypeDef hrtc;
 #endif
 
-/* LoRa Communication Variables */
-uint8_t lora_rx_buffer[64];
-uint8_t lora_tx_buffer[64];
-volatile uint8_t lora_rx_complete = 0;
-volatile uint8_t lora_tx_complete = 1;
-uint8_t lora_rx_index = 0;
-
-/* Upper Computer Communication Variables */
-uint8_t uart1_rx_buffer[64];
-volatile uint8_t uart1_rx_complete = 0;
-uint8_t uart1_rx_index = 0;
-
-/* Alarm Signal State - 简化版本，无HOLD状态 */
-typedef enum {
-    ALARM_STATE_IDLE = 0,
-    ALARM_STATE_SET_1,
-    ALARM_STATE_WAIT_RESPONSE_1,
-    ALARM_STATE_WAIT_RESPONSE_0,
-    ALARM_STATE_COMPLETE
-} alarm_state_t;
-
-volatile alarm_state_t alarm_state = ALARM_STATE_IDLE;
-uint32_t lora_timeout_start_time = 0;
-
-#define LORA_TIMEOUT_MS         5000    // 5 second timeout for LoRa response
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
+static void MX_DMA_Init(void);
 static void MX_SPI1_Init(void);
 static void MX_USART1_UART_Init(void);
 static void MX_UART5_Init(void);
@@ -146,24 +140,22 @@ static void check_rc(int rc, const char * msg_context);
 void msg_printer(int level, const char * str, va_list ap);
 
 static void SetupMCUHardware(struct inv_iim423xx_serif * icm_serif);
+static void Main_Loop_Dispatch(uint32_t events);
+#if ENABLE_LOW_POWER_MODE
+#if ENABLE_FIFO_BATCHING
+static void Main_Loop_RunBatch(void);
+#else
+static void Main_Loop_RunDetection(void);
+#endif
+#endif
 
 /* USER CODE BEGIN PFP */
 void inv_iim423xx_sleep_ms(uint32_t ms);
 void inv_iim423xx_sleep_us(uint32_t us);
 void Simple_Protocol_Test(void);  // 协议测试函数声明
 
-/* LoRa Communication Functions */
-uint16_t Calculate_CRC16_Modbus(uint8_t *data, uint16_t length);
-void Build_Modbus_Command(uint8_t value, uint8_t *command_buffer);
-void LoRa_Send_Command(uint8_t *command, uint8_t length);
-void Process_Alarm_State_Machine(void);
-void Trigger_Alarm_Cycle(void);
-
 /* Upper Computer Communication Functions */
-void Process_UART1_Command(void);
 void Send_Response_To_PC(const char *message);
-void Start_UART1_Reception(void);
-void Start_LoRa_Reception(void);
 /* USER CODE END PFP */
 //low-levevl IO access function
 int inv_io_hal_read_reg(struct inv_iim423xx_serif * serif, uint8_t reg, uint8_t * rbuffer, uint32_t rlen);
@@ -192,12 +184,14 @@ enum gpio_inv_pin_num {
 int fputc(int ch, FILE *f)
 {
   HAL_UART_Transmit(&huart1, (uint8_t *)&ch, 1, 1000);
+  Power_Account_AddUartTx(1, huart1.Init.BaudRate);
   return ch;
 }
 
 int __io_putchar(int ch)
 {
   HAL_UART_Transmit(&huart1, (uint8_t *)&ch, 1, 1000);
+  Power_Account_AddUartTx(1, huart1.Init.BaudRate);
   return ch;
 }
 
@@ -205,6 +199,7 @@ int __io_putchar(int ch)
 int _write(int file, char *ptr, int len)
 {
   HAL_UART_Transmit(&huart1, (uint8_t *)ptr, len, 1000);
+  Power_Account_AddUartTx(len, huart1.Init.BaudRate);
   return len;
 }
 /* USER CODE END 0 */
@@ -238,6 +233,7 @@ int main(void)
 
 //  /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_SPI1_Init();
   MX_USART1_UART_Init();
   MX_UART5_Init();
@@ -285,9 +281,36 @@ int main(void)
 
 	   HAL_Delay(1000);
 
+  /* Enable DWT cycle counter for timing/telemetry */
+  if (DWT_Timer_Init() != 0) {
+    printf("!!! ERROR : DWT cycle counter not available\r\n");
+  }
+#if ENABLE_POWER_ACCOUNTING
+  Power_Account_Init();
+#endif
+#if ENABLE_DVFS
+  Dvfs_Init();
+#endif
+#if ENABLE_PROFILING
+  Profiler_Init();
+#endif
+#if ENABLE_LATENCY_TRACKER
+  Latency_Tracker_Init();
+#endif
+#if ENABLE_SYSTEM_MONITOR
+  System_Monitor_Init();
+#endif
+
+  /* Initialize detection parameters (must precede detector init) */
+  Detection_Params_Init();
+
   /* Initialize UART reception */
-  Start_UART1_Reception();
-  Start_LoRa_Reception();
+  if (Host_Protocol_Init(&huart1) != 0) {
+    printf("!!! ERROR : failed to initialize host command protocol\r\n");
+  }
+  if (LoRa_Transport_Init(&huart5) != 0) {
+    printf("!!! ERROR : failed to initialize LoRa transport\r\n");
+  }
 
   printf("LoRa Communication System Initialized\n");
   printf("PE14 LoRa Power Control: OFF (Low Power Mode)\n");
@@ -358,6 +381,14 @@ int main(void)
 	printf("LOW_POWER: Wakeup period: %d seconds\r\n", RTC_WAKEUP_PERIOD_SEC);
 #endif
 
+#if ENABLE_TELEMETRY
+	/* 初始化周期遥测 (所有统计源初始化之后) */
+	Telemetry_Init();
+#endif
+
+	/* 初始化事件驱动主循环 */
+	Event_Loop_Init();
+
 	/* Skip FFT Tests for production */
 	// FFT_RunAllTests();
 
@@ -370,6 +401,11 @@ int main(void)
 	/* 显示三种场景说明 */
 	LowPower_PrintScenarios();
 
+#if ENABLE_WOM_WAKEUP || ENABLE_FIFO_BATCHING
+	/* 运动唤醒/批处理方案与原RTC轮询方案的能耗对比 */
+	LowPower_PrintEnergyEstimate();
+#endif
+
 	/* 给串口输出时间，然后启动RTC */
 	HAL_Delay(1000);
 	printf("LOW_POWER: Starting RTC wakeup timer...\r\n");
@@ -383,6 +419,78 @@ int main(void)
 	printf("LOW_POWER: RTC wakeup timer started successfully\r\n");
 	HAL_Delay(500);  // 再给一点时间输出
 
+#if ENABLE_FIFO_BATCHING
+	/* FIFO批处理：传感器持续采集，MCU STOP直到FIFO接近满，一次读空并处理后立即回到STOP */
+	do {
+		if (!LowPower_GetStats()->batch_armed) {
+			LowPower_ArmFifoBatching();
+		}
+
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_SLEEP);
+#endif
+#if ENABLE_SYSTEM_MONITOR
+		uint32_t stop_start = DWT_Timer_GetCycles();
+#endif
+		wakeup_source_t wakeup_source = LowPower_EnterStop();
+#if ENABLE_SYSTEM_MONITOR
+		System_Monitor_RecordIdle(DWT_Timer_GetCycles() - stop_start);
+#endif
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
+
+		if (wakeup_source == WAKEUP_SOURCE_EXTERNAL) {
+			LowPower_BeginBatch();
+		}
+		Main_Loop_RunBatch();
+
+		if (RTC_Wakeup_IsPending()) {
+			LowPower_HandleHeartbeat();
+		}
+
+	} while(1);
+#elif ENABLE_WOM_WAKEUP
+	/* 运动唤醒：传感器LP + WOM，MCU STOP，只有WOM中断启动LN采集；RTC为健康心跳 */
+	do {
+		if (!LowPower_GetStats()->wom_armed) {
+			LowPower_ArmWakeOnMotion();
+		}
+
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_SLEEP);
+#endif
+#if ENABLE_SYSTEM_MONITOR
+		uint32_t stop_start = DWT_Timer_GetCycles();
+#endif
+		wakeup_source_t wakeup_source = LowPower_EnterStop();
+#if ENABLE_SYSTEM_MONITOR
+		System_Monitor_RecordIdle(DWT_Timer_GetCycles() - stop_start);
+#endif
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
+
+		if (wakeup_source == WAKEUP_SOURCE_EXTERNAL) {
+			/* WOM唤醒：恢复LN 1kHz采集，运行检测流程直到完成 */
+			LowPower_HandleMotionWakeup();
+			LowPower_StartDetectionProcess();
+			Main_Loop_RunDetection();
+		}
+
+		if (RTC_Wakeup_IsPending()) {
+			LowPower_HandleHeartbeat();
+		}
+
+		/* 处理活跃期内收到的上位机命令 */
+		Host_Protocol_Process();
+
+#if ENABLE_TELEMETRY
+		Telemetry_Process();
+#endif
+
+	} while(1);
+#else
 	do {
 		/* 检查是否有RTC唤醒事件 */
 		if (RTC_Wakeup_IsPending()) {
@@ -393,127 +501,83 @@ int main(void)
 			LowPower_StartDetectionProcess();
 
 			/* 运行现有的检测流程直到完成 */
-			do {
-				/* Poll device for data */
-				if (irq_from_device & TO_MASK(INV_GPIO_INT1)) {
-					rc = GetDataFromInvDevice();
-					check_rc(rc, "error while processing FIFO");
-					irq_from_device &= ~TO_MASK(INV_GPIO_INT1);
-				}
-
-				/* Process upper computer commands */
-				if (uart1_rx_complete) {
-					Process_UART1_Command();
-					uart1_rx_complete = 0;
-					Start_UART1_Reception();
-				}
-
-				/* Process binary commands */
-				if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RXNE)) {
-					uint8_t received_char = (uint8_t)(huart1.Instance->DR & 0xFF);
-					if (uart1_rx_index == 0) {
-						if (received_char == 0x10 || received_char == 0x11 ||
-						    received_char == 0x02 || received_char == 0x04) {
-							uart1_rx_buffer[uart1_rx_index] = received_char;
-							uart1_rx_index++;
-							uart1_rx_complete = 1;
-						}
-					} else {
-						uart1_rx_index = 0;
-					}
-				}
-
-				/* Process alarm state machine */
-				Process_Alarm_State_Machine();
-
-#if ENABLE_SYSTEM_STATE_MACHINE
-				/* Process system state machine */
-				System_State_Machine_Process();
-#endif
-
-				/* 短暂延时避免CPU占用过高 */
-				HAL_Delay(1);
+			Main_Loop_RunDetection();
+		}
 
-			} while (!LowPower_IsDetectionComplete());
+		/* 处理休眠期间由UART1空闲中断唤醒收到的命令 */
+		Host_Protocol_Process();
 
-			/* 检测完成，打印统计信息 */
-			if (LOW_POWER_DEBUG_ENABLED) {
-				static uint32_t stats_counter = 0;
-				stats_counter++;
-				if (stats_counter % 10 == 0) {  // 每10次检测打印一次统计
-					LowPower_PrintStats();
-				}
-			}
-		}
+#if ENABLE_TELEMETRY
+		Telemetry_Process();
+#endif
 
 		/* 进入Sleep模式等待下次唤醒 */
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_SLEEP);
+#endif
+#if ENABLE_SYSTEM_MONITOR
+		uint32_t sleep_start = DWT_Timer_GetCycles();
+#endif
 		LowPower_EnterSleep();
+#if ENABLE_SYSTEM_MONITOR
+		System_Monitor_RecordIdle(DWT_Timer_GetCycles() - sleep_start);
+#endif
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
 
 	} while(1);
+#endif /* ENABLE_FIFO_BATCHING / ENABLE_WOM_WAKEUP */
 
 #else
-	/* 连续模式主循环（现有v4.0逻辑） */
+	/* 连续模式主循环：中断投递事件，主循环分发，空闲时WFI */
 	printf("CONTINUOUS_MODE: Starting continuous main loop\r\n");
 
 	do {
-		/* Poll device for data */
-		if (irq_from_device & TO_MASK(INV_GPIO_INT1)) {
-			rc = GetDataFromInvDevice();
-			check_rc(rc, "error while processing FIFO");
-
-			// inv_disable_irq();
-			irq_from_device &= ~TO_MASK(INV_GPIO_INT1);
-			// inv_enable_irq();
-		}
-
-		/* FFT自动处理模式，无需手动检查 */
-		// FFT处理和数据输出现在是自动的
+		uint32_t events = Event_Loop_Fetch();
 
-		/* Process upper computer commands */
-		if (uart1_rx_complete) {
-			Process_UART1_Command();
-			uart1_rx_complete = 0;
-			Start_UART1_Reception();  // Restart reception
-		}
+		Main_Loop_Dispatch(events);
 
-		// 直接读取UART1数据寄存器 - 处理二进制命令
-		if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RXNE)) {
-			// 直接从数据寄存器读取
-			uint8_t received_char = (uint8_t)(huart1.Instance->DR & 0xFF);
-
-			// 处理二进制命令（单字节命令）
-			if (uart1_rx_index == 0) {
-				// 第一个字节，检查是否是有效命令
-				if (received_char == 0x10 || received_char == 0x11 ||
-				    received_char == 0x02 || received_char == 0x04) {
-					uart1_rx_buffer[uart1_rx_index] = received_char;
-					uart1_rx_index++;
-					uart1_rx_complete = 1;  // 单字节命令立即完成
-				}
-			} else {
-				// 缓冲区溢出保护，重置
-				uart1_rx_index = 0;
-			}
-		}
-
-		/* Process alarm state machine */
-		Process_Alarm_State_Machine();
-
-#if ENABLE_SYSTEM_STATE_MACHINE
-		/* Process system state machine (阶段5) */
-		System_State_Machine_Process();
-#endif
-
-		/* 协议测试 - 每10秒发送一次测试数据 (可选) */
+		/* 心跳 - 每10秒输出一次运行状态和主循环空闲率 */
 		static uint32_t last_test_time = 0;
-		if (HAL_GetTick() - last_test_time > 10000) {
+		if ((events & EVENT_MASK(EVENT_TICK)) && HAL_GetTick() - last_test_time > 10000) {
 			last_test_time = HAL_GetTick();
 			// Simple_Protocol_Test();  // 暂时禁用测试数据
 			printf("CONTINUOUS_MODE: System running normally (tick: %lu)\r\n", HAL_GetTick());
+			Event_Loop_PrintStats(true);
+			printf("SENSOR_FIFO: peak %lu/%d packets, overflows %lu\r\n",
+			       GetInvDeviceFifoPeakPackets(true), INV_FIFO_CAPACITY_PACKETS,
+			       GetInvDeviceFifoOverflowCount());
+#if ENABLE_DUAL_RATE_SENSOR
+			{
+				const sensor_rate_stats_t *rs = Sensor_Rate_GetStats();
+				printf("SENSOR_RATE: %s, to LN %lu, to LP %lu, LN %lu ms, LP %lu ms, baseline %.6f g, errors %lu\r\n",
+				       rs->rate == SENSOR_RATE_MONITOR ? "LP monitor" : "LN active",
+				       rs->to_active_count, rs->to_monitor_count, rs->active_time_ms, rs->monitor_time_ms,
+				       rs->monitor_baseline_rms, rs->switch_errors);
+			}
+#endif
+#if ENABLE_FFT_DEFERRED
+			FFT_Worker_PrintStats(true);
+#endif
+#if ENABLE_SEQUENTIAL_DECISION
+			Sequential_Decision_PrintStats();
+#endif
+#if ENABLE_DVFS
+			Dvfs_PrintStats();
+#endif
+#if ENABLE_SYSTEM_MONITOR
+			System_Monitor_PrintStats(true);
+#endif
 		}
 
-		// 短暂延时避免CPU占用过高
-		HAL_Delay(1);
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_WAIT);
+#endif
+		Event_Loop_WaitForEvent();
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
 
 	} while(1);
 #endif
@@ -688,6 +752,32 @@ static void check_rc(int rc, const char * msg_context)
 }
 
 
+/**
+  * Enable DMA controller clock
+  */
+static void MX_DMA_Init(void)
+{
+
+  /* DMA controller clock enable */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* DMA interrupt init */
+  /* DMA1_Stream0_IRQn interrupt configuration (UART5_RX) */
+  HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+  /* DMA1_Stream7_IRQn interrupt configuration (UART5_TX) */
+  HAL_NVIC_SetPriority(DMA1_Stream7_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+  /* DMA2_Stream2_IRQn interrupt configuration (USART1_RX) */
+  HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+  /* DMA2_Stream7_IRQn interrupt configuration (USART1_TX) */
+  HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 1, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+
+}
+
 /**
   * @brief GPIO Initialization Function
   * @param None
@@ -846,9 +936,176 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
     if (GPIO_Pin == GPIO_PIN_7) { // PC7 - ???????
         irq_from_device |= TO_MASK(INV_GPIO_INT1);
+        Event_Post(EVENT_SENSOR_FIFO);
     }
 }
 
+#if ENABLE_LOW_POWER_MODE && ENABLE_FIFO_BATCHING
+/**
+ * @brief 处理一批：读空FIFO、推进检测链和各模块，直到可以回到STOP
+ *
+ * 完成判断放在等待之前，批处理结束后不再多等一个SysTick。
+ */
+static void Main_Loop_RunBatch(void)
+{
+	Event_Post(EVENT_TICK);  // 状态机超时、上位机命令和遥测每批推进一次
+	for (;;) {
+		Main_Loop_Dispatch(Event_Loop_Fetch());
+		if (LowPower_IsBatchComplete()) {
+			break;
+		}
+
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_WAIT);
+#endif
+		Event_Loop_WaitForEvent();
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
+	}
+
+	/* 每1000批打印一次统计 (1kHz下约2分钟) */
+	static uint32_t stats_batch = 0;
+	uint32_t batch_count = LowPower_GetStats()->batch_count;
+	if (LOW_POWER_DEBUG_ENABLED && batch_count - stats_batch >= 1000) {
+		stats_batch = batch_count;
+		LowPower_PrintStats();
+		LowPower_PrintEnergyEstimate();
+		Event_Loop_PrintStats(true);
+		printf("SENSOR_FIFO: peak %lu/%u packets, overflows %lu\r\n",
+		       GetInvDeviceFifoPeakPackets(true), InvDevice_GetFifoCapacityPackets(),
+		       GetInvDeviceFifoOverflowCount());
+	}
+}
+#elif ENABLE_LOW_POWER_MODE
+/**
+ * @brief 低功耗唤醒后运行检测流程直到完成 (事件驱动，无事件时WFI)
+ */
+static void Main_Loop_RunDetection(void)
+{
+	Event_Post(EVENT_TICK);  // 唤醒后先完整推进一轮各模块
+	do {
+		Main_Loop_Dispatch(Event_Loop_Fetch());
+
+#if ENABLE_TELEMETRY
+		Telemetry_IdleEnter(TELEMETRY_IDLE_WAIT);
+#endif
+		Event_Loop_WaitForEvent();
+#if ENABLE_TELEMETRY
+		Telemetry_IdleExit();
+#endif
+
+	} while (!LowPower_IsDetectionComplete());
+
+	/* 检测完成，打印统计信息 */
+	if (LOW_POWER_DEBUG_ENABLED) {
+		static uint32_t stats_counter = 0;
+		stats_counter++;
+		if (stats_counter % 10 == 0) {  // 每10次检测打印一次统计
+			LowPower_PrintStats();
+#if ENABLE_WOM_WAKEUP
+			LowPower_PrintEnergyEstimate();
+#endif
+			Event_Loop_PrintStats(true);
+			printf("SENSOR_FIFO: peak %lu/%d packets, overflows %lu\r\n",
+			       GetInvDeviceFifoPeakPackets(true), INV_FIFO_CAPACITY_PACKETS,
+			       GetInvDeviceFifoOverflowCount());
+#if ENABLE_SYSTEM_MONITOR
+			System_Monitor_PrintStats(true);
+#endif
+#if ENABLE_DVFS
+			Dvfs_PrintStats();
+#endif
+		}
+	}
+}
+#endif
+
+/**
+ * @brief 分发一轮主循环事件 (连续模式和低功耗检测循环共用)
+ * @param events Event_Loop_Fetch返回的事件掩码
+ */
+static void Main_Loop_Dispatch(uint32_t events)
+{
+	int rc;
+
+	/* 传感器FIFO：以irq_from_device为准，先清标志再读，读取期间的新中断不会丢失 */
+	if (irq_from_device & TO_MASK(INV_GPIO_INT1)) {
+		irq_from_device &= ~TO_MASK(INV_GPIO_INT1);
+		rc = GetDataFromInvDevice();
+#if ENABLE_TELEMETRY
+		Telemetry_RecordFifoRead(rc);
+#endif
+		check_rc(rc, "error while processing FIFO");
+	}
+
+#if ENABLE_DUAL_RATE_SENSOR
+	/* 双速率切换：FIFO已读空，在回调之外重配置传感器 */
+	if (events & (EVENT_MASK(EVENT_SENSOR_FIFO) | EVENT_MASK(EVENT_TICK))) {
+		Sensor_Rate_Process();
+	}
+#endif
+
+#if ENABLE_FFT_DEFERRED
+	/* 延后的FFT/细检测：每轮只执行一个阶段，传感器中断已挂起时先让出给FIFO读取 */
+	if (FFT_Worker_Pending()) {
+		if (!(irq_from_device & TO_MASK(INV_GPIO_INT1))) {
+			FFT_Worker_Run();
+		}
+		if (FFT_Worker_Pending()) {
+			Event_Post(EVENT_DSP_JOB);
+		}
+	}
+#endif
+
+	/* Process upper computer commands (DMA idle-line framed protocol) */
+	if (events & (EVENT_MASK(EVENT_HOST_RX) | EVENT_MASK(EVENT_HOST_TX) | EVENT_MASK(EVENT_TICK))) {
+		Host_Protocol_Process();
+	}
+
+	/* Process LoRa alarm transport (non-blocking) */
+	if (events & (EVENT_MASK(EVENT_LORA_RX) | EVENT_MASK(EVENT_LORA_TX) | EVENT_MASK(EVENT_TICK))) {
+		LoRa_Transport_Process();
+	}
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+	/* Process system state machine (阶段5) */
+	if (events & (EVENT_MASK(EVENT_SENSOR_FIFO) | EVENT_MASK(EVENT_DSP_JOB) | EVENT_MASK(EVENT_TICK))) {
+		PROFILE_START(sm_start);
+		System_State_Machine_Process();
+		PROFILE_STOP(PROF_STAGE_STATE_MACHINE, sm_start);
+	}
+#endif
+
+#if ENABLE_DVFS
+	/* 按状态切换工作点 (状态机推进之后，UART/SPI忙时推迟到下一轮) */
+	if (events & (EVENT_MASK(EVENT_SENSOR_FIFO) | EVENT_MASK(EVENT_DSP_JOB) | EVENT_MASK(EVENT_TICK))) {
+		Dvfs_Process();
+	}
+#endif
+
+#if ENABLE_TELEMETRY
+	/* Periodic telemetry */
+	if (events & EVENT_MASK(EVENT_TICK)) {
+		Telemetry_Process();
+	}
+#endif
+
+#if ENABLE_SYSTEM_MONITOR
+	/* CPU load accounting per state */
+	if (events & EVENT_MASK(EVENT_TICK)) {
+		System_Monitor_Process();
+	}
+#endif
+
+#if ENABLE_POWER_ACCOUNTING
+	/* 驻留能耗记账 (DWT回绕前推进，分段记录) */
+	if (events & EVENT_MASK(EVENT_TICK)) {
+		Power_Account_Process();
+	}
+#endif
+}
+
 
 /* USER CODE END 4 */
 /*
@@ -1040,31 +1297,40 @@ unsigned char iim423xx_spi_write(uint8_t reg_addr, const uint8_t *reg_data, uint
 /*
  * Iim423xx driver needs a sleep feature from external device. Thus inv_iim423xx_sleep_us
  * is defined as extern symbol in driver. Let's give its implementation here.
+ *
+ * 驱动在运行中切换LN/LP (双速率、WOM) 时也会调用，因此用DWT周期计数忙等，
+ * 不能改写SysTick->LOAD (HAL 1ms节拍、HAL_GetTick超时和EVENT_TICK都依赖它)。
  */
 void inv_iim423xx_sleep_us(uint32_t us)
 {
-	// inv_delay_us(us);
-	uint32_t count;
-	
-	count = us;
-	count = (SystemCoreClock/1000000) * count;
-  count = count > 16777216 ? 16777216 : count;
-  SysTick->LOAD = count - 1;
-  SysTick->VAL = 0;
+  /* 正常在DWT_Timer_Init之后调用；计数器未使能时就地使能，不清零 */
+  if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles = (SystemCoreClock / 1000000U) * us;
 
-  while (!((SysTick->CTRL >> 16) & 0x1));
+  while ((DWT->CYCCNT - start) < cycles);
 }
 
 
 //low-levevl IO access function
 int inv_io_hal_read_reg(struct inv_iim423xx_serif * serif, uint8_t reg, uint8_t * rbuffer, uint32_t rlen)
 {
+	int rc;
+
 	switch (serif->serif_type) {
 		case IIM423XX_AUX1_SPI3:
 		case IIM423XX_AUX1_SPI4:
 		case IIM423XX_AUX2_SPI3:
 		case IIM423XX_UI_SPI4:
-			return iim423xx_spi_read(reg, rbuffer, rlen, 0);
+			rc = iim423xx_spi_read(reg, rbuffer, rlen, 0);
+#if ENABLE_LOW_POWER_MODE
+			LowPower_NoteSpiTransaction();
+#endif
+			return rc;
 //			return inv_spi_master_read_register(INV_SPI_AP, reg, rlen, rbuffer);
 //		case IIM423XX_UI_I2C:
 //			while(inv_i2c_master_read_register(ICM_I2C_ADDR, reg, rlen, rbuffer)) {
@@ -1085,7 +1351,11 @@ switch (serif->serif_type) {
 	case IIM423XX_AUX1_SPI4:
 	case IIM423XX_AUX2_SPI3:
 	case IIM423XX_UI_SPI4:
-		return iim423xx_spi_write(reg, wbuffer, wlen, 0);
+		rc = iim423xx_spi_write(reg, wbuffer, wlen, 0);
+#if ENABLE_LOW_POWER_MODE
+		LowPower_NoteSpiTransaction();
+#endif
+		return rc;
 //		for(uint32_t i=0; i<wlen; i++) {
 //			rc = inv_spi_master_write_register(INV_SPI_AP, reg+i, 1, &wbuffer[i]);
 //			if(rc)
@@ -1185,268 +1455,6 @@ void Simple_Protocol_Test(void)
     printf("DEBUG: Protocol frame prepared (%d bytes) - not sent\r\n", index);
 }
 
-/**
- * @brief Calculate CRC16 for Modbus protocol
- * @param data: Data buffer
- * @param length: Data length
- * @retval CRC16 value
- */
-uint16_t Calculate_CRC16_Modbus(uint8_t *data, uint16_t length)
-{
-    uint16_t crc = 0xFFFF;
-    uint16_t i, j;
-
-    for (i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc = crc >> 1;
-            }
-        }
-    }
-
-    return crc;
-}
-
-/**
- * @brief Build Modbus command for alarm register
- * @param value: Register value (0 or 1)
- * @param command_buffer: Output buffer for command
- */
-void Build_Modbus_Command(uint8_t value, uint8_t *command_buffer)
-{
-    // Modbus command structure: 01 46 00 00 00 01 02 00 [value] [CRC_L] [CRC_H]
-    command_buffer[0] = 0x01;  // Device address
-    command_buffer[1] = 0x46;  // Function code (Write Multiple Registers)
-    command_buffer[2] = 0x00;  // Register address high byte
-    command_buffer[3] = 0x00;  // Register address low byte
-    command_buffer[4] = 0x00;  // Number of registers high byte
-    command_buffer[5] = 0x01;  // Number of registers low byte (1 register)
-    command_buffer[6] = 0x02;  // Data length (2 bytes)
-    command_buffer[7] = 0x00;  // Data high byte
-    command_buffer[8] = value; // Data low byte (0 or 1)
-
-    // Calculate CRC16
-    uint16_t crc = Calculate_CRC16_Modbus(command_buffer, 9);
-    command_buffer[9] = (uint8_t)(crc & 0xFF);        // CRC low byte
-    command_buffer[10] = (uint8_t)((crc >> 8) & 0xFF); // CRC high byte
-}
-
-/**
- * @brief Send command to LoRa module
- * @param command: Command buffer
- * @param length: Command length
- */
-void LoRa_Send_Command(uint8_t *command, uint8_t length)
-{
-    lora_tx_complete = 0;
-    lora_timeout_start_time = HAL_GetTick();
-
-    // Send command via UART5
-    HAL_UART_Transmit(&huart5, command, length, 1000);
-    lora_tx_complete = 1;
-
-    printf("LoRa Command Sent: ");
-    for (int i = 0; i < length; i++) {
-        printf("%02X ", command[i]);
-    }
-    printf("\n");
-}
-
-// LoRa_Wait_Response函数已删除，改用状态机中的直接检查方式
-
-/**
- * @brief Process alarm state machine
- */
-void Process_Alarm_State_Machine(void)
-{
-    static uint8_t modbus_command[11];
-    static uint8_t response[10];
-
-    switch (alarm_state) {
-        case ALARM_STATE_SET_1:
-            printf("Setting alarm register to 1...\n");
-            Build_Modbus_Command(1, modbus_command);
-            LoRa_Send_Command(modbus_command, 11);
-            alarm_state = ALARM_STATE_WAIT_RESPONSE_1;
-            break;
-
-        case ALARM_STATE_WAIT_RESPONSE_1:
-            // 检查是否收到LoRa响应
-            if (lora_rx_complete) {
-                // 复制响应数据
-                memcpy(response, lora_rx_buffer, lora_rx_index);
-
-                printf("Alarm set to 1 confirmed\n");
-                printf("LoRa Response Received: ");
-                for (int i = 0; i < lora_rx_index; i++) {
-                    printf("%02X ", lora_rx_buffer[i]);
-                }
-                printf("\n");
-
-                // 重置接收状态
-                lora_rx_complete = 0;
-                lora_rx_index = 0;
-                Start_LoRa_Reception();
-
-                // 立即发送设置0命令 (无延时)
-                printf("Immediately setting alarm register to 0...\n");
-                Build_Modbus_Command(0, modbus_command);
-                LoRa_Send_Command(modbus_command, 11);
-                alarm_state = ALARM_STATE_WAIT_RESPONSE_0;
-                Send_Response_To_PC("ALARM_SET_SUCCESS");
-
-                // 通知系统状态机报警发送进行中
-                #if ENABLE_SYSTEM_STATE_MACHINE
-                System_State_Machine_SetAlarmStatus(0);  // 进行中
-                #endif
-            } else if ((HAL_GetTick() - lora_timeout_start_time) > LORA_TIMEOUT_MS) {
-                printf("Timeout waiting for response to set 1\n");
-                // 超时时断电LoRa模块 (PE14 = LOW)
-                HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_RESET);
-                alarm_state = ALARM_STATE_IDLE;
-                Send_Response_To_PC("ALARM_SET_TIMEOUT");
-                printf("LoRa powered OFF due to timeout (PE14=LOW)\n");
-
-                // 通知系统状态机报警发送失败
-                #if ENABLE_SYSTEM_STATE_MACHINE
-                System_State_Machine_SetAlarmStatus(2);  // 失败
-                #endif
-            }
-            break;
-
-        // ALARM_STATE_HOLD 已删除 - 无需延时，直接从 WAIT_RESPONSE_1 转到 WAIT_RESPONSE_0
-
-        case ALARM_STATE_WAIT_RESPONSE_0:
-            // 检查是否收到LoRa响应
-            if (lora_rx_complete) {
-                // 复制响应数据
-                memcpy(response, lora_rx_buffer, lora_rx_index);
-
-                printf("Alarm set to 0 confirmed\n");
-                printf("LoRa Response Received: ");
-                for (int i = 0; i < lora_rx_index; i++) {
-                    printf("%02X ", lora_rx_buffer[i]);
-                }
-                printf("\n");
-
-                // 重置接收状态
-                lora_rx_complete = 0;
-                lora_rx_index = 0;
-                Start_LoRa_Reception();
-
-                // 断电LoRa模块 (PE14 = LOW)
-                HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_RESET);
-                alarm_state = ALARM_STATE_COMPLETE;
-                Send_Response_To_PC("ALARM_RESET_SUCCESS");
-                printf("LoRa powered OFF (PE14=LOW)\n");
-
-                // 通知系统状态机报警发送成功
-                #if ENABLE_SYSTEM_STATE_MACHINE
-                System_State_Machine_SetAlarmStatus(1);  // 成功
-                #endif
-            } else if ((HAL_GetTick() - lora_timeout_start_time) > LORA_TIMEOUT_MS) {
-                printf("Timeout waiting for response to set 0\n");
-                // 超时时也要断电LoRa模块 (PE14 = LOW)
-                HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_RESET);
-                alarm_state = ALARM_STATE_IDLE;
-                Send_Response_To_PC("ALARM_RESET_TIMEOUT");
-                printf("LoRa powered OFF due to timeout (PE14=LOW)\n");
-
-                // 通知系统状态机报警发送失败
-                #if ENABLE_SYSTEM_STATE_MACHINE
-                System_State_Machine_SetAlarmStatus(2);  // 失败
-                #endif
-            }
-            break;
-
-        case ALARM_STATE_COMPLETE:
-            printf("Alarm cycle completed successfully\n");
-            alarm_state = ALARM_STATE_IDLE;
-            Send_Response_To_PC("ALARM_CYCLE_COMPLETE");
-            break;
-
-        default:
-            break;
-    }
-}
-
-/**
- * @brief Trigger alarm cycle
- */
-void Trigger_Alarm_Cycle(void)
-{
-    if (alarm_state == ALARM_STATE_IDLE) {
-        // 上电LoRa模块 (PE14 = HIGH)
-        HAL_GPIO_WritePin(GPIOE, GPIO_PIN_14, GPIO_PIN_SET);
-			HAL_Delay(500);  // 等待LoRa模块启动
-        alarm_state = ALARM_STATE_SET_1;
-        printf("Alarm cycle triggered, LoRa powered ON (PE14=HIGH)\n");
-    } else {
-        printf("Alarm cycle already in progress\n");
-    }
-}
-
-/**
- * @brief Process UART1 command from upper computer
- */
-void Process_UART1_Command(void)
-{
-    // 处理二进制协议命令
-    if (uart1_rx_index >= 1) {
-        uint8_t command = uart1_rx_buffer[0];
-
-        switch (command) {
-            case 0x10:  // 触发报警命令
-                // 触发LoRa报警周期
-                Trigger_Alarm_Cycle();
-                Send_Response_To_PC("ALARM_TRIGGERED");
-                break;
-
-            case 0x11:  // 查询状态命令
-                // 发送状态响应
-                Send_Response_To_PC("STATUS_OK");
-                break;
-
-            case 0x02:  // 原始数据命令（保持兼容）
-                // 继续发送原始数据（已经在主循环中处理）
-                break;
-
-            case 0x04:  // FFT数据命令（保持兼容）
-                // 继续发送FFT数据（已经在主循环中处理）
-                break;
-
-#if ENABLE_LOW_POWER_MODE
-            case 0x20:  // 低功耗统计命令
-                LowPower_PrintStats();
-                RTC_Wakeup_PrintStats();
-                Send_Response_To_PC("LOW_POWER_STATS_PRINTED");
-                break;
-
-            case 0x21:  // 设置连续模式
-                LowPower_SetMode(POWER_MODE_CONTINUOUS);
-                Send_Response_To_PC("MODE_SET_CONTINUOUS");
-                break;
-
-            case 0x22:  // 设置低功耗模式
-                LowPower_SetMode(POWER_MODE_LOW_POWER);
-                Send_Response_To_PC("MODE_SET_LOW_POWER");
-                break;
-#endif
-
-            default:
-                // 未知命令
-                break;
-        }
-    }
-
-    // Clear buffer
-    memset(uart1_rx_buffer, 0, sizeof(uart1_rx_buffer));
-    uart1_rx_index = 0;
-}
-
 /**
  * @brief Send response to PC via UART1 (现在仅输出调试信息)
  * @param message: Message to send
@@ -1458,58 +1466,48 @@ void Send_Response_To_PC(const char *message)
 }
 
 /**
- * @brief Start UART1 reception
+ * @brief UART transmit complete callback (DMA)
+ * @param huart: UART handle
  */
-void Start_UART1_Reception(void)
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
-    uart1_rx_index = 0;
-    uart1_rx_complete = 0;
-    HAL_UART_Receive_IT(&huart1, &uart1_rx_buffer[uart1_rx_index], 1);
+    if (huart->Instance == USART1) {
+        Host_Protocol_TxCpltCallback(huart);
+        Event_Post(EVENT_HOST_TX);
+    } else if (huart->Instance == UART5) {
+        LoRa_Transport_TxCpltCallback(huart);
+        Event_Post(EVENT_LORA_TX);
+    }
 }
 
 /**
- * @brief Start LoRa reception
+ * @brief UART receive-to-idle event callback (DMA half/full/idle)
+ * @param huart: UART handle
+ * @param Size: Current DMA write position
  */
-void Start_LoRa_Reception(void)
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
 {
-    lora_rx_index = 0;
-    lora_rx_complete = 0;
-    HAL_UART_Receive_IT(&huart5, &lora_rx_buffer[lora_rx_index], 1);
+    if (huart->Instance == USART1) {
+        Host_Protocol_RxEventCallback(huart, Size);
+        Event_Post(EVENT_HOST_RX);
+    } else if (huart->Instance == UART5) {
+        Modbus_RTU_RxEventCallback(huart, Size);
+        Event_Post(EVENT_LORA_RX);
+    }
 }
 
 /**
- * @brief UART receive complete callback
+ * @brief UART error callback
  * @param huart: UART handle
  */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
     if (huart->Instance == USART1) {
-        // UART1 - Upper computer communication - 简化版本，避免printf导致重启
-        if (uart1_rx_buffer[uart1_rx_index] == '\n' || uart1_rx_buffer[uart1_rx_index] == '\r') {
-            uart1_rx_buffer[uart1_rx_index] = '\0';
-            uart1_rx_complete = 1;
-        } else {
-            uart1_rx_index++;
-            if (uart1_rx_index < sizeof(uart1_rx_buffer) - 1) {
-                HAL_UART_Receive_IT(&huart1, &uart1_rx_buffer[uart1_rx_index], 1);
-            } else {
-                // Buffer overflow, reset
-                uart1_rx_index = 0;
-                HAL_UART_Receive_IT(&huart1, &uart1_rx_buffer[uart1_rx_index], 1);
-            }
-        }
+        Host_Protocol_ErrorCallback(huart);
+        Event_Post(EVENT_HOST_RX);
     } else if (huart->Instance == UART5) {
-        // UART5 - LoRa communication - 简化版本
-        lora_rx_index++;
-        if (lora_rx_index >= 7) {  // Expected response length for Modbus
-            lora_rx_complete = 1;
-        } else if (lora_rx_index < sizeof(lora_rx_buffer)) {
-            HAL_UART_Receive_IT(&huart5, &lora_rx_buffer[lora_rx_index], 1);
-        } else {
-            // Buffer overflow, reset
-            lora_rx_index = 0;
-            HAL_UART_Receive_IT(&huart5, &lora_rx_buffer[lora_rx_index], 1);
-        }
+        Modbus_RTU_ErrorCallback(huart);
+        Event_Post(EVENT_LORA_RX);
     }
 }
 
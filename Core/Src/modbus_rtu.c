@@ -0,0 +1,368 @@
+/**
+ * @file modbus_rtu.c
+ * @brief Modbus RTU帧收发引擎实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 原实现逐字节HAL_UART_Receive_IT，收满7字节即认为应答完成，
+ * 不检查功能码、字节数和CRC。现在由DMA接收，空闲线中断记录帧边界，
+ * 主循环按边界切分帧，只有校验通过的帧才交给上层。
+ */
+
+#include "modbus_rtu.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Modbus CRC16查表 (多项式0xA001反射) */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+/* 私有变量 */
+static UART_HandleTypeDef *rtu_huart = NULL;
+static uint8_t rx_dma_buffer[MODBUS_RTU_RX_DMA_SIZE];
+static uint16_t rx_tail = 0;
+
+/* 帧边界队列：空闲线中断写入 (生产者)，主循环读取 (消费者) */
+static volatile uint16_t boundary_pos[MODBUS_RTU_BOUNDARY_DEPTH];
+static volatile uint8_t boundary_head = 0;
+static volatile uint8_t boundary_tail = 0;
+static volatile uint8_t boundary_restart = 0;       // 错误重启时的队列写位置，此前的边界属于旧缓冲区
+static volatile uint8_t rx_restart_pending = 0;     // 错误回调已重启DMA接收，主循环复位读指针和半帧
+static volatile uint16_t rx_event_pos = 0;          // 最近一次接收事件时的DMA写指针
+static volatile bool rx_line_idle = true;           // 最近一次接收事件是空闲线 (满缓冲事件不是)
+
+static uint8_t frame_buffer[MODBUS_RTU_MAX_FRAME];
+static uint16_t frame_length = 0;
+static bool frame_overflow = false;
+
+static modbus_rtu_frame_t ready_frame;
+static bool frame_ready = false;
+static modbus_rtu_stats_t rtu_stats;
+
+/* 私有函数声明 */
+static int start_dma_reception(void);
+static void complete_frame(void);
+static uint16_t expected_length(const uint8_t *frame, uint16_t length);
+
+/* --------------------------------------------------------------------------------------
+ *  CRC
+ * -------------------------------------------------------------------------------------- */
+
+uint16_t Modbus_RTU_CRC16_Update(uint16_t crc, const uint8_t *data, uint16_t length)
+{
+    while (length--) {
+        crc = (crc >> 8) ^ crc16_table[(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+uint16_t Modbus_RTU_CRC16(const uint8_t *data, uint16_t length)
+{
+    return Modbus_RTU_CRC16_Update(0xFFFF, data, length);
+}
+
+/* --------------------------------------------------------------------------------------
+ *  接收
+ * -------------------------------------------------------------------------------------- */
+
+int Modbus_RTU_Init(UART_HandleTypeDef *huart)
+{
+    if (huart == NULL || huart->hdmarx == NULL) {
+        printf("MODBUS: ERROR - UART or RX DMA not configured\r\n");
+        return -1;
+    }
+
+    rtu_huart = huart;
+    memset(&rtu_stats, 0, sizeof(rtu_stats));
+    rx_tail = 0;
+    boundary_head = 0;
+    boundary_tail = 0;
+    rx_restart_pending = 0;
+    frame_length = 0;
+    frame_overflow = false;
+    frame_ready = false;
+
+    if (start_dma_reception() != 0) {
+        printf("MODBUS: ERROR - Failed to start DMA reception\r\n");
+        return -2;
+    }
+
+    printf("MODBUS: RTU engine ready (baud=%lu, idle-line framing)\r\n", huart->Init.BaudRate);
+    return 0;
+}
+
+void Modbus_RTU_Process(void)
+{
+    if (rtu_huart == NULL) {
+        return;
+    }
+
+    /* 错误回调重启了DMA接收 (写指针回到缓冲区起点)：丢弃半帧和旧缓冲区的边界 */
+    if (rx_restart_pending) {
+        rx_restart_pending = 0;
+        boundary_tail = boundary_restart;
+        rx_tail = 0;
+        frame_length = 0;
+        frame_overflow = false;
+    }
+
+    /* 上一帧被取走前不切新帧 (ready_frame.pdu指向frame_buffer) */
+    if (frame_ready || boundary_tail == boundary_head) {
+        return;
+    }
+
+    uint16_t end = boundary_pos[boundary_tail];
+    boundary_tail = (uint8_t)((boundary_tail + 1) % MODBUS_RTU_BOUNDARY_DEPTH);
+
+    while (rx_tail != end && !rx_restart_pending) {
+        if (frame_length < MODBUS_RTU_MAX_FRAME) {
+            frame_buffer[frame_length++] = rx_dma_buffer[rx_tail];
+        } else {
+            frame_overflow = true;
+        }
+        rx_tail = (rx_tail + 1) % MODBUS_RTU_RX_DMA_SIZE;
+    }
+
+    /* 搬运期间发生错误重启：这一帧不完整，下一轮复位 */
+    if (!rx_restart_pending) {
+        complete_frame();
+    }
+}
+
+bool Modbus_RTU_GetFrame(modbus_rtu_frame_t *frame)
+{
+    if (!frame_ready || frame == NULL) {
+        return false;
+    }
+    *frame = ready_frame;
+    frame_ready = false;
+    return true;
+}
+
+bool Modbus_RTU_IsRxIdle(void)
+{
+    if (rtu_huart == NULL) {
+        return true;
+    }
+    uint16_t pos = MODBUS_RTU_RX_DMA_SIZE - (uint16_t)__HAL_DMA_GET_COUNTER(rtu_huart->hdmarx);
+    return rx_line_idle && (pos % MODBUS_RTU_RX_DMA_SIZE) == rx_event_pos;
+}
+
+void Modbus_RTU_Flush(void)
+{
+    if (rtu_huart != NULL) {
+        rx_restart_pending = 0;
+        boundary_tail = boundary_head;
+        rx_tail = MODBUS_RTU_RX_DMA_SIZE - (uint16_t)__HAL_DMA_GET_COUNTER(rtu_huart->hdmarx);
+        if (rx_tail >= MODBUS_RTU_RX_DMA_SIZE) {
+            rx_tail = 0;
+        }
+    }
+    frame_length = 0;
+    frame_overflow = false;
+    frame_ready = false;
+}
+
+const modbus_rtu_stats_t* Modbus_RTU_GetStats(void)
+{
+    return &rtu_stats;
+}
+
+void Modbus_RTU_RxEventCallback(UART_HandleTypeDef *huart, uint16_t pos)
+{
+    if (huart != rtu_huart) {
+        return;
+    }
+
+    /* 半满中断已关闭；满缓冲事件 (pos为缓冲区长度) 不是空闲线，不作为帧边界 */
+    rx_event_pos = pos % MODBUS_RTU_RX_DMA_SIZE;
+    rx_line_idle = (pos < MODBUS_RTU_RX_DMA_SIZE);
+    if (!rx_line_idle) {
+        return;
+    }
+
+    uint8_t next = (uint8_t)((boundary_head + 1) % MODBUS_RTU_BOUNDARY_DEPTH);
+    if (next != boundary_tail) {
+        boundary_pos[boundary_head] = pos;
+        boundary_head = next;
+    }
+}
+
+void Modbus_RTU_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != rtu_huart) {
+        return;
+    }
+
+    /* 只重启DMA；读指针、半帧和边界队列由主循环复位 (主循环可能正在搬运) */
+    rtu_stats.uart_errors++;
+    HAL_UART_AbortReceive(huart);
+    start_dma_reception();
+    boundary_restart = boundary_head;
+    rx_restart_pending = 1;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  发送帧构建与应答检查
+ * -------------------------------------------------------------------------------------- */
+
+uint16_t Modbus_RTU_BuildWriteMultiple(uint8_t *buffer, uint8_t address, uint8_t function,
+                                       uint16_t start_reg, const uint16_t *regs, uint16_t quantity)
+{
+    uint16_t idx = 0;
+
+    buffer[idx++] = address;
+    buffer[idx++] = function;
+    buffer[idx++] = (uint8_t)(start_reg >> 8);
+    buffer[idx++] = (uint8_t)(start_reg & 0xFF);
+    buffer[idx++] = (uint8_t)(quantity >> 8);
+    buffer[idx++] = (uint8_t)(quantity & 0xFF);
+    buffer[idx++] = (uint8_t)(quantity * 2);
+    for (uint16_t i = 0; i < quantity; i++) {
+        buffer[idx++] = (uint8_t)(regs[i] >> 8);
+        buffer[idx++] = (uint8_t)(regs[i] & 0xFF);
+    }
+
+    uint16_t crc = Modbus_RTU_CRC16(buffer, idx);
+    buffer[idx++] = (uint8_t)(crc & 0xFF);
+    buffer[idx++] = (uint8_t)((crc >> 8) & 0xFF);
+    return idx;
+}
+
+modbus_rtu_response_t Modbus_RTU_CheckWriteResponse(const modbus_rtu_frame_t *frame, uint8_t address,
+                                                    uint8_t function, uint16_t start_reg, uint16_t quantity)
+{
+    if (frame->address != address || frame->function != function) {
+        return MODBUS_RTU_RESP_MISMATCH;
+    }
+    if (frame->is_exception) {
+        return MODBUS_RTU_RESP_EXCEPTION;
+    }
+    if (frame->pdu_length != 4) {
+        return MODBUS_RTU_RESP_MISMATCH;
+    }
+
+    uint16_t echo_start = ((uint16_t)frame->pdu[0] << 8) | frame->pdu[1];
+    uint16_t echo_quantity = ((uint16_t)frame->pdu[2] << 8) | frame->pdu[3];
+    if (echo_start != start_reg || echo_quantity != quantity) {
+        return MODBUS_RTU_RESP_MISMATCH;
+    }
+    return MODBUS_RTU_RESP_ACK;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+static int start_dma_reception(void)
+{
+    /* DMA从缓冲区起点重新写入，启动前线路视为空闲 */
+    rx_event_pos = 0;
+    rx_line_idle = true;
+    if (HAL_UARTEx_ReceiveToIdle_DMA(rtu_huart, rx_dma_buffer, MODBUS_RTU_RX_DMA_SIZE) != HAL_OK) {
+        return -1;
+    }
+    /* 帧边界取空闲线事件，不需要半满中断 */
+    __HAL_DMA_DISABLE_IT(rtu_huart->hdmarx, DMA_IT_HT);
+    return 0;
+}
+
+/**
+ * @brief 根据功能码推算应有的帧长度
+ * @return 期望长度，0表示未知功能码(仅做CRC校验)
+ */
+static uint16_t expected_length(const uint8_t *frame, uint16_t length)
+{
+    uint8_t function = frame[1];
+
+    if (function & MODBUS_RTU_EXCEPTION_FLAG) {
+        return 5;   // 地址+功能码+异常码+CRC
+    }
+
+    switch (function) {
+        case 0x03:  // 读保持寄存器
+        case 0x04:  // 读输入寄存器
+            return (length >= 3) ? (uint16_t)(5 + frame[2]) : 0;
+        case 0x06:  // 写单个寄存器
+        case 0x10:  // 写多个寄存器
+        case 0x46:  // 写多个寄存器 (LoRa网关自定义)
+            return 8;   // 地址+功能码+起始地址+数量/值+CRC
+        default:
+            return 0;
+    }
+}
+
+static void complete_frame(void)
+{
+    uint16_t length = frame_length;
+    bool overflow = frame_overflow;
+
+    frame_length = 0;
+    frame_overflow = false;
+
+    if (overflow || length < MODBUS_RTU_MIN_FRAME) {
+        rtu_stats.length_errors++;
+        return;
+    }
+
+    uint16_t crc_rx = (uint16_t)frame_buffer[length - 2] | ((uint16_t)frame_buffer[length - 1] << 8);
+    if (Modbus_RTU_CRC16(frame_buffer, length - 2) != crc_rx) {
+        rtu_stats.crc_errors++;
+        printf("MODBUS: CRC error (%u bytes)\r\n", length);
+        return;
+    }
+
+    uint16_t expected = expected_length(frame_buffer, length);
+    if (expected != 0 && expected != length) {
+        rtu_stats.length_errors++;
+        printf("MODBUS: Length error fc=0x%02X (got %u, expected %u)\r\n",
+               frame_buffer[1], length, expected);
+        return;
+    }
+
+    ready_frame.address = frame_buffer[0];
+    ready_frame.function = frame_buffer[1] & (uint8_t)~MODBUS_RTU_EXCEPTION_FLAG;
+    ready_frame.is_exception = (frame_buffer[1] & MODBUS_RTU_EXCEPTION_FLAG) != 0;
+    ready_frame.exception_code = ready_frame.is_exception ? frame_buffer[2] : 0;
+    ready_frame.pdu = &frame_buffer[2];
+    ready_frame.pdu_length = length - 4;
+    ready_frame.frame_length = length;
+    frame_ready = true;
+
+    rtu_stats.frames_ok++;
+    if (ready_frame.is_exception) {
+        rtu_stats.exceptions++;
+    }
+}
@@ -0,0 +1,324 @@
+/**
+ * @file power_account.c
+ * @brief 状态驻留能耗核算实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 每次负载或状态变化时先把上次记账以来的时间计入旧的负载掩码和状态，再切换。
+ * 记账可能在中断中发生 (UART发送完成等)，统计更新在关中断的临界区内完成。
+ */
+
+#include "power_account.h"
+#include "dwt_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(HOST_BUILD)
+#define POWER_ACCOUNT_LOCK(primask)     ((void)(primask))
+#define POWER_ACCOUNT_UNLOCK(primask)   ((void)(primask))
+#else
+#define POWER_ACCOUNT_LOCK(primask)     do { (primask) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define POWER_ACCOUNT_UNLOCK(primask)   __set_PRIMASK(primask)
+#endif
+
+/* 私有变量 */
+static power_residency_t residency;
+static power_model_t model;
+static bool initialized = false;
+static uint64_t last_us = 0;
+static uint32_t stop_mask = 0;                      // 进入STOP时的负载
+static system_state_t stop_state = STATE_SYSTEM_INIT;
+#if ENABLE_POWER_TRACE
+static uint64_t segment_start_us = 0;
+static uint64_t segment_load_us[POWER_LOAD_COUNT];  // 分段起点的各负载累计值
+#endif
+
+static const char* const load_names[POWER_LOAD_COUNT] = {
+    "mcu_run", "mcu_sleep", "mcu_stop", "sensor_ln", "sensor_lp", "lora", "uart_tx"
+};
+
+/* 私有函数声明 */
+static void charge_time(uint64_t us, uint32_t mask, system_state_t state);
+static void advance(void);
+static void trace_segment(void);
+
+int Power_Account_Init(void)
+{
+    memset(&residency, 0, sizeof(residency));
+    Power_Account_DefaultModel(&model);
+
+    residency.active_mask = POWER_LOAD_MASK(POWER_LOAD_MCU_RUN) | POWER_LOAD_MASK(POWER_LOAD_SENSOR_LN);
+    residency.state = STATE_SYSTEM_INIT;
+    last_us = DWT_Timer_GetTimeUs();
+#if ENABLE_POWER_TRACE
+    segment_start_us = 0;
+    memset(segment_load_us, 0, sizeof(segment_load_us));
+#endif
+    initialized = true;
+
+    return 0;
+}
+
+void Power_Account_SetMcu(power_load_t mode)
+{
+    uint32_t primask;
+
+    if (!initialized) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    advance();
+    residency.active_mask = (residency.active_mask & ~POWER_LOAD_MCU_MASK) | POWER_LOAD_MASK(mode);
+    if (mode == POWER_LOAD_MCU_STOP) {
+        stop_mask = residency.active_mask;
+        stop_state = residency.state;
+    }
+    POWER_ACCOUNT_UNLOCK(primask);
+}
+
+void Power_Account_SetSensor(power_load_t mode)
+{
+    uint32_t primask;
+
+    if (!initialized) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    advance();
+    residency.active_mask &= ~POWER_LOAD_SENSOR_MASK;
+    if (mode == POWER_LOAD_SENSOR_LN || mode == POWER_LOAD_SENSOR_LP) {
+        residency.active_mask |= POWER_LOAD_MASK(mode);
+    }
+    POWER_ACCOUNT_UNLOCK(primask);
+}
+
+void Power_Account_SetLoad(power_load_t load, bool on)
+{
+    uint32_t primask;
+
+    if (!initialized || load >= POWER_LOAD_COUNT) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    advance();
+    if (on) {
+        residency.active_mask |= POWER_LOAD_MASK(load);
+    } else {
+        residency.active_mask &= ~POWER_LOAD_MASK(load);
+    }
+    POWER_ACCOUNT_UNLOCK(primask);
+}
+
+void Power_Account_AddUartTx(uint32_t bytes, uint32_t baud)
+{
+    uint32_t primask;
+
+    if (!initialized || baud == 0) {
+        return;
+    }
+
+    /* 起始位 + 8数据位 + 停止位；发送期间MCU仍在运行，只叠加UART负载 */
+    uint64_t us = (uint64_t)bytes * 10U * 1000000U / baud;
+
+    POWER_ACCOUNT_LOCK(primask);
+    residency.load_us[POWER_LOAD_UART_TX] += us;
+    residency.state_load_us[residency.state][POWER_LOAD_UART_TX] += us;
+    POWER_ACCOUNT_UNLOCK(primask);
+}
+
+void Power_Account_SetState(system_state_t state)
+{
+    uint32_t primask;
+
+    if (!initialized || state >= STATE_COUNT) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    advance();
+    POWER_ACCOUNT_UNLOCK(primask);
+
+    trace_segment();
+    residency.state = state;
+}
+
+void Power_Account_AddStopTime(uint32_t stop_ms)
+{
+    uint32_t primask;
+
+    if (!initialized) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    charge_time((uint64_t)stop_ms * 1000U, stop_mask, stop_state);
+    POWER_ACCOUNT_UNLOCK(primask);
+}
+
+void Power_Account_Process(void)
+{
+    uint32_t primask;
+
+    if (!initialized) {
+        return;
+    }
+
+    POWER_ACCOUNT_LOCK(primask);
+    advance();
+    POWER_ACCOUNT_UNLOCK(primask);
+
+#if ENABLE_POWER_TRACE
+    if (residency.total_us - segment_start_us >= (uint64_t)POWER_TRACE_MAX_SEGMENT_MS * 1000U) {
+        trace_segment();
+    }
+#endif
+}
+
+const power_residency_t* Power_Account_GetResidency(void)
+{
+    uint32_t primask;
+
+    if (initialized) {
+        POWER_ACCOUNT_LOCK(primask);
+        advance();
+        POWER_ACCOUNT_UNLOCK(primask);
+    }
+
+    return &residency;
+}
+
+void Power_Account_SetModel(const power_model_t *new_model)
+{
+    if (new_model != NULL) {
+        model = *new_model;
+    }
+}
+
+const power_model_t* Power_Account_GetModel(void)
+{
+    return &model;
+}
+
+void Power_Account_DefaultModel(power_model_t *out)
+{
+    out->load_ma[POWER_LOAD_MCU_RUN] = LP_CURRENT_MCU_RUN_MA;
+    out->load_ma[POWER_LOAD_MCU_SLEEP] = LP_CURRENT_MCU_SLEEP_MA;
+    out->load_ma[POWER_LOAD_MCU_STOP] = LP_CURRENT_MCU_STOP_MA;
+    out->load_ma[POWER_LOAD_SENSOR_LN] = LP_CURRENT_SENSOR_LN_MA;
+    out->load_ma[POWER_LOAD_SENSOR_LP] = LP_CURRENT_SENSOR_LP_MA;
+    out->load_ma[POWER_LOAD_LORA] = LP_CURRENT_LORA_ON_MA;
+    out->load_ma[POWER_LOAD_UART_TX] = LP_CURRENT_UART_TX_MA;
+}
+
+float32_t Power_Account_Charge(const uint64_t load_us[POWER_LOAD_COUNT], const power_model_t *m)
+{
+    float32_t mas = 0.0f;
+
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        mas += (float32_t)load_us[i] * 1e-6f * m->load_ma[i];
+    }
+
+    return mas;
+}
+
+float32_t Power_Account_AverageMa(void)
+{
+    const power_residency_t *r = Power_Account_GetResidency();
+
+    if (r->total_us == 0) {
+        return 0.0f;
+    }
+
+    return Power_Account_Charge(r->load_us, &model) / ((float32_t)r->total_us * 1e-6f);
+}
+
+void Power_Account_PrintStats(void)
+{
+    const power_residency_t *r = Power_Account_GetResidency();
+    float32_t total_s = (float32_t)r->total_us * 1e-6f;
+
+    if (!initialized || r->total_us == 0) {
+        return;
+    }
+
+    printf("=== POWER RESIDENCY (%.1f s, average %.3f mA) ===\r\n", total_s, Power_Account_AverageMa());
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        printf("  %-10s %6.2f%%  %8.3f mA  %10.3f mAs\r\n", load_names[i],
+               100.0f * (float32_t)r->load_us[i] / (float32_t)r->total_us, model.load_ma[i],
+               (float32_t)r->load_us[i] * 1e-6f * model.load_ma[i]);
+    }
+    for (int s = 0; s < STATE_COUNT; s++) {
+        if (r->state_us[s] == 0) {
+            continue;
+        }
+        float32_t mas = Power_Account_Charge(r->state_load_us[s], &model);
+        printf("  state %2d  %6.2f%%  %10.3f mAs  avg %.3f mA\r\n", s,
+               100.0f * (float32_t)r->state_us[s] / (float32_t)r->total_us, mas,
+               mas / ((float32_t)r->state_us[s] * 1e-6f));
+    }
+    printf("==========================================\r\n");
+}
+
+const char* Power_Account_LoadName(power_load_t load)
+{
+    return (load < POWER_LOAD_COUNT) ? load_names[load] : "?";
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 把一段时间计入负载掩码和系统状态 (调用方持有临界区)
+ */
+static void charge_time(uint64_t us, uint32_t mask, system_state_t state)
+{
+    residency.total_us += us;
+    residency.state_us[state] += us;
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        if (mask & POWER_LOAD_MASK(i)) {
+            residency.load_us[i] += us;
+            residency.state_load_us[state][i] += us;
+        }
+    }
+}
+
+/**
+ * @brief 上次记账以来的DWT时间计入当前负载和状态 (调用方持有临界区)
+ */
+static void advance(void)
+{
+    uint64_t now = DWT_Timer_GetTimeUs();
+
+    charge_time(now - last_us, residency.active_mask, residency.state);
+    last_us = now;
+}
+
+/**
+ * @brief 输出当前分段并开始新分段 (主循环上下文)
+ */
+static void trace_segment(void)
+{
+#if ENABLE_POWER_TRACE
+    uint64_t delta[POWER_LOAD_COUNT];
+
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        delta[i] = residency.load_us[i] - segment_load_us[i];
+        segment_load_us[i] = residency.load_us[i];
+    }
+
+    printf("PWR_SEG,%lu,%d,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+           (unsigned long)HAL_GetTick(), (int)residency.state,
+           (unsigned long)(residency.total_us - segment_start_us),
+           (unsigned long)delta[POWER_LOAD_MCU_RUN], (unsigned long)delta[POWER_LOAD_MCU_SLEEP],
+           (unsigned long)delta[POWER_LOAD_MCU_STOP], (unsigned long)delta[POWER_LOAD_SENSOR_LN],
+           (unsigned long)delta[POWER_LOAD_SENSOR_LP], (unsigned long)delta[POWER_LOAD_LORA],
+           (unsigned long)delta[POWER_LOAD_UART_TX]);
+
+    segment_start_us = residency.total_us;
+    residency.trace_segments++;
+#endif
+}
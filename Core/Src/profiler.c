@@ -0,0 +1,141 @@
+/**
+ * @file profiler.c
+ * @brief 基于DWT周期计数器的分阶段耗时统计实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 打点均在主循环上下文中执行 (FIFO读取和回调也在主循环中)，记录时不关中断。
+ */
+
+#include "profiler.h"
+
+#if ENABLE_PROFILING
+
+#include <stdio.h>
+#include <string.h>
+
+/* 私有变量 */
+static profiler_stats_t stage_stats[PROF_STAGE_COUNT];
+
+static const char *const stage_names[PROF_STAGE_COUNT] = {
+    "FIFO_READ", "DECODE", "HIGHPASS", "COARSE", "FFT",
+    "MAGNITUDE", "FINE", "STATE_MACHINE", "LORA_SEND"
+};
+
+/* 私有函数声明 */
+static uint8_t bucket_of(uint32_t cycles);
+static uint32_t cycles_to_ns(uint64_t cycles);
+
+int Profiler_Init(void)
+{
+    Profiler_Reset();
+    printf("PROFILER: Enabled (%d stages, %d log2 buckets)\r\n", PROF_STAGE_COUNT, PROFILER_HIST_BUCKETS);
+    return 0;
+}
+
+void Profiler_Record(profiler_stage_t stage, uint32_t cycles)
+{
+    if (stage >= PROF_STAGE_COUNT) {
+        return;
+    }
+
+    profiler_stats_t *stats = &stage_stats[stage];
+    stats->count++;
+    stats->sum_cycles += cycles;
+    if (cycles < stats->min_cycles) {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+    stats->histogram[bucket_of(cycles)]++;
+}
+
+const profiler_stats_t* Profiler_GetStats(profiler_stage_t stage)
+{
+    if (stage >= PROF_STAGE_COUNT) {
+        return NULL;
+    }
+    return &stage_stats[stage];
+}
+
+const char* Profiler_GetStageName(profiler_stage_t stage)
+{
+    if (stage >= PROF_STAGE_COUNT) {
+        return "?";
+    }
+    return stage_names[stage];
+}
+
+void Profiler_Reset(void)
+{
+    memset(stage_stats, 0, sizeof(stage_stats));
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+        stage_stats[i].min_cycles = UINT32_MAX;
+    }
+}
+
+void Profiler_Print(bool reset)
+{
+    printf("=== PROFILER (%lu MHz, times in us) ===\r\n", SystemCoreClock / 1000000U);
+    printf("  %-13s %8s %10s %10s %10s\r\n", "stage", "count", "min", "mean", "max");
+
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+        const profiler_stats_t *stats = &stage_stats[i];
+        if (stats->count == 0) {
+            continue;
+        }
+
+        uint32_t min_ns = cycles_to_ns(stats->min_cycles);
+        uint32_t mean_ns = cycles_to_ns(stats->sum_cycles / stats->count);
+        uint32_t max_ns = cycles_to_ns(stats->max_cycles);
+        printf("  %-13s %8lu %6lu.%03lu %6lu.%03lu %6lu.%03lu\r\n", stage_names[i], stats->count,
+               min_ns / 1000, min_ns % 1000, mean_ns / 1000, mean_ns % 1000, max_ns / 1000, max_ns % 1000);
+
+        /* 直方图: 只打印非零桶, 格式 "<上限周期数:次数"，最后一桶为 ">=下限:次数" */
+        printf("  %-13s", "");
+        for (uint8_t b = 0; b < PROFILER_HIST_BUCKETS; b++) {
+            if (stats->histogram[b] == 0) {
+                continue;
+            }
+            if (b == PROFILER_HIST_BUCKETS - 1) {
+                printf(" >=%lu:%lu", 1UL << b, stats->histogram[b]);
+            } else {
+                printf(" <%lu:%lu", 1UL << (b + 1), stats->histogram[b]);
+            }
+        }
+        printf("\r\n");
+    }
+    printf("=====================================\r\n");
+
+    if (reset) {
+        Profiler_Reset();
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief log2分桶: floor(log2(cycles))，0周期归入第0桶，超出范围归入最后一桶
+ */
+static uint8_t bucket_of(uint32_t cycles)
+{
+    if (cycles == 0) {
+        return 0;
+    }
+    uint32_t bucket = 31U - __CLZ(cycles);
+    return (bucket < PROFILER_HIST_BUCKETS) ? (uint8_t)bucket : (PROFILER_HIST_BUCKETS - 1);
+}
+
+static uint32_t cycles_to_ns(uint64_t cycles)
+{
+    uint32_t mhz = SystemCoreClock / 1000000U;
+    if (mhz == 0) {
+        mhz = 1;
+    }
+    return (uint32_t)((cycles * 1000U) / mhz);
+}
+
+#endif /* ENABLE_PROFILING */
@@ -11,6 +11,7 @@
 
 #include "rtc_wakeup.h"
 #include "low_power_manager.h"
+#include "event_loop.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -20,6 +21,11 @@ volatile bool rtc_wakeup_flag = false;
 static rtc_wakeup_stats_t g_rtc_stats;
 static bool g_rtc_initialized = false;
 
+/* 内部函数声明 */
+static int RTC_Wakeup_ConfigureClock(void);
+static int RTC_Wakeup_ConfigureTimer(uint32_t period_ms);
+static void RTC_Wakeup_UpdateStats(void);
+
 /**
  * @brief RTC初始化
  */
@@ -105,19 +111,49 @@ int RTC_Wakeup_Configure(uint32_t period_sec)
     HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
     
     // 配置唤醒定时器
-    int ret = RTC_Wakeup_ConfigureTimer(period_sec);
+    int ret = RTC_Wakeup_ConfigureTimer(period_sec * 1000U);
     if (ret != 0) {
         printf("RTC_WAKEUP: ERROR - Failed to configure wakeup timer: %d\r\n", ret);
         return -2;
     }
     
     g_rtc_stats.wakeup_period_sec = period_sec;
+    g_rtc_stats.wakeup_period_ms = period_sec * 1000U;
     g_rtc_stats.state = RTC_STATE_WAKEUP_DISABLED;
     
     printf("RTC_WAKEUP: Wakeup timer configured successfully\r\n");
     return 0;
 }
 
+/**
+ * @brief 按毫秒配置RTC唤醒定时器
+ */
+int RTC_Wakeup_ConfigureMs(uint32_t period_ms)
+{
+    if (!g_rtc_initialized) {
+        return -1;
+    }
+
+    if (period_ms == g_rtc_stats.wakeup_period_ms) {
+        return 0;
+    }
+
+    // 运行中重配置：停止后重新装载计数器，唤醒使能状态不变
+    HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+
+    int ret = RTC_Wakeup_ConfigureTimer(period_ms);
+    if (ret != 0) {
+        printf("RTC_WAKEUP: ERROR - Failed to reconfigure wakeup timer: %d\r\n", ret);
+        return -2;
+    }
+
+    g_rtc_stats.wakeup_period_sec = period_ms / 1000U;
+    g_rtc_stats.wakeup_period_ms = period_ms;
+    g_rtc_stats.reconfigure_count++;
+
+    return 0;
+}
+
 /**
  * @brief 启动RTC唤醒定时器
  */
@@ -141,7 +177,7 @@ int RTC_Wakeup_Start(void)
     g_rtc_stats.state = RTC_STATE_WAKEUP_ENABLED;
 
     if (g_rtc_stats.wakeup_period_sec <= 10) {  // 只在调试模式下打印
-        printf("RTC_WAKEUP: Wakeup timer started (%lu sec period)\r\n", g_rtc_stats.wakeup_period_sec);
+        printf("RTC_WAKEUP: Wakeup timer started (%lu ms period)\r\n", g_rtc_stats.wakeup_period_ms);
     }
 
     return 0;
@@ -189,7 +225,7 @@ int RTC_Wakeup_HandleInterrupt(void)
     if (last_wakeup_tick > 0) {
         uint32_t interval_ms = current_tick - last_wakeup_tick;
         printf("RTC_WAKEUP: *** RTC INTERRUPT *** Interval = %lu ms (expected: %lu ms)\r\n",
-               interval_ms, g_rtc_stats.wakeup_period_sec * 1000);
+               interval_ms, g_rtc_stats.wakeup_period_ms);
     } else {
         printf("RTC_WAKEUP: *** FIRST RTC INTERRUPT ***\r\n");
     }
@@ -215,6 +251,45 @@ void RTC_Wakeup_ClearFlag(void)
     g_rtc_stats.is_wakeup_pending = false;
 }
 
+/**
+ * @brief 读取RTC日历时间 (毫秒)
+ */
+uint32_t RTC_Wakeup_GetTimeMs(void)
+{
+    RTC_TimeTypeDef sTime = {0};
+    RTC_DateTypeDef sDate = {0};
+
+    if (!g_rtc_initialized) {
+        return 0;
+    }
+
+    // 读时间后必须读日期以解锁影子寄存器
+    HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+    HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+
+    uint32_t seconds = ((uint32_t)sTime.Hours * 60U + sTime.Minutes) * 60U + sTime.Seconds;
+    uint32_t sub_ms = ((sTime.SecondFraction - sTime.SubSeconds) * 1000U) / (sTime.SecondFraction + 1U);
+
+    return seconds * 1000U + sub_ms;
+}
+
+/**
+ * @brief STOP唤醒后重新同步日历影子寄存器
+ */
+int RTC_Wakeup_Resync(void)
+{
+    if (!g_rtc_initialized) {
+        return -1;
+    }
+
+    // 清RSF并等待下一次影子寄存器更新 (最多2个RTCCLK周期)
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
+    HAL_StatusTypeDef status = HAL_RTC_WaitForSynchro(&hrtc);
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
+
+    return (status == HAL_OK) ? 0 : -2;
+}
+
 /**
  * @brief 获取RTC唤醒统计信息
  */
@@ -231,7 +306,8 @@ void RTC_Wakeup_PrintStats(void)
     printf("=== RTC WAKEUP STATISTICS ===\r\n");
     printf("State: %d\r\n", g_rtc_stats.state);
     printf("Wakeup count: %lu\r\n", g_rtc_stats.wakeup_count);
-    printf("Wakeup period: %lu sec\r\n", g_rtc_stats.wakeup_period_sec);
+    printf("Wakeup period: %lu ms (reconfigured %lu times)\r\n",
+           g_rtc_stats.wakeup_period_ms, g_rtc_stats.reconfigure_count);
     printf("Last wakeup: %lu ms\r\n", g_rtc_stats.last_wakeup_time);
     printf("Pending: %s\r\n", g_rtc_stats.is_wakeup_pending ? "YES" : "NO");
     printf("=============================\r\n");
@@ -244,6 +320,7 @@ void HAL_RTCEx_WakeUpTimerEventCallback(RTC_HandleTypeDef *hrtc)
 {
     // 处理RTC唤醒中断
     RTC_Wakeup_HandleInterrupt();
+    Event_Post(EVENT_RTC_WAKEUP);
 }
 
 /**
@@ -284,42 +361,46 @@ static int RTC_Wakeup_ConfigureClock(void)
 
 /**
  * @brief 配置RTC唤醒定时器
+ *
+ * 周期不超过RTC_WAKEUP_FINE_MAX_MS时用RTCCLK/16 (0.5ms分辨率)，否则用1Hz时钟 (秒分辨率)。
+ * 早期版本按HAL_GetTick实测值标定计数值 (2秒周期写11)，但Sleep期间SysTick暂停，
+ * 实测间隔偏短；STOP唤醒后HAL时基已按RTC补偿，计数值直接由唤醒时钟频率计算。
  */
-static int RTC_Wakeup_ConfigureTimer(uint32_t period_sec)
+static int RTC_Wakeup_ConfigureTimer(uint32_t period_ms)
 {
-    // 基于实际测试调整计数值
-    // 当前实际间隔约500ms，目标2000ms，需要4倍计数值
-    // 实验性调整：使用更大的计数值来获得更长的间隔
     uint32_t wakeup_counter;
+    uint32_t clock_source;
 
-    if (period_sec == 2) {
-        // 基于实际测试精确调整
-        // 计数值32产生5828ms间隔，目标2000ms
-        // 新计数值 = 32 × (2000/5828) ≈ 11
-        wakeup_counter = 11;  // 期望获得约2秒间隔
+    if (period_ms == 0) {
+        printf("RTC_WAKEUP: ERROR - Wakeup period must be > 0\r\n");
+        return -1;
+    }
+
+    if (period_ms <= RTC_WAKEUP_FINE_MAX_MS) {
+        uint32_t ticks = (period_ms * RTC_WAKEUP_FINE_CLOCK_FREQ + 500U) / 1000U;
+        wakeup_counter = (ticks > 0) ? ticks - 1U : 0U;
+        clock_source = RTC_WAKEUP_FINE_CLOCK_SOURCE;
     } else {
-        wakeup_counter = period_sec * 5;  // 其他周期使用调整后的系数
+        wakeup_counter = (period_ms + 500U) / 1000U - 1U;
+        clock_source = RTC_WAKEUP_CLOCK_SOURCE;
     }
 
     // 检查计数值范围
     if (wakeup_counter > 0xFFFF) {
-        printf("RTC_WAKEUP: ERROR - Wakeup period too long (max ~32 seconds)\r\n");
+        printf("RTC_WAKEUP: ERROR - Wakeup period too long (max 65536 seconds)\r\n");
         return -1;
     }
 
-    printf("RTC_WAKEUP: Wakeup counter value: %lu (period: %lu sec)\r\n", wakeup_counter, period_sec);
-    printf("RTC_WAKEUP: Clock source: 0x%X, Clock freq: %lu Hz\r\n", RTC_WAKEUP_CLOCK_SOURCE, RTC_WAKEUP_CLOCK_FREQ);
-    printf("RTC_WAKEUP: Expected interval: %lu ms\r\n", period_sec * 1000);
+    printf("RTC_WAKEUP: Wakeup counter %lu, clock %s, period %lu ms\r\n", wakeup_counter,
+           (clock_source == RTC_WAKEUP_FINE_CLOCK_SOURCE) ? "RTCCLK/16" : "1Hz", period_ms);
 
     // 实际配置HAL库的RTC唤醒定时器
-    HAL_StatusTypeDef hal_status = HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, wakeup_counter, RTC_WAKEUP_CLOCK_SOURCE);
+    HAL_StatusTypeDef hal_status = HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, wakeup_counter, clock_source);
     if (hal_status != HAL_OK) {
         printf("RTC_WAKEUP: ERROR - Failed to set wakeup timer, HAL status: %d\r\n", hal_status);
         return -2;
     }
 
-    printf("RTC_WAKEUP: Wakeup timer configured successfully\r\n");
-    printf("RTC_WAKEUP: Timer should trigger in %lu seconds\r\n", period_sec);
     return 0;
 }
 
@@ -330,5 +411,5 @@ static void RTC_Wakeup_UpdateStats(void)
 {
     g_rtc_stats.wakeup_count++;
     g_rtc_stats.last_wakeup_time = HAL_GetTick();
-    g_rtc_stats.total_wakeup_time += g_rtc_stats.wakeup_period_sec;
+    g_rtc_stats.total_wakeup_time += g_rtc_stats.wakeup_period_ms;
 }
@@ -0,0 +1,262 @@
+/**
+ * @file system_monitor.c
+ * @brief CPU负载、栈高水位与静态RAM占用监测实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 空闲上报与节拍归集都在主循环上下文中执行，不需要关中断。
+ * 栈边界和RAM区域取自Keil链接器符号 (__initial_sp, Image$$RW_IRAM1$$...)，
+ * 其它工具链下不做栈填充，只统计负载。
+ */
+
+#include "system_monitor.h"
+
+#if ENABLE_SYSTEM_MONITOR
+
+#include "dwt_timer.h"
+#include "fft_processor.h"
+#include "host_protocol.h"
+#include "lora_transport.h"
+#include "modbus_rtu.h"
+#include "event_loop.h"
+#include "profiler.h"
+#include "latency_tracker.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__CC_ARM) || defined(__ARMCC_VERSION)
+#define SYSTEM_MONITOR_HAS_LINKER_SYMBOLS   1
+extern uint32_t __initial_sp;
+extern uint32_t Image$$RW_IRAM1$$Base;
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit;
+#else
+#define SYSTEM_MONITOR_HAS_LINKER_SYMBOLS   0
+#endif
+
+/* 静态RAM占用表项 */
+typedef struct {
+    const char *name;
+    uint32_t bytes;
+} ram_usage_item_t;
+
+/* 私有变量 */
+static system_monitor_stats_t monitor_stats;
+static uint32_t last_cycles = 0;
+static uint32_t pending_idle_cycles = 0;
+static uint64_t pending_stop_cycles = 0;        // STOP时长折算的周期 (不在DWT差值内)
+static uint64_t window_total_cycles = 0;
+static uint64_t window_idle_cycles = 0;
+static uint32_t *stack_bottom = NULL;
+static uint32_t *stack_painted_end = NULL;
+
+/*
+ * 各模块主要静态对象 (按类型sizeof统计；私有结构体只计入其缓冲区，为下限值)
+ */
+static const ram_usage_item_t ram_usage_table[] = {
+    { "FFT processor",      sizeof(fft_processor_t) + FFT_SIZE * sizeof(float32_t) },
+    { "IIM423xx driver",    sizeof(struct inv_iim423xx) },
+#if ENABLE_DATA_PREPROCESSING
+    { "High-pass filter",   sizeof(highpass_filter_t) },
+#endif
+#if ENABLE_COARSE_DETECTION
+    { "Coarse detector",    sizeof(coarse_detector_t) },
+#endif
+#if ENABLE_FINE_DETECTION
+    { "Fine detector",      2 * sizeof(fine_detection_features_t) },
+#endif
+#if ENABLE_SYSTEM_STATE_MACHINE
+    { "State machine",      sizeof(system_state_machine_t) + STATE_TRACE_DEPTH * sizeof(state_trace_entry_t) },
+#endif
+    { "Host protocol bufs", HOST_PROTOCOL_RX_DMA_SIZE + 11 + HOST_LINK_TEST_CHUNK_MAX },
+    { "LoRa/Modbus bufs",   LORA_EVENT_QUEUE_SIZE * (8 + LORA_MAX_REG_COUNT * 2) +
+                            MODBUS_RTU_RX_DMA_SIZE + MODBUS_RTU_MAX_FRAME },
+    { "Event loop",         sizeof(event_loop_stats_t) },
+#if ENABLE_PROFILING
+    { "Profiler",           PROF_STAGE_COUNT * sizeof(profiler_stats_t) },
+#endif
+#if ENABLE_LATENCY_TRACKER
+    { "Latency tracker",    (LATENCY_INFLIGHT_SLOTS + LATENCY_HISTORY_DEPTH + 1) * sizeof(latency_record_t) },
+#endif
+    { "System monitor",     sizeof(system_monitor_stats_t) },
+    { "msg_printer out_str", 256 },
+};
+
+/* 私有函数声明 */
+static void paint_stack(void);
+static system_state_t current_state_slot(void);
+
+int System_Monitor_Init(void)
+{
+    memset(&monitor_stats, 0, sizeof(monitor_stats));
+    monitor_stats.stack_size = SYSTEM_MONITOR_STACK_SIZE;
+    last_cycles = DWT_Timer_GetCycles();
+    pending_idle_cycles = 0;
+    pending_stop_cycles = 0;
+    window_total_cycles = 0;
+    window_idle_cycles = 0;
+
+    paint_stack();
+    System_Monitor_PrintRamUsage();
+    return 0;
+}
+
+void System_Monitor_RecordIdle(uint32_t cycles)
+{
+    pending_idle_cycles += cycles;
+}
+
+void System_Monitor_RecordStop(uint32_t stop_ms)
+{
+    pending_stop_cycles += (uint64_t)stop_ms * (SystemCoreClock / 1000U);
+}
+
+void System_Monitor_Process(void)
+{
+    uint32_t now = DWT_Timer_GetCycles();
+    uint32_t delta = now - last_cycles;
+    uint32_t idle = pending_idle_cycles;
+    last_cycles = now;
+    pending_idle_cycles = 0;
+    if (idle > delta) {
+        idle = delta;
+    }
+
+    uint64_t stop = pending_stop_cycles;
+    pending_stop_cycles = 0;
+
+    uint8_t slot = (uint8_t)current_state_slot();
+    monitor_stats.state_total_cycles[slot] += delta + stop;
+    monitor_stats.state_busy_cycles[slot] += delta - idle;
+
+    window_total_cycles += delta + stop;
+    window_idle_cycles += idle + stop;
+
+    uint64_t window_cycles = (uint64_t)(SystemCoreClock / 1000U) * SYSTEM_MONITOR_LOAD_WINDOW_MS;
+    if (window_total_cycles >= window_cycles) {
+        uint64_t busy = window_total_cycles - window_idle_cycles;
+        monitor_stats.load_permille = (uint16_t)((busy * 1000U) / window_total_cycles);
+        if (monitor_stats.load_permille > monitor_stats.load_peak_permille) {
+            monitor_stats.load_peak_permille = monitor_stats.load_permille;
+        }
+        monitor_stats.windows++;
+        window_total_cycles = 0;
+        window_idle_cycles = 0;
+    }
+}
+
+uint32_t System_Monitor_GetStackPeak(void)
+{
+    if (stack_bottom == NULL) {
+        return 0;
+    }
+
+    /* 从栈底向上找第一个被改写的字 */
+    uint32_t *p = stack_bottom;
+    while (p < stack_painted_end && *p == SYSTEM_MONITOR_STACK_PAINT) {
+        p++;
+    }
+    uint32_t used = SYSTEM_MONITOR_STACK_SIZE - (uint32_t)((p - stack_bottom) * sizeof(uint32_t));
+    if (used > monitor_stats.stack_peak_bytes) {
+        monitor_stats.stack_peak_bytes = used;
+    }
+    return monitor_stats.stack_peak_bytes;
+}
+
+const system_monitor_stats_t* System_Monitor_GetStats(void)
+{
+    System_Monitor_GetStackPeak();
+    return &monitor_stats;
+}
+
+void System_Monitor_PrintStats(bool reset)
+{
+    uint32_t stack_peak = System_Monitor_GetStackPeak();
+
+    printf("SYSMON: load %u.%u%% (peak %u.%u%%), stack peak %lu/%lu bytes\r\n",
+           monitor_stats.load_permille / 10, monitor_stats.load_permille % 10,
+           monitor_stats.load_peak_permille / 10, monitor_stats.load_peak_permille % 10,
+           stack_peak, monitor_stats.stack_size);
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    for (uint8_t i = 0; i < SYSTEM_MONITOR_STATE_SLOTS; i++) {
+        uint64_t total = monitor_stats.state_total_cycles[i];
+        if (total == 0) {
+            continue;
+        }
+        uint32_t load = (uint32_t)((monitor_stats.state_busy_cycles[i] * 1000U) / total);
+        uint32_t ms = (uint32_t)(total / (SystemCoreClock / 1000U));
+        printf("  state %-2u load %lu.%lu%% over %lu ms\r\n", i, load / 10, load % 10, ms);
+    }
+#endif
+
+    if (reset) {
+        monitor_stats.load_peak_permille = monitor_stats.load_permille;
+        memset(monitor_stats.state_total_cycles, 0, sizeof(monitor_stats.state_total_cycles));
+        memset(monitor_stats.state_busy_cycles, 0, sizeof(monitor_stats.state_busy_cycles));
+    }
+}
+
+void System_Monitor_PrintRamUsage(void)
+{
+    uint32_t listed = 0;
+
+    printf("=== STATIC RAM USAGE ===\r\n");
+    for (uint32_t i = 0; i < sizeof(ram_usage_table) / sizeof(ram_usage_table[0]); i++) {
+        printf("  %-20s %6lu\r\n", ram_usage_table[i].name, ram_usage_table[i].bytes);
+        listed += ram_usage_table[i].bytes;
+    }
+    printf("  %-20s %6lu\r\n", "Stack (MSP)", (uint32_t)SYSTEM_MONITOR_STACK_SIZE);
+    printf("  %-20s %6lu\r\n", "Heap", (uint32_t)SYSTEM_MONITOR_HEAP_SIZE);
+    listed += SYSTEM_MONITOR_STACK_SIZE + SYSTEM_MONITOR_HEAP_SIZE;
+
+#if SYSTEM_MONITOR_HAS_LINKER_SYMBOLS
+    uint32_t used = (uint32_t)&Image$$RW_IRAM1$$ZI$$Limit - (uint32_t)&Image$$RW_IRAM1$$Base;
+    printf("  %-20s %6lu\r\n", "Other (HAL, libc...)", (used > listed) ? used - listed : 0);
+    printf("  Total RW+ZI %lu of %lu bytes, %lu free\r\n",
+           used, (uint32_t)SYSTEM_MONITOR_RAM_SIZE, (uint32_t)SYSTEM_MONITOR_RAM_SIZE - used);
+#else
+    printf("  Listed total %lu bytes (linker totals unavailable)\r\n", listed);
+#endif
+    printf("========================\r\n");
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 填充栈底到当前SP(留余量)之间的区域
+ */
+static void paint_stack(void)
+{
+#if SYSTEM_MONITOR_HAS_LINKER_SYMBOLS
+    uint32_t top = (uint32_t)&__initial_sp;
+    uint32_t sp = __get_MSP();
+
+    stack_bottom = (uint32_t *)(top - SYSTEM_MONITOR_STACK_SIZE);
+    stack_painted_end = (uint32_t *)((sp - SYSTEM_MONITOR_PAINT_MARGIN) & ~3U);
+    if (stack_painted_end <= stack_bottom) {
+        stack_bottom = NULL;        // 栈已几乎用尽，无法填充
+        return;
+    }
+
+    for (uint32_t *p = stack_bottom; p < stack_painted_end; p++) {
+        *p = SYSTEM_MONITOR_STACK_PAINT;
+    }
+    monitor_stats.stack_peak_bytes = top - sp;
+#else
+    stack_bottom = NULL;
+#endif
+}
+
+static system_state_t current_state_slot(void)
+{
+#if ENABLE_SYSTEM_STATE_MACHINE
+    system_state_t state = System_State_Machine_GetCurrentState();
+    return (state < STATE_COUNT) ? state : STATE_SYSTEM_INIT;
+#else
+    return (system_state_t)0;
+#endif
+}
+
+#endif /* ENABLE_SYSTEM_MONITOR */
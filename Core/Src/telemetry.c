@@ -0,0 +1,321 @@
+/**
+ * @file telemetry.c
+ * @brief 周期性二进制健康/性能遥测实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 上位机窗口和LoRa窗口各自保存一份起点快照，互不影响；
+ * 时间以DWT周期数累计，每次Process/空闲退出时按增量计入，
+ * 因此两次调用间隔只需小于CYCCNT回绕周期 (84MHz下约51秒)。
+ */
+
+#include "telemetry.h"
+#include "dwt_timer.h"
+#include "fft_processor.h"
+#include "host_protocol.h"
+#include "lora_transport.h"
+#include <stdio.h>
+#include <string.h>
+
+#if ENABLE_TELEMETRY
+
+/* 累计计数器快照 */
+typedef struct {
+    uint32_t fifo_reads;
+    uint32_t fifo_overflows;
+    uint32_t samples;
+    uint32_t fft_frames;
+    uint32_t coarse_triggers;
+    uint32_t fine_mining;
+    uint32_t fine_normal;
+    uint32_t uplink_ok;
+    uint32_t uplink_fail;
+    uint32_t state_ms[STATE_COUNT];
+} telemetry_counters_t;
+
+/* 统计窗口 */
+typedef struct {
+    uint64_t total_cycles;
+    uint64_t wait_cycles;
+    uint64_t sleep_cycles;
+    uint32_t start_tick;
+    telemetry_counters_t start;
+} telemetry_window_t;
+
+/* 私有变量 */
+static telemetry_window_t host_window;
+#if ENABLE_TELEMETRY_LORA
+static telemetry_window_t lora_window;
+#endif
+static uint32_t fifo_reads = 0;
+static uint32_t samples = 0;
+static uint32_t last_cycles = 0;
+static uint32_t idle_start_cycles = 0;
+static telemetry_idle_t idle_kind = TELEMETRY_IDLE_WAIT;
+static bool idle_active = false;
+
+/* 私有函数声明 */
+static void advance_time(void);
+static void capture_counters(telemetry_counters_t *counters);
+static void window_reset(telemetry_window_t *window, const telemetry_counters_t *now);
+static uint16_t ratio_permille(uint64_t part, uint64_t total);
+static uint16_t cpu_load_permille(const telemetry_window_t *window);
+static uint16_t sat_u16(uint32_t value);
+static uint16_t put_u16(uint8_t *buf, uint16_t value);
+static uint16_t put_u32(uint8_t *buf, uint32_t value);
+
+int Telemetry_Init(void)
+{
+    telemetry_counters_t now;
+
+    fifo_reads = 0;
+    samples = 0;
+    idle_active = false;
+    last_cycles = DWT_Timer_GetCycles();
+
+    capture_counters(&now);
+    window_reset(&host_window, &now);
+#if ENABLE_TELEMETRY_LORA
+    window_reset(&lora_window, &now);
+#endif
+
+    printf("TELEMETRY: Initialized (period %d ms, payload %d bytes)\r\n",
+           TELEMETRY_PERIOD_MS, TELEMETRY_PAYLOAD_SIZE);
+    return 0;
+}
+
+void Telemetry_Process(void)
+{
+    advance_time();
+
+    uint32_t now_tick = HAL_GetTick();
+
+    if ((now_tick - host_window.start_tick) >= TELEMETRY_PERIOD_MS) {
+        uint8_t payload[TELEMETRY_PAYLOAD_SIZE];
+        int length = Telemetry_BuildPayload(payload, sizeof(payload));
+        if (length > 0) {
+            Host_Protocol_StreamTelemetry(payload, (uint16_t)length);
+        }
+
+        telemetry_counters_t now;
+        capture_counters(&now);
+        window_reset(&host_window, &now);
+    }
+
+#if ENABLE_TELEMETRY_LORA
+    if ((now_tick - lora_window.start_tick) >= TELEMETRY_LORA_PERIOD_MS) {
+        telemetry_counters_t now;
+        uint16_t regs[TELEMETRY_LORA_REG_COUNT];
+        uint32_t state_total = 0;
+
+        capture_counters(&now);
+        for (uint8_t i = 0; i < STATE_COUNT; i++) {
+            state_total += now.state_ms[i] - lora_window.start.state_ms[i];
+        }
+
+        regs[0] = 3;
+        regs[1] = cpu_load_permille(&lora_window);
+        regs[2] = ratio_permille(lora_window.sleep_cycles, lora_window.total_cycles);
+        regs[3] = sat_u16(now.fifo_reads - lora_window.start.fifo_reads);
+        regs[4] = sat_u16(now.fifo_overflows - lora_window.start.fifo_overflows);
+        regs[5] = sat_u16(now.fft_frames - lora_window.start.fft_frames);
+        regs[6] = sat_u16(now.coarse_triggers - lora_window.start.coarse_triggers);
+        regs[7] = sat_u16(now.fine_mining - lora_window.start.fine_mining);
+        regs[8] = sat_u16(now.fine_normal - lora_window.start.fine_normal);
+        regs[9] = sat_u16(now.uplink_ok - lora_window.start.uplink_ok);
+        regs[10] = sat_u16(now.uplink_fail - lora_window.start.uplink_fail);
+        regs[11] = ratio_permille(now.state_ms[STATE_MONITORING] - lora_window.start.state_ms[STATE_MONITORING],
+                                  state_total);
+
+        if (LoRa_Transport_PostRegisters(TELEMETRY_LORA_START_REG, regs, TELEMETRY_LORA_REG_COUNT) != 0) {
+            printf("TELEMETRY: LoRa uplink queue full, summary skipped\r\n");
+        }
+        window_reset(&lora_window, &now);
+    }
+#endif
+}
+
+void Telemetry_IdleEnter(telemetry_idle_t kind)
+{
+    advance_time();
+    idle_kind = kind;
+    idle_start_cycles = last_cycles;
+    idle_active = true;
+}
+
+void Telemetry_IdleExit(void)
+{
+    if (!idle_active) {
+        return;
+    }
+
+    /* advance_time已把空闲期间的周期计入total，这里只需再计入空闲分量 */
+    advance_time();
+    uint32_t idle_cycles = last_cycles - idle_start_cycles;
+    idle_active = false;
+
+    if (idle_kind == TELEMETRY_IDLE_SLEEP) {
+        host_window.sleep_cycles += idle_cycles;
+#if ENABLE_TELEMETRY_LORA
+        lora_window.sleep_cycles += idle_cycles;
+#endif
+    } else {
+        host_window.wait_cycles += idle_cycles;
+#if ENABLE_TELEMETRY_LORA
+        lora_window.wait_cycles += idle_cycles;
+#endif
+    }
+}
+
+void Telemetry_RecordFifoRead(int rc)
+{
+    fifo_reads++;
+    if (rc > 0) {
+        samples += (uint32_t)rc;
+    }
+}
+
+int Telemetry_BuildPayload(uint8_t *buffer, uint16_t size)
+{
+    telemetry_counters_t now;
+    uint32_t state_total = 0;
+    uint32_t state_delta[STATE_COUNT];
+    uint16_t idx = 0;
+
+    if (buffer == NULL || size < TELEMETRY_PAYLOAD_SIZE) {
+        return -1;
+    }
+
+    advance_time();
+    capture_counters(&now);
+
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        state_delta[i] = now.state_ms[i] - host_window.start.state_ms[i];
+        state_total += state_delta[i];
+    }
+
+    uint32_t cycles_per_ms = SystemCoreClock / 1000U;
+    if (cycles_per_ms == 0) {
+        cycles_per_ms = 1;
+    }
+
+    buffer[idx++] = TELEMETRY_VERSION;
+    idx += put_u32(&buffer[idx], HAL_GetTick());
+    idx += put_u32(&buffer[idx], (uint32_t)(host_window.total_cycles / cycles_per_ms));
+    idx += put_u16(&buffer[idx], cpu_load_permille(&host_window));
+    idx += put_u16(&buffer[idx], ratio_permille(host_window.sleep_cycles, host_window.total_cycles));
+    idx += put_u32(&buffer[idx], now.fifo_reads);
+    idx += put_u32(&buffer[idx], now.fifo_overflows);
+    idx += put_u32(&buffer[idx], now.samples);
+    idx += put_u32(&buffer[idx], now.fft_frames);
+    idx += put_u32(&buffer[idx], now.coarse_triggers);
+    idx += put_u32(&buffer[idx], now.fine_mining);
+    idx += put_u32(&buffer[idx], now.fine_normal);
+    idx += put_u32(&buffer[idx], now.uplink_ok);
+    idx += put_u32(&buffer[idx], now.uplink_fail);
+    buffer[idx++] = TELEMETRY_STATE_SLOTS;
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        idx += put_u16(&buffer[idx], ratio_permille(state_delta[i], state_total));
+    }
+
+    return idx;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 把自上次调用以来的周期数计入各窗口
+ */
+static void advance_time(void)
+{
+    uint32_t now = DWT_Timer_GetCycles();
+    uint32_t delta = now - last_cycles;
+    last_cycles = now;
+
+    host_window.total_cycles += delta;
+#if ENABLE_TELEMETRY_LORA
+    lora_window.total_cycles += delta;
+#endif
+}
+
+static void capture_counters(telemetry_counters_t *counters)
+{
+    memset(counters, 0, sizeof(*counters));
+
+    counters->fifo_reads = fifo_reads;
+    counters->samples = samples;
+    counters->fifo_overflows = GetInvDeviceFifoOverflowCount();
+    counters->fft_frames = FFT_GetFrameCount();
+
+#if ENABLE_COARSE_DETECTION
+    counters->coarse_triggers = Coarse_Detector_GetInfo()->trigger_count;
+#endif
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    const system_state_machine_t *sm = System_State_Machine_GetInfo();
+    counters->fine_mining = sm->mining_detections;
+    counters->fine_normal = sm->total_detections - sm->mining_detections;
+    for (uint8_t i = 0; i < STATE_COUNT; i++) {
+        counters->state_ms[i] = sm->state_time_ms[i];
+    }
+    /* 当前状态本次驻留尚未计入state_time_ms */
+    if (sm->current_state < STATE_COUNT) {
+        counters->state_ms[sm->current_state] += HAL_GetTick() - sm->state_enter_time;
+    }
+#endif
+
+    const lora_transport_stats_t *lora = LoRa_Transport_GetStats();
+    counters->uplink_ok = lora->events_sent;
+    counters->uplink_fail = lora->events_failed;
+}
+
+static void window_reset(telemetry_window_t *window, const telemetry_counters_t *now)
+{
+    window->total_cycles = 0;
+    window->wait_cycles = 0;
+    window->sleep_cycles = 0;
+    window->start_tick = HAL_GetTick();
+    window->start = *now;
+}
+
+static uint16_t ratio_permille(uint64_t part, uint64_t total)
+{
+    if (total == 0) {
+        return 0;
+    }
+    if (part >= total) {
+        return 1000;
+    }
+    return (uint16_t)((part * 1000U) / total);
+}
+
+static uint16_t cpu_load_permille(const telemetry_window_t *window)
+{
+    return (uint16_t)(1000U - ratio_permille(window->wait_cycles + window->sleep_cycles,
+                                             window->total_cycles));
+}
+
+static uint16_t sat_u16(uint32_t value)
+{
+    return (value > 0xFFFFU) ? 0xFFFFU : (uint16_t)value;
+}
+
+static uint16_t put_u16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)(value >> 8);
+    return 2;
+}
+
+static uint16_t put_u32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)(value & 0xFF);
+    buf[1] = (uint8_t)((value >> 8) & 0xFF);
+    buf[2] = (uint8_t)((value >> 16) & 0xFF);
+    buf[3] = (uint8_t)((value >> 24) & 0xFF);
+    return 4;
+}
+
+#endif /* ENABLE_TELEMETRY */
@@ -0,0 +1,26 @@
+/**
+ * @file dsp_bench_main.c
+ * @brief 主机上运行DSP基准测试 (与目标板HOST_CMD_RUN_DSP_BENCH输出同一张表)
+ * @date 2026-10-19
+ * @version v1.0
+ */
+
+#include "dsp_benchmark.h"
+#include "detection_params.h"
+#include <stdio.h>
+
+extern uint32_t SystemCoreClock;
+
+int main(void)
+{
+    Detection_Params_Init();
+
+    int count = DSP_Benchmark_Run();
+    if (count <= 0) {
+        printf("DSP_BENCH: no results\n");
+        return 1;
+    }
+
+    DSP_Benchmark_PrintTable(SystemCoreClock);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把上位机记录的事件 (mining_events.json) 或合成事件转换为回放语料，供 build/replay 或
+stm32_command_protocol.py replay (目标板UART注入) 使用。
+
+语料格式 (文本, 每行一项):
+    # 注释
+    event <名称> <期望: mining|normal|-> <起点样本序号>
+    <Z轴样本, g>
+    ...
+每个事件 = 前导段 (事件首样本电平 + 高斯底噪, 让高通滤波器和粗检测基线稳定)
+         + 事件样本 (按time数组线性插值重采样到1kHz)
+         + 尾随段 (事件末样本电平 + 底噪, 保证触发后的FFT帧能够采满)
+噪声使用固定种子, 同一输入总是生成同一份语料。
+
+用法:
+    python3 events_to_corpus.py ../mining_events.json > corpus.txt
+    python3 events_to_corpus.py --synthetic 20 | ./build/replay -
+"""
+
+import argparse
+import json
+import math
+import random
+import sys
+
+SAMPLE_RATE_HZ = 1000.0         # 与固件 SAMPLING_FREQUENCY 一致
+
+
+def resample(times, values, rate):
+    """按时间戳线性插值到固定采样率 (time数组缺失或无效时按原样输出)"""
+    if len(times) != len(values) or len(values) < 2 or times[-1] <= times[0]:
+        return list(values)
+    out = []
+    step = 1.0 / rate
+    t = times[0]
+    j = 0
+    while t <= times[-1]:
+        while j + 1 < len(times) - 1 and times[j + 1] < t:
+            j += 1
+        t0, t1 = times[j], times[j + 1]
+        frac = 0.0 if t1 <= t0 else min(max((t - t0) / (t1 - t0), 0.0), 1.0)
+        out.append(values[j] + (values[j + 1] - values[j]) * frac)
+        t += step
+    return out
+
+
+def pad(samples, pre_ms, post_ms, noise_g, rng, rate=SAMPLE_RATE_HZ):
+    """加前导/尾随段，返回 (样本, 事件起点序号)"""
+    pre = int(pre_ms * rate / 1000.0)
+    post = int(post_ms * rate / 1000.0)
+    head = samples[0] if samples else 0.0
+    tail = samples[-1] if samples else 0.0
+    out = [head + rng.gauss(0.0, noise_g) for _ in range(pre)]
+    out += [s + rng.gauss(0.0, noise_g) for s in samples]
+    out += [tail + rng.gauss(0.0, noise_g) for _ in range(post)]
+    return out, pre
+
+
+def load_events(path, axis="z", native=False, pre_ms=3000, post_ms=3000, noise_g=0.001,
+                seed=1, rate=SAMPLE_RATE_HZ):
+    """
+    读取 mining_events.json, 返回 [{"name", "expected", "onset", "samples"}]
+    native=True 时忽略time数组, 把记录的样本当作连续的1kHz样本
+    """
+    with open(path, encoding="utf-8") as f:
+        records = json.load(f)
+    rng = random.Random(seed)
+    events = []
+    for i, rec in enumerate(records):
+        raw = rec.get("sensor_data", {}).get("raw_accel", {})
+        values = raw.get(axis, [])
+        if not values:
+            continue
+        samples = list(values) if native else resample(raw.get("time", []), values, rate)
+        samples, onset = pad(samples, pre_ms, post_ms, noise_g, rng, rate)
+        # 记录的都是上位机判定为挖掘的事件
+        expected = "mining" if "detection" in rec.get("detection_type", "") else "-"
+        name = f"{i:03d}_{rec.get('datetime', '').replace(' ', 'T') or 'event'}"
+        events.append({"name": name, "expected": expected, "onset": onset, "samples": samples})
+    return events
+
+
+def synthetic_events(count, pre_ms=3000, post_ms=3000, noise_g=0.001, seed=1,
+                     rate=SAMPLE_RATE_HZ):
+    """交替生成挖掘类 (8-12Hz) 和环境类 (40-80Hz) 突发, 每个持续2秒"""
+    rng = random.Random(seed)
+    events = []
+    for i in range(count):
+        mining = (i % 2 == 0)
+        freq = rng.uniform(8.0, 12.0) if mining else rng.uniform(40.0, 80.0)
+        amp = rng.uniform(0.02, 0.1)
+        burst = [1.0 + amp * math.sin(2.0 * math.pi * freq * n / rate) for n in range(int(2 * rate))]
+        samples, onset = pad(burst, pre_ms, post_ms, noise_g, rng, rate)
+        events.append({"name": f"synth{i:03d}_{freq:.1f}Hz", "expected": "mining" if mining else "normal",
+                       "onset": onset, "samples": samples})
+    return events
+
+
+def write_corpus(events, out):
+    for ev in events:
+        out.write(f"event {ev['name']} {ev['expected']} {ev['onset']}\n")
+        out.write("".join(f"{s:.7g}\n" for s in ev["samples"]))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("events", nargs="?", help="mining_events.json")
+    ap.add_argument("--synthetic", type=int, metavar="N", help="生成N个合成事件而不是读取文件")
+    ap.add_argument("--axis", default="z", choices=("x", "y", "z"))
+    ap.add_argument("--native", action="store_true", help="不按time数组重采样")
+    ap.add_argument("--pre-ms", type=int, default=3000)
+    ap.add_argument("--post-ms", type=int, default=3000)
+    ap.add_argument("--noise", type=float, default=0.001, help="前导/尾随底噪标准差 (g)")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    if args.synthetic:
+        events = synthetic_events(args.synthetic, args.pre_ms, args.post_ms, args.noise, args.seed)
+    elif args.events:
+        events = load_events(args.events, args.axis, args.native, args.pre_ms, args.post_ms,
+                             args.noise, args.seed)
+    else:
+        ap.error("需要事件文件或 --synthetic")
+    write_corpus(events, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,320 @@
+/**
+ * @file fifo_bench_main.c
+ * @brief Iim423xx驱动FIFO解码吞吐量基准与模糊测试 (寄存器模型见fifo_sim.h)
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 用法: fifo_bench [-n 包数] [-f 次数] [-s 种子]
+ *   默认  吞吐量基准：16/20字节包 x 水位线1/10/50/满，每组解码-n个包 (默认1000000)，
+ *         另加一组注入无效值/MSG/FSYNC的运行；只对inv_iim423xx_get_data_from_fifo计时，
+ *         并按X轴序号检查连续性、按注入统计核对回调计数
+ *   -f N  模糊测试：N次随机FIFO内容 + 随机FIFO_COUNT (0..65535) + 随机包长/端序/接口/空FIFO读出值，
+ *         检查FIFO_DATA传输不越出镜像缓冲区、返回包数和回调次数不超过镜像容量。
+ *         越界读 (解码循环按包头越出fifo_data) 由make fifo-fuzz的UBSan边界检查捕获
+ */
+
+#include "fifo_sim.h"
+#include "Iim423xxDefs.h"
+#include "Iim423xxTransport.h"
+#include "host_shim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_PACKETS   1000000U
+
+/* 回调统计 */
+typedef struct {
+    uint32_t events;
+    uint32_t accel;                 // 有效加速度包
+    uint32_t invalid;               // 无效值包 (无ACCEL标志)
+    uint32_t fsync;
+    uint32_t seq_errors;            // X轴序号不连续 (MSG复位后的第一个包除外)
+    uint32_t range_errors;          // Z轴超出1g±幅值
+    uint32_t expected_seq;
+    bool resync;                    // 下一个有效包重新对齐序号
+} bench_counters_t;
+
+/* 私有变量 */
+static struct inv_iim423xx device;
+static bench_counters_t counters;
+static fifo_sim_config_t active_config;
+
+/* 私有函数声明 */
+static int run_benchmark(uint32_t packets, uint32_t seed);
+static int run_case(const fifo_sim_config_t *cfg, uint32_t packets);
+static int run_fuzz(uint32_t iterations, uint32_t seed);
+static void bench_event(inv_iim423xx_sensor_event_t *event);
+static void fuzz_event(inv_iim423xx_sensor_event_t *event);
+static uint32_t fuzz_random(uint32_t *state);
+static double now_seconds(void);
+
+int main(int argc, char **argv)
+{
+    uint32_t packets = BENCH_DEFAULT_PACKETS;
+    uint32_t fuzz_iterations = 0;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            packets = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            fuzz_iterations = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-n packets] [-f iterations] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Host_Shim_SetLogEnabled(false);
+    if (fuzz_iterations > 0) {
+        return run_fuzz(fuzz_iterations, seed);
+    }
+    return run_benchmark(packets, seed);
+}
+
+/* --------------------------------------------------------------------------------------
+ *  吞吐量基准
+ * -------------------------------------------------------------------------------------- */
+
+static int run_benchmark(uint32_t packets, uint32_t seed)
+{
+    static const uint16_t watermarks[] = { 1, 10, 50, 0 };     // 0 = FIFO容量
+    int failures = 0;
+
+    printf("%-6s %-6s %5s %10s %9s %9s %8s %s\n",
+           "format", "serif", "wm", "packets", "ns/pkt", "Mpkt/s", "flushes", "check");
+
+    for (int highres = 0; highres <= 1; highres++) {
+        for (uint32_t i = 0; i < sizeof(watermarks) / sizeof(watermarks[0]); i++) {
+            fifo_sim_config_t cfg;
+            Fifo_Sim_DefaultConfig(&cfg);
+            cfg.highres = highres;
+            cfg.seed = seed;
+            cfg.watermark = watermarks[i];
+            if (cfg.watermark == 0) {
+                cfg.watermark = FIFO_SIM_CAPACITY /
+                                (highres ? FIFO_20BYTES_PACKET_SIZE : FIFO_16BYTES_PACKET_SIZE);
+            }
+            failures += run_case(&cfg, packets);
+        }
+    }
+
+    /* I2C：每包一次semi-write；注入无效值/MSG/FSYNC */
+    fifo_sim_config_t cfg;
+    Fifo_Sim_DefaultConfig(&cfg);
+    cfg.seed = seed;
+    cfg.serif_type = IIM423XX_UI_I2C;
+    failures += run_case(&cfg, packets);
+
+    cfg.serif_type = IIM423XX_UI_SPI4;
+    cfg.highres = true;
+    cfg.big_endian = false;
+    cfg.fsync_period = 100;
+    cfg.invalid_permille = 10;
+    cfg.msg_permille = 2;
+    failures += run_case(&cfg, packets);
+
+    printf("FIFO_BENCH: %s\n", failures ? "FAIL" : "OK");
+    return failures ? 1 : 0;
+}
+
+static int run_case(const fifo_sim_config_t *cfg, uint32_t packets)
+{
+    if (Fifo_Sim_Init(cfg) != 0 || Fifo_Sim_Attach(&device, bench_event) != 0) {
+        fprintf(stderr, "simulator init failed\n");
+        return 1;
+    }
+    active_config = *cfg;
+    memset(&counters, 0, sizeof(counters));
+
+    uint32_t batch_us = (uint32_t)(1000000ULL * cfg->watermark / cfg->odr_hz);
+    uint32_t decoded = 0;
+    uint32_t errors = 0;
+    double elapsed = 0.0;
+
+    while (Fifo_Sim_GetStats()->packets_generated < packets) {
+        Fifo_Sim_Advance(batch_us);
+
+        double start = now_seconds();
+        int rc = inv_iim423xx_get_data_from_fifo(&device);
+        elapsed += now_seconds() - start;
+
+        if (rc < 0) {
+            errors++;
+            counters.resync = true;
+        } else {
+            decoded += (uint32_t)rc;
+        }
+    }
+
+    /* 无MSG注入时每个生成的包都必须被回调一次 (有效或无效)，且序号连续；
+     * 有MSG注入时，MSG包之后同一批次的包 (含同批次的其余MSG包) 随FIFO复位丢弃 */
+    const fifo_sim_stats_t *st = Fifo_Sim_GetStats();
+    bool ok = (counters.seq_errors == 0) && (counters.range_errors == 0) &&
+              (st->bound_violations == 0) && (st->packets_dropped == 0) &&
+              (counters.invalid == st->invalid_injected || cfg->msg_permille != 0) &&
+              (counters.fsync <= st->fsync_injected);
+    if (cfg->msg_permille == 0) {
+        ok = ok && (errors == 0) && (counters.events == st->packets_generated) &&
+             (counters.fsync == st->fsync_injected);
+    } else {
+        ok = ok && (errors > 0) && (errors <= st->msg_injected) &&
+             (counters.events + st->msg_injected <= st->packets_generated);
+    }
+
+    const char *serif = (cfg->serif_type == IIM423XX_UI_I2C) ? "i2c" :
+                        (cfg->serif_type == IIM423XX_UI_I3C) ? "i3c" : "spi4";
+    printf("%-6s %-6s %5u %10u %9.1f %9.2f %8u %s",
+           cfg->highres ? "20B" : "16B", serif, cfg->watermark, counters.events,
+           counters.events ? elapsed * 1e9 / counters.events : 0.0,
+           elapsed > 0.0 ? counters.events / elapsed / 1e6 : 0.0,
+           st->flushes, ok ? "OK" : "FAIL");
+    if (cfg->msg_permille || cfg->invalid_permille || cfg->fsync_period) {
+        printf("  (%s, invalid %u/%u, msg %u, fsync %u/%u, lost to MSG %u)",
+               cfg->big_endian ? "BE" : "LE", counters.invalid, st->invalid_injected,
+               st->msg_injected, counters.fsync, st->fsync_injected,
+               st->packets_generated - counters.events - st->msg_injected);
+    }
+    printf("\n");
+    if (!ok) {
+        printf("  seq_errors=%u range_errors=%u errors=%u decoded=%u dropped=%u violations=%u\n",
+               counters.seq_errors, counters.range_errors, errors, decoded,
+               st->packets_dropped, st->bound_violations);
+    }
+    return ok ? 0 : 1;
+}
+
+static void bench_event(inv_iim423xx_sensor_event_t *event)
+{
+    counters.events++;
+    if (event->sensor_mask & (1 << INV_IIM423XX_SENSOR_FSYNC_EVENT)) {
+        counters.fsync++;
+    }
+    if (!(event->sensor_mask & (1 << INV_IIM423XX_SENSOR_ACCEL))) {
+        counters.invalid++;
+        counters.expected_seq = (counters.expected_seq + 1) & 0x7FFF;
+        return;
+    }
+    counters.accel++;
+
+    uint32_t seq = (uint16_t)event->accel[0];
+    if (counters.resync) {
+        counters.resync = false;
+    } else if (seq != counters.expected_seq) {
+        counters.seq_errors++;
+    }
+    counters.expected_seq = (seq + 1) & 0x7FFF;
+
+    int32_t z20 = (int32_t)event->accel[2] * 16;
+    if (active_config.highres) {
+        z20 += event->accel_high_res[2];
+    }
+    float z_g = (float)z20 / (FIFO_SIM_LSB_PER_G * 16.0f);
+    float limit = active_config.tone_g + 0.001f;
+    if (z_g < 1.0f - limit || z_g > 1.0f + limit) {
+        counters.range_errors++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  模糊测试
+ * -------------------------------------------------------------------------------------- */
+
+static int run_fuzz(uint32_t iterations, uint32_t seed)
+{
+    static const uint8_t headers[] = { 0x48, 0x4C, 0x58, 0x5C, 0x40, 0x50, 0x08, 0x00, 0x80, 0xFF };
+    static const uint8_t serif_types[] = { IIM423XX_UI_I2C, IIM423XX_UI_SPI4, IIM423XX_UI_I3C };
+    static uint8_t bytes[FIFO_SIM_CAPACITY];
+    uint32_t state = seed ? seed : 1;
+    uint32_t rc_ok = 0, rc_error = 0, max_read = 0;
+    uint64_t events = 0;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        fifo_sim_config_t cfg;
+        Fifo_Sim_DefaultConfig(&cfg);
+        cfg.highres = fuzz_random(&state) & 1;
+        cfg.big_endian = fuzz_random(&state) & 1;
+        cfg.serif_type = serif_types[fuzz_random(&state) % 3];
+        cfg.empty_byte = headers[fuzz_random(&state) % sizeof(headers)];
+        if (Fifo_Sim_Init(&cfg) != 0 || Fifo_Sim_Attach(&device, fuzz_event) != 0) {
+            fprintf(stderr, "simulator init failed\n");
+            return 1;
+        }
+        uint32_t packet_size = cfg.highres ? FIFO_20BYTES_PACKET_SIZE : FIFO_16BYTES_PACKET_SIZE;
+        uint32_t mirror_packets = (IIM423XX_FIFO_MIRRORING_SIZE) / packet_size;
+
+        /* 内容：随机字节，包头位置偏向合法/边界包头 (含20位标志、MSG位) */
+        uint32_t len = fuzz_random(&state) % (FIFO_SIM_CAPACITY + 1);
+        uint32_t stride = (fuzz_random(&state) & 1) ? packet_size : FIFO_16BYTES_PACKET_SIZE + 4;
+        for (uint32_t i = 0; i < len; i++) {
+            bytes[i] = (uint8_t)fuzz_random(&state);
+            if (i % stride == 0 && (fuzz_random(&state) % 4) != 0) {
+                bytes[i] = headers[fuzz_random(&state) % sizeof(headers)];
+            }
+        }
+
+        /* FIFO_COUNT：0、实际包数附近、镜像容量边界、任意16位值 */
+        uint16_t count;
+        switch (fuzz_random(&state) % 5) {
+        case 0:  count = (uint16_t)(len / packet_size); break;
+        case 1:  count = (uint16_t)(mirror_packets - 1 + fuzz_random(&state) % 3); break;
+        case 2:  count = (uint16_t)(fuzz_random(&state) % 256); break;
+        case 3:  count = 0xFFFF; break;
+        default: count = (uint16_t)fuzz_random(&state); break;
+        }
+        uint8_t int_status = (uint8_t)((fuzz_random(&state) & 1) ? BIT_INT_STATUS_FIFO_THS : 0);
+        if (fuzz_random(&state) % 4 == 0) {
+            int_status |= BIT_INT_STATUS_FIFO_FULL;
+        }
+        Fifo_Sim_LoadRaw(bytes, len, count, int_status);
+
+        counters.events = 0;
+        int rc = inv_iim423xx_get_data_from_fifo(&device);
+        const fifo_sim_stats_t *st = Fifo_Sim_GetStats();
+
+        if (st->bound_violations != 0 || counters.events > mirror_packets ||
+            (rc > 0 && (uint32_t)rc > mirror_packets)) {
+            printf("FIFO_FUZZ: iteration %u FAILED: %s %s serif=%u len=%u count=%u rc=%d "
+                   "events=%u max_read=%u violations=%u\n",
+                   it, cfg.highres ? "20B" : "16B", cfg.big_endian ? "BE" : "LE", cfg.serif_type,
+                   len, count, rc, counters.events, st->max_read_len, st->bound_violations);
+            return 1;
+        }
+        rc < 0 ? rc_error++ : rc_ok++;
+        events += counters.events;
+        if (st->max_read_len > max_read) {
+            max_read = st->max_read_len;
+        }
+    }
+
+    printf("FIFO_FUZZ: %u iterations OK (seed %u): %u decoded, %u rejected (MSG/size), "
+           "%llu events, max FIFO_DATA read %u/%u bytes\n",
+           iterations, seed, rc_ok, rc_error, (unsigned long long)events,
+           max_read, (unsigned)(IIM423XX_FIFO_MIRRORING_SIZE));
+    return 0;
+}
+
+static void fuzz_event(inv_iim423xx_sensor_event_t *event)
+{
+    (void)event;
+    counters.events++;
+}
+
+static uint32_t fuzz_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file fifo_sim.c
+ * @brief IIM-42352 FIFO寄存器模型与合成字节流发生器
+ * @date 2026-10-19
+ * @version v1.0
+ */
+
+#include "fifo_sim.h"
+#include "Iim423xxDefs.h"
+#include "Iim423xxTransport.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_BANKS               5
+#define SIM_SERIF_MAX_TRANSFER  (1024 * 32)     // 与main.c中的serif配置一致
+#define SIM_TEMPERATURE_RAW     0x10
+
+/* 私有变量 */
+static fifo_sim_config_t config;
+static fifo_sim_stats_t stats;
+static uint8_t regs[SIM_BANKS][256];
+static uint8_t fifo[FIFO_SIM_CAPACITY];
+static uint32_t fifo_head = 0;                  // 下一个出队字节
+static uint32_t fifo_len = 0;                   // FIFO中的字节数
+static bool fifo_full_flag = false;
+static bool raw_mode = false;                   // LoadRaw装入的内容：FIFO_COUNT/INT_STATUS按装入值返回
+static uint16_t raw_count = 0;
+static uint8_t raw_int_status = 0;
+static uint32_t packet_size = FIFO_16BYTES_PACKET_SIZE;
+static uint64_t period_ns = 1000000;
+static uint64_t now_ns = 0;                     // 模型时间
+static uint64_t next_sample_ns = 0;             // 下一个包的时刻
+static uint32_t sequence = 0;
+static uint32_t rng_state = 1;
+static struct inv_iim423xx *attached = NULL;
+
+/* 私有函数声明 */
+static int sim_read_reg(struct inv_iim423xx_serif *serif, uint8_t reg, uint8_t *buf, uint32_t len);
+static int sim_write_reg(struct inv_iim423xx_serif *serif, uint8_t reg, const uint8_t *buf, uint32_t len);
+static uint8_t read_register(uint8_t reg);
+static void write_register(uint8_t reg, uint8_t value);
+static void read_fifo_data(uint8_t *buf, uint32_t len);
+static void flush_fifo(void);
+static void generate_packet(void);
+static void put16(uint8_t *p, uint16_t value);
+static uint32_t next_random(void);
+static bool inject(uint16_t permille);
+
+/* --------------------------------------------------------------------------------------
+ *  公共接口
+ * -------------------------------------------------------------------------------------- */
+
+void Fifo_Sim_DefaultConfig(fifo_sim_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->odr_hz = 1000;
+    cfg->watermark = 10;
+    cfg->big_endian = true;
+    cfg->serif_type = IIM423XX_UI_SPI4;
+    cfg->tone_hz = 10.0f;
+    cfg->tone_g = 0.05f;
+    cfg->seed = 1;
+    cfg->empty_byte = FIFO_SIM_HEADER_MSG;
+}
+
+int Fifo_Sim_Init(const fifo_sim_config_t *cfg)
+{
+    if (cfg->odr_hz == 0 || cfg->odr_hz > 32000 || cfg->watermark == 0) {
+        return -1;
+    }
+
+    config = *cfg;
+    memset(&stats, 0, sizeof(stats));
+    memset(regs, 0, sizeof(regs));
+    regs[0][MPUREG_PWR_MGMT_0] = IIM423XX_PWR_MGMT_0_ACCEL_MODE_LN;
+    regs[0][MPUREG_WHO_AM_I] = ICM_WHOAMI;
+
+    packet_size = config.highres ? FIFO_20BYTES_PACKET_SIZE : FIFO_16BYTES_PACKET_SIZE;
+    period_ns = 1000000000ULL / config.odr_hz;
+    now_ns = 0;
+    next_sample_ns = period_ns;
+    sequence = 0;
+    rng_state = config.seed ? config.seed : 1;
+    fifo_head = 0;
+    fifo_len = 0;
+    fifo_full_flag = false;
+    raw_mode = false;
+    attached = NULL;
+    return 0;
+}
+
+int Fifo_Sim_Attach(struct inv_iim423xx *s, void (*cb)(inv_iim423xx_sensor_event_t *event))
+{
+    memset(s, 0, sizeof(*s));
+
+    s->transport.serif.context = NULL;
+    s->transport.serif.read_reg = sim_read_reg;
+    s->transport.serif.write_reg = sim_write_reg;
+    s->transport.serif.configure = NULL;
+    s->transport.serif.max_read = SIM_SERIF_MAX_TRANSFER;
+    s->transport.serif.max_write = SIM_SERIF_MAX_TRANSFER;
+    s->transport.serif.serif_type = (IIM423XX_SERIAL_IF_TYPE_t)config.serif_type;
+
+    s->sensor_event_cb = cb;
+    s->endianess_data = config.big_endian ? IIM423XX_INTF_CONFIG0_DATA_BIG_ENDIAN
+                                          : IIM423XX_INTF_CONFIG0_DATA_LITTLE_ENDIAN;
+    s->fifo_highres_enabled = config.highres;
+    s->fifo_is_used = INV_IIM423XX_FIFO_ENABLED;
+    s->accel_start_time_us = UINT32_MAX;        // 跳过上电稳定时间判断
+
+    attached = s;
+    return inv_iim423xx_init_transport(s);
+}
+
+void Fifo_Sim_Advance(uint32_t us)
+{
+    now_ns += (uint64_t)us * 1000U;
+    while (next_sample_ns <= now_ns) {
+        generate_packet();
+        next_sample_ns += period_ns;
+    }
+}
+
+void Fifo_Sim_LoadRaw(const uint8_t *bytes, uint32_t len, uint16_t reported_count, uint8_t int_status)
+{
+    if (len > FIFO_SIM_CAPACITY) {
+        len = FIFO_SIM_CAPACITY;
+    }
+    memcpy(fifo, bytes, len);
+    fifo_head = 0;
+    fifo_len = len;
+    raw_mode = true;
+    raw_count = reported_count;
+    raw_int_status = int_status;
+}
+
+const fifo_sim_stats_t* Fifo_Sim_GetStats(void)
+{
+    return &stats;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  串行接口回调
+ * -------------------------------------------------------------------------------------- */
+
+static int sim_read_reg(struct inv_iim423xx_serif *serif, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+    (void)serif;
+
+    if (reg == MPUREG_FIFO_DATA && regs[0][MPUREG_REG_BANK_SEL] == 0) {
+        /* 突发读不递增地址，镜像缓冲区越界的传输直接拒绝 */
+        stats.fifo_reads++;
+        if (len > stats.max_read_len) {
+            stats.max_read_len = len;
+        }
+        if (attached != NULL &&
+            (len > IIM423XX_FIFO_MIRRORING_SIZE || buf < attached->fifo_data ||
+             buf + len > attached->fifo_data + IIM423XX_FIFO_MIRRORING_SIZE)) {
+            stats.bound_violations++;
+            return -1;
+        }
+        read_fifo_data(buf, len);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = read_register((uint8_t)(reg + i));
+    }
+    return 0;
+}
+
+static int sim_write_reg(struct inv_iim423xx_serif *serif, uint8_t reg, const uint8_t *buf, uint32_t len)
+{
+    (void)serif;
+
+    for (uint32_t i = 0; i < len; i++) {
+        write_register((uint8_t)(reg + i), buf[i]);
+    }
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  寄存器模型
+ * -------------------------------------------------------------------------------------- */
+
+static uint8_t read_register(uint8_t reg)
+{
+    uint8_t bank = regs[0][MPUREG_REG_BANK_SEL];
+
+    if (reg == MPUREG_REG_BANK_SEL) {
+        return bank;
+    }
+    if (bank != 0) {
+        return regs[bank][reg];
+    }
+
+    uint16_t count = raw_mode ? raw_count : (uint16_t)(fifo_len / packet_size);
+    switch (reg) {
+    case MPUREG_INT_STATUS: {
+        uint8_t status;
+        if (raw_mode) {
+            status = raw_int_status;
+        } else {
+            status = (count >= config.watermark) ? BIT_INT_STATUS_FIFO_THS : 0;
+            if (fifo_full_flag) {
+                status |= BIT_INT_STATUS_FIFO_FULL;
+            }
+        }
+        fifo_full_flag = false;                 // 读清除
+        return status;
+    }
+    case MPUREG_FIFO_COUNTH:                    // 记录模式，FIFO_COUNT_ENDIAN = 小端
+        return (uint8_t)(count & 0xFF);
+    case MPUREG_FIFO_COUNTH + 1:
+        return (uint8_t)(count >> 8);
+    default:
+        return regs[0][reg];
+    }
+}
+
+static void write_register(uint8_t reg, uint8_t value)
+{
+    uint8_t bank = regs[0][MPUREG_REG_BANK_SEL];
+
+    if (reg == MPUREG_REG_BANK_SEL) {
+        regs[0][MPUREG_REG_BANK_SEL] = (value < SIM_BANKS) ? value : 0;
+        return;
+    }
+    if (bank != 0) {
+        regs[bank][reg] = value;
+        return;
+    }
+
+    switch (reg) {
+    case MPUREG_WHO_AM_I:                       // 只读 (I2C/I3C的semi-write)
+        break;
+    case MPUREG_SIGNAL_PATH_RESET:              // 复位位自清零，不保存
+        if (value & IIM423XX_SIGNAL_PATH_RESET_FIFO_FLUSH_EN) {
+            flush_fifo();
+        }
+        break;
+    case MPUREG_FIFO_CONFIG:
+        if ((value & BIT_FIFO_CONFIG_MODE_MASK) == IIM423XX_FIFO_CONFIG_MODE_BYPASS) {
+            flush_fifo();
+        }
+        regs[0][reg] = value;
+        break;
+    default:
+        regs[0][reg] = value;
+        break;
+    }
+}
+
+static void read_fifo_data(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        if (fifo_len == 0) {
+            buf[i] = config.empty_byte;
+            stats.empty_bytes++;
+            continue;
+        }
+        buf[i] = fifo[fifo_head];
+        fifo_head = (fifo_head + 1) % FIFO_SIM_CAPACITY;
+        fifo_len--;
+    }
+    if (raw_mode && fifo_len == 0) {
+        raw_count = 0;
+    }
+}
+
+static void flush_fifo(void)
+{
+    stats.flushes++;
+    stats.bytes_flushed += fifo_len;
+    fifo_head = 0;
+    fifo_len = 0;
+    raw_mode = false;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  发生器
+ * -------------------------------------------------------------------------------------- */
+
+static void generate_packet(void)
+{
+    uint8_t packet[FIFO_20BYTES_PACKET_SIZE];
+    uint8_t header = FIFO_SIM_HEADER_ACCEL;
+    uint32_t seq = sequence++;
+
+    if (fifo_len + packet_size > FIFO_SIM_CAPACITY) {
+        stats.packets_dropped++;
+        fifo_full_flag = true;
+        return;
+    }
+
+    memset(packet, 0, sizeof(packet));
+    if (config.highres) {
+        header |= FIFO_SIM_HEADER_20BITS;
+    }
+    if (config.fsync_period != 0 && (seq % config.fsync_period) == 0) {
+        header |= FIFO_SIM_HEADER_FSYNC;
+        stats.fsync_injected++;
+    }
+
+    /* 20位值 = 16位寄存器值 << 4 | 高分辨率半字节 */
+    float t = (float)((double)next_sample_ns * 1e-9);
+    float z_g = 1.0f + config.tone_g * sinf(2.0f * 3.14159265f * config.tone_hz * t);
+    int32_t z20 = (int32_t)lroundf(z_g * FIFO_SIM_LSB_PER_G * 16.0f);
+    int16_t x = (int16_t)(seq & 0x7FFF);
+    int16_t z = (int16_t)(z20 >> 4);
+    uint8_t z_nibble = (uint8_t)(z20 & 0x0F);
+    int16_t temperature = SIM_TEMPERATURE_RAW;
+
+    if (inject(config.msg_permille)) {
+        header = FIFO_SIM_HEADER_MSG;
+        stats.msg_injected++;
+    } else if (inject(config.invalid_permille)) {
+        x = z = INVALID_VALUE_FIFO;
+        temperature = config.highres ? INVALID_VALUE_FIFO : INVALID_VALUE_FIFO_1B;
+        stats.invalid_injected++;
+    }
+
+    uint8_t *p = packet;
+    *p++ = header;
+    put16(p, (uint16_t)x);
+    put16(p + 2, (uint16_t)(x == INVALID_VALUE_FIFO ? INVALID_VALUE_FIFO : 0));
+    put16(p + 4, (uint16_t)z);
+    p += FIFO_ACCEL_DATA_SIZE + FIFO_RESERVED_DATA_SIZE;
+    if (config.highres) {
+        put16(p, (uint16_t)temperature);
+        p += FIFO_TEMP_DATA_SIZE + FIFO_TEMP_HIGH_RES_SIZE;
+    } else {
+        *p = (uint8_t)temperature;
+        p += FIFO_TEMP_DATA_SIZE;
+    }
+    put16(p, (uint16_t)(next_sample_ns / 1000U));  // ODR时间戳 (1us分辨率，16位回绕)
+    p += FIFO_TS_FSYNC_SIZE;
+    if (config.highres) {
+        p[2] = (uint8_t)(z_nibble << 4);        // x/y/z高分辨率位在各字节高半字节
+    }
+
+    for (uint32_t i = 0; i < packet_size; i++) {
+        fifo[(fifo_head + fifo_len) % FIFO_SIM_CAPACITY] = packet[i];
+        fifo_len++;
+    }
+    stats.packets_generated++;
+}
+
+static void put16(uint8_t *p, uint16_t value)
+{
+    if (config.big_endian) {
+        p[0] = (uint8_t)(value >> 8);
+        p[1] = (uint8_t)value;
+    } else {
+        p[0] = (uint8_t)value;
+        p[1] = (uint8_t)(value >> 8);
+    }
+}
+
+static uint32_t next_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool inject(uint16_t permille)
+{
+    return permille != 0 && (next_random() % 1000U) < permille;
+}
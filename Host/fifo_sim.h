@@ -0,0 +1,115 @@
+/**
+ * @file fifo_sim.h
+ * @brief IIM-42352 FIFO寄存器模型与合成字节流发生器 (驱动FIFO解码的吞吐量/模糊测试)
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 以serif.read_reg/write_reg回调接入Iim423xx驱动，inv_iim423xx_get_data_from_fifo
+ * 在主机上走与目标板完全相同的寄存器访问路径：
+ *   INT_STATUS     FIFO包数 >= 水位线置FIFO_THS；满过置FIFO_FULL (读后清除)
+ *   FIFO_COUNTH/L  包数 (记录模式，小端)
+ *   FIFO_DATA      逐字节出队；FIFO为空时返回empty_byte (默认0x80，即仅MSG位的包头，与器件行为一致)
+ *   SIGNAL_PATH_RESET.FIFO_FLUSH / FIFO_CONFIG旁路  清空FIFO
+ *   REG_BANK_SEL   切换寄存器组，其余寄存器按组读写普通存储
+ *
+ * 发生器按配置的ODR生成16/20字节包 (ODR时间戳、可选FSYNC标记)：
+ *   X轴 = 包序号 (0..0x7FFF循环)，解码端据此检查连续性
+ *   Y轴 = 0，Z轴 = 1g + 正弦 (8192 LSB/g，20位模式低4位写入高分辨率半字节)
+ * 可按千分比注入三轴无效值 (0x8000/温度0x80) 和MSG包头 (0x80)。
+ *
+ * Fifo_Sim_LoadRaw直接装入任意字节和任意FIFO_COUNT，供模糊测试使用；
+ * FIFO_DATA读取长度超过IIM423XX_FIFO_MIRRORING_SIZE或目标地址越出s->fifo_data时
+ * 拒绝传输并计入bound_violations。
+ */
+
+#ifndef FIFO_SIM_H
+#define FIFO_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Iim423xxDriver_HL.h"
+
+#define FIFO_SIM_CAPACITY           2048        // 器件FIFO容量 (字节)
+#define FIFO_SIM_LSB_PER_G          8192.0f     // ±4g量程
+#define FIFO_SIM_HEADER_ACCEL       0x48        // accel | ODR时间戳
+#define FIFO_SIM_HEADER_FSYNC       0x04
+#define FIFO_SIM_HEADER_20BITS      0x10
+#define FIFO_SIM_HEADER_MSG         0x80
+
+/* 发生器配置 */
+typedef struct {
+    uint32_t odr_hz;                // 输出数据率
+    uint16_t watermark;             // 水位线 (包)
+    bool highres;                   // true: 20字节包
+    bool big_endian;                // 数据端序 (INTF_CONFIG0，器件默认大端)
+    uint8_t serif_type;             // IIM423XX_SERIAL_IF_TYPE_t (I2C/I3C每包多一次semi-write)
+    uint16_t fsync_period;          // 每N包一个FSYNC标记 (0 = 不生成)
+    uint16_t invalid_permille;      // 无效值包比例 (‰)
+    uint16_t msg_permille;          // MSG包头比例 (‰)
+    uint8_t empty_byte;             // FIFO为空时FIFO_DATA返回的字节 (模糊测试用非0x80值模拟总线错误)
+    float tone_hz;                  // Z轴正弦频率
+    float tone_g;                   // Z轴正弦幅值
+    uint32_t seed;                  // 注入用伪随机种子
+} fifo_sim_config_t;
+
+/* 统计 */
+typedef struct {
+    uint32_t packets_generated;     // 写入FIFO的包 (含无效值/MSG包)
+    uint32_t packets_dropped;       // FIFO满丢弃的包
+    uint32_t invalid_injected;
+    uint32_t msg_injected;
+    uint32_t fsync_injected;
+    uint32_t flushes;               // FIFO复位次数
+    uint32_t bytes_flushed;         // 复位时丢弃的字节
+    uint32_t fifo_reads;            // FIFO_DATA传输次数
+    uint32_t max_read_len;          // 单次FIFO_DATA传输最大长度
+    uint32_t empty_bytes;           // 从空FIFO读出的字节
+    uint32_t bound_violations;      // 越出镜像缓冲区的FIFO_DATA传输 (被拒绝)
+} fifo_sim_stats_t;
+
+/**
+ * @brief 默认配置：1kHz、水位线10、16字节包、大端、SPI4，不注入
+ */
+void Fifo_Sim_DefaultConfig(fifo_sim_config_t *cfg);
+
+/**
+ * @brief 复位寄存器模型 (PWR_MGMT_0 = accel LN)、清空FIFO和统计
+ * @return 0: 成功, -1: 配置无效
+ */
+int Fifo_Sim_Init(const fifo_sim_config_t *cfg);
+
+/**
+ * @brief 按配置初始化驱动实例并绑定到模型 (不执行inv_iim423xx_init的器件配置序列)
+ * @param s 驱动实例 (整体清零后设置serif、端序、包长并初始化寄存器缓存)
+ * @param cb 每包回调
+ * @return 0: 成功, <0: 传输层初始化失败
+ */
+int Fifo_Sim_Attach(struct inv_iim423xx *s, void (*cb)(inv_iim423xx_sensor_event_t *event));
+
+/**
+ * @brief 推进模型时间，按ODR生成包 (FIFO满时丢弃并置FIFO_FULL)
+ */
+void Fifo_Sim_Advance(uint32_t us);
+
+/**
+ * @brief 装入原始字节 (模糊测试)
+ * @param bytes FIFO内容 (超过FIFO_SIM_CAPACITY的部分截断)
+ * @param reported_count FIFO_COUNT寄存器返回的包数，与实际字节数无关
+ * @param int_status INT_STATUS寄存器值
+ */
+void Fifo_Sim_LoadRaw(const uint8_t *bytes, uint32_t len, uint16_t reported_count, uint8_t int_status);
+
+/**
+ * @brief 获取统计
+ */
+const fifo_sim_stats_t* Fifo_Sim_GetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIFO_SIM_H */
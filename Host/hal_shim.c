@@ -0,0 +1,195 @@
+/**
+ * @file hal_shim.c
+ * @brief 主机构建的HAL/计时垫片
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 只实现检测流水线实际用到的少量平台函数：
+ *   HAL_GetTick/HAL_Delay、SystemCoreClock、DWT计时 (dwt_timer.h在HOST_BUILD下改为外部函数)、
+ *   Iim423xx驱动要求的时间/延时/中断回调，以及CMSIS-DSP中只有汇编实现的arm_bitreversal_32。
+ * 周期计数基于CLOCK_MONOTONIC，"周期"即纳秒，SystemCoreClock固定为1GHz。
+ *
+ * 虚拟时间模式下毫秒/微秒时钟 (HAL_GetTick、DWT_Timer_GetTimeUs等) 只由Host_Shim_AdvanceUs推进，
+ * 离线喂样本时检测器的持续时间/冷却/超时按样本时间而不是主机运行时间计算；
+ * 周期计数仍为真实纳秒，剖析器统计的是主机上的实际耗时。
+ */
+
+#include "stm32f4xx_hal.h"
+#include "dwt_timer.h"
+#include "host_shim.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define HOST_CORE_CLOCK_HZ      1000000000U
+
+uint32_t SystemCoreClock = HOST_CORE_CLOCK_HZ;
+
+/* 私有变量 */
+static bool virtual_time = false;
+static uint64_t virtual_time_us = 0;
+static bool log_enabled = true;
+static uint32_t alarm_count = 0;
+
+/* 私有函数声明 */
+static uint64_t monotonic_ns(void);
+static uint64_t time_us(void);
+
+/* --------------------------------------------------------------------------------------
+ *  垫片控制
+ * -------------------------------------------------------------------------------------- */
+
+void Host_Shim_SetVirtualTime(bool enable)
+{
+    virtual_time = enable;
+    virtual_time_us = 0;
+}
+
+void Host_Shim_AdvanceUs(uint32_t us)
+{
+    virtual_time_us += us;
+}
+
+void Host_Shim_SetLogEnabled(bool enable)
+{
+    log_enabled = enable;
+}
+
+void Host_Shim_CountAlarm(void)
+{
+    alarm_count++;
+}
+
+uint32_t Host_Shim_GetAlarmCount(void)
+{
+    return alarm_count;
+}
+
+int host_printf(const char *format, ...)
+{
+    if (!log_enabled) {
+        return 0;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int n = vprintf(format, args);
+    va_end(args);
+    return n;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  HAL
+ * -------------------------------------------------------------------------------------- */
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(time_us() / 1000U);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    if (virtual_time) {
+        virtual_time_us += (uint64_t)Delay * 1000U;
+        return;
+    }
+    struct timespec ts = { (time_t)(Delay / 1000U), (long)(Delay % 1000U) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/* --------------------------------------------------------------------------------------
+ *  DWT计时
+ * -------------------------------------------------------------------------------------- */
+
+int DWT_Timer_Init(void)
+{
+    (void)monotonic_ns();
+    return 0;
+}
+
+uint32_t DWT_Timer_GetCycles(void)
+{
+    return (uint32_t)monotonic_ns();
+}
+
+uint32_t DWT_Timer_CyclesToUs(uint32_t cycles)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    if (cycles_per_us == 0) {
+        cycles_per_us = 1;
+    }
+    return cycles / cycles_per_us;
+}
+
+uint32_t DWT_Timer_ElapsedUs(uint32_t start_cycles)
+{
+    return DWT_Timer_CyclesToUs(DWT_Timer_GetCycles() - start_cycles);
+}
+
+uint64_t DWT_Timer_GetTimeUs(void)
+{
+    return time_us();
+}
+
+/* --------------------------------------------------------------------------------------
+ *  Iim423xx驱动平台函数 (主机上不访问传感器)
+ * -------------------------------------------------------------------------------------- */
+
+uint64_t inv_iim423xx_get_time_us(void)
+{
+    return time_us();
+}
+
+void inv_iim423xx_sleep_us(uint32_t us)
+{
+    if (virtual_time) {
+        virtual_time_us += us;
+        return;
+    }
+    struct timespec ts = { (time_t)(us / 1000000U), (long)(us % 1000000U) * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+void inv_helper_disable_irq(void)
+{
+}
+
+void inv_helper_enable_irq(void)
+{
+}
+
+/* --------------------------------------------------------------------------------------
+ *  CMSIS-DSP
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief arm_bitreversal2.S的C实现：表项为字节偏移，成对交换复数 (两个32位字)
+ */
+void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTab)
+{
+    for (uint32_t i = 0; i + 1 < bitRevLen; i += 2) {
+        uint32_t a = pBitRevTab[i] >> 2;
+        uint32_t b = pBitRevTab[i + 1] >> 2;
+        uint32_t tmp;
+
+        tmp = pSrc[a];     pSrc[a] = pSrc[b];         pSrc[b] = tmp;
+        tmp = pSrc[a + 1]; pSrc[a + 1] = pSrc[b + 1]; pSrc[b + 1] = tmp;
+    }
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t time_us(void)
+{
+    return virtual_time ? virtual_time_us : monotonic_ns() / 1000U;
+}
@@ -0,0 +1,18 @@
+/**
+ * @file host_log.h
+ * @brief 主机构建中强制包含到固件源文件 (-include)，把printf重定向到可关闭的host_printf
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 先包含stdio.h，源文件中之后的#include <stdio.h>不再展开，宏只影响调用处。
+ */
+
+#ifndef HOST_LOG_H
+#define HOST_LOG_H
+
+#include <stdio.h>
+#include "host_shim.h"
+
+#define printf host_printf
+
+#endif /* HOST_LOG_H */
@@ -0,0 +1,163 @@
+/**
+ * @file host_pipeline.c
+ * @brief 主机上驱动固件检测流水线
+ * @date 2026-10-19
+ * @version v1.0
+ */
+
+#include "host_pipeline.h"
+#include "host_shim.h"
+#include "fft_processor.h"
+#include "detection_params.h"
+#include "profiler.h"
+#include "latency_tracker.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLE_PERIOD_US        ((uint32_t)(1000000.0f / SAMPLING_FREQUENCY))
+#define SETTLE_SAMPLES          2000    // 复位后高通滤波器预热样本数 (5Hz截止，约10个时间常数)
+
+/* 私有变量 */
+static host_pipeline_stats_t stats;
+static host_pipeline_frame_cb_t frame_cb = NULL;
+static void *frame_cb_user = NULL;
+static uint32_t last_frame_count = 0;
+static uint32_t last_trigger_count = 0;
+
+/* 私有函数声明 */
+static int init_detectors(void);
+
+int Host_Pipeline_Init(bool verbose)
+{
+    int rc = 0;
+
+    Host_Shim_SetVirtualTime(true);
+    Host_Shim_SetLogEnabled(verbose);
+    memset(&stats, 0, sizeof(stats));
+
+    Detection_Params_Init();
+    Profiler_Init();
+
+#if ENABLE_DATA_PREPROCESSING
+    rc |= Highpass_Filter_Init();
+#endif
+    rc |= init_detectors();
+#if ENABLE_SYSTEM_STATE_MACHINE
+    rc |= System_State_Machine_Init();
+#endif
+
+    return (rc == 0) ? 0 : -1;
+}
+
+int Host_Pipeline_Reset(float32_t settle_level)
+{
+#if ENABLE_DATA_PREPROCESSING
+    Highpass_Filter_Reset();
+    for (uint32_t i = 0; i < SETTLE_SAMPLES; i++) {
+        (void)Highpass_Filter_Process(settle_level);
+    }
+#else
+    (void)settle_level;
+#endif
+    return (init_detectors() == 0) ? 0 : -1;
+}
+
+void Host_Pipeline_SetFrameCallback(host_pipeline_frame_cb_t cb, void *user)
+{
+    frame_cb = cb;
+    frame_cb_user = user;
+}
+
+void Host_Pipeline_PushSample(float32_t accel_z_g)
+{
+    Host_Shim_AdvanceUs(SAMPLE_PERIOD_US);
+    Vibration_Pipeline_ProcessSample(accel_z_g);
+
+    while (FFT_Worker_Pending()) {
+        FFT_Worker_Run();
+    }
+
+#if ENABLE_COARSE_DETECTION
+    uint32_t triggers = Coarse_Detector_GetInfo()->trigger_count;
+    if (triggers != last_trigger_count) {
+        stats.coarse_triggers += triggers - last_trigger_count;
+        last_trigger_count = triggers;
+    }
+#endif
+
+    uint32_t frames = FFT_GetFrameCount();
+    if (frames != last_frame_count) {
+        last_frame_count = frames;
+        stats.fft_frames++;
+#if ENABLE_FINE_DETECTION
+        const fine_detection_features_t *features = Fine_Detector_GetLastResult();
+        if (features->is_valid) {
+            if (features->classification == FINE_DETECTION_MINING) {
+                stats.fine_mining++;
+            } else {
+                stats.fine_normal++;
+            }
+            if (frame_cb != NULL) {
+                frame_cb(stats.samples, features, frame_cb_user);
+            }
+        }
+#endif
+    }
+
+#if ENABLE_SYSTEM_STATE_MACHINE
+    System_State_Machine_Process();
+#endif
+
+    stats.samples++;
+}
+
+void Host_Pipeline_PushBlock(const float32_t *samples, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        Host_Pipeline_PushSample(samples[i]);
+    }
+}
+
+const host_pipeline_stats_t* Host_Pipeline_GetStats(void)
+{
+    stats.alarms = Host_Shim_GetAlarmCount();
+    return &stats;
+}
+
+void Host_Pipeline_PrintStats(void)
+{
+    const host_pipeline_stats_t *s = Host_Pipeline_GetStats();
+
+    printf("PIPELINE: samples=%u (%.1f s) coarse_triggers=%u fft_frames=%u "
+           "fine_mining=%u fine_normal=%u alarms=%u\n",
+           s->samples, s->samples / SAMPLING_FREQUENCY, s->coarse_triggers, s->fft_frames,
+           s->fine_mining, s->fine_normal, s->alarms);
+#if ENABLE_SEQUENTIAL_DECISION
+    const sequential_decision_t *seq = Sequential_Decision_GetInfo();
+    printf("SEQUENTIAL: decisions=%u mining=%u normal=%u forced=%u avg_frames=%.2f ignored=%u\n",
+           seq->decisions, seq->decided_mining, seq->decided_normal, seq->forced,
+           seq->decisions ? (double)seq->total_frames / seq->decisions : 0.0, seq->ignored_frames);
+#endif
+}
+
+/**
+ * @brief 重新初始化粗检测/FFT/细检测/延迟跟踪 (参数、高通系数和状态机保持不变)
+ */
+static int init_detectors(void)
+{
+    int rc = 0;
+
+    last_frame_count = 0;
+    last_trigger_count = 0;
+    Latency_Tracker_Init();
+
+#if ENABLE_COARSE_DETECTION
+    rc |= Coarse_Detector_Init();
+#endif
+    rc |= FFT_Init(true, true);
+    FFT_SetTriggerMode(true);
+#if ENABLE_FINE_DETECTION
+    rc |= Fine_Detector_Init();
+#endif
+    return rc;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file host_pipeline.h
+ * @brief 主机上驱动固件检测流水线 (libdetection.a对外接口)
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 按固件主循环的顺序推进同一份算法代码：
+ *   Vibration_Pipeline_ProcessSample (高通 -> 粗检测 -> FFT采集)
+ *   -> FFT_Worker_Run直到空闲 (变换 -> 细检测 -> 上报)
+ *   -> System_State_Machine_Process
+ * 每个样本推进1/SAMPLING_FREQUENCY的虚拟时间，时间相关的判定与目标板一致。
+ */
+
+#ifndef HOST_PIPELINE_H
+#define HOST_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "example-raw-data.h"
+
+/* 运行统计 */
+typedef struct {
+    uint32_t samples;               // 已处理样本数
+    uint32_t coarse_triggers;       // 粗检测触发次数
+    uint32_t fft_frames;            // 完成的FFT帧数
+    uint32_t fine_mining;           // 细检测判定挖掘的帧数
+    uint32_t fine_normal;           // 细检测判定正常的帧数
+    uint32_t alarms;                // 状态机发起的报警次数
+} host_pipeline_stats_t;
+
+/**
+ * @brief 细检测结果回调 (每个完成分类的FFT帧调用一次)
+ * @param sample_index 帧完成时的样本序号 (从0开始)
+ */
+typedef void (*host_pipeline_frame_cb_t)(uint32_t sample_index,
+                                         const fine_detection_features_t *features,
+                                         void *user);
+
+/**
+ * @brief 初始化全部检测模块 (顺序与main.c一致)，切换到虚拟时间
+ * @param verbose true: 保留固件模块的printf输出
+ * @return 0: 成功, <0: 某个模块初始化失败
+ * @note 高通滤波器延迟线为模块内静态量，同一进程内只应初始化一次
+ */
+int Host_Pipeline_Init(bool verbose);
+
+/**
+ * @brief 逐事件回放前清空检测状态：高通延迟线、粗检测基线/窗口、FFT缓冲
+ * @param settle_level 高通滤波器以该电平预热 (通常为下一个样本，含重力分量)，
+ *                     避免0 -> 1g阶跃响应在前导段触发粗检测
+ * @return 0: 成功, <0: 失败
+ * @note 运行时参数、统计和虚拟时钟不清零；状态机不复位，沿自身超时回到监测状态
+ */
+int Host_Pipeline_Reset(float32_t settle_level);
+
+/**
+ * @brief 设置细检测结果回调 (NULL取消)
+ */
+void Host_Pipeline_SetFrameCallback(host_pipeline_frame_cb_t cb, void *user);
+
+/**
+ * @brief 推入一个Z轴样本 (g)
+ */
+void Host_Pipeline_PushSample(float32_t accel_z_g);
+
+/**
+ * @brief 推入一段样本
+ */
+void Host_Pipeline_PushBlock(const float32_t *samples, uint32_t count);
+
+/**
+ * @brief 获取运行统计
+ */
+const host_pipeline_stats_t* Host_Pipeline_GetStats(void);
+
+/**
+ * @brief 打印运行统计
+ */
+void Host_Pipeline_PrintStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PIPELINE_H */
@@ -0,0 +1,49 @@
+/**
+ * @file host_shim.h
+ * @brief 主机构建垫片控制接口
+ * @date 2026-10-19
+ * @version v1.0
+ */
+
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief 切换虚拟时间模式 (并把虚拟时钟清零)
+ * @param enable true: 毫秒/微秒时钟只由Host_Shim_AdvanceUs推进; false: 跟随主机单调时钟
+ */
+void Host_Shim_SetVirtualTime(bool enable);
+
+/**
+ * @brief 推进虚拟时钟
+ */
+void Host_Shim_AdvanceUs(uint32_t us);
+
+/**
+ * @brief 开关固件模块的printf输出 (固件源文件经host_log.h重定向到host_printf)
+ */
+void Host_Shim_SetLogEnabled(bool enable);
+
+/**
+ * @brief 报警计数 (host_stubs.c中的Trigger_Alarm_Cycle调用)
+ */
+void Host_Shim_CountAlarm(void);
+uint32_t Host_Shim_GetAlarmCount(void);
+
+/**
+ * @brief 可关闭的printf
+ */
+int host_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SHIM_H */
@@ -0,0 +1,55 @@
+/**
+ * @file host_stubs.c
+ * @brief 主机构建中不参与检测算法的外设模块空实现
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 上位机流上报和LoRa报警在主机上没有链路，算法模块对它们的调用在这里吞掉。
+ * 报警视为立即发送成功，状态机走完ALARM_SENDING -> ALARM_COMPLETE而不是等待10秒超时。
+ */
+
+#include "host_protocol.h"
+#include "host_shim.h"
+
+void Host_Protocol_StreamSpectrum(uint32_t timestamp_ms, float32_t dominant_freq,
+                                  const float32_t *spectrum, uint16_t points)
+{
+    (void)timestamp_ms;
+    (void)dominant_freq;
+    (void)spectrum;
+    (void)points;
+}
+
+#if ENABLE_FINE_DETECTION
+void Host_Protocol_StreamDetection(const fine_detection_features_t *features)
+{
+    (void)features;
+}
+#endif
+
+/* 手动报警只来自上位机命令，主机构建中不会调用，也不确认状态机的报警 */
+void Trigger_Alarm_Cycle(void)
+{
+}
+
+/* 挖掘报警：计数并立即确认，状态机不在ALARM_SENDING中等待 */
+static void alarm_sent(void)
+{
+    Host_Shim_CountAlarm();
+#if ENABLE_SYSTEM_STATE_MACHINE
+    System_State_Machine_SetAlarmStatus(1);
+#endif
+}
+
+#if ENABLE_FINE_DETECTION
+void Trigger_Alarm_Detection(const fine_detection_features_t *features)
+{
+    (void)features;
+    alarm_sent();
+}
+#else
+void Trigger_Alarm_Detection(void)
+{
+    alarm_sent();
+}
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file power_sim.c
+ * @brief 回放固件PWR_SEG分段记录，按不同电流模型/电池参数预测平均电流和电池寿命
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 用法: power_sim [-b mAh] [-u fraction] [-p 参数集文件] [记录|-]
+ *   记录   固件串口日志 (ENABLE_POWER_TRACE=1)，只解析含"PWR_SEG,"的行，其余行忽略
+ *   -b     电池容量 (默认2600 mAh)
+ *   -u     可用容量比例 (默认0.8，低温/截止电压/自放电余量)
+ *   -p     参数集文件，每行: 名称 容量mAh run sleep stop ln lp lora uart_tx (mA，"-"为默认值)
+ *          未给出时只评估默认模型 (power_account.c / LP_CURRENT_*)
+ *
+ * 分段格式见power_account.h。负载时间与电流模型分离，同一份记录可评估不同器件/配置下的能耗。
+ */
+
+#include "power_account.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POWER_SIM_MAX_SETS          16
+#define POWER_SIM_NAME_LEN          32
+#define POWER_SIM_DEFAULT_MAH       2600.0f
+#define POWER_SIM_DEFAULT_USABLE    0.8f
+
+/* 参数集 */
+typedef struct {
+    char name[POWER_SIM_NAME_LEN];
+    float32_t capacity_mah;
+    power_model_t model;
+} power_sim_set_t;
+
+/* 私有变量 */
+static power_sim_set_t sets[POWER_SIM_MAX_SETS];
+static int set_count = 0;
+static uint64_t total_us = 0;
+static uint64_t load_us[POWER_LOAD_COUNT];
+static uint64_t state_us[STATE_COUNT];
+static uint64_t state_load_us[STATE_COUNT][POWER_LOAD_COUNT];
+static uint32_t segments = 0;
+
+/* 私有函数声明 */
+static int load_sets(const char *path, float32_t default_mah);
+static int parse_segment(const char *line);
+static void print_report(float32_t usable);
+
+int main(int argc, char **argv)
+{
+    float32_t capacity_mah = POWER_SIM_DEFAULT_MAH;
+    float32_t usable = POWER_SIM_DEFAULT_USABLE;
+    const char *set_path = NULL;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            capacity_mah = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            usable = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            set_path = argv[++i];
+        } else if (path == NULL) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-b mAh] [-u fraction] [-p param_sets] [trace|-]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (capacity_mah <= 0.0f || usable <= 0.0f || usable > 1.0f) {
+        fprintf(stderr, "invalid battery capacity or usable fraction\n");
+        return 2;
+    }
+
+    if (set_path != NULL) {
+        if (load_sets(set_path, capacity_mah) != 0) {
+            return 2;
+        }
+    } else {
+        strcpy(sets[0].name, "default");
+        sets[0].capacity_mah = capacity_mah;
+        Power_Account_DefaultModel(&sets[0].model);
+        set_count = 1;
+    }
+
+    FILE *fp = (path == NULL || strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    char line[512];
+    uint32_t bad = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        const char *seg = strstr(line, "PWR_SEG,");
+        if (seg != NULL && parse_segment(seg + 8) != 0) {
+            bad++;
+        }
+    }
+    if (fp != stdin) {
+        fclose(fp);
+    }
+
+    if (bad > 0) {
+        fprintf(stderr, "skipped %u malformed PWR_SEG lines\n", bad);
+    }
+    if (total_us == 0) {
+        fprintf(stderr, "no PWR_SEG segments in trace\n");
+        return 1;
+    }
+
+    print_report(usable);
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------
+ *  私有函数
+ * -------------------------------------------------------------------------------------- */
+
+/**
+ * @brief 读取参数集文件 ("#"开头为注释)
+ */
+static int load_sets(const char *path, float32_t default_mah)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    int line_no = 0;
+
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char *tok[2 + POWER_LOAD_COUNT];
+        int n = 0;
+
+        line_no++;
+        for (char *t = strtok(line, " \t\r\n"); t != NULL && n < 2 + POWER_LOAD_COUNT; t = strtok(NULL, " \t\r\n")) {
+            tok[n++] = t;
+        }
+        if (n == 0 || tok[0][0] == '#') {
+            continue;
+        }
+        if (set_count >= POWER_SIM_MAX_SETS) {
+            fprintf(stderr, "%s:%d: too many parameter sets (max %d)\n", path, line_no, POWER_SIM_MAX_SETS);
+            fclose(fp);
+            return -1;
+        }
+
+        power_sim_set_t *set = &sets[set_count++];
+        snprintf(set->name, sizeof(set->name), "%s", tok[0]);
+        set->capacity_mah = (n > 1 && strcmp(tok[1], "-") != 0) ? strtof(tok[1], NULL) : default_mah;
+        Power_Account_DefaultModel(&set->model);
+        for (int i = 0; i < POWER_LOAD_COUNT && 2 + i < n; i++) {
+            if (strcmp(tok[2 + i], "-") != 0) {
+                set->model.load_ma[i] = strtof(tok[2 + i], NULL);
+            }
+        }
+        if (set->capacity_mah <= 0.0f) {
+            fprintf(stderr, "%s:%d: invalid capacity\n", path, line_no);
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+
+    if (set_count == 0) {
+        fprintf(stderr, "%s: no parameter sets\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 解析"PWR_SEG,"之后的字段并累加
+ * @return 0: 成功, -1: 字段不全或状态越界
+ */
+static int parse_segment(const char *line)
+{
+    unsigned long long v[3 + POWER_LOAD_COUNT];
+    const char *p = line;
+    char *end;
+
+    for (int i = 0; i < 3 + POWER_LOAD_COUNT; i++) {
+        v[i] = strtoull(p, &end, 10);
+        if (end == p || (i < 2 + POWER_LOAD_COUNT && *end != ',')) {
+            return -1;
+        }
+        p = end + 1;
+    }
+
+    uint32_t state = (uint32_t)v[1];
+    if (state >= STATE_COUNT) {
+        return -1;
+    }
+
+    total_us += v[2];
+    state_us[state] += v[2];
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        load_us[i] += v[3 + i];
+        state_load_us[state][i] += v[3 + i];
+    }
+    segments++;
+    return 0;
+}
+
+static void print_report(float32_t usable)
+{
+    const power_model_t *ref = &sets[0].model;
+    float32_t total_s = (float32_t)total_us * 1e-6f;
+
+    printf("trace: %u segments, %.1f s (%.2f h)\n", segments, total_s, total_s / 3600.0f);
+
+    printf("\n%-10s %8s %12s\n", "load", "duty%", "on_s");
+    for (int i = 0; i < POWER_LOAD_COUNT; i++) {
+        printf("%-10s %8.3f %12.3f\n", Power_Account_LoadName((power_load_t)i),
+               100.0 * (double)load_us[i] / (double)total_us, (double)load_us[i] * 1e-6);
+    }
+
+    printf("\n%-6s %8s %12s %10s   (model \"%s\")\n", "state", "time%", "mAs", "avg_mA", sets[0].name);
+    for (int s = 0; s < STATE_COUNT; s++) {
+        if (state_us[s] == 0) {
+            continue;
+        }
+        float32_t mas = Power_Account_Charge(state_load_us[s], ref);
+        printf("%-6d %8.3f %12.3f %10.3f\n", s, 100.0 * (double)state_us[s] / (double)total_us,
+               mas, mas / ((float32_t)state_us[s] * 1e-6f));
+    }
+
+    printf("\n%-16s %9s %10s %10s %10s   (usable %.0f%%)\n",
+           "parameter_set", "mAh", "avg_mA", "mAh/day", "life_days", usable * 100.0f);
+    for (int k = 0; k < set_count; k++) {
+        float32_t avg_ma = Power_Account_Charge(load_us, &sets[k].model) / total_s;
+        float32_t mah_day = avg_ma * 24.0f;
+        float32_t days = (avg_ma > 0.0f) ? sets[k].capacity_mah * usable / mah_day : 0.0f;
+        printf("%-16s %9.0f %10.4f %10.2f %10.1f\n", sets[k].name, sets[k].capacity_mah,
+               avg_ma, mah_day, days);
+    }
+}
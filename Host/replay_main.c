@@ -0,0 +1,316 @@
+/**
+ * @file replay_main.c
+ * @brief 回放语料逐事件通过固件检测流水线，输出分类/置信度/延迟和吞吐量
+ * @date 2026-10-19
+ * @version v1.0
+ *
+ * 用法: replay [-v] [-c] [-P id=value]... [语料|-]
+ *   语料格式见events_to_corpus.py；每个事件的首样本之前清空检测状态 (Host_Pipeline_Reset)
+ *   -P  覆盖运行时参数 (ID见detection_params.h，如 -P 0x01=2.5)，用于阈值调优
+ *   -c  CSV输出 (每事件一行)
+ *   -v  保留固件模块的调试输出
+ *
+ * 结果: mining = 至少一帧判定挖掘; normal = 有FFT帧但无挖掘; none = 粗检测未触发/无帧。
+ * 延迟按样本时间计算，起点为语料中的事件起点 (前导段之后)。
+ */
+
+#include "host_pipeline.h"
+#include "detection_params.h"
+#include "fft_processor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_NAME_LEN         64
+#define REPLAY_NONE             0xFFFFFFFFU
+
+/* 单个事件的回放结果 */
+typedef struct {
+    char name[REPLAY_NAME_LEN];
+    char expected[16];
+    uint32_t onset;                 // 事件起点 (相对事件首样本)
+    uint32_t first_sample;          // 事件首样本的全局序号
+    uint32_t samples;
+    uint32_t coarse_triggers;
+    uint32_t first_trigger;         // 首次粗检测触发 (全局序号, REPLAY_NONE=无)
+    uint32_t frames_mining;
+    uint32_t frames_normal;
+    uint32_t first_mining;          // 首个挖掘帧 (全局序号, REPLAY_NONE=无)
+    float32_t max_confidence;
+    double host_seconds;
+} replay_event_t;
+
+/* 汇总 */
+typedef struct {
+    uint32_t events;
+    uint32_t tp, fn, fp, tn, unlabeled;
+    uint64_t samples;
+    double host_seconds;
+} replay_summary_t;
+
+/* 私有变量 */
+static replay_event_t current;
+static replay_summary_t summary;
+static bool csv = false;
+static bool event_open = false;
+static float32_t *event_samples = NULL;     // 当前事件的样本 (读完整个事件再计时回放)
+static uint32_t event_capacity = 0;
+
+/* 私有函数声明 */
+static void begin_event(const char *line);
+static void end_event(void);
+static int append_sample(float32_t value);
+static void run_event(void);
+static void on_frame(uint32_t sample_index, const fine_detection_features_t *features, void *user);
+static int apply_param(const char *arg);
+static const char* result_name(const replay_event_t *ev);
+static void format_ms(char *buf, size_t size, const replay_event_t *ev, uint32_t index);
+static double now_seconds(void);
+
+int main(int argc, char **argv)
+{
+    bool verbose = false;
+    const char *path = NULL;
+    const char *params[32];
+    int param_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc && param_count < 32) {
+            params[param_count++] = argv[++i];
+        } else if (path == NULL) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-v] [-c] [-P id=value]... [corpus|-]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (Host_Pipeline_Init(verbose) != 0) {
+        fprintf(stderr, "pipeline init failed\n");
+        return 1;
+    }
+    for (int i = 0; i < param_count; i++) {
+        if (apply_param(params[i]) != 0) {
+            return 2;
+        }
+    }
+    Host_Pipeline_SetFrameCallback(on_frame, NULL);
+
+    FILE *fp = (path == NULL || strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (fp == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    if (csv) {
+        printf("event,expected,result,confidence,frames_mining,frames_normal,coarse_triggers,"
+               "coarse_ms,detect_ms,samples,host_ms\n");
+    } else {
+        printf("%-32s %-7s %-7s %6s %7s %6s %10s %10s %9s\n",
+               "event", "expect", "result", "conf", "mine/nm", "coarse", "coarse_ms", "detect_ms", "host_ms");
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (strncmp(line, "event", 5) == 0) {
+            begin_event(line);
+            continue;
+        }
+        char *end;
+        float value = strtof(line, &end);
+        if (end == line) {
+            continue;
+        }
+        if (!event_open) {
+            begin_event("event stream - 0");
+        }
+        if (append_sample(value) != 0) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+    }
+    end_event();
+    if (fp != stdin) {
+        fclose(fp);
+    }
+    free(event_samples);
+
+    uint32_t labeled = summary.tp + summary.fn + summary.fp + summary.tn;
+    printf("REPLAY: %u events, %u labeled: TP=%u FN=%u FP=%u TN=%u accuracy=%.1f%%\n",
+           summary.events, labeled, summary.tp, summary.fn, summary.fp, summary.tn,
+           labeled ? 100.0 * (summary.tp + summary.tn) / labeled : 0.0);
+    printf("REPLAY: %llu samples (%.1f s signal) in %.3f s host time, %.2f Msamples/s\n",
+           (unsigned long long)summary.samples, summary.samples / SAMPLING_FREQUENCY,
+           summary.host_seconds,
+           summary.host_seconds > 0.0 ? summary.samples / summary.host_seconds / 1e6 : 0.0);
+    Host_Pipeline_PrintStats();
+    return 0;
+}
+
+static void begin_event(const char *line)
+{
+    end_event();
+
+    memset(&current, 0, sizeof(current));
+    strcpy(current.name, "?");
+    strcpy(current.expected, "-");
+    sscanf(line, "event %63s %15s %u", current.name, current.expected, &current.onset);
+    current.first_trigger = REPLAY_NONE;
+    current.first_mining = REPLAY_NONE;
+    event_open = true;
+}
+
+static void end_event(void)
+{
+    if (!event_open) {
+        return;
+    }
+    run_event();
+    event_open = false;
+
+    const char *result = result_name(&current);
+    bool detected = (current.first_mining != REPLAY_NONE);
+    summary.events++;
+    summary.samples += current.samples;
+    summary.host_seconds += current.host_seconds;
+    if (strcmp(current.expected, "mining") == 0) {
+        detected ? summary.tp++ : summary.fn++;
+    } else if (strcmp(current.expected, "normal") == 0) {
+        detected ? summary.fp++ : summary.tn++;
+    } else {
+        summary.unlabeled++;
+    }
+
+    char coarse_ms[16];
+    char detect_ms[16];
+    format_ms(coarse_ms, sizeof(coarse_ms), &current, current.first_trigger);
+    format_ms(detect_ms, sizeof(detect_ms), &current, current.first_mining);
+    if (csv) {
+        printf("%s,%s,%s,%.3f,%u,%u,%u,%s,%s,%u,%.3f\n",
+               current.name, current.expected, result, current.max_confidence,
+               current.frames_mining, current.frames_normal, current.coarse_triggers,
+               coarse_ms, detect_ms, current.samples, current.host_seconds * 1000.0);
+    } else {
+        char frames[16];
+        snprintf(frames, sizeof(frames), "%u/%u", current.frames_mining, current.frames_normal);
+        printf("%-32s %-7s %-7s %6.3f %7s %6u %10s %10s %9.3f\n",
+               current.name, current.expected, result, current.max_confidence, frames,
+               current.coarse_triggers, coarse_ms, detect_ms, current.host_seconds * 1000.0);
+    }
+}
+
+static int append_sample(float32_t value)
+{
+    if (current.samples == event_capacity) {
+        uint32_t capacity = event_capacity ? event_capacity * 2 : 65536;
+        float32_t *grown = realloc(event_samples, capacity * sizeof(float32_t));
+        if (grown == NULL) {
+            return -1;
+        }
+        event_samples = grown;
+        event_capacity = capacity;
+    }
+    event_samples[current.samples++] = value;
+    return 0;
+}
+
+/**
+ * @brief 以事件首样本电平复位后逐样本推入流水线，只对流水线本身计时
+ */
+static void run_event(void)
+{
+    if (current.samples == 0) {
+        return;
+    }
+
+    Host_Pipeline_Reset(event_samples[0]);
+    current.first_sample = Host_Pipeline_GetStats()->samples;
+
+    double start = now_seconds();
+    for (uint32_t i = 0; i < current.samples; i++) {
+        uint32_t triggers = Host_Pipeline_GetStats()->coarse_triggers;
+        Host_Pipeline_PushSample(event_samples[i]);
+        if (Host_Pipeline_GetStats()->coarse_triggers != triggers) {
+            current.coarse_triggers++;
+            if (current.first_trigger == REPLAY_NONE) {
+                current.first_trigger = current.first_sample + i;
+            }
+        }
+    }
+    current.host_seconds = now_seconds() - start;
+}
+
+static void on_frame(uint32_t sample_index, const fine_detection_features_t *features, void *user)
+{
+    (void)user;
+    if (!event_open) {
+        return;
+    }
+    if (features->confidence_score > current.max_confidence) {
+        current.max_confidence = features->confidence_score;
+    }
+    if (features->classification == FINE_DETECTION_MINING) {
+        current.frames_mining++;
+        if (current.first_mining == REPLAY_NONE) {
+            current.first_mining = sample_index;
+        }
+    } else {
+        current.frames_normal++;
+    }
+}
+
+/**
+ * @brief 解析 id=value 并写入运行时参数 (与HOST_CMD_SET_PARAM同样做范围检查)
+ */
+static int apply_param(const char *arg)
+{
+    char *end;
+    unsigned long id = strtoul(arg, &end, 0);
+    if (*end != '=') {
+        fprintf(stderr, "bad parameter '%s' (expected id=value)\n", arg);
+        return -1;
+    }
+    float value = strtof(end + 1, NULL);
+    int rc = Detection_Params_SetValue((uint8_t)id, value);
+    if (rc != 0) {
+        fprintf(stderr, "parameter 0x%02lX=%g rejected (%d)\n", id, value, rc);
+        return -1;
+    }
+    return 0;
+}
+
+static const char* result_name(const replay_event_t *ev)
+{
+    if (ev->frames_mining > 0) {
+        return "mining";
+    }
+    return (ev->frames_normal > 0) ? "normal" : "none";
+}
+
+/**
+ * @brief 全局样本序号 -> 相对事件起点的毫秒数 (负值表示在前导段内，无记录时为"-")
+ */
+static void format_ms(char *buf, size_t size, const replay_event_t *ev, uint32_t index)
+{
+    if (index == REPLAY_NONE) {
+        snprintf(buf, size, "-");
+        return;
+    }
+    double rel = (double)index - (double)ev->first_sample - (double)ev->onset;
+    snprintf(buf, size, "%.0f", rel * 1000.0 / SAMPLING_FREQUENCY);
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
@@ -722,19 +722,28 @@ int inv_iim423xx_get_data_from_fifo(struct inv_iim423xx * s)
 
 	if((int_status & BIT_INT_STATUS_FIFO_THS) || (int_status & BIT_INT_STATUS_FIFO_FULL)) {
 		
+		if(int_status & BIT_INT_STATUS_FIFO_FULL)
+			s->fifo_full_count++;
+
 		/* FIFO record mode configured at driver init, so we read packet number, not byte count */
 		status |= inv_iim423xx_read_reg(s, MPUREG_FIFO_COUNTH, 2, data);
 		if(status != INV_ERROR_SUCCESS)
 			return status;
 		inv_iim423xx_format_data(IIM423XX_INTF_CONFIG0_DATA_LITTLE_ENDIAN, data, &packet_count);
 
+		if(s->fifo_highres_enabled)
+			packet_size = FIFO_20BYTES_PACKET_SIZE;
+
+		/* A corrupted FIFO_COUNT (or 20-byte packets) must not overflow the mirror; 
+		 * packets left in the FIFO are read on the next watermark interrupt */
+		if (packet_count > (IIM423XX_FIFO_MIRRORING_SIZE) / packet_size)
+			packet_count = (IIM423XX_FIFO_MIRRORING_SIZE) / packet_size;
+
 		if (packet_count > 0) {
 			/* Read FIFO only when data is expected in FIFO */
 			/* fifo_idx type variable must be large enough to parse the FIFO_MIRRORING_SIZE */
 			uint16_t fifo_idx = 0;
-
-			if(s->fifo_highres_enabled)
-				packet_size = FIFO_20BYTES_PACKET_SIZE;
+			uint16_t fifo_len = packet_count * packet_size;
 
 			if(s->transport.serif.serif_type == IIM423XX_UI_I3C) {
 				/* in case of I3C, need to read packet by packet since INT is embedded on protocol so this can 
@@ -769,6 +778,13 @@ int inv_iim423xx_get_data_from_fifo(struct inv_iim423xx * s)
 				
 				header = (fifo_header_t *) &s->fifo_data[fifo_idx];
 				
+				/* Header flags describing a longer packet than what is left (corrupted data, 
+				 * 20-bit flag in 16-byte mode) would make the decoder read past the FIFO data */
+				if (fifo_idx + (header->bits.twentybits_bit ? FIFO_20BYTES_PACKET_SIZE : FIFO_16BYTES_PACKET_SIZE) > fifo_len) {
+					inv_iim423xx_reset_fifo(s);
+					return INV_ERROR_SIZE;
+				}
+				
 				fifo_idx += FIFO_HEADER_SIZE;
 				
 				/* Decode packet */
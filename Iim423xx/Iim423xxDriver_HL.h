@@ -163,6 +163,7 @@ struct inv_iim423xx {
 	uint8_t endianess_data;                                       /**< internal status of data endianess mode to report correctly data */
 	uint8_t fifo_highres_enabled;                                 /**< FIFO packets are 20 bytes long */
 	INV_IIM423XX_FIFO_CONFIG_t fifo_is_used;                      /**< Data are get from FIFO or from sensor registers. By default Fifo is used*/
+	uint32_t fifo_full_count;                                     /**< Number of FIFO reads that found FIFO_FULL set (samples lost) */
 	
 	#if (!INV_IIM423XX_LIGHTWEIGHT_DRIVER)
 		/* First FSYNC event after enable is irrelevant 
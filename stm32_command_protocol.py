@@ -0,0 +1,690 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+STM32 上位机帧命令协议客户端 (对应固件 host_protocol.c)
+
+帧格式 (小端):
+    AA 55 | CMD(1) | LEN(2) | PAYLOAD(LEN) | CRC16(2)
+    CRC16 为 Modbus CRC (多项式0xA001, 初值0xFFFF), 覆盖 CMD+LEN+PAYLOAD
+应答帧: CMD = 请求CMD | 0x80, PAYLOAD[0] = 状态码
+
+用法示例:
+    python stm32_command_protocol.py COM8 get-all
+    python stm32_command_protocol.py COM8 set 0x01 3.0
+    python stm32_command_protocol.py COM8 stats
+    python stm32_command_protocol.py COM8 telemetry
+    python stm32_command_protocol.py COM8 loop         # 主循环空闲率/中断延迟
+    python stm32_command_protocol.py COM8 trace        # 最近的状态机转换记录
+    python stm32_command_protocol.py COM8 profile [reset]  # 分阶段DWT耗时统计
+    python stm32_command_protocol.py COM8 latency      # 粗检测触发到报警帧发出的端到端延迟
+    python stm32_command_protocol.py COM8 sysmon       # CPU负载/栈高水位/各状态负载
+    python stm32_command_protocol.py COM8 bench        # DSP内核周期基准 (表格与Host/dsp_bench一致)
+    python stm32_command_protocol.py COM8 replay [mining_events.json]  # 记录事件经UART注入目标板检测链
+    python stm32_command_protocol.py COM8 monitor      # 打印周期遥测帧
+    python stm32_command_protocol.py COM8 linktest 921600 1000000 512
+"""
+
+import os
+import struct
+import sys
+import time
+
+import serial
+
+FRAME_HEADER = b'\xAA\x55'
+RESPONSE_FLAG = 0x80
+
+# 命令码
+CMD_TRIGGER_ALARM = 0x10
+CMD_GET_STATUS = 0x11
+CMD_LOW_POWER_STATS = 0x20
+CMD_SET_MODE_CONTINUOUS = 0x21
+CMD_SET_MODE_LOW_POWER = 0x22
+CMD_GET_PARAM = 0x30
+CMD_SET_PARAM = 0x31
+CMD_GET_ALL_PARAMS = 0x32
+CMD_RESET_PARAMS = 0x33
+CMD_GET_STATS = 0x40
+CMD_GET_TELEMETRY = 0x41
+CMD_GET_LOOP_STATS = 0x42
+CMD_GET_STATE_TRACE = 0x43
+CMD_GET_PROFILE = 0x44
+CMD_GET_LATENCY = 0x45
+CMD_GET_SYSMON = 0x46
+CMD_RUN_DSP_BENCH = 0x47
+CMD_REPLAY_CONTROL = 0x48
+CMD_REPLAY_SAMPLES = 0x49
+CMD_STREAM_CONTROL = 0x50
+CMD_STREAM_SPECTRUM = 0x51
+CMD_STREAM_DETECTION = 0x52
+CMD_STREAM_TELEMETRY = 0x53
+CMD_SET_BAUD = 0x60
+CMD_PING = 0x61
+CMD_LINK_TEST = 0x62
+CMD_LINK_TEST_DATA = 0x63
+CMD_LINK_TEST_RESULT = 0x64
+
+DEFAULT_BAUD = 115200
+SUPPORTED_BAUDS = (115200, 230400, 460800, 921600, 1000000, 2000000)
+
+# 流数据掩码
+STREAM_SPECTRUM = 0x01
+STREAM_DETECTION = 0x02
+STREAM_TELEMETRY = 0x04
+
+STATUS_NAMES = {
+    0x00: "OK",
+    0x01: "UNKNOWN_CMD",
+    0x02: "BAD_LENGTH",
+    0x03: "UNKNOWN_PARAM",
+    0x04: "OUT_OF_RANGE",
+    0x05: "BUSY",
+}
+
+# 参数ID (与 detection_params.h 一致)
+PARAM_NAMES = {
+    0x01: "trigger_multiplier",
+    0x02: "baseline_rms_threshold",
+    0x03: "rms_window_size",
+    0x04: "trigger_duration_ms",
+    0x05: "cooldown_time_ms",
+    0x10: "low_freq_min",
+    0x11: "low_freq_max",
+    0x12: "mid_freq_min",
+    0x13: "mid_freq_max",
+    0x14: "high_freq_min",
+    0x15: "high_freq_max",
+    0x16: "low_freq_threshold",
+    0x17: "mid_freq_threshold",
+    0x18: "dominant_freq_max",
+    0x19: "centroid_max",
+    0x1A: "confidence_threshold",
+}
+
+
+# 主循环事件名 (与 event_loop.h event_id_t 一致)
+EVENT_NAMES = ("SENSOR_FIFO", "HOST_RX", "HOST_TX", "LORA_RX", "LORA_TX", "RTC_WAKEUP", "DSP_JOB", "TICK")
+
+# 状态机事件名 (与 example-raw-data.h system_event_t 一致)
+SM_EVENT_NAMES = ("COARSE_TRIGGER", "FINE_MINING", "FINE_NORMAL", "ALARM_OK", "ALARM_FAIL",
+                  "TIMEOUT", "ALWAYS", "FAULT")
+
+# 耗时统计阶段名 (与 profiler.h profiler_stage_t 一致)
+PROFILE_STAGE_NAMES = ("FIFO_READ", "DECODE", "HIGHPASS", "COARSE", "FFT",
+                       "MAGNITUDE", "FINE", "STATE_MACHINE", "LORA_SEND")
+
+# 端到端延迟打点名 (与 latency_tracker.h latency_mark_t 一致)
+LATENCY_MARK_NAMES = ("coarse", "fft", "fine", "mining", "alarm_queued", "tx_start", "tx_done")
+LATENCY_MARK_NONE = 0xFFFFFFFF
+
+# DSP基准内核名与能量估算参数 (与 dsp_benchmark.h 一致)
+DSP_BENCH_KERNEL_NAMES = ("biquad_sample", "biquad_block", "rms_window", "rms_running", "cfft", "rfft",
+                          "magnitude", "magnitude_sq", "band_energy", "centroid", "fine_detector")
+DSP_BENCH_SUPPLY_V = 3.3
+DSP_BENCH_RUN_MA = {84: 21.0, 168: 40.0}
+
+# 样本回放 (与 host_protocol.h 一致)
+REPLAY_LSB_PER_G = 8192.0
+REPLAY_MAX_SAMPLES = 64
+
+# 系统状态名 (与 example-raw-data.h system_state_t 一致)
+STATE_NAMES = (
+    "SYSTEM_INIT", "IDLE_SLEEP", "MONITORING", "COARSE_TRIGGERED", "FINE_ANALYSIS",
+    "MINING_DETECTED", "ALARM_SENDING", "ALARM_COMPLETE", "ERROR_HANDLING",
+    "SYSTEM_RESET", "LP_SLEEP_PREPARE", "LP_SLEEP_MODE", "LP_WAKEUP",
+    "LP_DETECTION_ACTIVE",
+)
+
+
+def crc16_modbus(data, crc=0xFFFF):
+    """Modbus CRC16"""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            if crc & 0x0001:
+                crc = (crc >> 1) ^ 0xA001
+            else:
+                crc >>= 1
+    return crc
+
+
+def build_frame(cmd, payload=b''):
+    """构建命令帧"""
+    body = struct.pack('<BH', cmd, len(payload)) + bytes(payload)
+    return FRAME_HEADER + body + struct.pack('<H', crc16_modbus(body))
+
+
+def parse_telemetry(data):
+    """解析遥测载荷 (格式见 telemetry.h)"""
+    keys = ("version", "timestamp_ms", "window_ms", "cpu_load_permille", "sleep_permille",
+            "fifo_reads", "fifo_overflows", "samples", "fft_frames", "coarse_triggers",
+            "fine_mining", "fine_normal", "uplink_ok", "uplink_fail")
+    fmt = '<BIIHHIIIIIIIII'
+    fields = struct.unpack_from(fmt, data)
+    result = dict(zip(keys, fields))
+    offset = struct.calcsize(fmt)
+    count = data[offset]
+    residency = struct.unpack_from(f'<{count}H', data, offset + 1)
+    result["residency_permille"] = {
+        (STATE_NAMES[i] if i < len(STATE_NAMES) else str(i)): value
+        for i, value in enumerate(residency)
+    }
+    return result
+
+
+def negotiate_baud(ser, baud, timeout=1.0):
+    """
+    在已打开的串口上把链路切换到 baud (固件须处于 115200)
+    成功返回 True；失败时串口恢复为 115200 (固件确认超时后也会自动回退)
+    """
+    if baud == ser.baudrate:
+        return True
+    parser = FrameParser()
+
+    def wait_response(cmd):
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            for rcmd, payload in parser.feed(ser.read(ser.in_waiting or 1)):
+                if rcmd == (cmd | RESPONSE_FLAG) and len(payload) >= 1:
+                    return payload
+        return None
+
+    saved_timeout = ser.timeout
+    ser.timeout = 0.05
+    try:
+        ser.reset_input_buffer()
+        ser.write(build_frame(CMD_SET_BAUD, struct.pack('<I', baud)))
+        resp = wait_response(CMD_SET_BAUD)
+        if resp is None or resp[0] != 0:
+            return False
+
+        # 等固件切换后再改本端速率
+        time.sleep(0.05)
+        ser.baudrate = baud
+        ser.reset_input_buffer()
+        parser = FrameParser()
+        ser.write(build_frame(CMD_PING, b'baud'))
+        resp = wait_response(CMD_PING)
+        if resp is not None and resp[0] == 0 and resp[1:] == b'baud':
+            return True
+
+        ser.baudrate = DEFAULT_BAUD
+        ser.reset_input_buffer()
+        return False
+    finally:
+        ser.timeout = saved_timeout
+
+
+class FrameParser:
+    """流式帧解析器：从混有printf文本的串口数据中提取帧"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        """送入新数据，返回解析出的 (cmd, payload) 列表"""
+        self.buffer.extend(data)
+        frames = []
+        while True:
+            start = self.buffer.find(FRAME_HEADER)
+            if start < 0:
+                # 保留末尾可能是半个帧头的字节
+                del self.buffer[:-1]
+                break
+            if start > 0:
+                del self.buffer[:start]
+            if len(self.buffer) < 5:
+                break
+            cmd, length = struct.unpack_from('<BH', self.buffer, 2)
+            total = 5 + length + 2
+            if length > 4096:
+                del self.buffer[:2]
+                continue
+            if len(self.buffer) < total:
+                break
+            body = bytes(self.buffer[2:5 + length])
+            crc_rx = struct.unpack_from('<H', self.buffer, 5 + length)[0]
+            if crc16_modbus(body) == crc_rx:
+                frames.append((cmd, body[3:]))
+                del self.buffer[:total]
+            else:
+                # CRC错误：可能是文本中偶然出现的AA 55，跳过帧头继续搜索
+                del self.buffer[:2]
+        return frames
+
+
+class STM32CommandClient:
+    def __init__(self, port="COM8", baudrate=115200, timeout=1.0):
+        self.port = port
+        self.baudrate = baudrate
+        self.timeout = timeout
+        self.ser = None
+        self.parser = FrameParser()
+        self.on_stream = None           # 等待应答期间收到的主动上报帧回调 (cmd, payload)
+
+    def connect(self, target_baud=None):
+        """以115200连接，target_baud给定时协商切换到高速"""
+        try:
+            self.ser = serial.Serial(self.port, self.baudrate, timeout=0.05)
+            print(f"✅ 已连接到 {self.port} @ {self.baudrate}")
+        except Exception as e:
+            print(f"❌ 连接失败: {e}")
+            return False
+
+        if target_baud and target_baud != self.baudrate:
+            if negotiate_baud(self.ser, target_baud, self.timeout):
+                self.baudrate = target_baud
+                print(f"✅ 链路已切换到 {target_baud}")
+            else:
+                print(f"⚠️ 速率协商失败，保持 {self.ser.baudrate}")
+        return True
+
+    def disconnect(self):
+        if self.ser and self.ser.is_open:
+            self.ser.close()
+
+    def request(self, cmd, payload=b''):
+        """发送命令并等待应答，返回 (status, data)"""
+        self.ser.write(build_frame(cmd, payload))
+        deadline = time.time() + self.timeout
+        while time.time() < deadline:
+            data = self.ser.read(self.ser.in_waiting or 1)
+            for rcmd, rpayload in self.parser.feed(data):
+                if rcmd == (cmd | RESPONSE_FLAG) and len(rpayload) >= 1:
+                    return rpayload[0], rpayload[1:]
+                if self.on_stream is not None and not (rcmd & RESPONSE_FLAG):
+                    self.on_stream(rcmd, rpayload)
+        raise TimeoutError(f"命令0x{cmd:02X}应答超时")
+
+    def get_param(self, param_id):
+        status, data = self.request(CMD_GET_PARAM, bytes([param_id]))
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        return struct.unpack('<f', data[1:5])[0]
+
+    def set_param(self, param_id, value):
+        status, data = self.request(CMD_SET_PARAM, struct.pack('<Bf', param_id, value))
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        return struct.unpack('<f', data[1:5])[0]
+
+    def get_all_params(self):
+        status, data = self.request(CMD_GET_ALL_PARAMS)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        count = data[0]
+        params = {}
+        for i in range(count):
+            param_id, value = struct.unpack_from('<Bf', data, 1 + i * 5)
+            params[param_id] = value
+        return params
+
+    def reset_params(self):
+        return self.request(CMD_RESET_PARAMS)[0]
+
+    def get_stats(self):
+        status, data = self.request(CMD_GET_STATS)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        fields = struct.unpack('<IfffIIIIIII', data[:44])
+        keys = ("trigger_count", "current_rms", "baseline_rms", "peak_factor",
+                "total_detections", "mining_detections", "false_alarms", "transition_count",
+                "rx_frames", "crc_errors", "uart_errors")
+        return dict(zip(keys, fields))
+
+    def get_telemetry(self):
+        status, data = self.request(CMD_GET_TELEMETRY)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        return parse_telemetry(data)
+
+    def monitor(self, callback, duration=None):
+        """持续接收主动上报的遥测帧"""
+        start = time.time()
+        while duration is None or time.time() - start < duration:
+            data = self.ser.read(self.ser.in_waiting or 1)
+            for cmd, payload in self.parser.feed(data):
+                if cmd == CMD_STREAM_TELEMETRY:
+                    callback(parse_telemetry(payload))
+
+    def get_loop_stats(self):
+        status, data = self.request(CMD_GET_LOOP_STATS)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        idle, wakeups, count = struct.unpack_from('<HIB', data)
+        events = {}
+        for i in range(count):
+            posted, dispatched, avg_us, max_us = struct.unpack_from('<4I', data, 7 + i * 16)
+            name = EVENT_NAMES[i] if i < len(EVENT_NAMES) else str(i)
+            events[name] = {"posted": posted, "dispatched": dispatched,
+                            "latency_avg_us": avg_us, "latency_max_us": max_us}
+        return {"idle_percent": idle / 10.0, "wakeups": wakeups, "events": events}
+
+    def get_state_trace(self):
+        """读取状态机转换跟踪，返回 (当前状态, 记录列表)，记录按时间先后排列"""
+        status, data = self.request(CMD_GET_STATE_TRACE)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        current, count = struct.unpack_from('<BB', data)
+        entries = []
+        for i in range(count):
+            timestamp_us, dwell_ms, src, dst, event = struct.unpack_from('<QIBBB', data, 2 + i * 15)
+            entries.append({
+                "timestamp_us": timestamp_us,
+                "dwell_ms": dwell_ms,
+                "from": STATE_NAMES[src] if src < len(STATE_NAMES) else str(src),
+                "to": STATE_NAMES[dst] if dst < len(STATE_NAMES) else str(dst),
+                "event": SM_EVENT_NAMES[event] if event < len(SM_EVENT_NAMES) else str(event),
+            })
+        return (STATE_NAMES[current] if current < len(STATE_NAMES) else str(current)), entries
+
+    def get_profile(self, reset=False):
+        """读取分阶段耗时统计，时间单位为微秒，histogram为log2分桶计数"""
+        status, data = self.request(CMD_GET_PROFILE, bytes([1 if reset else 0]))
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        core_hz, count, buckets = struct.unpack_from('<IBB', data)
+        cycles_per_us = core_hz / 1e6
+        offset = 6
+        stages = {}
+        for i in range(count):
+            n, min_c, max_c, sum_lo, sum_hi = struct.unpack_from('<5I', data, offset)
+            hist = struct.unpack_from(f'<{buckets}I', data, offset + 20)
+            offset += 20 + 4 * buckets
+            name = PROFILE_STAGE_NAMES[i] if i < len(PROFILE_STAGE_NAMES) else str(i)
+            total = (sum_hi << 32) | sum_lo
+            stages[name] = {
+                "count": n,
+                "min_us": min_c / cycles_per_us,
+                "mean_us": (total / n / cycles_per_us) if n else 0.0,
+                "max_us": max_c / cycles_per_us,
+                "histogram": list(hist),
+            }
+        return {"core_mhz": core_hz / 1e6, "stages": stages}
+
+    def get_latency(self):
+        """读取端到端检测延迟记录，延迟单位为微秒 (None表示未经过该环节)"""
+        status, data = self.request(CMD_GET_LATENCY)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        started, completed, abandoned, marks, has_worst, count = struct.unpack_from('<3I3B', data)
+        offset = 15
+        records = []
+        for _ in range(has_worst + count):
+            corr_id, start_us = struct.unpack_from('<HQ', data, offset)
+            deltas = struct.unpack_from(f'<{marks}I', data, offset + 10)
+            offset += 10 + 4 * marks
+            records.append({
+                "id": corr_id,
+                "start_us": start_us,
+                "marks": {
+                    (LATENCY_MARK_NAMES[m] if m < len(LATENCY_MARK_NAMES) else str(m)):
+                        (None if d == LATENCY_MARK_NONE else d)
+                    for m, d in enumerate(deltas)
+                },
+            })
+        worst = records.pop(0) if has_worst else None
+        return {"started": started, "completed": completed, "abandoned": abandoned,
+                "worst": worst, "history": records}
+
+    def get_sysmon(self):
+        """读取CPU负载 (百分比)、主栈高水位和各状态负载"""
+        status, data = self.request(CMD_GET_SYSMON)
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        core_hz, load, peak, windows, stack_size, stack_peak, n = struct.unpack_from('<I2H3IB', data)
+        states = {}
+        for i in range(n):
+            total, busy = struct.unpack_from('<2Q', data, 21 + i * 16)
+            if total == 0:
+                continue
+            name = STATE_NAMES[i] if i < len(STATE_NAMES) else str(i)
+            states[name] = {"load": busy * 100.0 / total, "time_ms": total * 1000.0 / core_hz}
+        return {"load": load / 10.0, "load_peak": peak / 10.0, "windows": windows,
+                "stack_size": stack_size, "stack_peak": stack_peak, "states": states}
+
+    def run_dsp_benchmark(self):
+        """在目标板上运行DSP基准测试 (仅监测状态，期间暂停采集)，返回 (counter_hz, paused_ms, [(kernel, N, min, max)])"""
+        saved_timeout = self.timeout
+        self.timeout = max(self.timeout, 10.0)
+        try:
+            status, data = self.request(CMD_RUN_DSP_BENCH)
+        finally:
+            self.timeout = saved_timeout
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        counter_hz, paused_ms, count = struct.unpack_from('<2IB', data)
+        rows = []
+        for i in range(count):
+            kernel, size, min_c, max_c = struct.unpack_from('<BH2I', data, 9 + i * 11)
+            name = DSP_BENCH_KERNEL_NAMES[kernel] if kernel < len(DSP_BENCH_KERNEL_NAMES) else str(kernel)
+            rows.append((name, size, min_c, max_c))
+        return counter_hz, paused_ms, rows
+
+    def ping(self, payload=b''):
+        status, data = self.request(CMD_PING, payload)
+        return status == 0 and data == bytes(payload)
+
+    def echo_test(self, count=100, size=100):
+        """上位机->固件->上位机回环误码测试"""
+        errors = 0
+        start = time.time()
+        for i in range(count):
+            payload = bytes((i + j) & 0xFF for j in range(size))
+            try:
+                if not self.ping(payload):
+                    errors += 1
+            except TimeoutError:
+                errors += 1
+        elapsed = time.time() - start
+        return {"frames": count, "errors": errors,
+                "round_trip_bytes_per_sec": 2 * count * (size + 8) / elapsed}
+
+    def link_test(self, total_bytes=1000000, chunk=512):
+        """固件->上位机DMA吞吐测试，返回上位机统计和固件结果"""
+        status, _ = self.request(CMD_LINK_TEST, struct.pack('<IH', total_bytes, chunk))
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+
+        host = {"frames": 0, "bytes": 0, "seq_gaps": 0, "pattern_errors": 0}
+        expected_seq = 0
+        start = time.time()
+        deadline = start + max(10.0, total_bytes * 20 / self.ser.baudrate)
+        while time.time() < deadline:
+            for cmd, payload in self.parser.feed(self.ser.read(self.ser.in_waiting or 1)):
+                if cmd == CMD_LINK_TEST_DATA:
+                    seq = struct.unpack_from('<I', payload)[0]
+                    if seq != expected_seq:
+                        host["seq_gaps"] += 1
+                    expected_seq = seq + 1
+                    data = payload[4:]
+                    if any(b != ((seq + i) & 0xFF) for i, b in enumerate(data)):
+                        host["pattern_errors"] += 1
+                    host["frames"] += 1
+                    host["bytes"] += len(payload) + 7
+                elif cmd == CMD_LINK_TEST_RESULT:
+                    keys = ("bytes", "frames", "elapsed_ms", "bytes_per_sec", "baud",
+                            "tx_errors", "rx_crc_errors", "uart_errors", "fft_frames")
+                    device = dict(zip(keys, struct.unpack_from('<9I', payload)))
+                    elapsed = time.time() - start
+                    host["bytes_per_sec"] = host["bytes"] / elapsed if elapsed > 0 else 0
+                    host["frame_loss"] = device["frames"] - host["frames"]
+                    return {"host": host, "device": device}
+        raise TimeoutError("吞吐测试结果超时")
+
+    def set_stream(self, mask):
+        return self.request(CMD_STREAM_CONTROL, bytes([mask]))[0]
+
+    def replay_control(self, start):
+        """开始/结束回放，返回本次回放计数"""
+        status, data = self.request(CMD_REPLAY_CONTROL, bytes([1 if start else 0]))
+        if status != 0:
+            raise ValueError(STATUS_NAMES.get(status, status))
+        keys = ("samples", "coarse_triggers", "fft_frames", "mining_detections")
+        return dict(zip(keys, struct.unpack_from('<4I', data)))
+
+    def replay_samples(self, samples):
+        """注入样本 (g)，FFT工作者忙 (BUSY) 时稍后重发同一帧"""
+        for i in range(0, len(samples), REPLAY_MAX_SAMPLES):
+            chunk = [max(-32768, min(32767, int(round(s * REPLAY_LSB_PER_G))))
+                     for s in samples[i:i + REPLAY_MAX_SAMPLES]]
+            payload = struct.pack(f'<{len(chunk)}h', *chunk)
+            for _ in range(100):
+                status, _ = self.request(CMD_REPLAY_SAMPLES, payload)
+                if status == 0:
+                    break
+                if status != 0x05:
+                    raise ValueError(STATUS_NAMES.get(status, status))
+                time.sleep(0.005)
+            else:
+                raise TimeoutError("回放样本持续BUSY")
+
+    def replay_events(self, events):
+        """
+        逐事件回放 (事件格式见 Host/events_to_corpus.py load_events)，
+        通过细检测流上报收集每帧分类，返回每事件结果列表
+        """
+        results = []
+        frames = []
+
+        def collect(cmd, payload):
+            if cmd == CMD_STREAM_DETECTION and len(payload) >= 33:
+                _, cls, conf = struct.unpack_from('<IBf', payload)
+                frames.append((cls, conf))
+
+        saved_mask = self.request(CMD_GET_STATUS)[1][3]
+        self.set_stream(STREAM_DETECTION)
+        self.on_stream = collect
+        try:
+            for ev in events:
+                frames.clear()
+                self.replay_control(True)
+                start = time.time()
+                self.replay_samples(ev["samples"])
+                elapsed = time.time() - start
+                time.sleep(0.1)         # 等最后一帧细检测上报
+                self.request(CMD_PING)
+                counters = self.replay_control(False)
+                mining = sum(1 for cls, _ in frames if cls == 1)
+                results.append({
+                    "name": ev["name"], "expected": ev["expected"],
+                    "result": "mining" if mining else ("normal" if frames else "none"),
+                    "confidence": max((conf for _, conf in frames), default=0.0),
+                    "frames_mining": mining, "frames_normal": len(frames) - mining,
+                    "samples_per_sec": len(ev["samples"]) / elapsed if elapsed > 0 else 0.0,
+                    **counters})
+        finally:
+            self.on_stream = None
+            self.replay_control(False)
+            self.set_stream(saved_mask)
+        return results
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return
+
+    client = STM32CommandClient(sys.argv[1])
+    target_baud = int(sys.argv[3]) if sys.argv[2] == "linktest" and len(sys.argv) > 3 else None
+    if not client.connect(target_baud):
+        return
+
+    try:
+        action = sys.argv[2]
+        if action == "get-all":
+            for param_id, value in client.get_all_params().items():
+                print(f"[0x{param_id:02X}] {PARAM_NAMES.get(param_id, '?'):24s} = {value:.6f}")
+        elif action == "get":
+            print(client.get_param(int(sys.argv[3], 0)))
+        elif action == "set":
+            print(client.set_param(int(sys.argv[3], 0), float(sys.argv[4])))
+        elif action == "reset":
+            print(STATUS_NAMES.get(client.reset_params()))
+        elif action == "stats":
+            for key, value in client.get_stats().items():
+                print(f"{key:20s} = {value}")
+        elif action == "telemetry":
+            for key, value in client.get_telemetry().items():
+                print(f"{key:20s} = {value}")
+        elif action == "monitor":
+            client.monitor(lambda t: print(
+                f"[{t['timestamp_ms']:>10d}] cpu={t['cpu_load_permille'] / 10:.1f}% "
+                f"sleep={t['sleep_permille'] / 10:.1f}% samples={t['samples']} "
+                f"fft={t['fft_frames']} ovf={t['fifo_overflows']} "
+                f"mining={t['fine_mining']} uplink={t['uplink_ok']}/{t['uplink_fail']}"))
+        elif action == "loop":
+            stats = client.get_loop_stats()
+            print(f"idle {stats['idle_percent']:.1f}%  wakeups {stats['wakeups']}")
+            for name, ev in stats["events"].items():
+                print(f"{name:12s} posted={ev['posted']:<8d} dispatched={ev['dispatched']:<8d} "
+                      f"avg={ev['latency_avg_us']}us max={ev['latency_max_us']}us")
+        elif action == "trace":
+            current, entries = client.get_state_trace()
+            for e in entries:
+                print(f"{e['timestamp_us'] / 1e6:14.6f}s {e['from']:>20s} -> {e['to']:<20s} "
+                      f"on {e['event']:<15s} dwell={e['dwell_ms']}ms")
+            print(f"current state: {current}")
+        elif action == "profile":
+            profile = client.get_profile(len(sys.argv) > 3 and sys.argv[3] == "reset")
+            print(f"core {profile['core_mhz']:.0f} MHz")
+            for name, st in profile["stages"].items():
+                if st["count"] == 0:
+                    continue
+                print(f"{name:14s} n={st['count']:<8d} min={st['min_us']:9.2f}us "
+                      f"mean={st['mean_us']:9.2f}us max={st['max_us']:9.2f}us")
+                buckets = [f"<{1 << (b + 1)}:{c}" for b, c in enumerate(st["histogram"]) if c]
+                print(" " * 15 + " ".join(buckets) + " (cycles:count)")
+        elif action == "latency":
+            lat = client.get_latency()
+            print(f"started={lat['started']} completed={lat['completed']} abandoned={lat['abandoned']}")
+            rows = [("worst", lat["worst"])] if lat["worst"] else []
+            rows += [("", r) for r in lat["history"]]
+            for label, r in rows:
+                stages = " ".join(f"{k}={'-' if v is None else f'{v / 1000:.3f}ms'}"
+                                  for k, v in r["marks"].items() if k != "coarse")
+                print(f"{label:5s} #{r['id']:<5d} {stages}")
+        elif action == "sysmon":
+            mon = client.get_sysmon()
+            print(f"cpu load {mon['load']:.1f}% (peak {mon['load_peak']:.1f}%, {mon['windows']} windows)")
+            print(f"stack peak {mon['stack_peak']}/{mon['stack_size']} bytes")
+            for name, st in mon["states"].items():
+                print(f"{name:20s} load={st['load']:5.1f}% over {st['time_ms']:.0f}ms")
+        elif action == "bench":
+            counter_hz, paused_ms, rows = client.run_dsp_benchmark()
+            print(f"counter {counter_hz} Hz, acquisition paused {paused_ms} ms")
+            print(f"{'kernel':14s} {'N':>5s} {'cycles':>10s} {'cyc/pt':>8s} {'us@84MHz':>10s} "
+                  f"{'us@168MHz':>10s} {'uJ@84MHz':>9s} {'uJ@168MHz':>9s}")
+            for name, size, cycles, _ in rows:
+                us = {mhz: cycles / mhz for mhz in DSP_BENCH_RUN_MA}
+                uj = {mhz: DSP_BENCH_RUN_MA[mhz] * DSP_BENCH_SUPPLY_V * us[mhz] / 1000 for mhz in us}
+                print(f"{name:14s} {size:5d} {cycles:10d} {cycles / size:8.2f} {us[84]:10.2f} "
+                      f"{us[168]:10.2f} {uj[84]:9.3f} {uj[168]:9.3f}")
+        elif action == "linktest":
+            total = int(sys.argv[4]) if len(sys.argv) > 4 else 1000000
+            chunk = int(sys.argv[5]) if len(sys.argv) > 5 else 512
+            print(client.echo_test())
+            result = client.link_test(total, chunk)
+            for side, values in result.items():
+                for key, value in values.items():
+                    print(f"{side}.{key:18s} = {value}")
+        elif action == "replay":
+            sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "Host"))
+            from events_to_corpus import load_events
+            events = load_events(sys.argv[3] if len(sys.argv) > 3 else "mining_events.json")
+            print(f"{'event':32s} {'expect':7s} {'result':7s} {'conf':>6s} {'mine/nm':>7s} "
+                  f"{'coarse':>6s} {'samples/s':>10s}")
+            for r in client.replay_events(events):
+                frames = f"{r['frames_mining']}/{r['frames_normal']}"
+                print(f"{r['name']:32s} {r['expected']:7s} {r['result']:7s} {r['confidence']:6.3f} "
+                      f"{frames:>7s} {r['coarse_triggers']:6d} {r['samples_per_sec']:10.0f}")
+        elif action == "stream":
+            print(STATUS_NAMES.get(client.set_stream(int(sys.argv[3], 0))))
+        else:
+            print(__doc__)
+    finally:
+        client.disconnect()
+
+
+if __name__ == "__main__":
+    main()
@@ -9,6 +9,7 @@ import tkinter as tk
 from tkinter import ttk, messagebox
 import serial
 import serial.tools.list_ports
+from stm32_command_protocol import negotiate_baud, SUPPORTED_BAUDS, DEFAULT_BAUD
 import threading
 import time
 import struct
@@ -1035,6 +1036,12 @@ class VibrAnalyzer:
         ttk.Label(serial_frame, text="串口:").pack(side=tk.LEFT)
         self.port_combo = ttk.Combobox(serial_frame, width=15)
         self.port_combo.pack(side=tk.LEFT, padx=(5, 10))
+
+        ttk.Label(serial_frame, text="波特率:").pack(side=tk.LEFT)
+        self.baud_combo = ttk.Combobox(serial_frame, width=9, state="readonly",
+                                       values=[str(b) for b in SUPPORTED_BAUDS])
+        self.baud_combo.set(str(DEFAULT_BAUD))
+        self.baud_combo.pack(side=tk.LEFT, padx=(5, 10))
         
         self.connect_btn = ttk.Button(serial_frame, text="连接", command=self.toggle_connection)
         self.connect_btn.pack(side=tk.LEFT, padx=(0, 10))
@@ -1809,6 +1816,9 @@ class VibrAnalyzer:
                     return
 
                 self.serial_conn = serial.Serial(port, 115200, timeout=1)
+                target_baud = int(self.baud_combo.get())
+                if target_baud != DEFAULT_BAUD and not negotiate_baud(self.serial_conn, target_baud):
+                    print(f"⚠️ 波特率协商到 {target_baud} 失败，保持 {DEFAULT_BAUD}")
 
             # 设置运行状态
             self.running = True